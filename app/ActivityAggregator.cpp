@@ -0,0 +1,227 @@
+#include "ActivityAggregator.h"
+#include "ActivityClock.h"
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QtAlgorithms>
+#include <cmath>
+
+namespace {
+
+const int SECONDS_PER_MINUTE = 60;
+
+qint64 minuteStart(qint64 timestampMSecs)
+{
+    return timestampMSecs - timestampMSecs % ActivityAggregator::MINUTE_MS;
+}
+
+// Bits first..last inclusive, both within 0..63
+quint64 secondRange(int first, int last)
+{
+    if (last < first) {
+        return 0;
+    }
+    return (~quint64(0) >> (63 - (last - first))) << first;
+}
+
+} // namespace
+
+QJsonObject ActivityMinuteSummary::toJson() const
+{
+    QJsonObject json;
+    json["minuteStart"] = QDateTime::fromMSecsSinceEpoch(minuteStartMSecs).toUTC().toString(Qt::ISODate);
+    json["keyCount"] = keyCount;
+    json["clickCount"] = clickCount;
+    json["mouseDistance"] = mouseDistance;
+    json["activeSeconds"] = activeSeconds;
+    json["idleSeconds"] = idleSeconds;
+    json["processName"] = processName;
+    json["windowTitle"] = windowTitle;
+    return json;
+}
+
+void ActivityAggregator::addEvents(const QVector<ActivityEvent>& events)
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (const ActivityEvent& event : events) {
+        const qint64 timestampMSecs = ActivityClock::toMSecsSinceEpoch(event.ticks);
+
+        switch (event.type) {
+            case ActivityEventType::IdleStarted:
+                m_idleSinceMSecs = timestampMSecs - qint64(event.x) * 1000;
+                break;
+            case ActivityEventType::IdleEnded:
+                markIdle(m_idleSinceMSecs >= 0 ? m_idleSinceMSecs : timestampMSecs - qint64(event.x) * 1000,
+                         timestampMSecs);
+                m_idleSinceMSecs = -1;
+                break;
+            case ActivityEventType::AppSwitch:
+            case ActivityEventType::ScreenshotCaptured:
+                break;
+            default:
+                // A minute already handed out cannot change any more
+                if (timestampMSecs >= m_completedBeforeMSecs) {
+                    addInput(event, timestampMSecs);
+                }
+                break;
+        }
+    }
+}
+
+void ActivityAggregator::setForegroundApplication(const QString& processName, const QString& windowTitle,
+                                                  qint64 timestampMSecs)
+{
+    QMutexLocker locker(&m_mutex);
+
+    accountForeground(timestampMSecs);
+    m_processName = processName;
+    m_windowTitle = windowTitle;
+    m_foregroundSinceMSecs = qMax(timestampMSecs, m_foregroundSinceMSecs);
+}
+
+void ActivityAggregator::setIdleThresholdSeconds(int seconds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_idleThresholdSeconds = qMax(0, seconds);
+}
+
+QVector<ActivityMinuteSummary> ActivityAggregator::takeCompleted(qint64 nowMSecs)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Without input an idle period may still be reported that reaches back to the last input
+    qint64 settledMSecs = nowMSecs;
+    if (m_idleSinceMSecs >= 0) {
+        const qint64 idleUntil = minuteStart(nowMSecs);
+        if (idleUntil > m_idleSinceMSecs) {
+            markIdle(m_idleSinceMSecs, idleUntil);
+            m_idleSinceMSecs = idleUntil;
+        }
+    } else {
+        settledMSecs = qMin(nowMSecs, qMax(m_lastInputMSecs, nowMSecs - qint64(m_idleThresholdSeconds) * 1000));
+    }
+
+    accountForeground(nowMSecs);
+
+    QVector<ActivityMinuteSummary> completed;
+    const qint64 completeBefore = minuteStart(settledMSecs);
+    if (completeBefore <= m_completedBeforeMSecs) {
+        return completed;
+    }
+
+    auto it = m_buckets.begin();
+    while (it != m_buckets.end() && it.key() < completeBefore) {
+        finish(it.value());
+        completed.append(it.value().summary);
+        it = m_buckets.erase(it);
+    }
+    m_completedBeforeMSecs = completeBefore;
+    return completed;
+}
+
+int ActivityAggregator::openMinuteCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_buckets.size();
+}
+
+ActivityAggregator::Bucket& ActivityAggregator::bucketAt(qint64 timestampMSecs)
+{
+    const qint64 start = minuteStart(timestampMSecs);
+    auto it = m_buckets.find(start);
+    if (it == m_buckets.end()) {
+        it = m_buckets.insert(start, Bucket());
+        it.value().summary.minuteStartMSecs = start;
+    }
+    return it.value();
+}
+
+void ActivityAggregator::addInput(const ActivityEvent& event, qint64 timestampMSecs)
+{
+    Bucket& bucket = bucketAt(timestampMSecs);
+    const int second = static_cast<int>((timestampMSecs - bucket.summary.minuteStartMSecs) / 1000);
+    bucket.activeSecondMask |= quint64(1) << second;
+    m_lastInputMSecs = qMax(m_lastInputMSecs, timestampMSecs);
+
+    switch (event.type) {
+        case ActivityEventType::KeyDown:
+        case ActivityEventType::SysKeyDown:
+            ++bucket.summary.keyCount;
+            break;
+        case ActivityEventType::MouseLeftDown:
+        case ActivityEventType::MouseRightDown:
+            ++bucket.summary.clickCount;
+            break;
+        case ActivityEventType::MouseMove:
+            if (m_hasMousePosition) {
+                const double dx = double(event.x) - m_mouseX;
+                const double dy = double(event.y) - m_mouseY;
+                bucket.summary.mouseDistance += std::llround(std::sqrt(dx * dx + dy * dy));
+            }
+            m_hasMousePosition = true;
+            m_mouseX = event.x;
+            m_mouseY = event.y;
+            break;
+        default:
+            break;
+    }
+}
+
+void ActivityAggregator::markIdle(qint64 startMSecs, qint64 endMSecs)
+{
+    startMSecs = qMax(startMSecs, m_completedBeforeMSecs);
+    for (qint64 minute = minuteStart(startMSecs); minute < endMSecs; minute += MINUTE_MS) {
+        const qint64 from = qMax(startMSecs, minute) - minute;
+        const qint64 to = qMin(endMSecs, minute + MINUTE_MS) - minute;
+        if (to <= from) {
+            continue;
+        }
+        // Seconds touched by the idle period, partial ones included
+        bucketAt(minute).idleSecondMask |= secondRange(static_cast<int>(from / 1000),
+                                                        static_cast<int>((to + 999) / 1000) - 1);
+    }
+}
+
+void ActivityAggregator::accountForeground(qint64 untilMSecs)
+{
+    if (m_foregroundSinceMSecs < 0 || m_processName.isEmpty()) {
+        return;
+    }
+
+    const qint64 since = qMax(m_foregroundSinceMSecs, m_completedBeforeMSecs);
+    for (qint64 minute = minuteStart(since); minute < untilMSecs; minute += MINUTE_MS) {
+        const qint64 from = qMax(since, minute);
+        const qint64 to = qMin(untilMSecs, minute + MINUTE_MS);
+        if (to > from) {
+            bucketAt(minute).foregroundMSecs[m_processName][m_windowTitle] += to - from;
+        }
+    }
+    m_foregroundSinceMSecs = qMax(m_foregroundSinceMSecs, untilMSecs);
+}
+
+void ActivityAggregator::finish(Bucket& bucket)
+{
+    ActivityMinuteSummary& summary = bucket.summary;
+    summary.activeSeconds = qPopulationCount(bucket.activeSecondMask);
+    summary.idleSeconds = qMin(SECONDS_PER_MINUTE - summary.activeSeconds,
+                               int(qPopulationCount(bucket.idleSecondMask & ~bucket.activeSecondMask)));
+
+    qint64 bestProcessMSecs = 0;
+    for (auto process = bucket.foregroundMSecs.cbegin(); process != bucket.foregroundMSecs.cend(); ++process) {
+        qint64 processMSecs = 0;
+        qint64 bestTitleMSecs = -1;
+        QString bestTitle;
+        for (auto title = process.value().cbegin(); title != process.value().cend(); ++title) {
+            processMSecs += title.value();
+            if (title.value() > bestTitleMSecs) {
+                bestTitleMSecs = title.value();
+                bestTitle = title.key();
+            }
+        }
+        if (processMSecs > bestProcessMSecs) {
+            bestProcessMSecs = processMSecs;
+            summary.processName = process.key();
+            summary.windowTitle = bestTitle;
+        }
+    }
+}
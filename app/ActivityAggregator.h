@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include "ActivityEvent.h"
+
+/**
+ * @brief Activity of one wall-clock minute
+ */
+struct ActivityMinuteSummary {
+    qint64 minuteStartMSecs = 0;  ///< Start of the minute, UTC milliseconds since epoch
+    int keyCount = 0;             ///< Key presses, system keys included
+    int clickCount = 0;           ///< Left and right button presses
+    qint64 mouseDistance = 0;     ///< Pointer travel in pixels
+    int activeSeconds = 0;        ///< Seconds of the minute with at least one input event
+    int idleSeconds = 0;          ///< Seconds of the minute inside an idle period
+    QString processName;          ///< Foreground process with the most time in the minute
+    QString windowTitle;          ///< That process's window title with the most time
+
+    /**
+     * @brief Convert to the JSON object posted to /activity/summary
+     */
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief The ActivityAggregator class folds the activity stream into per-minute summaries
+ *
+ * Input and idle events from the ActivityEventBus are counted into the
+ * minute they happened in, and foreground application changes are
+ * weighted by how long each application stayed in front. A minute is
+ * complete once nothing can change it any more. Because an idle period
+ * starts the idle threshold before it is reported, a minute without input
+ * is held back until the threshold has passed, or until the user is known
+ * to be idle.
+ *
+ * Thread-safe: addEvents() normally runs on the bus thread, the other
+ * methods on the GUI thread.
+ */
+class ActivityAggregator
+{
+public:
+    /**
+     * @brief Count a batch of activity events
+     * @param events Input, IdleStarted and IdleEnded events; other kinds are ignored
+     */
+    void addEvents(const QVector<ActivityEvent>& events);
+
+    /**
+     * @brief Record a foreground application change
+     * @param processName Executable name of the foreground process
+     * @param windowTitle Title of the foreground window
+     * @param timestampMSecs When the change happened, UTC milliseconds since epoch
+     */
+    void setForegroundApplication(const QString& processName, const QString& windowTitle, qint64 timestampMSecs);
+
+    /**
+     * @brief Set how long before being reported an idle period starts
+     * @param seconds The idle detector's threshold
+     */
+    void setIdleThresholdSeconds(int seconds);
+
+    /**
+     * @brief Remove and return every minute that can no longer change
+     * @param nowMSecs The current time, UTC milliseconds since epoch
+     * @return Completed minutes in chronological order
+     */
+    QVector<ActivityMinuteSummary> takeCompleted(qint64 nowMSecs);
+
+    /**
+     * @brief Get the number of minutes still being aggregated
+     */
+    int openMinuteCount() const;
+
+    static const qint64 MINUTE_MS = 60 * 1000;    ///< Bucket length
+
+private:
+    struct Bucket {
+        ActivityMinuteSummary summary;
+        quint64 activeSecondMask = 0;             ///< Bit n set if second n saw input
+        quint64 idleSecondMask = 0;               ///< Bit n set if second n was idle
+        QHash<QString, QHash<QString, qint64>> foregroundMSecs; ///< Process -> title -> time in front
+    };
+
+    Bucket& bucketAt(qint64 timestampMSecs);
+    void addInput(const ActivityEvent& event, qint64 timestampMSecs);
+    void markIdle(qint64 startMSecs, qint64 endMSecs);
+    void accountForeground(qint64 untilMSecs);
+    static void finish(Bucket& bucket);
+
+    mutable QMutex m_mutex;                       ///< Protects all members below
+    QMap<qint64, Bucket> m_buckets;               ///< Open minutes by start time
+    qint64 m_completedBeforeMSecs = 0;            ///< Minutes before this were already returned
+    qint64 m_lastInputMSecs = 0;                  ///< Time of the latest input event
+    qint64 m_idleSinceMSecs = -1;                 ///< Start of the running idle period, -1 if active
+    int m_idleThresholdSeconds = 5 * 60;
+
+    QString m_processName;                        ///< Current foreground process
+    QString m_windowTitle;                        ///< Current foreground window title
+    qint64 m_foregroundSinceMSecs = -1;           ///< Time accounted for the current foreground, -1 if none
+
+    bool m_hasMousePosition = false;
+    std::int32_t m_mouseX = 0;
+    std::int32_t m_mouseY = 0;
+};
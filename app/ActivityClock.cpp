@@ -0,0 +1,73 @@
+#include "ActivityClock.h"
+#include <atomic>
+
+namespace {
+
+qint64 tickFrequency()
+{
+    // Function-local so other translation units can use the clock during static initialization
+    static const qint64 frequency = [] {
+        LARGE_INTEGER value;
+        QueryPerformanceFrequency(&value);
+        return value.QuadPart;
+    }();
+    return frequency;
+}
+
+// Wall clock minus tick clock, in milliseconds; (re)written by recalibrate()
+std::atomic<qint64> s_offsetMSecs{0};
+std::atomic<qint64> s_calibratedTicks{0};   ///< 0 until the first calibration
+
+qint64 monotonicMSecs(qint64 tickValue)
+{
+    // Split to keep tickValue * 1000 from overflowing on long uptimes
+    const qint64 frequency = tickFrequency();
+    return tickValue / frequency * 1000 + tickValue % frequency * 1000 / frequency;
+}
+
+} // namespace
+
+qint64 ActivityClock::frequency()
+{
+    return tickFrequency();
+}
+
+qint64 ActivityClock::ticksToMSecs(qint64 tickCount)
+{
+    return monotonicMSecs(tickCount);
+}
+
+qint64 ActivityClock::msecsToTicks(qint64 msecs)
+{
+    const qint64 frequency = tickFrequency();
+    return msecs / 1000 * frequency + msecs % 1000 * frequency / 1000;
+}
+
+qint64 ActivityClock::toMSecsSinceEpoch(qint64 tickValue)
+{
+    if (s_calibratedTicks.load(std::memory_order_acquire) == 0) {
+        recalibrate();
+    }
+    return monotonicMSecs(tickValue) + s_offsetMSecs.load(std::memory_order_relaxed);
+}
+
+qint64 ActivityClock::msecsSinceEpoch()
+{
+    const qint64 now = ticks();
+    if (now - s_calibratedTicks.load(std::memory_order_relaxed) > msecsToTicks(RECALIBRATION_INTERVAL_MS)) {
+        recalibrate();
+        return toMSecsSinceEpoch(ticks());
+    }
+    return toMSecsSinceEpoch(now);
+}
+
+void ActivityClock::recalibrate()
+{
+    // Bracket the system clock read with ticks and pair it with the midpoint
+    const qint64 before = ticks();
+    const qint64 wallMSecs = QDateTime::currentMSecsSinceEpoch();
+    const qint64 after = ticks();
+
+    s_offsetMSecs.store(wallMSecs - monotonicMSecs(before + (after - before) / 2), std::memory_order_relaxed);
+    s_calibratedTicks.store(after, std::memory_order_release);
+}
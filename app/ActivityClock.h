@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QDateTime>
+#include <QtGlobal>
+#include <windows.h>
+
+/**
+ * @file ActivityClock.h
+ * @brief Single time source for activity timestamps
+ *
+ * Hot paths such as the input hooks only read the QueryPerformanceCounter
+ * tick count; turning ticks into UTC wall-clock time is deferred to the
+ * consumer. The conversion uses an offset between the monotonic clock and
+ * the system clock that is measured at startup and re-measured at most
+ * every RECALIBRATION_INTERVAL_MS when a wall-clock time is requested, so
+ * timestamps follow system clock adjustments without any mutex or
+ * allocation. Durations should always be computed from ticks, never from
+ * wall-clock differences.
+ *
+ * All functions are thread-safe.
+ */
+namespace ActivityClock {
+
+const qint64 RECALIBRATION_INTERVAL_MS = 60 * 1000;  ///< Maximum age of the wall-clock offset
+
+/**
+ * @brief Read the monotonic tick counter (wait-free, safe on the hook thread)
+ * @return Current QueryPerformanceCounter value
+ */
+inline qint64 ticks()
+{
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+}
+
+/**
+ * @brief Get the number of ticks per second
+ */
+qint64 frequency();
+
+/**
+ * @brief Convert a tick duration into milliseconds
+ * @param tickCount Difference between two ticks() values
+ */
+qint64 ticksToMSecs(qint64 tickCount);
+
+/**
+ * @brief Convert a millisecond duration into ticks
+ */
+qint64 msecsToTicks(qint64 msecs);
+
+/**
+ * @brief Convert a ticks() value into UTC milliseconds since epoch
+ *
+ * Uses the current wall-clock offset without recalibrating.
+ */
+qint64 toMSecsSinceEpoch(qint64 tickValue);
+
+/**
+ * @brief Convert a ticks() value into a local date and time
+ */
+inline QDateTime toDateTime(qint64 tickValue)
+{
+    return QDateTime::fromMSecsSinceEpoch(toMSecsSinceEpoch(tickValue));
+}
+
+/**
+ * @brief Get the current UTC time in milliseconds since epoch
+ *
+ * Recalibrates the wall-clock offset first if it is older than
+ * RECALIBRATION_INTERVAL_MS.
+ */
+qint64 msecsSinceEpoch();
+
+/**
+ * @brief Get the current local date and time from the activity clock
+ */
+inline QDateTime currentDateTime()
+{
+    return QDateTime::fromMSecsSinceEpoch(msecsSinceEpoch());
+}
+
+/**
+ * @brief Re-measure the offset between the tick counter and the system clock now
+ */
+void recalibrate();
+
+} // namespace ActivityClock
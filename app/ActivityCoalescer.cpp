@@ -0,0 +1,95 @@
+#include "ActivityCoalescer.h"
+#include <QtGlobal>
+#include <cmath>
+
+ActivityCoalescer::ActivityCoalescer(int intervalMSecs)
+    : m_intervalMSecs(qMax(0, intervalMSecs))
+{
+}
+
+void ActivityCoalescer::setIntervalMSecs(int intervalMSecs)
+{
+    m_intervalMSecs = qMax(0, intervalMSecs);
+}
+
+void ActivityCoalescer::process(const ActivityJournalRecord& record, QVector<ActivityJournalRecord>& output)
+{
+    if (m_intervalMSecs <= 0 || !isMouseMove(record)) {
+        flush(output);
+        if (isMouseMove(record)) {
+            ++m_inputMoveCount;
+            ++m_outputMoveRecordCount;
+        }
+        output.append(record);
+        return;
+    }
+
+    if (hasPendingMoves() && record.timestampMSecs - m_window.timestampMSecs >= m_intervalMSecs) {
+        flush(output);
+    }
+    addMove(record);
+}
+
+void ActivityCoalescer::flushExpired(qint64 nowMSecs, QVector<ActivityJournalRecord>& output)
+{
+    if (hasPendingMoves() && nowMSecs - m_window.timestampMSecs >= m_intervalMSecs) {
+        flush(output);
+    }
+}
+
+void ActivityCoalescer::flush(QVector<ActivityJournalRecord>& output)
+{
+    if (!hasPendingMoves()) {
+        return;
+    }
+
+    if (m_window.moveCount == 1) {
+        // Nothing to merge; keep the raw event
+        ActivityJournalRecord move;
+        move.type = JournalRecordType::Input;
+        move.inputType = ActivityEventType::MouseMove;
+        move.timestampMSecs = m_window.timestampMSecs;
+        move.x = m_window.x;
+        move.y = m_window.y;
+        output.append(move);
+    } else {
+        m_window.pathLength = static_cast<qint32>(std::lround(m_pathLength));
+        output.append(m_window);
+    }
+    ++m_outputMoveRecordCount;
+
+    m_window = ActivityJournalRecord();
+    m_pathLength = 0.0;
+}
+
+bool ActivityCoalescer::isMouseMove(const ActivityJournalRecord& record)
+{
+    return record.type == JournalRecordType::Input && record.inputType == ActivityEventType::MouseMove;
+}
+
+void ActivityCoalescer::addMove(const ActivityJournalRecord& record)
+{
+    ++m_inputMoveCount;
+
+    if (!hasPendingMoves()) {
+        m_window.type = JournalRecordType::MouseMoveSummary;
+        m_window.timestampMSecs = record.timestampMSecs;
+        m_window.x = m_window.lastX = m_window.minX = m_window.maxX = record.x;
+        m_window.y = m_window.lastY = m_window.minY = m_window.maxY = record.y;
+        m_window.moveCount = 1;
+        return;
+    }
+
+    const double dx = static_cast<double>(record.x) - m_window.lastX;
+    const double dy = static_cast<double>(record.y) - m_window.lastY;
+    m_pathLength += std::sqrt(dx * dx + dy * dy);
+
+    m_window.moveCount++;
+    m_window.spanMSecs = static_cast<qint32>(record.timestampMSecs - m_window.timestampMSecs);
+    m_window.lastX = record.x;
+    m_window.lastY = record.y;
+    m_window.minX = qMin(m_window.minX, record.x);
+    m_window.minY = qMin(m_window.minY, record.y);
+    m_window.maxX = qMax(m_window.maxX, record.x);
+    m_window.maxY = qMax(m_window.maxY, record.y);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QVector>
+#include "ActivityJournal.h"
+
+/**
+ * @brief The ActivityCoalescer class merges bursts of mouse moves into summaries
+ *
+ * Mouse-move input records that fall within the same interval are folded
+ * into a single MouseMoveSummary record carrying the move count, path
+ * length, bounding box and first/last point. Every other record (clicks,
+ * wheel, keys, application changes, system messages) passes through
+ * unchanged and closes the open interval first, so the output keeps the
+ * input order.
+ *
+ * Sampling adapts to the amount of movement: an interval that saw a single
+ * move is written as that raw MOUSE_MOVE record rather than a summary.
+ */
+class ActivityCoalescer
+{
+public:
+    /**
+     * @brief Construct a new ActivityCoalescer object
+     * @param intervalMSecs Length of a coalescing interval, 0 to disable coalescing
+     */
+    explicit ActivityCoalescer(int intervalMSecs = DEFAULT_INTERVAL_MS);
+
+    /**
+     * @brief Set the coalescing interval
+     *
+     * An interval that is currently open keeps collecting until the next
+     * record arrives; it is then judged against the new interval.
+     * @param intervalMSecs Length of a coalescing interval, 0 to disable coalescing
+     */
+    void setIntervalMSecs(int intervalMSecs);
+
+    /**
+     * @brief Get the coalescing interval
+     * @return The interval in milliseconds, 0 if coalescing is disabled
+     */
+    int intervalMSecs() const { return m_intervalMSecs; }
+
+    /**
+     * @brief Feed a record through the coalescer
+     * @param record The record to process, in timestamp order
+     * @param output Receives any records that are ready to be written (appended)
+     */
+    void process(const ActivityJournalRecord& record, QVector<ActivityJournalRecord>& output);
+
+    /**
+     * @brief Close the open interval if it has run its full length
+     * @param nowMSecs Current time in UTC milliseconds since epoch
+     * @param output Receives the summary if one was closed (appended)
+     */
+    void flushExpired(qint64 nowMSecs, QVector<ActivityJournalRecord>& output);
+
+    /**
+     * @brief Close the open interval regardless of its age
+     * @param output Receives the summary if there was an open interval (appended)
+     */
+    void flush(QVector<ActivityJournalRecord>& output);
+
+    /**
+     * @brief Check whether mouse moves are waiting in the open interval
+     */
+    bool hasPendingMoves() const { return m_window.moveCount > 0; }
+
+    /**
+     * @brief Get the number of mouse-move records fed in since construction
+     */
+    quint64 inputMoveCount() const { return m_inputMoveCount; }
+
+    /**
+     * @brief Get the number of records written out for those moves (summaries and single moves)
+     */
+    quint64 outputMoveRecordCount() const { return m_outputMoveRecordCount; }
+
+    static const int DEFAULT_INTERVAL_MS = 1000; ///< Default coalescing interval
+
+private:
+    static bool isMouseMove(const ActivityJournalRecord& record);
+    void addMove(const ActivityJournalRecord& record);
+
+    int m_intervalMSecs;
+    ActivityJournalRecord m_window;      ///< Summary of the open interval, moveCount == 0 when closed
+    double m_pathLength = 0.0;           ///< Unrounded path length of the open interval
+    quint64 m_inputMoveCount = 0;
+    quint64 m_outputMoveRecordCount = 0;
+};
@@ -0,0 +1,233 @@
+#include "ActivityCollector.h"
+#include "ActivityClock.h"
+#include "ActivityEventBus.h"
+#include "Metrics.h"
+#include <QDebug>
+
+// Low-level hooks are called on the thread that installed them
+thread_local ActivityCollector* ActivityCollector::t_instance = nullptr;
+
+ActivityCollector::ActivityCollector(ActivityEventBus *bus, QObject *parent)
+    : QThread(parent)
+    , m_bus(bus)
+{
+}
+
+ActivityCollector::~ActivityCollector()
+{
+    stop();
+}
+
+bool ActivityCollector::start()
+{
+    if (isRunning()) {
+        return isCollecting();
+    }
+
+    m_errorString.clear();
+    QThread::start(QThread::HighestPriority);
+    m_started.acquire();
+
+    if (!isCollecting()) {
+        // run() has already returned or is about to
+        wait();
+        return false;
+    }
+
+    qDebug() << "Activity collector started on thread" << m_threadId.load();
+    return true;
+}
+
+void ActivityCollector::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    const DWORD threadId = m_threadId.load();
+    if (threadId != 0) {
+        PostThreadMessageW(threadId, WM_QUIT, 0, 0);
+    }
+    wait();
+    qDebug() << "Activity collector stopped - events seen:" << eventCount();
+}
+
+void ActivityCollector::run()
+{
+    // Create the message queue before anyone can post WM_QUIT to it
+    MSG msg;
+    PeekMessageW(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+    m_threadId.store(GetCurrentThreadId());
+
+    const int hookTimeout = hookTimeoutMSecs();
+    m_hookBudgetMicros = static_cast<quint64>(hookTimeout) * 1000 / Metrics::HOOK_BUDGET_DIVISOR;
+    TT_METRIC_SET(HookTimeoutMSecs, hookTimeout);
+
+    installHooks();
+    const bool installed = isCollecting();
+    m_started.release();
+
+    if (installed) {
+        // The hook callbacks are dispatched from inside GetMessage
+        while (GetMessageW(&msg, NULL, 0, 0) > 0) {
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+    }
+
+    removeHooks();
+    m_threadId.store(0);
+}
+
+void ActivityCollector::installHooks()
+{
+    t_instance = this;
+
+    m_keyboardHook = SetWindowsHookExW(WH_KEYBOARD_LL, LowLevelKeyboardProc, GetModuleHandle(NULL), 0);
+    const DWORD keyboardError = m_keyboardHook == NULL ? GetLastError() : 0;
+    m_mouseHook = SetWindowsHookExW(WH_MOUSE_LL, LowLevelMouseProc, GetModuleHandle(NULL), 0);
+    const DWORD mouseError = m_mouseHook == NULL ? GetLastError() : 0;
+
+    if (m_keyboardHook == NULL || m_mouseHook == NULL) {
+        if (m_keyboardHook == NULL) {
+            m_errorString += QString("Keyboard hook failed. Error: %1\n").arg(keyboardError);
+        }
+        if (m_mouseHook == NULL) {
+            m_errorString += QString("Mouse hook failed. Error: %1\n").arg(mouseError);
+        }
+        removeHooks();
+        return;
+    }
+
+    m_hooksInstalled.store(true);
+}
+
+void ActivityCollector::removeHooks()
+{
+    m_hooksInstalled.store(false);
+
+    if (m_keyboardHook != nullptr) {
+        UnhookWindowsHookEx(m_keyboardHook);
+        m_keyboardHook = nullptr;
+    }
+
+    if (m_mouseHook != nullptr) {
+        UnhookWindowsHookEx(m_mouseHook);
+        m_mouseHook = nullptr;
+    }
+
+    t_instance = nullptr;
+}
+
+int ActivityCollector::hookTimeoutMSecs()
+{
+    // Usually a string value, but a DWORD is honoured as well
+    DWORD timeout = 0;
+    DWORD size = sizeof(timeout);
+    if (RegGetValueW(HKEY_CURRENT_USER, L"Control Panel\\Desktop", L"LowLevelHooksTimeout", RRF_RT_REG_DWORD,
+                     nullptr, &timeout, &size) == ERROR_SUCCESS && timeout > 0) {
+        return static_cast<int>(timeout);
+    }
+
+    wchar_t text[16] = {};
+    size = sizeof(text);
+    if (RegGetValueW(HKEY_CURRENT_USER, L"Control Panel\\Desktop", L"LowLevelHooksTimeout", RRF_RT_REG_SZ,
+                     nullptr, text, &size) == ERROR_SUCCESS) {
+        bool ok = false;
+        const int value = QString::fromWCharArray(text).trimmed().toInt(&ok);
+        if (ok && value > 0) {
+            return value;
+        }
+    }
+    return DEFAULT_HOOK_TIMEOUT_MS;
+}
+
+void ActivityCollector::dispatch(const ActivityEvent& event)
+{
+    m_eventCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (m_bus) {
+        m_bus->publish(event);
+    }
+
+#if TIMETRACKER_METRICS
+    // event.ticks was read on entry to the hook callback
+    if (Metrics::isEnabled()) {
+        const quint64 micros = Metrics::microsSince(event.ticks);
+        Metrics::add(Metrics::Counter::HookEvents);
+        Metrics::record(Metrics::Histogram::HookLatencyMicros, micros);
+        if (micros > m_hookBudgetMicros) {
+            Metrics::add(Metrics::Counter::HookCallbacksOverBudget);
+        }
+    }
+#endif
+}
+
+// These run on every input event system-wide, so they only copy a small POD
+// record into the bus ring buffer; consumers run on other threads.
+LRESULT CALLBACK ActivityCollector::LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam)
+{
+    if (nCode == HC_ACTION && t_instance) {
+        ActivityEvent event{};
+        event.ticks = ActivityClock::ticks();
+        switch (wParam) {
+            case WM_KEYDOWN:
+                event.type = ActivityEventType::KeyDown;
+                break;
+            case WM_KEYUP:
+                event.type = ActivityEventType::KeyUp;
+                break;
+            case WM_SYSKEYDOWN:
+                event.type = ActivityEventType::SysKeyDown;
+                break;
+            case WM_SYSKEYUP:
+                event.type = ActivityEventType::SysKeyUp;
+                break;
+            default:
+                event.type = ActivityEventType::KeyOther;
+                break;
+        }
+
+        KBDLLHOOKSTRUCT* p = reinterpret_cast<KBDLLHOOKSTRUCT*>(lParam);
+        event.x = static_cast<std::int32_t>(p->vkCode);
+        t_instance->dispatch(event);
+    }
+    return CallNextHookEx(NULL, nCode, wParam, lParam);
+}
+
+LRESULT CALLBACK ActivityCollector::LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam)
+{
+    if (nCode == HC_ACTION && t_instance) {
+        ActivityEvent event{};
+        event.ticks = ActivityClock::ticks();
+        switch (wParam) {
+            case WM_LBUTTONDOWN:
+                event.type = ActivityEventType::MouseLeftDown;
+                break;
+            case WM_LBUTTONUP:
+                event.type = ActivityEventType::MouseLeftUp;
+                break;
+            case WM_RBUTTONDOWN:
+                event.type = ActivityEventType::MouseRightDown;
+                break;
+            case WM_RBUTTONUP:
+                event.type = ActivityEventType::MouseRightUp;
+                break;
+            case WM_MOUSEMOVE:
+                event.type = ActivityEventType::MouseMove;
+                break;
+            case WM_MOUSEWHEEL:
+                event.type = ActivityEventType::MouseWheel;
+                break;
+            default:
+                event.type = ActivityEventType::MouseOther;
+                break;
+        }
+
+        MSLLHOOKSTRUCT* p = reinterpret_cast<MSLLHOOKSTRUCT*>(lParam);
+        event.x = p->pt.x;
+        event.y = p->pt.y;
+        t_instance->dispatch(event);
+    }
+    return CallNextHookEx(NULL, nCode, wParam, lParam);
+}
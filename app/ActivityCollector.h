@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QThread>
+#include <QSemaphore>
+#include <QString>
+#include <atomic>
+#include <windows.h>
+#include "ActivityEvent.h"
+
+class ActivityEventBus;
+
+/**
+ * @brief The ActivityCollector class owns the low-level input hooks on a dedicated thread
+ *
+ * WH_KEYBOARD_LL and WH_MOUSE_LL callbacks run on the thread that installed
+ * the hooks, and only while that thread pumps messages. Installing them on a
+ * high-priority thread with its own GetMessage loop keeps system-wide input
+ * responsive however long the GUI thread is busy with dialogs or captures.
+ *
+ * The callbacks do nothing but publish each event to the ActivityEventBus,
+ * a wait-free ring buffer push; the journal writer, the idle detector and
+ * every other consumer are fed from the bus thread in batches.
+ */
+class ActivityCollector : public QThread
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Construct a new ActivityCollector object
+     * @param bus Receives every input event, may be nullptr; the collector is its only publisher
+     * @param parent The parent QObject
+     */
+    explicit ActivityCollector(ActivityEventBus *bus, QObject *parent = nullptr);
+
+    /**
+     * @brief Destroy the ActivityCollector object, removing the hooks
+     */
+    ~ActivityCollector();
+
+    /**
+     * @brief Start the collector thread and install the hooks on it
+     *
+     * Blocks until the hooks are installed or have failed.
+     * @return true if both hooks are installed, false otherwise (see errorString())
+     */
+    bool start();
+
+    /**
+     * @brief Remove the hooks and stop the collector thread
+     */
+    void stop();
+
+    /**
+     * @brief Check whether both hooks are installed
+     */
+    bool isCollecting() const { return m_hooksInstalled.load(); }
+
+    /**
+     * @brief Get the reason the last start() failed
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief Get the number of input events seen by the hooks
+     * @return The total event count since construction
+     */
+    quint64 eventCount() const { return m_eventCount.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Read the time Windows allows a low-level hook callback
+     *
+     * A hook that runs over LowLevelHooksTimeout too often is removed
+     * silently, so callback latency is measured against it.
+     * @return The timeout in milliseconds, DEFAULT_HOOK_TIMEOUT_MS if it is not set
+     */
+    static int hookTimeoutMSecs();
+
+    static const int DEFAULT_HOOK_TIMEOUT_MS = 1000; ///< The limit Windows applies since Windows 7
+
+protected:
+    void run() override;
+
+private:
+    void installHooks();
+    void removeHooks();
+    void dispatch(const ActivityEvent& event);
+
+    static LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam);
+    static LRESULT CALLBACK LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam);
+    static thread_local ActivityCollector* t_instance; ///< Collector owning the calling thread's hooks
+
+    ActivityEventBus *m_bus = nullptr;          ///< Event sink, published to only from the hooks
+    HHOOK m_keyboardHook = nullptr;             ///< Used on the collector thread only
+    HHOOK m_mouseHook = nullptr;                ///< Used on the collector thread only
+    QString m_errorString;                      ///< Written before m_started is released
+
+    QSemaphore m_started;                       ///< Released once hook installation has finished
+    std::atomic<DWORD> m_threadId{0};           ///< Native ID of the collector thread
+    std::atomic<bool> m_hooksInstalled{false};  ///< Both hooks are in place
+    std::atomic<quint64> m_eventCount{0};       ///< Events seen by the hooks
+    quint64 m_hookBudgetMicros = 0;             ///< Callback latency counted as over budget, collector thread only
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Kind of activity event
+ *
+ * Raw input events from the low-level hooks come first; the remaining
+ * kinds are low-rate events posted to the ActivityEventBus.
+ */
+enum class ActivityEventType : std::uint16_t {
+    KeyDown,
+    KeyUp,
+    SysKeyDown,
+    SysKeyUp,
+    KeyOther,
+    MouseLeftDown,
+    MouseLeftUp,
+    MouseRightDown,
+    MouseRightUp,
+    MouseMove,
+    MouseWheel,
+    MouseOther,
+    AppSwitch,            ///< Foreground application changed
+    ScreenshotCaptured,   ///< x: number of screens captured
+    IdleStarted,          ///< x: idle threshold in seconds
+    IdleEnded             ///< x: idle duration in seconds
+};
+
+/**
+ * @brief Fixed-size record pushed by the hook callbacks and posted to the event bus
+ *
+ * Kept trivially copyable so it can live in a preallocated ring buffer
+ * and be copied without touching the heap on the hook thread.
+ */
+struct ActivityEvent {
+    std::int64_t ticks;       ///< ActivityClock::ticks() at capture time
+    ActivityEventType type;   ///< Event kind
+    std::uint16_t reserved;   ///< Padding, always zero
+    std::int32_t x;           ///< Virtual-key code for keyboard events, X coordinate for mouse events, see type otherwise
+    std::int32_t y;           ///< Y coordinate for mouse events, unused for other kinds
+};
+
+static_assert(std::is_trivially_copyable<ActivityEvent>::value,
+              "ActivityEvent must stay a POD record for the hook ring buffer");
@@ -0,0 +1,220 @@
+#include "ActivityEventBus.h"
+#include "ActivityClock.h"
+#include "Metrics.h"
+#include <QDebug>
+#include <QMutexLocker>
+#include <algorithm>
+
+ActivityEventBus::ActivityEventBus(QObject *parent)
+    : QThread(parent)
+    , m_ringBuffer(RING_CAPACITY)
+    , m_drainBuffer(DRAIN_BATCH_SIZE)
+{
+}
+
+ActivityEventBus::~ActivityEventBus()
+{
+    stop();
+}
+
+void ActivityEventBus::post(ActivityEventType type, std::int32_t x, std::int32_t y)
+{
+    ActivityEvent event{};
+    event.ticks = ActivityClock::ticks();
+    event.type = type;
+    event.x = x;
+    event.y = y;
+
+    QMutexLocker locker(&m_postMutex);
+    m_posted.append(event);
+}
+
+int ActivityEventBus::subscribe(const QString& name, quint32 typeMask, Handler handler,
+                                QObject *context, int capacity)
+{
+    auto consumer = std::make_shared<Consumer>();
+    consumer->name = name;
+    consumer->typeMask = typeMask;
+    consumer->handler = std::move(handler);
+    consumer->context = context;
+    consumer->hasContext = context != nullptr;
+    consumer->capacity = capacity > 0 ? capacity : 1;
+
+    QMutexLocker locker(&m_consumerMutex);
+    consumer->id = m_nextConsumerId++;
+    m_consumers.insert(consumer->id, consumer);
+    return consumer->id;
+}
+
+void ActivityEventBus::unsubscribe(int consumerId)
+{
+    QMutexLocker locker(&m_consumerMutex);
+    std::shared_ptr<Consumer> consumer = m_consumers.take(consumerId);
+    if (consumer) {
+        consumer->active.store(false);
+    }
+}
+
+quint64 ActivityEventBus::consumerDroppedCount(int consumerId) const
+{
+    std::shared_ptr<Consumer> consumer;
+    {
+        QMutexLocker locker(&m_consumerMutex);
+        consumer = m_consumers.value(consumerId);
+    }
+    if (!consumer) {
+        return 0;
+    }
+
+    QMutexLocker locker(&consumer->mutex);
+    return consumer->dropped;
+}
+
+void ActivityEventBus::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    m_stopRequested.store(true);
+    {
+        QMutexLocker locker(&m_wakeMutex);
+        m_wakeCondition.wakeAll();
+    }
+    wait();
+    m_stopRequested.store(false);
+}
+
+void ActivityEventBus::run()
+{
+    while (!m_stopRequested.load()) {
+        drain();
+
+        QMutexLocker locker(&m_wakeMutex);
+        if (!m_stopRequested.load()) {
+            m_wakeCondition.wait(&m_wakeMutex, DRAIN_INTERVAL_MS);
+        }
+    }
+
+    // Final drain so nothing published before stop() is lost
+    drain();
+}
+
+void ActivityEventBus::drain()
+{
+    QVector<ActivityEvent> posted;
+    {
+        QMutexLocker locker(&m_postMutex);
+        posted.swap(m_posted);
+    }
+
+    // Interleave low-rate events with the input events by capture time
+    m_batch.clear();
+    int postedIndex = 0;
+    std::size_t count;
+    do {
+        count = m_ringBuffer.popBatch(m_drainBuffer.data(), m_drainBuffer.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            const ActivityEvent& event = m_drainBuffer[static_cast<int>(i)];
+            while (postedIndex < posted.size() && posted[postedIndex].ticks <= event.ticks) {
+                m_batch.append(posted[postedIndex++]);
+            }
+            m_batch.append(event);
+        }
+    } while (count == static_cast<std::size_t>(m_drainBuffer.size()));
+
+    while (postedIndex < posted.size()) {
+        m_batch.append(posted[postedIndex++]);
+    }
+
+    quint64 dropped = m_ringBuffer.droppedCount();
+    if (dropped != m_reportedDropCount) {
+        qWarning() << "ActivityEventBus ring buffer overflow -" << (dropped - m_reportedDropCount)
+                   << "events dropped (total:" << dropped << ")";
+        TT_METRIC_ADD(RingBufferDrops, dropped - m_reportedDropCount);
+        m_reportedDropCount = dropped;
+    }
+
+    if (!m_batch.isEmpty()) {
+        fanOut();
+    }
+}
+
+void ActivityEventBus::fanOut()
+{
+    QList<std::shared_ptr<Consumer>> consumers;
+    {
+        QMutexLocker locker(&m_consumerMutex);
+        consumers = m_consumers.values();
+    }
+    std::sort(consumers.begin(), consumers.end(),
+              [](const std::shared_ptr<Consumer>& a, const std::shared_ptr<Consumer>& b) { return a->id < b->id; });
+
+    for (const std::shared_ptr<Consumer>& consumer : consumers) {
+        const QVector<ActivityEvent> *events = &m_batch;
+        if (consumer->typeMask != ALL_EVENTS) {
+            m_filtered.clear();
+            for (const ActivityEvent& event : m_batch) {
+                if (consumer->typeMask & typeBit(event.type)) {
+                    m_filtered.append(event);
+                }
+            }
+            events = &m_filtered;
+        }
+
+        if (events->isEmpty() || !consumer->active.load()) {
+            continue;
+        }
+
+        if (consumer->hasContext) {
+            enqueue(consumer, *events);
+        } else {
+            consumer->handler(*events);
+        }
+    }
+}
+
+void ActivityEventBus::enqueue(const std::shared_ptr<Consumer>& consumer, const QVector<ActivityEvent>& events)
+{
+    QObject *context = consumer->context.data();
+    if (!context) {
+        // The receiving object is gone; nobody will take these events
+        return;
+    }
+
+    QMutexLocker locker(&consumer->mutex);
+    consumer->pending += events;
+
+    const int excess = static_cast<int>(consumer->pending.size()) - consumer->capacity;
+    if (excess > 0) {
+        consumer->pending.remove(0, excess);
+        consumer->dropped += static_cast<quint64>(excess);
+        TT_METRIC_ADD(ConsumerDrops, static_cast<quint64>(excess));
+    }
+    if (consumer->dropped != consumer->reportedDropped) {
+        qWarning() << "ActivityEventBus consumer" << consumer->name << "is falling behind -"
+                   << (consumer->dropped - consumer->reportedDropped) << "events dropped (total:"
+                   << consumer->dropped << ")";
+        consumer->reportedDropped = consumer->dropped;
+    }
+
+    if (!consumer->deliveryScheduled) {
+        consumer->deliveryScheduled = true;
+        std::shared_ptr<Consumer> target = consumer;
+        QMetaObject::invokeMethod(context, [target]() { deliver(target); }, Qt::QueuedConnection);
+    }
+}
+
+void ActivityEventBus::deliver(const std::shared_ptr<Consumer>& consumer)
+{
+    QVector<ActivityEvent> events;
+    {
+        QMutexLocker locker(&consumer->mutex);
+        events.swap(consumer->pending);
+        consumer->deliveryScheduled = false;
+    }
+
+    if (!events.isEmpty() && consumer->active.load()) {
+        consumer->handler(events);
+    }
+}
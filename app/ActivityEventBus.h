@@ -0,0 +1,156 @@
+#pragma once
+
+#include <QThread>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "ActivityEvent.h"
+#include "ActivityRingBuffer.h"
+
+/**
+ * @brief The ActivityEventBus class fans activity events out to consumers in batches
+ *
+ * Producers publish ActivityEvent records: the input hooks through the
+ * wait-free publish(), low-rate producers such as the application tracker,
+ * screenshot capture and idle transitions through post(). Once per drain
+ * cycle the bus thread merges both sources in tick order and hands every
+ * consumer the events matching its type mask as one batch, so the cost on
+ * the hook path is a single ring buffer push however many consumers exist.
+ *
+ * A consumer without a context object is called on the bus thread and must
+ * be thread-safe and quick. A consumer with a context object is called on
+ * that object's thread; while a batch is waiting to be delivered, further
+ * events accumulate behind it up to the consumer's capacity and the oldest
+ * are dropped and counted beyond that, so a blocked GUI thread only costs
+ * its own consumers events.
+ */
+class ActivityEventBus : public QThread
+{
+    Q_OBJECT
+
+public:
+    using Handler = std::function<void(const QVector<ActivityEvent>& events)>;
+
+    /**
+     * @brief Construct a new ActivityEventBus object
+     * @param parent The parent QObject
+     */
+    explicit ActivityEventBus(QObject *parent = nullptr);
+
+    /**
+     * @brief Destroy the ActivityEventBus object, delivering pending events
+     */
+    ~ActivityEventBus();
+
+    /**
+     * @brief Publish a raw input event (hook thread only, wait-free)
+     * @param event The event to publish
+     * @return true if queued, false if the ring buffer was full and the event was dropped
+     */
+    bool publish(const ActivityEvent& event) { return m_ringBuffer.tryPush(event); }
+
+    /**
+     * @brief Publish a low-rate event from any thread
+     * @param type Event kind
+     * @param x First payload value, see ActivityEvent
+     * @param y Second payload value, see ActivityEvent
+     */
+    void post(ActivityEventType type, std::int32_t x = 0, std::int32_t y = 0);
+
+    /**
+     * @brief Register a consumer (thread-safe)
+     * @param name Consumer name used in diagnostics
+     * @param typeMask Event kinds to deliver, built with typeBit()
+     * @param handler Called with each non-empty batch
+     * @param context Object whose thread runs the handler, nullptr for the bus thread
+     * @param capacity Maximum events held for a context consumer before the oldest are dropped
+     * @return Consumer ID for unsubscribe()
+     */
+    int subscribe(const QString& name, quint32 typeMask, Handler handler,
+                  QObject *context = nullptr, int capacity = DEFAULT_CONSUMER_CAPACITY);
+
+    /**
+     * @brief Remove a consumer; batches already scheduled for it are discarded
+     * @param consumerId ID returned by subscribe()
+     */
+    void unsubscribe(int consumerId);
+
+    /**
+     * @brief Stop the bus thread after delivering everything published so far
+     */
+    void stop();
+
+    /**
+     * @brief Get the number of input events dropped because the ring buffer was full
+     */
+    quint64 droppedEventCount() const { return m_ringBuffer.droppedCount(); }
+
+    /**
+     * @brief Get the number of events a consumer lost to backpressure
+     * @param consumerId ID returned by subscribe()
+     * @return The total drop count for that consumer, 0 for unknown IDs
+     */
+    quint64 consumerDroppedCount(int consumerId) const;
+
+    /**
+     * @brief Get the mask bit for one event kind
+     */
+    static constexpr quint32 typeBit(ActivityEventType type) { return 1u << static_cast<int>(type); }
+
+    static const quint32 INPUT_EVENTS = (1u << (static_cast<int>(ActivityEventType::MouseOther) + 1)) - 1; ///< Hook events
+    static const quint32 ALL_EVENTS = 0xffffffffu;   ///< Every event kind
+    static const int DEFAULT_CONSUMER_CAPACITY = 8192; ///< Events held per context consumer
+    static const int DRAIN_INTERVAL_MS = 50;         ///< Interval between drain cycles
+
+protected:
+    void run() override;
+
+private:
+    struct Consumer {
+        int id = 0;
+        QString name;
+        quint32 typeMask = 0;
+        Handler handler;
+        QPointer<QObject> context;          ///< Delivery thread; null for the bus thread
+        bool hasContext = false;            ///< Distinguishes a destroyed context from none
+        int capacity = DEFAULT_CONSUMER_CAPACITY;
+        std::atomic<bool> active{true};     ///< Cleared by unsubscribe()
+
+        QMutex mutex;                       ///< Protects the members below
+        QVector<ActivityEvent> pending;     ///< Events waiting for the context thread
+        bool deliveryScheduled = false;     ///< A queued delivery is on its way
+        quint64 dropped = 0;                ///< Events lost to backpressure
+        quint64 reportedDropped = 0;        ///< Drop count already reported in the debug output
+    };
+
+    void drain();
+    void fanOut();
+    void enqueue(const std::shared_ptr<Consumer>& consumer, const QVector<ActivityEvent>& events);
+    static void deliver(const std::shared_ptr<Consumer>& consumer);
+
+    ActivityRingBuffer<ActivityEvent> m_ringBuffer; ///< Hook-to-bus event queue
+    QVector<ActivityEvent> m_drainBuffer;       ///< Bus-side scratch buffer for batch pops
+    QVector<ActivityEvent> m_batch;             ///< Events of the current drain cycle in tick order
+    QVector<ActivityEvent> m_filtered;          ///< Per-consumer scratch buffer
+
+    QMutex m_postMutex;                         ///< Protects m_posted
+    QVector<ActivityEvent> m_posted;            ///< Low-rate events waiting for the next cycle
+
+    mutable QMutex m_consumerMutex;             ///< Protects m_consumers and m_nextConsumerId
+    QHash<int, std::shared_ptr<Consumer>> m_consumers; ///< Registered consumers by ID
+    int m_nextConsumerId = 1;
+
+    QMutex m_wakeMutex;                         ///< Mutex paired with m_wakeCondition
+    QWaitCondition m_wakeCondition;             ///< Wakes the bus early on stop
+    std::atomic<bool> m_stopRequested{false};   ///< Set by stop()
+    quint64 m_reportedDropCount = 0;            ///< Ring drop count already reported in the debug output
+
+    static const int RING_CAPACITY = 16384;     ///< Ring buffer capacity in events
+    static const int DRAIN_BATCH_SIZE = 1024;   ///< Maximum events popped per batch
+};
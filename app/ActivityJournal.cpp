@@ -0,0 +1,719 @@
+#include "ActivityJournal.h"
+#include "Metrics.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QStringList>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char FILE_MAGIC[4] = {'T', 'T', 'A', 'J'};
+const char BLOCK_MAGIC[4] = {'T', 'B', 'L', 'K'};
+
+// Wire tags that share the record type byte but never surface as JournalRecordType
+const quint8 STRING_DEF_TAG = 0x40;          ///< id (varint), string; no timestamp delta
+const quint8 ACTIVE_APP_INTERNED_TAG = 0x41; ///< Timestamp delta, process id, title id
+const quint64 MAX_STRING_ID = 1 << 20;       ///< Sanity limit on string ids when reading
+
+template <typename T>
+void appendFixed(QByteArray& out, T value)
+{
+    char buffer[sizeof(T)];
+    qToLittleEndian(value, buffer);
+    out.append(buffer, sizeof(T));
+}
+
+template <typename T>
+T readFixed(const char *data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+void appendVarUInt(QByteArray& out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+void appendVarInt(QByteArray& out, qint64 value)
+{
+    // Zigzag encoding keeps small negative numbers small
+    appendVarUInt(out, (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63));
+}
+
+void appendString(QByteArray& out, const QString& value)
+{
+    QByteArray utf8 = value.toUtf8();
+    appendVarUInt(out, static_cast<quint64>(utf8.size()));
+    out.append(utf8);
+}
+
+/**
+ * Bounds-checked cursor over an encoded block payload
+ */
+class PayloadCursor
+{
+public:
+    PayloadCursor(const char *data, qsizetype size) : m_pos(data), m_end(data + size) {}
+
+    bool atEnd() const { return m_pos == m_end; }
+
+    bool readByte(quint8& value)
+    {
+        if (m_pos >= m_end) return false;
+        value = static_cast<quint8>(*m_pos++);
+        return true;
+    }
+
+    bool readVarUInt(quint64& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            quint8 byte;
+            if (!readByte(byte)) return false;
+            value |= static_cast<quint64>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    bool readVarInt(qint64& value)
+    {
+        quint64 raw;
+        if (!readVarUInt(raw)) return false;
+        value = static_cast<qint64>(raw >> 1) ^ -static_cast<qint64>(raw & 1);
+        return true;
+    }
+
+    bool readInt32(qint32& value)
+    {
+        qint64 wide;
+        if (!readVarInt(wide)) return false;
+        value = static_cast<qint32>(wide);
+        return true;
+    }
+
+    bool readString(QString& value)
+    {
+        quint64 length;
+        if (!readVarUInt(length) || length > static_cast<quint64>(m_end - m_pos)) return false;
+        value = QString::fromUtf8(m_pos, static_cast<qsizetype>(length));
+        m_pos += length;
+        return true;
+    }
+
+private:
+    const char *m_pos;
+    const char *m_end;
+};
+
+const char* inputTypeName(ActivityEventType type)
+{
+    switch (type) {
+        case ActivityEventType::KeyDown:        return "KEY_DOWN";
+        case ActivityEventType::KeyUp:          return "KEY_UP";
+        case ActivityEventType::SysKeyDown:     return "SYSKEY_DOWN";
+        case ActivityEventType::SysKeyUp:       return "SYSKEY_UP";
+        case ActivityEventType::KeyOther:       return "KEY_OTHER";
+        case ActivityEventType::MouseLeftDown:  return "MOUSE_LEFT_DOWN";
+        case ActivityEventType::MouseLeftUp:    return "MOUSE_LEFT_UP";
+        case ActivityEventType::MouseRightDown: return "MOUSE_RIGHT_DOWN";
+        case ActivityEventType::MouseRightUp:   return "MOUSE_RIGHT_UP";
+        case ActivityEventType::MouseMove:      return "MOUSE_MOVE";
+        case ActivityEventType::MouseWheel:     return "MOUSE_WHEEL";
+        case ActivityEventType::MouseOther:     return "MOUSE_OTHER";
+        case ActivityEventType::AppSwitch:      return "APP_SWITCH";
+        case ActivityEventType::ScreenshotCaptured: return "SCREENSHOT_CAPTURED";
+        case ActivityEventType::IdleStarted:    return "IDLE_STARTED";
+        case ActivityEventType::IdleEnded:      return "IDLE_ENDED";
+    }
+    return "UNKNOWN";
+}
+
+} // namespace
+
+// =============================================================================
+// Format helpers
+// =============================================================================
+
+quint32 ActivityJournal::crc32(const char *data, qsizetype size, quint32 crc)
+{
+    static quint32 table[256];
+    static bool tableReady = [] {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return true;
+    }();
+    Q_UNUSED(tableReady);
+
+    crc = ~crc;
+    for (qsizetype i = 0; i < size; ++i) {
+        crc = table[(crc ^ static_cast<quint8>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+QString ActivityJournal::eventTypeName(const ActivityJournalRecord& record)
+{
+    switch (record.type) {
+        case JournalRecordType::Input:         return QString::fromLatin1(inputTypeName(record.inputType));
+        case JournalRecordType::ActiveApp:     return QStringLiteral("ACTIVE_APP");
+        case JournalRecordType::System:        return QStringLiteral("SYSTEM");
+        case JournalRecordType::IdleAnnotated: return QStringLiteral("IDLE_ANNOTATED");
+        case JournalRecordType::Text:          return record.text;
+        case JournalRecordType::MouseMoveSummary: return QStringLiteral("MOUSE_MOVE_SUMMARY");
+    }
+    return QStringLiteral("UNKNOWN");
+}
+
+QString ActivityJournal::details(const ActivityJournalRecord& record)
+{
+    switch (record.type) {
+        case JournalRecordType::Input:
+            if (record.inputType <= ActivityEventType::KeyOther) {
+                return QString("VK Code: %1").arg(record.x);
+            }
+            return QString("X: %1, Y: %2").arg(record.x).arg(record.y);
+        case JournalRecordType::ActiveApp:
+            return QString("PROCESS: %1 - TITLE: %2").arg(record.text, record.detail);
+        case JournalRecordType::System:
+            return record.text;
+        case JournalRecordType::IdleAnnotated:
+            return QString("DURATION: %1s - REASON: %2 - NOTE: %3")
+                .arg(record.durationSeconds).arg(record.text, record.detail);
+        case JournalRecordType::Text:
+            return record.detail;
+        case JournalRecordType::MouseMoveSummary:
+            return QString("Count: %1, Path: %2, Span: %3ms, Box: (%4,%5)-(%6,%7), First: (%8,%9), Last: (%10,%11)")
+                .arg(record.moveCount).arg(record.pathLength).arg(record.spanMSecs)
+                .arg(record.minX).arg(record.minY).arg(record.maxX).arg(record.maxY)
+                .arg(record.x).arg(record.y).arg(record.lastX).arg(record.lastY);
+    }
+    return QString();
+}
+
+QString ActivityJournal::formattedTimestamp(const ActivityJournalRecord& record)
+{
+    QDateTime time = QDateTime::fromMSecsSinceEpoch(record.timestampMSecs);
+    if (record.type == JournalRecordType::ActiveApp) {
+        return time.toString("yyyy-MM-dd hh:mm:ss.zzz");
+    }
+    return time.toString("yyyy-MM-dd hh:mm:ss");
+}
+
+QString ActivityJournal::toTextLine(const ActivityJournalRecord& record)
+{
+    return formattedTimestamp(record) + " - " + eventTypeName(record) + " - " + details(record);
+}
+
+bool ActivityJournal::parseTextLine(const QString& line, ActivityJournalRecord& record)
+{
+    QStringList parts = line.trimmed().split(" - ");
+    if (parts.size() < 3) {
+        return false;
+    }
+
+    QDateTime time = QDateTime::fromString(parts[0], "yyyy-MM-dd hh:mm:ss.zzz");
+    if (!time.isValid()) {
+        time = QDateTime::fromString(parts[0], "yyyy-MM-dd hh:mm:ss");
+    }
+    if (!time.isValid()) {
+        return false;
+    }
+
+    record = ActivityJournalRecord();
+    record.type = JournalRecordType::Text;
+    record.timestampMSecs = time.toMSecsSinceEpoch();
+    record.text = parts[1];
+    record.detail = parts.mid(2).join(" - ");
+    return true;
+}
+
+QString ActivityJournal::segmentFilePath(const QString& basePath, quint32 sequence)
+{
+    QFileInfo base(basePath);
+    QString name = QString("%1.%2.%3")
+        .arg(base.completeBaseName())
+        .arg(sequence, 6, 10, QChar('0'))
+        .arg(base.suffix());
+    return base.path() == "." ? name : QDir(base.path()).filePath(name);
+}
+
+QList<quint32> ActivityJournal::segmentSequences(const QString& basePath)
+{
+    QFileInfo base(basePath);
+    const QString stem = base.completeBaseName();
+    const QString suffix = base.suffix();
+
+    QList<quint32> sequences;
+    const QStringList names = QDir(base.path()).entryList(
+        QStringList() << QString("%1.*.%2").arg(stem, suffix), QDir::Files);
+    for (const QString& name : names) {
+        // "<stem>.<sequence>.<suffix>"
+        QString middle = name.mid(stem.size() + 1, name.size() - stem.size() - suffix.size() - 2);
+        bool ok = false;
+        quint32 sequence = middle.toUInt(&ok);
+        if (ok && !middle.isEmpty()) {
+            sequences.append(sequence);
+        }
+    }
+    std::sort(sequences.begin(), sequences.end());
+    return sequences;
+}
+
+// =============================================================================
+// ActivityJournalWriter
+// =============================================================================
+
+ActivityJournalWriter::ActivityJournalWriter(const QString& filePath)
+    : m_filePath(filePath)
+{
+}
+
+bool ActivityJournalWriter::setFilePath(const QString& filePath)
+{
+    if (m_recordCount > 0) {
+        return false;
+    }
+
+    if (filePath != m_filePath) {
+        m_stringIds.clear();
+        m_stringTableLoaded = false;
+    }
+    m_filePath = filePath;
+    return true;
+}
+
+void ActivityJournalWriter::append(const ActivityJournalRecord& record)
+{
+    if (m_recordCount == 0) {
+        m_baseTimestamp = record.timestampMSecs;
+        m_lastTimestamp = record.timestampMSecs;
+    }
+    encodeRecord(record);
+    ++m_recordCount;
+    ++m_entryCount;
+}
+
+quint32 ActivityJournalWriter::internString(const QString& value)
+{
+    if (!m_stringTableLoaded) {
+        loadStringTable();
+    }
+
+    auto it = m_stringIds.constFind(value);
+    if (it != m_stringIds.constEnd()) {
+        return it.value();
+    }
+
+    // The definition goes into the same block as its first use
+    const quint32 id = static_cast<quint32>(m_stringIds.size()) + 1;
+    m_stringIds.insert(value, id);
+    m_payload.append(static_cast<char>(STRING_DEF_TAG));
+    appendVarUInt(m_payload, id);
+    appendString(m_payload, value);
+    ++m_entryCount;
+    return id;
+}
+
+void ActivityJournalWriter::loadStringTable()
+{
+    m_stringTableLoaded = true;
+    m_dataEnd = 0;
+    if (m_filePath.isEmpty() || !QFile::exists(m_filePath)) {
+        return;
+    }
+
+    ActivityJournalReader reader(m_filePath);
+    if (!reader.open()) {
+        // A header cut short is dropped; any other file is left as it is
+        const qint64 size = QFileInfo(m_filePath).size();
+        m_dataEnd = size < ActivityJournal::FILE_HEADER_SIZE ? 0 : size;
+        return;
+    }
+    reader.readAll();
+    m_dataEnd = reader.position();
+
+    const QVector<QString>& strings = reader.strings();
+    for (int i = 0; i < strings.size(); ++i) {
+        m_stringIds.insert(strings[i], static_cast<quint32>(i) + 1);
+    }
+}
+
+void ActivityJournalWriter::encodeRecord(const ActivityJournalRecord& record)
+{
+    if (record.type == JournalRecordType::ActiveApp) {
+        const quint32 textId = internString(record.text);
+        const quint32 detailId = internString(record.detail);
+        m_payload.append(static_cast<char>(ACTIVE_APP_INTERNED_TAG));
+        appendVarInt(m_payload, record.timestampMSecs - m_lastTimestamp);
+        m_lastTimestamp = record.timestampMSecs;
+        appendVarUInt(m_payload, textId);
+        appendVarUInt(m_payload, detailId);
+        return;
+    }
+
+    m_payload.append(static_cast<char>(record.type));
+    appendVarInt(m_payload, record.timestampMSecs - m_lastTimestamp);
+    m_lastTimestamp = record.timestampMSecs;
+
+    switch (record.type) {
+        case JournalRecordType::Input:
+            appendVarUInt(m_payload, static_cast<quint64>(record.inputType));
+            appendVarInt(m_payload, record.x);
+            appendVarInt(m_payload, record.y);
+            break;
+        case JournalRecordType::ActiveApp:
+        case JournalRecordType::Text:
+            appendString(m_payload, record.text);
+            appendString(m_payload, record.detail);
+            break;
+        case JournalRecordType::System:
+            appendString(m_payload, record.text);
+            break;
+        case JournalRecordType::IdleAnnotated:
+            appendVarInt(m_payload, record.durationSeconds);
+            appendString(m_payload, record.text);
+            appendString(m_payload, record.detail);
+            break;
+        case JournalRecordType::MouseMoveSummary:
+            // Points after the first are stored relative to it to keep the varints short
+            appendVarUInt(m_payload, static_cast<quint64>(record.moveCount));
+            appendVarUInt(m_payload, static_cast<quint64>(record.pathLength));
+            appendVarUInt(m_payload, static_cast<quint64>(record.spanMSecs));
+            appendVarInt(m_payload, record.x);
+            appendVarInt(m_payload, record.y);
+            appendVarInt(m_payload, static_cast<qint64>(record.lastX) - record.x);
+            appendVarInt(m_payload, static_cast<qint64>(record.lastY) - record.y);
+            appendVarInt(m_payload, static_cast<qint64>(record.minX) - record.x);
+            appendVarInt(m_payload, static_cast<qint64>(record.minY) - record.y);
+            appendVarInt(m_payload, static_cast<qint64>(record.maxX) - record.x);
+            appendVarInt(m_payload, static_cast<qint64>(record.maxY) - record.y);
+            break;
+    }
+}
+
+QByteArray ActivityJournalWriter::encodeFileHeader(qint64 createdMSecs)
+{
+    QByteArray header(FILE_MAGIC, sizeof(FILE_MAGIC));
+    appendFixed<quint16>(header, ActivityJournal::FORMAT_VERSION);
+    appendFixed<quint16>(header, 0);
+    appendFixed<qint64>(header, createdMSecs);
+    return header;
+}
+
+QByteArray ActivityJournalWriter::encodeBlock(const QVector<ActivityJournalRecord>& records)
+{
+    ActivityJournalWriter encoder(QString{});
+    for (const ActivityJournalRecord& record : records) {
+        encoder.append(record);
+    }
+    return encoder.currentBlock();
+}
+
+QByteArray ActivityJournalWriter::currentBlock() const
+{
+    QByteArray block(BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+    appendFixed<quint32>(block, static_cast<quint32>(m_entryCount));
+    appendFixed<quint32>(block, static_cast<quint32>(m_payload.size()));
+    appendFixed<qint64>(block, m_baseTimestamp);
+    appendFixed<quint32>(block, ActivityJournal::crc32(m_payload.constData(), m_payload.size()));
+    block.append(m_payload);
+    return block;
+}
+
+bool ActivityJournalWriter::flush()
+{
+    if (m_recordCount == 0) {
+        return true;
+    }
+
+    if (!m_stringTableLoaded) {
+        loadStringTable();
+    }
+
+    // A torn block left by a crash or a failed write would hide every block appended after it
+    if (QFileInfo(m_filePath).size() > m_dataEnd && !QFile::resize(m_filePath, m_dataEnd)) {
+        qWarning() << "ActivityJournalWriter failed to cut torn tail of journal:" << m_filePath;
+        return false;
+    }
+
+    // The block stays buffered if the write fails so the next flush retries it
+    QByteArray block = currentBlock();
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "ActivityJournalWriter failed to open journal:" << m_filePath << file.errorString();
+        return false;
+    }
+
+    if (m_dataEnd == 0) {
+        block.prepend(encodeFileHeader(QDateTime::currentMSecsSinceEpoch()));
+    }
+
+    if (file.write(block) != block.size() || !file.flush()) {
+        qWarning() << "ActivityJournalWriter failed to write block:" << file.errorString();
+        // Cut the partial block, and a header written with it, so the retry starts on a block boundary
+        file.close();
+        file.resize(m_dataEnd);
+        return false;
+    }
+    file.close();
+
+    m_dataEnd += block.size();
+    m_bytesWritten += block.size();
+    TT_METRIC_ADD(JournalBytesWritten, static_cast<quint64>(block.size()));
+    m_payload.clear();
+    m_recordCount = 0;
+    m_entryCount = 0;
+    return true;
+}
+
+// =============================================================================
+// ActivityJournalReader
+// =============================================================================
+
+ActivityJournalReader::ActivityJournalReader(const QString& filePath)
+    : m_filePath(filePath)
+    , m_file(filePath)
+{
+}
+
+void ActivityJournalReader::setFilePath(const QString& filePath)
+{
+    m_file.close();
+    m_filePath = filePath;
+    m_file.setFileName(filePath);
+    m_position = 0;
+    m_scannedPosition = 0;
+    m_strings.clear();
+}
+
+bool ActivityJournalReader::open()
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QByteArray header = m_file.read(ActivityJournal::FILE_HEADER_SIZE);
+    if (header.size() < ActivityJournal::FILE_HEADER_SIZE
+        || memcmp(header.constData(), FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+        qWarning() << "Not an activity journal:" << m_filePath;
+        m_file.close();
+        return false;
+    }
+
+    quint16 version = readFixed<quint16>(header.constData() + 4);
+    if (version > ActivityJournal::FORMAT_VERSION) {
+        qWarning() << "Unsupported activity journal version" << version << "in" << m_filePath;
+        m_file.close();
+        return false;
+    }
+
+    m_position = ActivityJournal::FILE_HEADER_SIZE;
+    m_scannedPosition = qMax(m_scannedPosition, m_position);
+    return true;
+}
+
+void ActivityJournalReader::close()
+{
+    m_file.close();
+}
+
+bool ActivityJournalReader::seek(qint64 position)
+{
+    if (!m_file.isOpen() || position < ActivityJournal::FILE_HEADER_SIZE || position > m_file.size()) {
+        return false;
+    }
+
+    scanStrings(position);
+    m_position = position;
+    return true;
+}
+
+void ActivityJournalReader::scanStrings(qint64 position)
+{
+    // Ids used after the seek target may be defined in any block before it
+    QVector<ActivityJournalRecord> skipped;
+    m_position = m_scannedPosition;
+    while (m_position < position && readNextBlock(skipped)) {
+        skipped.clear();
+    }
+}
+
+bool ActivityJournalReader::readNextBlock(QVector<ActivityJournalRecord>& records)
+{
+    while (m_file.isOpen()) {
+        m_file.seek(m_position);
+        QByteArray header = m_file.read(ActivityJournal::BLOCK_HEADER_SIZE);
+        if (header.size() < ActivityJournal::BLOCK_HEADER_SIZE) {
+            return false; // End of data or partially written header
+        }
+
+        const char *h = header.constData();
+        if (memcmp(h, BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) != 0) {
+            qWarning() << "Activity journal block magic mismatch at offset" << m_position << "- stopping";
+            ++m_corruptBlocks;
+            return false;
+        }
+
+        quint32 recordCount = readFixed<quint32>(h + 4);
+        quint32 payloadSize = readFixed<quint32>(h + 8);
+        qint64 baseTimestamp = readFixed<qint64>(h + 12);
+        quint32 expectedCrc = readFixed<quint32>(h + 20);
+
+        if (payloadSize > ActivityJournal::MAX_BLOCK_PAYLOAD_SIZE) {
+            qWarning() << "Activity journal block too large at offset" << m_position << "- stopping";
+            ++m_corruptBlocks;
+            return false;
+        }
+
+        QByteArray payload = m_file.read(payloadSize);
+        if (payload.size() < static_cast<qsizetype>(payloadSize)) {
+            return false; // Block still being written
+        }
+
+        m_position += ActivityJournal::BLOCK_HEADER_SIZE + payloadSize;
+        m_scannedPosition = qMax(m_scannedPosition, m_position);
+
+        if (ActivityJournal::crc32(payload.constData(), payload.size()) != expectedCrc) {
+            qWarning() << "Activity journal block checksum mismatch - skipping" << recordCount << "records";
+            ++m_corruptBlocks;
+            continue;
+        }
+
+        QVector<ActivityJournalRecord> decoded;
+        decoded.reserve(static_cast<int>(recordCount));
+        if (!decodePayload(payload, recordCount, baseTimestamp, decoded, m_strings)) {
+            qWarning() << "Activity journal block failed to decode - skipping";
+            ++m_corruptBlocks;
+            continue;
+        }
+
+        records += decoded;
+        return true;
+    }
+    return false;
+}
+
+QVector<ActivityJournalRecord> ActivityJournalReader::readAll()
+{
+    QVector<ActivityJournalRecord> records;
+    while (readNextBlock(records)) {
+    }
+    return records;
+}
+
+bool ActivityJournalReader::decodePayload(const QByteArray& payload, quint32 recordCount, qint64 baseTimestamp,
+                                          QVector<ActivityJournalRecord>& records, QVector<QString>& strings)
+{
+    PayloadCursor cursor(payload.constData(), payload.size());
+    qint64 timestamp = baseTimestamp;
+
+    for (quint32 i = 0; i < recordCount; ++i) {
+        ActivityJournalRecord record;
+        quint8 type;
+        if (!cursor.readByte(type)) {
+            return false;
+        }
+
+        if (type == STRING_DEF_TAG) {
+            quint64 id;
+            QString value;
+            if (!cursor.readVarUInt(id) || id == 0 || id > MAX_STRING_ID
+                || !cursor.readString(value)) {
+                return false;
+            }
+            if (strings.size() < static_cast<qsizetype>(id)) {
+                strings.resize(static_cast<qsizetype>(id));
+            }
+            strings[static_cast<qsizetype>(id - 1)] = value;
+            continue;
+        }
+
+        qint64 delta;
+        if (!cursor.readVarInt(delta)) {
+            return false;
+        }
+        timestamp += delta;
+        record.type = static_cast<JournalRecordType>(type);
+        record.timestampMSecs = timestamp;
+
+        if (type == ACTIVE_APP_INTERNED_TAG) {
+            // An id whose definition was in a skipped block resolves to an empty string
+            quint64 textId, detailId;
+            if (!cursor.readVarUInt(textId) || !cursor.readVarUInt(detailId)) {
+                return false;
+            }
+            record.type = JournalRecordType::ActiveApp;
+            record.textId = static_cast<quint32>(textId);
+            record.detailId = static_cast<quint32>(detailId);
+            record.text = strings.value(static_cast<qsizetype>(textId) - 1);
+            record.detail = strings.value(static_cast<qsizetype>(detailId) - 1);
+            records.append(record);
+            continue;
+        }
+
+        bool ok = false;
+        switch (record.type) {
+            case JournalRecordType::Input: {
+                quint64 inputType;
+                ok = cursor.readVarUInt(inputType) && cursor.readInt32(record.x) && cursor.readInt32(record.y);
+                record.inputType = static_cast<ActivityEventType>(inputType);
+                break;
+            }
+            case JournalRecordType::ActiveApp:
+            case JournalRecordType::Text:
+                ok = cursor.readString(record.text) && cursor.readString(record.detail);
+                break;
+            case JournalRecordType::System:
+                ok = cursor.readString(record.text);
+                break;
+            case JournalRecordType::IdleAnnotated:
+                ok = cursor.readInt32(record.durationSeconds)
+                     && cursor.readString(record.text) && cursor.readString(record.detail);
+                break;
+            case JournalRecordType::MouseMoveSummary: {
+                quint64 moveCount, pathLength, spanMSecs;
+                qint32 lastDx, lastDy, minDx, minDy, maxDx, maxDy;
+                ok = cursor.readVarUInt(moveCount) && cursor.readVarUInt(pathLength)
+                     && cursor.readVarUInt(spanMSecs)
+                     && cursor.readInt32(record.x) && cursor.readInt32(record.y)
+                     && cursor.readInt32(lastDx) && cursor.readInt32(lastDy)
+                     && cursor.readInt32(minDx) && cursor.readInt32(minDy)
+                     && cursor.readInt32(maxDx) && cursor.readInt32(maxDy);
+                if (ok) {
+                    record.moveCount = static_cast<qint32>(moveCount);
+                    record.pathLength = static_cast<qint32>(pathLength);
+                    record.spanMSecs = static_cast<qint32>(spanMSecs);
+                    record.lastX = record.x + lastDx;
+                    record.lastY = record.y + lastDy;
+                    record.minX = record.x + minDx;
+                    record.minY = record.y + minDy;
+                    record.maxX = record.x + maxDx;
+                    record.maxY = record.y + maxDy;
+                }
+                break;
+            }
+        }
+
+        if (!ok) {
+            return false;
+        }
+        records.append(record);
+    }
+
+    return cursor.atEnd();
+}
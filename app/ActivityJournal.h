@@ -0,0 +1,326 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+#include <QFile>
+#include "ActivityEvent.h"
+
+/**
+ * @file ActivityJournal.h
+ * @brief Compact, versioned, append-only binary format for activity data
+ *
+ * Layout:
+ * - File header (16 bytes): magic "TTAJ", format version (u16), flags (u16),
+ *   creation time in UTC milliseconds since epoch (i64).
+ * - A sequence of blocks. Each block has a 24-byte header: magic "TBLK",
+ *   record count (u32), payload size (u32), base timestamp (i64) and a
+ *   CRC-32 of the payload (u32), followed by the payload.
+ * - Each record in a payload is: record type (u8), timestamp delta in
+ *   milliseconds from the previous record (zigzag varint), then a
+ *   type-specific payload of varints and length-prefixed UTF-8 strings.
+ *
+ * Process names and window titles of application changes are interned per
+ * segment file: the first record that uses a string is preceded by a
+ * string definition (id varint, UTF-8 string) and the record itself only
+ * stores the ids. Definitions are consumed by the reader and never
+ * returned as records. Records written before interning keep their
+ * inline strings and are still read.
+ *
+ * A journal is stored as numbered segment files derived from a base path,
+ * e.g. "activity_journal.000001.ttj", each with its own file header. Only
+ * the highest-numbered segment is ever appended to.
+ *
+ * All fixed-width integers are little-endian. A block whose header claims
+ * more bytes than are present is treated as a partially written tail and
+ * ends the read; a block with a bad checksum is skipped.
+ */
+
+/**
+ * @brief Kind of record stored in the activity journal
+ */
+enum class JournalRecordType : quint8 {
+    Input = 1,          ///< Raw keyboard/mouse event: inputType, x, y
+    ActiveApp = 2,      ///< Foreground application change: text = process, detail = title
+    System = 3,         ///< System message: text = message
+    IdleAnnotated = 4,  ///< Idle annotation: durationSeconds, text = reason, detail = note
+    Text = 5,           ///< Free-form entry: text = event type, detail = details (legacy import)
+    MouseMoveSummary = 6 ///< Coalesced mouse moves: x/y = first point plus the summary fields
+};
+
+/**
+ * @brief Decoded journal record
+ *
+ * Only the fields relevant to the record type are meaningful; the others
+ * keep their default values.
+ */
+struct ActivityJournalRecord {
+    JournalRecordType type = JournalRecordType::System;
+    qint64 timestampMSecs = 0;                             ///< UTC milliseconds since epoch
+    ActivityEventType inputType = ActivityEventType::KeyOther; ///< Input: event kind
+    qint32 x = 0;                                          ///< Input: vkCode or X coordinate
+    qint32 y = 0;                                          ///< Input: Y coordinate
+    qint32 durationSeconds = 0;                            ///< IdleAnnotated: idle duration
+    qint32 moveCount = 0;                                  ///< MouseMoveSummary: number of merged moves
+    qint32 pathLength = 0;                                 ///< MouseMoveSummary: travelled distance in pixels
+    qint32 spanMSecs = 0;                                  ///< MouseMoveSummary: time from first to last move
+    qint32 lastX = 0;                                      ///< MouseMoveSummary: last point
+    qint32 lastY = 0;
+    qint32 minX = 0;                                       ///< MouseMoveSummary: bounding box
+    qint32 minY = 0;
+    qint32 maxX = 0;
+    qint32 maxY = 0;
+    QString text;                                          ///< Primary string payload
+    QString detail;                                        ///< Secondary string payload
+    quint32 textId = 0;                                    ///< ActiveApp: string table id of text, 0 if inline
+    quint32 detailId = 0;                                  ///< ActiveApp: string table id of detail, 0 if inline
+};
+
+namespace ActivityJournal {
+
+const char DEFAULT_FILE_NAME[] = "activity_journal.ttj";
+const quint16 FORMAT_VERSION = 1;
+const int FILE_HEADER_SIZE = 16;
+const int BLOCK_HEADER_SIZE = 24;
+const quint32 MAX_BLOCK_PAYLOAD_SIZE = 16 * 1024 * 1024;  ///< Sanity limit when reading
+const qint64 DEFAULT_SEGMENT_SIZE = 4 * 1024 * 1024;      ///< Size at which a new segment is started
+
+/**
+ * @brief Compute the CRC-32 (ISO 3309 / zlib polynomial) of a byte range
+ * @param data Start of the data
+ * @param size Number of bytes
+ * @param crc Running CRC to continue from, 0 for a new checksum
+ * @return The updated CRC-32
+ */
+quint32 crc32(const char *data, qsizetype size, quint32 crc = 0);
+
+/**
+ * @brief Get the legacy text event type for a record, e.g. "MOUSE_MOVE" or "ACTIVE_APP"
+ */
+QString eventTypeName(const ActivityJournalRecord& record);
+
+/**
+ * @brief Get the legacy text details column for a record, e.g. "X: 10, Y: 20"
+ */
+QString details(const ActivityJournalRecord& record);
+
+/**
+ * @brief Format the record timestamp the way the legacy text log did
+ *
+ * Application changes carry milliseconds, everything else second precision.
+ * The result is local time without a zone, for the text log and display
+ * only; uploads use ISO-8601 UTC.
+ */
+QString formattedTimestamp(const ActivityJournalRecord& record);
+
+/**
+ * @brief Format a record as a legacy activity_log.txt line (without newline)
+ */
+QString toTextLine(const ActivityJournalRecord& record);
+
+/**
+ * @brief Parse a legacy activity_log.txt line into a Text record
+ * @param line Line such as "2025-06-15 11:05:07 - MOUSE_MOVE - X: 1099, Y: 949"
+ * @param record Receives the parsed record
+ * @return true if the line had a timestamp, event type and details
+ */
+bool parseTextLine(const QString& line, ActivityJournalRecord& record);
+
+/**
+ * @brief Build the path of a journal segment
+ * @param basePath Journal base path such as DEFAULT_FILE_NAME
+ * @param sequence Segment sequence number
+ * @return Path such as "activity_journal.000042.ttj" in the base path's directory
+ */
+QString segmentFilePath(const QString& basePath, quint32 sequence);
+
+/**
+ * @brief List the segments that exist for a journal base path
+ * @param basePath Journal base path such as DEFAULT_FILE_NAME
+ * @return Segment sequence numbers in ascending order
+ */
+QList<quint32> segmentSequences(const QString& basePath);
+
+} // namespace ActivityJournal
+
+/**
+ * @brief Appends records to an activity journal file block by block
+ *
+ * Records are encoded into an in-memory block by append() and written with
+ * a single open/write/close by flush(). The file header is written the
+ * first time data is flushed to an empty file.
+ *
+ * The string table of a file that already has data is read back before
+ * the first interned string is appended or the first block is flushed, so
+ * ids stay unique per file. The same pass finds the end of the last intact
+ * block; a torn tail after it is cut off before the next block is written.
+ */
+class ActivityJournalWriter
+{
+public:
+    /**
+     * @brief Construct a writer for the given journal file
+     * @param filePath Path of the journal file
+     */
+    explicit ActivityJournalWriter(const QString& filePath);
+
+    /**
+     * @brief Switch to another journal file, e.g. the next segment
+     * @param filePath Path of the file to append to from now on
+     * @return false if records are still waiting to be flushed to the current file
+     */
+    bool setFilePath(const QString& filePath);
+
+    /**
+     * @brief Encode a record into the current block
+     * @param record The record to append
+     */
+    void append(const ActivityJournalRecord& record);
+
+    /**
+     * @brief Write the current block to disk
+     * @return true on success or if there was nothing to write
+     */
+    bool flush();
+
+    /**
+     * @brief Get the number of records waiting in the current block
+     */
+    int pendingRecordCount() const { return m_recordCount; }
+
+    /**
+     * @brief Get the total number of bytes written to the file by this writer
+     */
+    qint64 bytesWritten() const { return m_bytesWritten; }
+
+    /**
+     * @brief Get the journal file path
+     */
+    QString filePath() const { return m_filePath; }
+
+    /**
+     * @brief Get the number of distinct strings interned in the current file
+     */
+    int stringCount() const { return m_stringIds.size(); }
+
+    /**
+     * @brief Encode a complete block (header and payload) for a list of records
+     * @param records Records to encode, in timestamp order
+     * @return The encoded block
+     */
+    static QByteArray encodeBlock(const QVector<ActivityJournalRecord>& records);
+
+    /**
+     * @brief Encode the file header
+     * @param createdMSecs Creation time in UTC milliseconds since epoch
+     */
+    static QByteArray encodeFileHeader(qint64 createdMSecs);
+
+private:
+    void encodeRecord(const ActivityJournalRecord& record);
+    quint32 internString(const QString& value);
+    void loadStringTable();
+    QByteArray currentBlock() const;
+
+    QString m_filePath;
+    QByteArray m_payload;        ///< Encoded records of the current block
+    int m_recordCount = 0;       ///< Records in the current block
+    int m_entryCount = 0;        ///< Records plus string definitions in the current block
+    QHash<QString, quint32> m_stringIds; ///< String table of the current file
+    bool m_stringTableLoaded = false;    ///< Whether m_stringIds and m_dataEnd reflect the file's existing data
+    qint64 m_dataEnd = 0;        ///< Offset just past the file's last intact block
+    qint64 m_baseTimestamp = 0;  ///< Timestamp of the first record in the block
+    qint64 m_lastTimestamp = 0;  ///< Timestamp of the previous record (delta base)
+    qint64 m_bytesWritten = 0;
+};
+
+/**
+ * @brief Reads an activity journal file block by block
+ */
+class ActivityJournalReader
+{
+public:
+    /**
+     * @brief Construct a reader for the given journal file
+     * @param filePath Path of the journal file
+     */
+    explicit ActivityJournalReader(const QString& filePath);
+
+    /**
+     * @brief Close the current file and read another one; call open() next
+     * @param filePath Path of the journal file
+     */
+    void setFilePath(const QString& filePath);
+
+    /**
+     * @brief Open the file and validate its header
+     * @return true if the file exists and has a supported header
+     */
+    bool open();
+
+    /**
+     * @brief Close the file
+     */
+    void close();
+
+    /**
+     * @brief Continue reading from a block boundary returned by position()
+     *
+     * Seeking forward reads the string definitions of the skipped blocks.
+     * @param position Offset of a block header, or of the end of the file
+     * @return true if the file is open and the offset lies within it
+     */
+    bool seek(qint64 position);
+
+    /**
+     * @brief Decode the next intact block
+     * @param records Receives the decoded records (appended)
+     * @return true if a block was read, false at end of data
+     */
+    bool readNextBlock(QVector<ActivityJournalRecord>& records);
+
+    /**
+     * @brief Decode all remaining blocks
+     * @return The decoded records
+     */
+    QVector<ActivityJournalRecord> readAll();
+
+    /**
+     * @brief Get the byte offset just past the last block returned
+     */
+    qint64 position() const { return m_position; }
+
+    /**
+     * @brief Get the number of blocks skipped because of checksum or decode errors
+     */
+    int corruptBlockCount() const { return m_corruptBlocks; }
+
+    /**
+     * @brief Get the string table read so far; the string with id n is at index n - 1
+     */
+    const QVector<QString>& strings() const { return m_strings; }
+
+    /**
+     * @brief Decode an encoded block payload
+     * @param payload Payload bytes (without block header)
+     * @param recordCount Number of records and string definitions the block header announced
+     * @param baseTimestamp Block base timestamp
+     * @param records Receives the decoded records (appended)
+     * @param strings String table to resolve ids against; definitions in the block are added to it
+     * @return true if the payload decoded cleanly
+     */
+    static bool decodePayload(const QByteArray& payload, quint32 recordCount, qint64 baseTimestamp,
+                              QVector<ActivityJournalRecord>& records, QVector<QString>& strings);
+
+private:
+    void scanStrings(qint64 position);
+
+    QString m_filePath;
+    QFile m_file;
+    qint64 m_position = 0;
+    qint64 m_scannedPosition = 0;   ///< Blocks before this offset have been added to m_strings
+    int m_corruptBlocks = 0;
+    QVector<QString> m_strings;     ///< String table of the file
+};
@@ -0,0 +1,238 @@
+#include "ActivityLogWriter.h"
+#include "ActivityUploader.h"
+#include "Metrics.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QTextStream>
+
+ActivityLogWriter::ActivityLogWriter(const QString& journalFilePath, QObject *parent)
+    : QThread(parent)
+    , m_journalFilePath(journalFilePath)
+    , m_journal(journalFilePath)
+    , m_ringBuffer(RING_CAPACITY)
+    , m_drainBuffer(DRAIN_BATCH_SIZE)
+{
+    qDebug() << "ActivityLogWriter created for" << m_journalFilePath
+             << "with ring capacity" << m_ringBuffer.capacity();
+}
+
+ActivityLogWriter::~ActivityLogWriter()
+{
+    stop();
+    qDebug() << "ActivityLogWriter destroyed - written:" << writtenEventCount()
+             << "dropped:" << droppedEventCount();
+}
+
+void ActivityLogWriter::logActiveApplication(const QString& processName, const QString& windowTitle,
+                                             qint64 timestampMSecs)
+{
+    ActivityJournalRecord record;
+    record.type = JournalRecordType::ActiveApp;
+    record.timestampMSecs = timestampMSecs;
+    record.text = processName;
+    record.detail = windowTitle;
+    queueRecord(record);
+}
+
+void ActivityLogWriter::logSystemMessage(const QString& message)
+{
+    ActivityJournalRecord record;
+    record.type = JournalRecordType::System;
+    record.text = message;
+    queueRecord(record);
+}
+
+void ActivityLogWriter::logIdleAnnotation(int durationSeconds, const QString& reason, const QString& note)
+{
+    ActivityJournalRecord record;
+    record.type = JournalRecordType::IdleAnnotated;
+    record.durationSeconds = durationSeconds;
+    record.text = reason;
+    record.detail = note;
+    queueRecord(record);
+}
+
+void ActivityLogWriter::queueRecord(const ActivityJournalRecord& record)
+{
+    ActivityJournalRecord stamped = record;
+    if (stamped.timestampMSecs == 0) {
+        stamped.timestampMSecs = ActivityClock::msecsSinceEpoch();
+    }
+
+    QMutexLocker locker(&m_messageMutex);
+    m_pendingMessages.append(stamped);
+}
+
+void ActivityLogWriter::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    m_stopRequested.store(true);
+    {
+        QMutexLocker locker(&m_wakeMutex);
+        m_wakeCondition.wakeAll();
+    }
+    wait();
+}
+
+void ActivityLogWriter::run()
+{
+    openSegment();
+    importLegacyLog();
+
+    while (!m_stopRequested.load()) {
+        drain();
+
+        QMutexLocker locker(&m_wakeMutex);
+        if (!m_stopRequested.load()) {
+            m_wakeCondition.wait(&m_wakeMutex, FLUSH_INTERVAL_MS);
+        }
+    }
+
+    // Final drain so nothing queued before stop() is lost
+    drain();
+}
+
+void ActivityLogWriter::drain()
+{
+    m_coalescer.setIntervalMSecs(m_coalescingIntervalMSecs.load());
+
+    QVector<ActivityJournalRecord> messages;
+    {
+        QMutexLocker locker(&m_messageMutex);
+        messages.swap(m_pendingMessages);
+    }
+
+    int messageIndex = 0;
+    quint64 appended = 0;
+
+    // Pop raw events in batches and interleave low-rate records by timestamp
+    std::size_t count;
+    do {
+        count = m_ringBuffer.popBatch(m_drainBuffer.data(), m_drainBuffer.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            const ActivityEvent& event = m_drainBuffer[static_cast<int>(i)];
+
+            ActivityJournalRecord record;
+            record.type = JournalRecordType::Input;
+            record.timestampMSecs = ActivityClock::toMSecsSinceEpoch(event.ticks);
+            record.inputType = event.type;
+            record.x = event.x;
+            record.y = event.y;
+
+            while (messageIndex < messages.size()
+                   && messages[messageIndex].timestampMSecs <= record.timestampMSecs) {
+                appendCoalesced(messages[messageIndex++], appended);
+            }
+            appendCoalesced(record, appended);
+        }
+    } while (count == static_cast<std::size_t>(m_drainBuffer.size()));
+
+    while (messageIndex < messages.size()) {
+        appendCoalesced(messages[messageIndex++], appended);
+    }
+
+    // Close a quiet interval so a summary is not held back indefinitely; keep nothing back on shutdown
+    m_coalescedBuffer.clear();
+    if (m_stopRequested.load()) {
+        m_coalescer.flush(m_coalescedBuffer);
+    } else {
+        m_coalescer.flushExpired(ActivityClock::msecsSinceEpoch(), m_coalescedBuffer);
+    }
+    for (const ActivityJournalRecord& coalesced : m_coalescedBuffer) {
+        m_journal.append(coalesced);
+        ++appended;
+    }
+
+    quint64 dropped = m_ringBuffer.droppedCount();
+    if (dropped != m_reportedDropCount) {
+        qWarning() << "ActivityLogWriter ring buffer overflow -" << (dropped - m_reportedDropCount)
+                   << "events dropped (total:" << dropped << ")";
+        TT_METRIC_ADD(RingBufferDrops, dropped - m_reportedDropCount);
+        m_reportedDropCount = dropped;
+    }
+
+    // One block per drain cycle; a failed write stays buffered for the next cycle
+    if (appended > 0 && m_journal.flush()) {
+        m_writtenCount.fetch_add(appended, std::memory_order_relaxed);
+        rotateSegmentIfFull();
+    }
+}
+
+void ActivityLogWriter::openSegment()
+{
+    // Continue the newest segment unless it is already full
+    const QList<quint32> sequences = ActivityJournal::segmentSequences(m_journalFilePath);
+    m_segmentSequence = sequences.isEmpty() ? 1 : sequences.last();
+    if (QFileInfo(ActivityJournal::segmentFilePath(m_journalFilePath, m_segmentSequence)).size() >= m_segmentSize) {
+        ++m_segmentSequence;
+    }
+
+    m_journal.setFilePath(ActivityJournal::segmentFilePath(m_journalFilePath, m_segmentSequence));
+    qDebug() << "Activity journal segment:" << m_journal.filePath();
+}
+
+void ActivityLogWriter::rotateSegmentIfFull()
+{
+    if (QFileInfo(m_journal.filePath()).size() < m_segmentSize) {
+        return;
+    }
+
+    // The new file is created with its header by the next flush
+    ++m_segmentSequence;
+    m_journal.setFilePath(ActivityJournal::segmentFilePath(m_journalFilePath, m_segmentSequence));
+    qDebug() << "Activity journal rotated to segment" << m_journal.filePath();
+}
+
+void ActivityLogWriter::appendCoalesced(const ActivityJournalRecord& record, quint64& appended)
+{
+    m_coalescedBuffer.clear();
+    m_coalescer.process(record, m_coalescedBuffer);
+    for (const ActivityJournalRecord& coalesced : m_coalescedBuffer) {
+        m_journal.append(coalesced);
+        ++appended;
+    }
+}
+
+void ActivityLogWriter::importLegacyLog()
+{
+    if (m_legacyLogFilePath.isEmpty() || !QFile::exists(m_legacyLogFilePath)) {
+        return;
+    }
+
+    QFile legacyFile(m_legacyLogFilePath);
+    if (!legacyFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Failed to open legacy activity log:" << m_legacyLogFilePath;
+        return;
+    }
+
+    // A block never exceeds an upload chunk, and segments rotate mid-import as they fill
+    int imported = 0;
+    bool written = true;
+    QTextStream in(&legacyFile);
+    while (written && !in.atEnd()) {
+        ActivityJournalRecord record;
+        if (!ActivityJournal::parseTextLine(in.readLine(), record)) {
+            continue;
+        }
+        m_journal.append(record);
+        if (++imported % ActivityUploader::DEFAULT_MAX_CHUNK_RECORDS == 0) {
+            written = m_journal.flush();
+            if (written) {
+                rotateSegmentIfFull();
+            }
+        }
+    }
+    legacyFile.close();
+
+    // A failed block stays buffered for the next drain; the legacy file is kept until everything is in
+    if (written && m_journal.flush()) {
+        rotateSegmentIfFull();
+        QFile::remove(m_legacyLogFilePath);
+        qDebug() << "Imported" << imported << "legacy activity log entries into" << m_journalFilePath;
+    }
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include "ActivityClock.h"
+#include "ActivityCoalescer.h"
+#include "ActivityEvent.h"
+#include "ActivityJournal.h"
+#include "ActivityRingBuffer.h"
+
+/**
+ * @brief The ActivityLogWriter class moves activity log I/O off the hook thread
+ *
+ * Fixed-size ActivityEvent records, stamped with ActivityClock ticks, are
+ * pushed into a preallocated lock-free ring buffer by a single producer
+ * thread (the ActivityEventBus). A background thread drains the buffer in batches
+ * and appends each batch to the binary activity journal as one block.
+ * The journal is split into segment files; once the active segment
+ * reaches segmentSize() the next block starts a new one.
+ * Mouse moves pass through an ActivityCoalescer on the way and are stored
+ * as per-interval summaries. Low-rate events (application switches, system messages, idle
+ * annotations) are queued through the log*() methods.
+ */
+class ActivityLogWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Construct a new ActivityLogWriter object
+     * @param journalFilePath Base path of the activity journal; segments are named after it
+     * @param parent The parent QObject
+     */
+    explicit ActivityLogWriter(const QString& journalFilePath, QObject *parent = nullptr);
+
+    /**
+     * @brief Destroy the ActivityLogWriter object, flushing pending events
+     */
+    ~ActivityLogWriter();
+
+    /**
+     * @brief Queue a raw input event (single producer thread only, wait-free)
+     * @param event The event to queue
+     * @return true if queued, false if the ring buffer was full and the event was dropped
+     */
+    bool pushEvent(const ActivityEvent& event) { return m_ringBuffer.tryPush(event); }
+
+    /**
+     * @brief Queue a foreground application change
+     * @param processName Executable name of the foreground process
+     * @param windowTitle Title of the foreground window
+     * @param timestampMSecs When the change happened, UTC milliseconds since epoch; 0 for now
+     */
+    void logActiveApplication(const QString& processName, const QString& windowTitle, qint64 timestampMSecs = 0);
+
+    /**
+     * @brief Queue a system message such as "Activity tracking started"
+     * @param message The message text
+     */
+    void logSystemMessage(const QString& message);
+
+    /**
+     * @brief Queue an idle period annotation
+     * @param durationSeconds Duration of the idle period
+     * @param reason Selected idle reason
+     * @param note Optional user note
+     */
+    void logIdleAnnotation(int durationSeconds, const QString& reason, const QString& note);
+
+    /**
+     * @brief Convert a legacy text activity log into the journal on startup
+     *
+     * Must be called before start(). The legacy file is imported on the
+     * writer thread in blocks of one upload chunk's worth of records,
+     * rotating segments as they fill, and removed once its contents are in the journal.
+     * @param legacyFilePath Path of the legacy activity_log.txt file
+     */
+    void setLegacyLogFilePath(const QString& legacyFilePath) { m_legacyLogFilePath = legacyFilePath; }
+
+    /**
+     * @brief Set the mouse-move coalescing interval (thread-safe)
+     *
+     * Takes effect on the next drain cycle.
+     * @param intervalMSecs Length of a coalescing interval, 0 to log every move
+     */
+    void setMoveCoalescingIntervalMSecs(int intervalMSecs) { m_coalescingIntervalMSecs.store(intervalMSecs); }
+
+    /**
+     * @brief Set the size at which a new journal segment is started
+     *
+     * Must be called before start().
+     * @param bytes Segment size limit in bytes
+     */
+    void setSegmentSize(qint64 bytes) { m_segmentSize = qMax<qint64>(ActivityJournal::FILE_HEADER_SIZE + 1, bytes); }
+
+    /**
+     * @brief Get the size at which a new journal segment is started
+     */
+    qint64 segmentSize() const { return m_segmentSize; }
+
+    /**
+     * @brief Stop the writer thread after draining everything queued so far
+     */
+    void stop();
+
+    /**
+     * @brief Get the number of raw events dropped because the ring buffer was full
+     * @return The total drop count since construction
+     */
+    quint64 droppedEventCount() const { return m_ringBuffer.droppedCount(); }
+
+    /**
+     * @brief Get the number of records written to the journal
+     * @return The total number of written records since construction
+     */
+    quint64 writtenEventCount() const { return m_writtenCount.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the base path of the activity journal
+     */
+    QString journalFilePath() const { return m_journalFilePath; }
+
+protected:
+    void run() override;
+
+private:
+    void queueRecord(const ActivityJournalRecord& record);
+    void drain();
+    void appendCoalesced(const ActivityJournalRecord& record, quint64& appended);
+    void importLegacyLog();
+    void openSegment();
+    void rotateSegmentIfFull();
+
+    QString m_journalFilePath;                  ///< Activity journal base path
+    QString m_legacyLogFilePath;                ///< Legacy text log to import on startup
+    ActivityJournalWriter m_journal;            ///< Block encoder, used on the writer thread only
+    quint32 m_segmentSequence = 0;              ///< Sequence number of the segment being appended to
+    qint64 m_segmentSize = ActivityJournal::DEFAULT_SEGMENT_SIZE; ///< Segment rotation threshold
+    ActivityRingBuffer<ActivityEvent> m_ringBuffer; ///< Hook-to-writer event queue
+    QVector<ActivityEvent> m_drainBuffer;       ///< Writer-side scratch buffer for batch pops
+    ActivityCoalescer m_coalescer;              ///< Mouse-move coalescer, used on the writer thread only
+    QVector<ActivityJournalRecord> m_coalescedBuffer; ///< Writer-side scratch buffer for coalescer output
+    std::atomic<int> m_coalescingIntervalMSecs{ActivityCoalescer::DEFAULT_INTERVAL_MS}; ///< Requested interval
+
+    QMutex m_messageMutex;                      ///< Protects m_pendingMessages
+    QVector<ActivityJournalRecord> m_pendingMessages; ///< Low-rate records waiting to be written
+
+    QMutex m_wakeMutex;                         ///< Mutex paired with m_wakeCondition
+    QWaitCondition m_wakeCondition;             ///< Wakes the writer early on stop
+    std::atomic<bool> m_stopRequested{false};   ///< Set by stop()
+
+    std::atomic<quint64> m_writtenCount{0};     ///< Records written to the journal
+    quint64 m_reportedDropCount = 0;            ///< Drop count already reported in the debug output
+
+    static const int RING_CAPACITY = 16384;     ///< Ring buffer capacity in events
+    static const int DRAIN_BATCH_SIZE = 1024;   ///< Maximum events popped per batch
+    static const int FLUSH_INTERVAL_MS = 100;   ///< Interval between drain cycles
+};
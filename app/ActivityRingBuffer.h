@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring buffer
+ *
+ * The producer (a low-level hook callback) calls tryPush(), the consumer
+ * (the log writer thread) calls popBatch(). Storage is allocated once in
+ * the constructor, so neither side ever allocates or blocks. When the
+ * buffer is full the event is dropped and counted instead of waiting.
+ *
+ * @tparam T Trivially copyable element type
+ */
+template <typename T>
+class ActivityRingBuffer
+{
+public:
+    /**
+     * @brief Construct a ring buffer
+     * @param capacity Requested capacity, rounded up to a power of two
+     */
+    explicit ActivityRingBuffer(std::size_t capacity)
+        : m_capacity(roundUpToPowerOfTwo(capacity))
+        , m_mask(m_capacity - 1)
+        , m_slots(new T[m_capacity])
+    {
+    }
+
+    ActivityRingBuffer(const ActivityRingBuffer&) = delete;
+    ActivityRingBuffer& operator=(const ActivityRingBuffer&) = delete;
+
+    /**
+     * @brief Push one element (producer side only)
+     * @param value The element to copy into the buffer
+     * @return true if stored, false if the buffer was full and the element was dropped
+     */
+    bool tryPush(const T& value)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+
+        if (head - tail >= m_capacity) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_slots[head & m_mask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop up to maxCount elements (consumer side only)
+     * @param out Destination array with room for maxCount elements
+     * @param maxCount Maximum number of elements to pop
+     * @return Number of elements copied into out
+     */
+    std::size_t popBatch(T* out, std::size_t maxCount)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        const std::size_t head = m_head.load(std::memory_order_acquire);
+
+        std::size_t count = head - tail;
+        if (count > maxCount) {
+            count = maxCount;
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = m_slots[(tail + i) & m_mask];
+        }
+
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Approximate number of elements waiting to be consumed
+     */
+    std::size_t size() const
+    {
+        const std::size_t head = m_head.load(std::memory_order_acquire);
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    /**
+     * @brief Check if the buffer is currently empty
+     */
+    bool isEmpty() const { return size() == 0; }
+
+    /**
+     * @brief Get the buffer capacity
+     */
+    std::size_t capacity() const { return m_capacity; }
+
+    /**
+     * @brief Get the number of elements dropped because the buffer was full
+     */
+    std::uint64_t droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    static std::size_t roundUpToPowerOfTwo(std::size_t value)
+    {
+        std::size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const std::size_t m_capacity;
+    const std::size_t m_mask;
+    std::unique_ptr<T[]> m_slots;
+
+    // Producer and consumer indices live on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+    alignas(64) std::atomic<std::uint64_t> m_dropped{0};
+};
@@ -0,0 +1,429 @@
+#include "ActivityTrace.h"
+#include "ActivityClock.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+const char FILE_MAGIC[4] = {'T', 'T', 'T', 'R'};
+const quint8 SCREENSHOT_UNCHANGED_FLAG = 0x01;
+
+template <typename T>
+void appendFixed(QByteArray& out, T value)
+{
+    char buffer[sizeof(T)];
+    qToLittleEndian(value, buffer);
+    out.append(buffer, sizeof(T));
+}
+
+void appendVarUInt(QByteArray& out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+void appendVarInt(QByteArray& out, qint64 value)
+{
+    appendVarUInt(out, (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63));
+}
+
+void appendString(QByteArray& out, const QString& value)
+{
+    QByteArray utf8 = value.toUtf8();
+    if (utf8.size() > ActivityTrace::MAX_STRING_BYTES) {
+        // Cut on a character boundary
+        qsizetype size = ActivityTrace::MAX_STRING_BYTES;
+        while (size > 0 && (static_cast<quint8>(utf8.at(size)) & 0xC0) == 0x80) {
+            --size;
+        }
+        utf8.truncate(size);
+    }
+    appendVarUInt(out, static_cast<quint64>(utf8.size()));
+    out.append(utf8);
+}
+
+qint64 ticksToMicros(qint64 tickCount)
+{
+    // Split to stay clear of overflow on traces that run for days
+    const qint64 frequency = ActivityClock::frequency();
+    return tickCount / frequency * 1000000 + tickCount % frequency * 1000000 / frequency;
+}
+
+/**
+ * Cursor over buffered trace bytes that tells running out of data from bad data
+ */
+class TraceCursor
+{
+public:
+    enum class Status { Ok, Short, Invalid };
+
+    TraceCursor(const char *data, qsizetype size) : m_start(data), m_pos(data), m_end(data + size) {}
+
+    Status status() const { return m_status; }
+    qsizetype consumed() const { return m_pos - m_start; }
+
+    quint8 readByte()
+    {
+        if (m_pos >= m_end) {
+            fail(Status::Short);
+            return 0;
+        }
+        return static_cast<quint8>(*m_pos++);
+    }
+
+    quint64 readFixed64()
+    {
+        if (m_end - m_pos < 8) {
+            fail(Status::Short);
+            return 0;
+        }
+        const quint64 value = qFromLittleEndian<quint64>(m_pos);
+        m_pos += 8;
+        return value;
+    }
+
+    quint64 readVarUInt()
+    {
+        quint64 value = 0;
+        for (int shift = 0; shift < 64 && m_status == Status::Ok; shift += 7) {
+            const quint8 byte = readByte();
+            value |= static_cast<quint64>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        fail(Status::Invalid);
+        return 0;
+    }
+
+    qint64 readVarInt()
+    {
+        const quint64 raw = readVarUInt();
+        return static_cast<qint64>(raw >> 1) ^ -static_cast<qint64>(raw & 1);
+    }
+
+    QString readString()
+    {
+        const quint64 length = readVarUInt();
+        if (m_status != Status::Ok) {
+            return QString();
+        }
+        if (length > static_cast<quint64>(ActivityTrace::MAX_STRING_BYTES)) {
+            fail(Status::Invalid);
+            return QString();
+        }
+        if (length > static_cast<quint64>(m_end - m_pos)) {
+            fail(Status::Short);
+            return QString();
+        }
+        const QString value = QString::fromUtf8(m_pos, static_cast<qsizetype>(length));
+        m_pos += length;
+        return value;
+    }
+
+    void fail(Status status)
+    {
+        if (m_status == Status::Ok) {
+            m_status = status;
+        }
+    }
+
+private:
+    const char *m_start;
+    const char *m_pos;
+    const char *m_end;
+    Status m_status = Status::Ok;
+};
+
+} // namespace
+
+// =============================================================================
+// ActivityTraceWriter
+// =============================================================================
+
+ActivityTraceWriter::ActivityTraceWriter(const QString& filePath)
+    : m_filePath(filePath)
+    , m_file(filePath)
+{
+}
+
+ActivityTraceWriter::~ActivityTraceWriter()
+{
+    close();
+}
+
+bool ActivityTraceWriter::open()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_file.isOpen()) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "ActivityTraceWriter failed to open trace:" << m_filePath << m_file.errorString();
+        return false;
+    }
+
+    m_startTicks = ActivityClock::ticks();
+    m_lastOffsetMicros = 0;
+    m_recordCount = 0;
+    m_buffer.clear();
+    m_buffer.reserve(WRITE_BUFFER_SIZE + 1024);
+
+    m_buffer.append(FILE_MAGIC, sizeof(FILE_MAGIC));
+    appendFixed<quint16>(m_buffer, ActivityTrace::FORMAT_VERSION);
+    appendFixed<quint16>(m_buffer, 0);
+    appendFixed<qint64>(m_buffer, ActivityClock::toMSecsSinceEpoch(m_startTicks));
+    return flushLocked();
+}
+
+void ActivityTraceWriter::close()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+    flushLocked();
+    m_file.close();
+}
+
+bool ActivityTraceWriter::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_file.isOpen();
+}
+
+void ActivityTraceWriter::writeEvent(const ActivityEvent& event)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+    beginRecord(ActivityTraceRecord::Kind::Event, event.ticks);
+    appendVarUInt(m_buffer, static_cast<quint64>(event.type));
+    appendVarInt(m_buffer, event.x);
+    appendVarInt(m_buffer, event.y);
+    endRecord();
+}
+
+void ActivityTraceWriter::writeForeground(const QString& processName, const QString& windowTitle)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+    beginRecord(ActivityTraceRecord::Kind::Foreground, ActivityClock::ticks());
+    appendString(m_buffer, processName);
+    appendString(m_buffer, windowTitle);
+    endRecord();
+}
+
+void ActivityTraceWriter::writeScreenshot(int screenIndex, const QSize& size, quint64 hash)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+    beginRecord(ActivityTraceRecord::Kind::Screenshot, ActivityClock::ticks());
+    appendVarUInt(m_buffer, static_cast<quint64>(qMax(0, screenIndex)));
+    m_buffer.append(static_cast<char>(0));
+    appendVarUInt(m_buffer, static_cast<quint64>(qMax(0, size.width())));
+    appendVarUInt(m_buffer, static_cast<quint64>(qMax(0, size.height())));
+    appendFixed<quint64>(m_buffer, hash);
+    endRecord();
+}
+
+void ActivityTraceWriter::writeUnchangedScreenshot(int screenIndex)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+    beginRecord(ActivityTraceRecord::Kind::Screenshot, ActivityClock::ticks());
+    appendVarUInt(m_buffer, static_cast<quint64>(qMax(0, screenIndex)));
+    m_buffer.append(static_cast<char>(SCREENSHOT_UNCHANGED_FLAG));
+    endRecord();
+}
+
+void ActivityTraceWriter::writeScreenshotEncoded(int screenIndex, qint64 encodedBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+    beginRecord(ActivityTraceRecord::Kind::ScreenshotEncoded, ActivityClock::ticks());
+    appendVarUInt(m_buffer, static_cast<quint64>(qMax(0, screenIndex)));
+    appendVarUInt(m_buffer, static_cast<quint64>(qMax<qint64>(0, encodedBytes)));
+    endRecord();
+}
+
+bool ActivityTraceWriter::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    return flushLocked();
+}
+
+quint64 ActivityTraceWriter::recordCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_recordCount;
+}
+
+void ActivityTraceWriter::beginRecord(ActivityTraceRecord::Kind kind, qint64 tickValue)
+{
+    const qint64 offsetMicros = ticksToMicros(tickValue - m_startTicks);
+    m_buffer.append(static_cast<char>(kind));
+    appendVarInt(m_buffer, offsetMicros - m_lastOffsetMicros);
+    m_lastOffsetMicros = offsetMicros;
+}
+
+void ActivityTraceWriter::endRecord()
+{
+    ++m_recordCount;
+    if (m_buffer.size() >= WRITE_BUFFER_SIZE) {
+        flushLocked();
+    }
+}
+
+bool ActivityTraceWriter::flushLocked()
+{
+    if (m_buffer.isEmpty() || !m_file.isOpen()) {
+        return true;
+    }
+
+    // Whole records only, so a crash leaves at most the last write cut short
+    if (m_file.write(m_buffer) != m_buffer.size()) {
+        qWarning() << "ActivityTraceWriter failed to write trace:" << m_file.errorString();
+        m_buffer.clear();
+        return false;
+    }
+    m_file.flush();
+    m_buffer.clear();
+    return true;
+}
+
+// =============================================================================
+// ActivityTraceReader
+// =============================================================================
+
+ActivityTraceReader::ActivityTraceReader(const QString& filePath)
+    : m_filePath(filePath)
+    , m_file(filePath)
+{
+}
+
+bool ActivityTraceReader::open()
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open activity trace:" << m_filePath << m_file.errorString();
+        return false;
+    }
+
+    const QByteArray header = m_file.read(ActivityTrace::FILE_HEADER_SIZE);
+    if (header.size() < ActivityTrace::FILE_HEADER_SIZE
+        || memcmp(header.constData(), FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+        qWarning() << "Not an activity trace:" << m_filePath;
+        m_file.close();
+        return false;
+    }
+
+    const quint16 version = qFromLittleEndian<quint16>(header.constData() + 4);
+    if (version > ActivityTrace::FORMAT_VERSION) {
+        qWarning() << "Unsupported activity trace version" << version << "in" << m_filePath;
+        m_file.close();
+        return false;
+    }
+
+    m_startMSecs = qFromLittleEndian<qint64>(header.constData() + 8);
+    m_buffer.clear();
+    m_position = 0;
+    m_lastOffsetMicros = 0;
+    return true;
+}
+
+bool ActivityTraceReader::readNext(ActivityTraceRecord& record)
+{
+    while (m_file.isOpen()) {
+        TraceCursor cursor(m_buffer.constData() + m_position, m_buffer.size() - m_position);
+        ActivityTraceRecord next;
+
+        const quint8 kind = cursor.readByte();
+        next.kind = static_cast<ActivityTraceRecord::Kind>(kind);
+        next.offsetMicros = m_lastOffsetMicros + cursor.readVarInt();
+
+        switch (next.kind) {
+            case ActivityTraceRecord::Kind::Event:
+                next.eventType = static_cast<ActivityEventType>(cursor.readVarUInt());
+                next.x = static_cast<qint32>(cursor.readVarInt());
+                next.y = static_cast<qint32>(cursor.readVarInt());
+                if (static_cast<quint16>(next.eventType) > static_cast<quint16>(ActivityEventType::IdleEnded)) {
+                    cursor.fail(TraceCursor::Status::Invalid);
+                }
+                break;
+            case ActivityTraceRecord::Kind::Foreground:
+                next.processName = cursor.readString();
+                next.windowTitle = cursor.readString();
+                break;
+            case ActivityTraceRecord::Kind::Screenshot:
+                next.screenIndex = static_cast<int>(cursor.readVarUInt());
+                next.unchanged = (cursor.readByte() & SCREENSHOT_UNCHANGED_FLAG) != 0;
+                if (!next.unchanged) {
+                    const int width = static_cast<int>(cursor.readVarUInt());
+                    const int height = static_cast<int>(cursor.readVarUInt());
+                    next.size = QSize(width, height);
+                    next.hash = cursor.readFixed64();
+                }
+                break;
+            case ActivityTraceRecord::Kind::ScreenshotEncoded:
+                next.screenIndex = static_cast<int>(cursor.readVarUInt());
+                next.encodedBytes = static_cast<qint64>(cursor.readVarUInt());
+                break;
+            default:
+                if (cursor.status() == TraceCursor::Status::Ok) {
+                    cursor.fail(TraceCursor::Status::Invalid);
+                }
+                break;
+        }
+
+        if (cursor.status() == TraceCursor::Status::Ok) {
+            m_position += cursor.consumed();
+            m_lastOffsetMicros = next.offsetMicros;
+            record = next;
+            return true;
+        }
+
+        if (cursor.status() == TraceCursor::Status::Invalid) {
+            qWarning() << "Corrupt activity trace record in" << m_filePath << "- stopping";
+            m_file.close();
+            return false;
+        }
+
+        // A record cut short at the very end was being written when the recorder stopped
+        if (!fill()) {
+            m_file.close();
+            return false;
+        }
+    }
+    return false;
+}
+
+bool ActivityTraceReader::fill()
+{
+    m_buffer.remove(0, m_position);
+    m_position = 0;
+
+    const QByteArray more = m_file.read(READ_BUFFER_SIZE);
+    if (more.isEmpty()) {
+        return false;
+    }
+    m_buffer.append(more);
+    return true;
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+#include "ActivityEvent.h"
+
+/**
+ * @file ActivityTrace.h
+ * @brief Recorded activity traces for replaying real-world load
+ *
+ * A trace holds the raw input the client saw, in order: hook and status
+ * events as published on the event bus, foreground application changes
+ * and screenshot fingerprints. Unlike the journal it is recorded before
+ * coalescing, aggregation and deduplication, so a replay can run the
+ * same input through those stages with other settings.
+ *
+ * Layout:
+ * - File header (16 bytes): magic "TTTR", format version (u16), flags
+ *   (u16), trace start time in UTC milliseconds since epoch (i64).
+ * - A sequence of records: kind (u8), microseconds since the previous
+ *   record (zigzag varint), then a kind-specific payload of varints and
+ *   length-prefixed UTF-8 strings.
+ *
+ * Records are written in the order they are handed to the writer. Bus
+ * events arrive in batches, so an event may be stamped a few
+ * milliseconds before the foreground change written ahead of it; the
+ * signed deltas keep every record's own time.
+ *
+ * All fixed-width integers are little-endian. A record cut short at the
+ * end of the file, as left by a crash, ends the read.
+ */
+
+/**
+ * @brief Decoded trace record
+ *
+ * Only the fields relevant to the record kind are meaningful.
+ */
+struct ActivityTraceRecord {
+    enum class Kind : quint8 {
+        Event = 1,             ///< Event bus event: eventType, x, y
+        Foreground = 2,        ///< Foreground application change: processName, windowTitle
+        Screenshot = 3,        ///< Screen capture: screenIndex, size, hash, unchanged
+        ScreenshotEncoded = 4  ///< Encoded size of the last capture of a screen: screenIndex, encodedBytes
+    };
+
+    Kind kind = Kind::Event;
+    qint64 offsetMicros = 0;                                 ///< Time since the start of the trace
+    ActivityEventType eventType = ActivityEventType::KeyOther; ///< Event: kind
+    qint32 x = 0;                                            ///< Event: see ActivityEvent
+    qint32 y = 0;
+    QString processName;                                     ///< Foreground: process
+    QString windowTitle;                                     ///< Foreground: title
+    int screenIndex = 0;                                     ///< Screenshot, ScreenshotEncoded: screen
+    QSize size;                                              ///< Screenshot: size after downscaling
+    quint64 hash = 0;                                        ///< Screenshot: ScreenshotDeduplicator::differenceHash()
+    bool unchanged = false;                                  ///< Screenshot: reported unchanged by the capture backend, no hash
+    qint64 encodedBytes = 0;                                 ///< ScreenshotEncoded: upload size, 0 if nothing was sent
+};
+
+namespace ActivityTrace {
+
+const quint16 FORMAT_VERSION = 1;
+const int FILE_HEADER_SIZE = 16;
+const int MAX_STRING_BYTES = 1024;  ///< Longer process names and titles are cut when written
+
+} // namespace ActivityTrace
+
+/**
+ * @brief Records an activity trace (thread-safe)
+ *
+ * Event bus batches arrive on the bus thread and foreground changes and
+ * screenshots on the GUI thread, so every call takes a mutex. Records
+ * are buffered and appended in blocks of WRITE_BUFFER_SIZE bytes.
+ */
+class ActivityTraceWriter
+{
+public:
+    /**
+     * @brief Construct a writer for the given trace file
+     * @param filePath Path of the trace file; an existing file is replaced
+     */
+    explicit ActivityTraceWriter(const QString& filePath);
+
+    /**
+     * @brief Flush and close the file
+     */
+    ~ActivityTraceWriter();
+
+    ActivityTraceWriter(const ActivityTraceWriter&) = delete;
+    ActivityTraceWriter& operator=(const ActivityTraceWriter&) = delete;
+
+    /**
+     * @brief Create the file and write its header; the trace starts now
+     * @return true if the file was created
+     */
+    bool open();
+
+    /**
+     * @brief Flush and close the file; later records are ignored
+     */
+    void close();
+
+    /**
+     * @brief Check whether records are being written
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Record an event bus event at its own ticks
+     */
+    void writeEvent(const ActivityEvent& event);
+
+    /**
+     * @brief Record a foreground application change now
+     */
+    void writeForeground(const QString& processName, const QString& windowTitle);
+
+    /**
+     * @brief Record a screen capture now
+     * @param screenIndex Screen the image was grabbed from
+     * @param size Size after downscaling
+     * @param hash ScreenshotDeduplicator::differenceHash() of the capture
+     */
+    void writeScreenshot(int screenIndex, const QSize& size, quint64 hash);
+
+    /**
+     * @brief Record a capture the capture backend reported unchanged, without hashing it
+     */
+    void writeUnchangedScreenshot(int screenIndex);
+
+    /**
+     * @brief Record the encoded size of the last capture of a screen now
+     */
+    void writeScreenshotEncoded(int screenIndex, qint64 encodedBytes);
+
+    /**
+     * @brief Write the buffered records to the file
+     * @return true on success or if there was nothing to write
+     */
+    bool flush();
+
+    /**
+     * @brief Get the trace file path
+     */
+    QString filePath() const { return m_filePath; }
+
+    /**
+     * @brief Get the number of records written so far
+     */
+    quint64 recordCount() const;
+
+    static const int WRITE_BUFFER_SIZE = 64 * 1024; ///< Buffered bytes before a write
+
+private:
+    void beginRecord(ActivityTraceRecord::Kind kind, qint64 tickValue);
+    void endRecord();
+    bool flushLocked();
+
+    QString m_filePath;
+    QFile m_file;
+    mutable QMutex m_mutex;          ///< Protects all members below
+    QByteArray m_buffer;             ///< Records not yet written
+    qint64 m_startTicks = 0;         ///< ActivityClock ticks the trace started at
+    qint64 m_lastOffsetMicros = 0;   ///< Delta base of the next record
+    quint64 m_recordCount = 0;
+};
+
+/**
+ * @brief Reads an activity trace record by record
+ */
+class ActivityTraceReader
+{
+public:
+    /**
+     * @brief Construct a reader for the given trace file
+     * @param filePath Path of the trace file
+     */
+    explicit ActivityTraceReader(const QString& filePath);
+
+    /**
+     * @brief Open the file and validate its header
+     * @return true if the file exists and has a supported header
+     */
+    bool open();
+
+    /**
+     * @brief Decode the next record
+     * @param record Receives the record
+     * @return true if a record was read, false at the end of the trace
+     */
+    bool readNext(ActivityTraceRecord& record);
+
+    /**
+     * @brief Get the trace start time in UTC milliseconds since epoch
+     */
+    qint64 startMSecs() const { return m_startMSecs; }
+
+    static const int READ_BUFFER_SIZE = 256 * 1024; ///< Bytes read from the file at a time
+
+private:
+    bool fill();
+
+    QString m_filePath;
+    QFile m_file;
+    QByteArray m_buffer;        ///< Unread bytes
+    qsizetype m_position = 0;   ///< Read position in m_buffer
+    qint64 m_startMSecs = 0;
+    qint64 m_lastOffsetMicros = 0;
+};
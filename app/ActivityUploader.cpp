@@ -0,0 +1,462 @@
+#include "ActivityUploader.h"
+#include "RequestCompressor.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+#include <QStringList>
+#include <QThreadPool>
+
+ActivityUploader::ActivityUploader(QNetworkAccessManager *networkManager, const QUrl& endpoint,
+                                   const QString& journalFilePath, QObject *parent)
+    : QObject(parent)
+    , m_networkManager(networkManager)
+    , m_endpoint(endpoint)
+    , m_journalFilePath(journalFilePath)
+    , m_cursorFilePath(journalFilePath + ".cursor")
+    , m_reader(QString())
+{
+    m_cursor = loadCursor(m_cursorFilePath);
+}
+
+ActivityUploader::~ActivityUploader()
+{
+    for (const QPointer<QNetworkReply>& reply : m_replies) {
+        if (!reply) continue;
+        disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+        reply->deleteLater();
+    }
+}
+
+void ActivityUploader::start()
+{
+    if (m_active) {
+        qDebug() << "Activity upload already in progress";
+        return;
+    }
+
+    m_uploadedRecords = 0;
+    if (!openSession()) {
+        qDebug() << "No activity logs to upload";
+    }
+}
+
+bool ActivityUploader::openSession()
+{
+    const QList<quint32> segments = ActivityJournal::segmentSequences(m_journalFilePath);
+    if (segments.isEmpty()) {
+        return false;
+    }
+
+    m_cursor = loadCursor(m_cursorFilePath);
+    if (!segments.contains(m_cursor.segment)) {
+        // Segments before the first remaining one were acknowledged and deleted
+        if (m_cursor.segment > segments.last()) {
+            qWarning() << "Activity upload cursor segment" << m_cursor.segment
+                       << "no longer exists - restarting from segment" << segments.first();
+        }
+        ActivityJournalCursor cursor;
+        cursor.segment = segments.first();
+        commitCursor(cursor);
+    }
+    skipConsumedSegments();
+
+    if (!openSegment(m_cursor.segment, m_cursor.offset)) {
+        return false;
+    }
+
+    m_active = true;
+    m_readerExhausted = false;
+    m_failed = false;
+    m_resendSmaller = false;
+
+    sendChunks();
+
+    if (m_replies.isEmpty()) {
+        m_reader.close();
+        m_active = false;
+        return false;
+    }
+    return true;
+}
+
+bool ActivityUploader::openSegment(quint32 segment, qint64 offset)
+{
+    m_reader.setFilePath(ActivityJournal::segmentFilePath(m_journalFilePath, segment));
+    if (!m_reader.open()) {
+        return false;
+    }
+    m_readSegment = segment;
+
+    if (!m_reader.seek(qMax<qint64>(offset, ActivityJournal::FILE_HEADER_SIZE))) {
+        qWarning() << "Activity upload cursor offset" << offset << "is past the end of segment"
+                   << segment << "- rereading the segment";
+        m_reader.seek(ActivityJournal::FILE_HEADER_SIZE);
+    }
+    return true;
+}
+
+bool ActivityUploader::nextSegment(quint32 segment, quint32& next) const
+{
+    for (quint32 sequence : ActivityJournal::segmentSequences(m_journalFilePath)) {
+        if (sequence > segment) {
+            next = sequence;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ActivityUploader::sendChunks()
+{
+    while (!m_failed && !m_resendSmaller && !m_readerExhausted && m_replies.size() < m_maxInFlight) {
+        ActivityUploadChunk chunk;
+        if (!readChunk(m_reader, m_maxChunkRecords, m_maxChunkBytes, chunk)) {
+            // Only the newest segment can still grow; an older one is finished, so move on
+            quint32 next;
+            if (nextSegment(m_readSegment, next) && openSegment(next, 0)) {
+                continue;
+            }
+            m_readerExhausted = true;
+            break;
+        }
+        chunk.segment = m_readSegment;
+
+        QNetworkRequest request(m_requestPrototype);
+        request.setUrl(m_endpoint);
+        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+        QByteArray body = chunkBody(chunk, m_userId, m_sessionId);
+        if (m_compressor) {
+            m_compressor->prepare(request, body);
+        }
+
+        QNetworkReply *reply = m_networkManager->post(request, body);
+        reply->setProperty("chunkSegment", chunk.segment);
+        reply->setProperty("chunkEndOffset", chunk.endOffset);
+        reply->setProperty("chunkBlockCount", chunk.blockCount);
+        reply->setProperty("chunkMaxBytes", m_maxChunkBytes);
+        connect(reply, &QNetworkReply::finished, this, &ActivityUploader::handleChunkResponse);
+        m_replies.append(reply);
+
+        qDebug() << "Uploading" << chunk.recordCount << "activity log entries (segment" << chunk.segment
+                 << "offset" << chunk.startOffset << "-" << chunk.endOffset << ")";
+
+        // The request holds its own copy of the body
+        chunk.entries.clear();
+        chunk.strings = QJsonObject();
+        m_chunks.append(chunk);
+    }
+}
+
+void ActivityUploader::handleChunkResponse()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    m_replies.removeOne(reply);
+    if (m_compressor) {
+        m_compressor->observe(reply);
+    }
+    const quint32 segment = reply->property("chunkSegment").toUInt();
+    const qint64 endOffset = reply->property("chunkEndOffset").toLongLong();
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    // Servers that echo the stored journal range must echo this chunk's; older ones echo nothing
+    const QJsonObject acknowledged = reply->error() == QNetworkReply::NoError
+        ? QJsonDocument::fromJson(reply->readAll()).object()["acknowledged"].toObject()
+        : QJsonObject();
+    const bool rangeMatches = acknowledged.isEmpty()
+        || (acknowledged["segment"].toInteger() == segment && acknowledged["endOffset"].toInteger() == endOffset);
+
+    if (reply->error() == QNetworkReply::NoError && !rangeMatches) {
+        qWarning() << "Server acknowledged segment" << acknowledged["segment"].toInteger()
+                   << "offset" << acknowledged["endOffset"].toInteger() << "for the chunk ending at segment"
+                   << segment << "offset" << endOffset;
+        m_failed = true;
+    } else if (reply->error() == QNetworkReply::NoError) {
+        for (ActivityUploadChunk& chunk : m_chunks) {
+            if (chunk.segment == segment && chunk.endOffset == endOffset) {
+                chunk.acknowledged = true;
+                break;
+            }
+        }
+        commitAcknowledged();
+    } else if (status == 400 || status == 422) {
+        // The payload itself was refused; resending it would hold the cursor, and every segment, forever
+        for (ActivityUploadChunk& chunk : m_chunks) {
+            if (chunk.segment == segment && chunk.endOffset == endOffset) {
+                qWarning() << "Server rejected activity log chunk at segment" << segment << "offset"
+                           << chunk.startOffset << "-" << endOffset << "with" << status << "- skipping"
+                           << chunk.recordCount << "entries";
+                chunk.rejected = true;
+                emit chunkRejected(segment, chunk.startOffset, endOffset, chunk.recordCount, status);
+                break;
+            }
+        }
+        commitAcknowledged();
+    } else if (status == 413 && reply->property("chunkBlockCount").toInt() > 1) {
+        // Blocks are never split, so only a chunk of several blocks can go out smaller.
+        // Chunks read under an already halved limit do not halve it again.
+        if (reply->property("chunkMaxBytes").toInt() == m_maxChunkBytes) {
+            m_maxChunkBytes = qMax(1, m_maxChunkBytes / 2);
+        }
+        qWarning() << "Server refused activity log chunk ending at segment" << segment << "offset" << endOffset
+                   << "as too large - resending in chunks of at most" << m_maxChunkBytes << "bytes";
+        m_resendSmaller = true;
+    } else {
+        // Auth, routing and server errors say nothing about the chunk; retry it next session
+        qWarning() << "Failed to upload activity log chunk ending at segment" << segment
+                   << "offset" << endOffset << ":" << reply->errorString();
+        m_failed = true;
+    }
+
+    reply->deleteLater();
+
+    sendChunks();
+    if (m_replies.isEmpty() && (m_failed || m_resendSmaller || m_readerExhausted)) {
+        finishSession();
+    }
+}
+
+void ActivityUploader::commitAcknowledged()
+{
+    // Only a contiguous prefix of acknowledged or rejected chunks can be committed
+    bool advanced = false;
+    ActivityJournalCursor cursor = m_cursor;
+    while (!m_chunks.isEmpty() && (m_chunks.first().acknowledged || m_chunks.first().rejected)) {
+        cursor.segment = m_chunks.first().segment;
+        cursor.offset = m_chunks.first().endOffset;
+        if (m_chunks.first().acknowledged) {
+            m_uploadedRecords += m_chunks.first().recordCount;
+        }
+        m_chunks.removeFirst();
+        advanced = true;
+    }
+
+    if (advanced) {
+        commitCursor(cursor);
+        releaseAcknowledgedSegments();
+    }
+}
+
+void ActivityUploader::commitCursor(const ActivityJournalCursor& cursor)
+{
+    m_cursor = cursor;
+    if (!saveCursor(m_cursorFilePath, m_cursor)) {
+        qWarning() << "Failed to persist activity upload cursor to" << m_cursorFilePath;
+    }
+    emit cursorCommitted(m_cursor.segment, m_cursor.offset);
+}
+
+void ActivityUploader::skipConsumedSegments()
+{
+    // A cursor at the end of a finished segment moves to the start of the next one
+    bool advanced = false;
+    ActivityJournalCursor cursor = m_cursor;
+    quint32 next;
+    while (nextSegment(cursor.segment, next)) {
+        const qint64 size = QFileInfo(ActivityJournal::segmentFilePath(m_journalFilePath, cursor.segment)).size();
+        if (cursor.offset < size) {
+            break;
+        }
+        cursor.segment = next;
+        cursor.offset = 0;
+        advanced = true;
+    }
+
+    if (advanced) {
+        commitCursor(cursor);
+        releaseAcknowledgedSegments();
+    }
+}
+
+void ActivityUploader::releaseAcknowledgedSegments()
+{
+    QStringList paths;
+    for (quint32 sequence : ActivityJournal::segmentSequences(m_journalFilePath)) {
+        if (sequence < m_cursor.segment) {
+            paths.append(ActivityJournal::segmentFilePath(m_journalFilePath, sequence));
+        }
+    }
+    if (paths.isEmpty()) {
+        return;
+    }
+
+    QThreadPool::globalInstance()->start([paths]() {
+        for (const QString& path : paths) {
+            if (!QFile::remove(path)) {
+                qWarning() << "Failed to delete acknowledged journal segment" << path;
+            }
+        }
+    });
+    emit segmentsReleased(paths.size());
+}
+
+void ActivityUploader::finishSession()
+{
+    m_reader.close();
+    m_chunks.clear();
+    m_active = false;
+
+    // The cursor still points at the chunk that was too large; reread it under the smaller limit
+    if (m_resendSmaller && !m_failed && openSession()) {
+        return;
+    }
+
+    const bool success = !m_failed && !m_resendSmaller;
+
+    if (success) {
+        qDebug() << "Activity logs uploaded successfully -" << m_uploadedRecords << "entries";
+        skipConsumedSegments();
+    }
+    emit uploadFinished(success, m_uploadedRecords);
+}
+
+bool ActivityUploader::readChunk(ActivityJournalReader& reader, int maxRecords, int maxBytes,
+                                 ActivityUploadChunk& chunk)
+{
+    chunk = ActivityUploadChunk();
+    chunk.startOffset = reader.position();
+    chunk.endOffset = reader.position();
+    chunk.entries = "[";
+
+    QVector<ActivityJournalRecord> records;
+    for (;;) {
+        const qint64 blockStart = reader.position();
+        records.clear();
+        if (!reader.readNextBlock(records)) {
+            break;
+        }
+
+        QByteArray blockJson;
+        QJsonObject blockStrings;
+        int blockStringBytes = 0;
+        for (const ActivityJournalRecord& record : records) {
+            if (!blockJson.isEmpty()) {
+                blockJson += ',';
+            }
+            blockJson += toJson(record);
+
+            // Ship each string once per chunk, next to the first entry that needs it
+            for (quint32 id : {record.textId, record.detailId}) {
+                const QString key = QString::number(id);
+                if (id == 0 || chunk.strings.contains(key) || blockStrings.contains(key)) {
+                    continue;
+                }
+                const QString& value = id == record.textId ? record.text : record.detail;
+                blockStrings.insert(key, value);
+                blockStringBytes += key.size() + value.toUtf8().size() + 6;
+            }
+        }
+
+        // Blocks are never split; leave one that does not fit for the next chunk
+        const int chunkBytes = chunk.entries.size() + chunk.stringBytes;
+        if (chunk.recordCount > 0
+            && (chunk.recordCount + records.size() > maxRecords
+                || chunkBytes + blockJson.size() + blockStringBytes + 1 > maxBytes)) {
+            reader.seek(blockStart);
+            break;
+        }
+
+        if (!blockJson.isEmpty()) {
+            if (chunk.recordCount > 0) {
+                chunk.entries += ',';
+            }
+            chunk.entries += blockJson;
+            chunk.recordCount += records.size();
+            for (auto it = blockStrings.constBegin(); it != blockStrings.constEnd(); ++it) {
+                chunk.strings.insert(it.key(), it.value());
+            }
+            chunk.stringBytes += blockStringBytes;
+        }
+        ++chunk.blockCount;
+        chunk.endOffset = reader.position();
+
+        if (chunk.recordCount >= maxRecords || chunk.entries.size() + chunk.stringBytes >= maxBytes) {
+            break;
+        }
+    }
+
+    chunk.entries += ']';
+    return chunk.recordCount > 0;
+}
+
+QByteArray ActivityUploader::toJson(const ActivityJournalRecord& record)
+{
+    QJsonObject logEntry;
+    // The text log's local "yyyy-MM-dd hh:mm:ss" has no zone and does not bind to the server's DateTime
+    logEntry["timestamp"] = QDateTime::fromMSecsSinceEpoch(record.timestampMSecs).toUTC().toString(Qt::ISODateWithMs);
+    logEntry["eventType"] = ActivityJournal::eventTypeName(record);
+    if (record.textId != 0 && record.detailId != 0) {
+        logEntry["process"] = static_cast<qint64>(record.textId);
+        logEntry["title"] = static_cast<qint64>(record.detailId);
+    } else {
+        logEntry["details"] = ActivityJournal::details(record);
+    }
+
+    return QJsonDocument(logEntry).toJson(QJsonDocument::Compact);
+}
+
+QByteArray ActivityUploader::chunkBody(const ActivityUploadChunk& chunk, const QString& userId,
+                                       const QString& sessionId)
+{
+    // Entries are already serialized; only the envelope goes through QJsonDocument
+    QJsonObject envelope;
+    envelope["userId"] = userId;
+    envelope["sessionId"] = sessionId;
+    envelope["strings"] = chunk.strings;
+    envelope["segment"] = static_cast<qint64>(chunk.segment);
+    envelope["startOffset"] = chunk.startOffset;
+    envelope["endOffset"] = chunk.endOffset;
+    QByteArray body = QJsonDocument(envelope).toJson(QJsonDocument::Compact);
+
+    body.chop(1);
+    body += ",\"entries\":";
+    body += chunk.entries.isEmpty() ? QByteArray("[]") : chunk.entries;
+    body += '}';
+    return body;
+}
+
+ActivityJournalCursor ActivityUploader::loadCursor(const QString& cursorFilePath)
+{
+    ActivityJournalCursor cursor;
+    QFile file(cursorFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return cursor;
+    }
+
+    // "<segment> <offset>"
+    const QList<QByteArray> fields = file.readAll().simplified().split(' ');
+    bool segmentOk = false;
+    bool offsetOk = false;
+    quint32 segment = 0;
+    qint64 offset = 0;
+    if (fields.size() == 2) {
+        segment = fields[0].toUInt(&segmentOk);
+        offset = fields[1].toLongLong(&offsetOk);
+    }
+
+    if (segmentOk && offsetOk && offset >= 0) {
+        cursor.segment = segment;
+        cursor.offset = offset;
+    }
+    return cursor;
+}
+
+bool ActivityUploader::saveCursor(const QString& cursorFilePath, const ActivityJournalCursor& cursor)
+{
+    QSaveFile file(cursorFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QByteArray::number(cursor.segment) + ' ' + QByteArray::number(cursor.offset));
+    return file.commit();
+}
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QPointer>
+#include <QString>
+#include <QUrl>
+#include "ActivityJournal.h"
+
+class QNetworkAccessManager;
+class RequestCompressor;
+
+/**
+ * @brief Position in a segmented activity journal up to which data was acknowledged
+ */
+struct ActivityJournalCursor {
+    quint32 segment = 0;     ///< Segment sequence number
+    qint64 offset = 0;       ///< Byte offset within the segment, 0 for its start
+};
+
+/**
+ * @brief One bounded slice of the activity journal ready to be posted
+ *
+ * Chunks always cover whole journal blocks of a single segment, so
+ * startOffset and endOffset are block boundaries that can be committed
+ * as an upload cursor.
+ *
+ * Application changes in entries refer to process names and titles by
+ * journal string id; strings holds the text of every id the chunk uses,
+ * so each chunk can be posted and retried on its own.
+ */
+struct ActivityUploadChunk {
+    quint32 segment = 0;     ///< Segment the chunk was read from
+    qint64 startOffset = 0;  ///< Segment offset of the first block in the chunk
+    qint64 endOffset = 0;    ///< Segment offset just past the last block in the chunk
+    int recordCount = 0;     ///< Number of activity entries in entries
+    int blockCount = 0;      ///< Number of journal blocks the chunk covers
+    QByteArray entries;      ///< Compact JSON array of activity entries
+    QJsonObject strings;     ///< String id (as text) to string for the ids used by entries
+    int stringBytes = 0;     ///< Approximate JSON size of strings
+    bool acknowledged = false; ///< Set once the server accepted the chunk
+    bool rejected = false;     ///< Set once the server refused the chunk for good
+};
+
+/**
+ * @brief The ActivityUploader class streams the activity journal to the server
+ *
+ * The journal is read from the committed cursor in chunks of at most
+ * maxChunkRecords() entries or maxChunkBytes() of JSON, whichever is hit
+ * first, and each chunk is posted as its own request of the form
+ * {"userId", "sessionId", "strings": {id: text}, "entries": [...]}. At most
+ * maxInFlight() chunks are outstanding at a time, so memory stays bounded
+ * by the chunk size regardless of the backlog. Each request also carries
+ * the chunk's "segment", "startOffset" and "endOffset"; a server that
+ * answers with an "acknowledged" range must name the same chunk, or the
+ * chunk counts as failed.
+ *
+ * When a chunk is acknowledged the cursor advances over every
+ * contiguously acknowledged chunk and is persisted next to the journal,
+ * so an interrupted upload resumes where it stopped. A failed chunk,
+ * including one refused for authentication or routing, stops the session;
+ * the next start() retries from the cursor. A chunk whose payload the
+ * server refuses (400 or 422) would be refused again, so it is logged,
+ * reported through chunkRejected() and skipped, and the cursor moves past
+ * it like an acknowledged one. A chunk refused as too large (413) halves
+ * maxChunkBytes() and the session rereads it from the cursor in smaller
+ * chunks.
+ *
+ * The journal is never truncated. Segments that lie entirely before the
+ * cursor are deleted on a worker thread, so the log writer keeps
+ * appending to the newest segment while uploads are running.
+ */
+class ActivityUploader : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Construct a new ActivityUploader object
+     * @param networkManager Network manager used to post chunks (not owned)
+     * @param endpoint URL that accepts activity chunks
+     * @param journalFilePath Base path of the segmented activity journal to upload
+     * @param parent The parent QObject
+     */
+    ActivityUploader(QNetworkAccessManager *networkManager, const QUrl& endpoint,
+                     const QString& journalFilePath, QObject *parent = nullptr);
+
+    /**
+     * @brief Destroy the ActivityUploader object, aborting outstanding chunks
+     */
+    ~ActivityUploader();
+
+    /**
+     * @brief Set the maximum number of entries per chunk
+     * @param records Entry limit, at least 1
+     */
+    void setMaxChunkRecords(int records) { m_maxChunkRecords = qMax(1, records); }
+
+    /**
+     * @brief Set the soft maximum JSON size per chunk
+     *
+     * A chunk is closed once it reaches this size; a single journal block
+     * larger than the limit still goes out as one chunk.
+     * @param bytes Size limit in bytes, at least 1
+     */
+    void setMaxChunkBytes(int bytes) { m_maxChunkBytes = qMax(1, bytes); }
+
+    /**
+     * @brief Set the maximum number of chunk requests outstanding at once
+     * @param requests Request limit, at least 1
+     */
+    void setMaxInFlight(int requests) { m_maxInFlight = qMax(1, requests); }
+
+    /**
+     * @brief Set the user and session every uploaded chunk is filed under
+     */
+    void setIdentity(const QString& userId, const QString& sessionId)
+    {
+        m_userId = userId;
+        m_sessionId = sessionId;
+    }
+
+    /**
+     * @brief Set the compressor that negotiates gzip chunk bodies with the server
+     * @param compressor Shared compressor, or nullptr to send plain JSON (not owned)
+     */
+    void setRequestCompressor(RequestCompressor *compressor) { m_compressor = compressor; }
+
+    /**
+     * @brief Set the request every chunk request is copied from
+     *
+     * Lets the owner share its TLS and HTTP/2 settings, so chunks travel
+     * over the same connection as its other uploads. The URL is replaced
+     * by the endpoint.
+     * @param prototype The request to copy
+     */
+    void setRequestPrototype(const QNetworkRequest& prototype) { m_requestPrototype = prototype; }
+
+    /**
+     * @brief Set the URL chunks are posted to, from the next chunk sent
+     */
+    void setEndpoint(const QUrl& endpoint) { m_endpoint = endpoint; }
+
+    int maxChunkRecords() const { return m_maxChunkRecords; }
+    int maxChunkBytes() const { return m_maxChunkBytes; }
+    int maxInFlight() const { return m_maxInFlight; }
+
+    /**
+     * @brief Check whether an upload session is running
+     */
+    bool isUploading() const { return m_active; }
+
+    /**
+     * @brief Get the journal position up to which the server has acknowledged data
+     */
+    ActivityJournalCursor committedCursor() const { return m_cursor; }
+
+    /**
+     * @brief Get the path of the file that persists the committed cursor
+     */
+    QString cursorFilePath() const { return m_cursorFilePath; }
+
+    /**
+     * @brief Read whole journal blocks into a chunk until a limit is reached
+     * @param reader Open reader positioned at the first block to include
+     * @param maxRecords Entry limit
+     * @param maxBytes Soft JSON size limit
+     * @param chunk Receives the chunk
+     * @return true if at least one entry was read
+     */
+    static bool readChunk(ActivityJournalReader& reader, int maxRecords, int maxBytes,
+                          ActivityUploadChunk& chunk);
+
+    /**
+     * @brief Serialize a journal record in the JSON shape the backend expects
+     *
+     * The timestamp is ISO-8601 UTC with milliseconds, e.g.
+     * "2025-06-15T15:06:40.123Z". Interned application changes carry
+     * "process" and "title" string ids instead of "details".
+     * @param record The record to serialize
+     * @return Compact JSON object bytes
+     */
+    static QByteArray toJson(const ActivityJournalRecord& record);
+
+    /**
+     * @brief Build the request body for a chunk
+     * @param chunk The chunk to post
+     * @param userId User the entries belong to
+     * @param sessionId Session the entries belong to
+     * @return Compact JSON object bytes
+     */
+    static QByteArray chunkBody(const ActivityUploadChunk& chunk, const QString& userId, const QString& sessionId);
+
+    /**
+     * @brief Load a persisted committed cursor
+     * @param cursorFilePath Path of the cursor file
+     * @return The cursor, or segment 0 offset 0 if the file is missing or invalid
+     */
+    static ActivityJournalCursor loadCursor(const QString& cursorFilePath);
+
+    /**
+     * @brief Persist a committed cursor atomically
+     * @param cursorFilePath Path of the cursor file
+     * @param cursor The cursor to store
+     * @return true on success
+     */
+    static bool saveCursor(const QString& cursorFilePath, const ActivityJournalCursor& cursor);
+
+    static const int DEFAULT_MAX_CHUNK_RECORDS = 2000;       ///< Default entry limit per chunk
+    static const int DEFAULT_MAX_CHUNK_BYTES = 512 * 1024;   ///< Default JSON size limit per chunk
+    static const int DEFAULT_MAX_IN_FLIGHT = 2;              ///< Default outstanding request limit
+
+public slots:
+    /**
+     * @brief Start an upload session from the committed cursor
+     *
+     * Does nothing if a session is already running.
+     */
+    void start();
+
+signals:
+    /**
+     * @brief Emitted when an upload session ends
+     * @param success true if every chunk read in the session was acknowledged or rejected for good
+     * @param uploadedRecords Entries acknowledged during the session
+     */
+    void uploadFinished(bool success, int uploadedRecords);
+
+    /**
+     * @brief Emitted whenever the committed cursor advances
+     * @param segment Segment of the new cursor
+     * @param offset Offset of the new cursor within the segment
+     */
+    void cursorCommitted(quint32 segment, qint64 offset);
+
+    /**
+     * @brief Emitted when the server refused a chunk's payload and the chunk is skipped
+     * @param segment Segment the chunk was read from
+     * @param startOffset Segment offset of the first block in the chunk
+     * @param endOffset Segment offset just past the last block in the chunk
+     * @param recordCount Number of entries dropped with the chunk
+     * @param httpStatus The server's response status
+     */
+    void chunkRejected(quint32 segment, qint64 startOffset, qint64 endOffset, int recordCount, int httpStatus);
+
+    /**
+     * @brief Emitted after fully acknowledged segments were scheduled for deletion
+     * @param count Number of segments scheduled
+     */
+    void segmentsReleased(int count);
+
+private slots:
+    void handleChunkResponse();
+
+private:
+    bool openSession();
+    bool openSegment(quint32 segment, qint64 offset);
+    bool nextSegment(quint32 segment, quint32& next) const;
+    void sendChunks();
+    void commitAcknowledged();
+    void commitCursor(const ActivityJournalCursor& cursor);
+    void skipConsumedSegments();
+    void releaseAcknowledgedSegments();
+    void finishSession();
+
+    QNetworkAccessManager *m_networkManager;
+    QUrl m_endpoint;
+    QString m_journalFilePath;
+    QString m_cursorFilePath;
+    QString m_userId = "current_user@company.com";
+    QString m_sessionId = "1";
+    RequestCompressor *m_compressor = nullptr;
+    QNetworkRequest m_requestPrototype;
+
+    ActivityJournalReader m_reader;             ///< Open for the duration of a session
+    quint32 m_readSegment = 0;                  ///< Segment m_reader is reading
+    QList<ActivityUploadChunk> m_chunks;        ///< Outstanding chunks in journal order
+    QList<QPointer<QNetworkReply>> m_replies;   ///< Replies still running (owned by the network manager)
+    ActivityJournalCursor m_cursor;             ///< Committed position
+
+    bool m_active = false;
+    bool m_readerExhausted = false;
+    bool m_failed = false;
+    bool m_resendSmaller = false;               ///< A chunk was refused as too large and is reread smaller
+    int m_uploadedRecords = 0;
+
+    int m_maxChunkRecords = DEFAULT_MAX_CHUNK_RECORDS;
+    int m_maxChunkBytes = DEFAULT_MAX_CHUNK_BYTES;
+    int m_maxInFlight = DEFAULT_MAX_IN_FLIGHT;
+};
@@ -1,11 +1,16 @@
 #include "ApiService.h"
 #include "IdleAnnotationDialog.h"
+#include "ActivityJournal.h"
+#include "ActivityUploader.h"
+#include "Metrics.h"
+#include "ScreenshotEncoder.h"
 #include <QApplication>
 #include <QDebug>
 #include <QFile>
-#include <QTextStream>
 #include <QHttpPart>
 #include <QFileInfo>
+#include <QNetworkInformation>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QSslConfiguration>
 #include <QSslSocket>
@@ -15,11 +20,39 @@ ApiService::ApiService(QObject *parent) : QObject(parent) {
     
     // Configure base URL (use localhost for development)
     m_baseUrl = "https://localhost:7001/api/trackingdata";
+
+    // Activity logs are streamed from the journal in bounded chunks
+    m_activityUploader = new ActivityUploader(m_networkManager, QUrl(m_baseUrl + "/activity/chunk"),
+                                              ActivityJournal::DEFAULT_FILE_NAME, this);
+    m_activityUploader->setRequestCompressor(&m_requestCompressor);
+    m_activityUploader->setRequestPrototype(createRequest(QString()));
+    connect(m_activityUploader, &ActivityUploader::uploadFinished,
+            this, &ApiService::handleActivityUploadFinished);
+
+    // Idle sessions and screenshot files wait on disk until the server has them
+    m_uploadQueue = new UploadQueue(UploadQueue::DEFAULT_DIRECTORY, this);
+    m_uploadQueue->registerKind("idletime", [this](const QList<UploadJob>& jobs) { return sendIdleSessions(jobs); },
+                                1, IDLE_SESSION_BATCH_SIZE);
+    m_uploadQueue->registerKind("screenshot", [this](const QList<UploadJob>& jobs) { return sendScreenshotFile(jobs); },
+                                SCREENSHOT_UPLOADS_IN_FLIGHT, 1);
+    m_uploadQueue->registerKind("summary", [this](const QList<UploadJob>& jobs) { return sendActivitySummaries(jobs); },
+                                1, ACTIVITY_SUMMARY_BATCH_SIZE);
+    connect(m_uploadQueue, &UploadQueue::jobFinished, this, &ApiService::handleUploadJobFinished);
     
     // Setup periodic activity log upload (every 5 minutes)
     m_uploadTimer = new QTimer(this);
     connect(m_uploadTimer, &QTimer::timeout, this, &ApiService::uploadActivityLogs);
-    m_uploadTimer->start(5 * 60 * 1000); // 5 minutes
+    m_uploadTimer->start(DEFAULT_ACTIVITY_UPLOAD_INTERVAL_MS);
+
+    // The journal keeps unsent activity, so a failed upload only needs an earlier retry
+    m_activityRetryTimer = new QTimer(this);
+    m_activityRetryTimer->setSingleShot(true);
+    connect(m_activityRetryTimer, &QTimer::timeout, this, &ApiService::uploadActivityLogs);
+
+    // Uploads are minutes apart; keep a connection ready so they skip the TCP and TLS handshakes
+    m_connectionWarmTimer = new QTimer(this);
+    connect(m_connectionWarmTimer, &QTimer::timeout, this, &ApiService::warmUpConnection);
+    m_connectionWarmTimer->start(CONNECTION_WARM_INTERVAL_MS);
     
     qDebug() << "ApiService initialized with base URL:" << m_baseUrl;
 }
@@ -34,61 +67,135 @@ void ApiService::setupNetworkManager() {
     m_networkManager = new QNetworkAccessManager(this);
     
     // Configure SSL for HTTPS
-    QSslConfiguration sslConfig = QSslConfiguration::defaultConfiguration();
-    sslConfig.setPeerVerifyMode(QSslSocket::VerifyNone); // For development only
+    m_sslConfiguration = QSslConfiguration::defaultConfiguration();
+#ifdef QT_DEBUG
+    m_sslConfiguration.setPeerVerifyMode(QSslSocket::VerifyNone); // For development only
+#endif
+    // Offer HTTP/2 so all uploads multiplex over one connection, and resume TLS sessions on reconnect
+    m_sslConfiguration.setAllowedNextProtocols({QSslConfiguration::ALPNProtocolHTTP2,
+                                                QSslConfiguration::NextProtocolHttp1_1});
+    m_sslConfiguration.setSslOption(QSsl::SslOptionDisableSessionTickets, false);
+    m_sslConfiguration.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+
+    // Reachability lets in-memory screenshots go straight to disk while offline
+    if (!QNetworkInformation::loadDefaultBackend()) {
+        qDebug() << "No network information backend - reachability checks disabled";
+    } else {
+        connect(QNetworkInformation::instance(), &QNetworkInformation::reachabilityChanged, this,
+                [this](QNetworkInformation::Reachability reachability) {
+                    if (reachability != QNetworkInformation::Reachability::Disconnected) {
+                        warmUpConnection();
+                    }
+                });
+    }
 }
 
-void ApiService::uploadActivityLogs() {
-    QMutexLocker locker(&m_uploadMutex);
-    
-    QJsonArray activityLogs = readActivityLogs();
-    if (activityLogs.isEmpty()) {
-        qDebug() << "No activity logs to upload";
+QNetworkRequest ApiService::createRequest(const QString& path) const {
+    QNetworkRequest request(QUrl(m_baseUrl + path));
+    request.setSslConfiguration(m_sslConfiguration);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    request.setRawHeader("User-Agent", "TimeTracker-Client/1.0");
+    return request;
+}
+
+void ApiService::setBaseUrl(const QString& baseUrl) {
+    QString url = baseUrl.trimmed();
+    while (url.endsWith('/')) {
+        url.chop(1);
+    }
+    if (url.isEmpty() || url == m_baseUrl) {
         return;
     }
-    
-    QJsonDocument doc(activityLogs);
-    QByteArray data = doc.toJson();
-    
-    QNetworkRequest request(QUrl(m_baseUrl + "/activity"));
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    request.setRawHeader("User-Agent", "TimeTracker-Client/1.0");
-    
-    QNetworkReply *reply = m_networkManager->post(request, data);
-    reply->setProperty("activityLogs", QVariant::fromValue(activityLogs));
-    
-    connect(reply, &QNetworkReply::finished, this, &ApiService::handleActivityResponse);
-    
-    qDebug() << "Uploading" << activityLogs.size() << "activity log entries";
+
+    m_baseUrl = url;
+    m_activityUploader->setEndpoint(QUrl(m_baseUrl + "/activity/chunk"));
+    m_activityUploader->setRequestPrototype(createRequest(QString()));
+
+    // Whether gzip is accepted was learned from the old server
+    m_requestCompressor.setEnabled(false);
+    warmUpConnection();
+
+    qDebug() << "ApiService base URL changed to:" << m_baseUrl;
 }
 
-void ApiService::uploadScreenshot(const QString& filePath, const QString& userId, const QString& sessionId) {
-    QFile file(filePath);
-    if (!file.exists()) {
-        qWarning() << "Screenshot file does not exist:" << filePath;
-        emit screenshotUploaded(false, filePath);
+void ApiService::setIdentity(const QString& userId, const QString& sessionId) {
+    m_activityUploader->setIdentity(userId, sessionId);
+}
+
+void ApiService::setActivityUploadIntervalMSecs(int intervalMSecs) {
+    const int interval = qMax(1, intervalMSecs);
+    if (interval != m_uploadTimer->interval()) {
+        m_uploadTimer->start(interval);
+        qDebug() << "Activity logs upload every" << interval / 1000 << "seconds";
+    }
+}
+
+void ApiService::warmUpConnection() {
+    QNetworkInformation *networkInfo = QNetworkInformation::instance();
+    if (networkInfo && networkInfo->reachability() == QNetworkInformation::Reachability::Disconnected) {
         return;
     }
-    
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Failed to open screenshot file:" << filePath;
-        emit screenshotUploaded(false, filePath);
+
+    // Reuses the cached connection if it is still open. The SSL configuration must be the one
+    // requests carry, otherwise they would not share the connection.
+    const QUrl url(m_baseUrl);
+    if (url.scheme() == "https") {
+        m_networkManager->connectToHostEncrypted(url.host(), static_cast<quint16>(url.port(443)),
+                                                 m_sslConfiguration, url.host());
+    } else if (url.scheme() == "http") {
+        m_networkManager->connectToHost(url.host(), static_cast<quint16>(url.port(80)));
+    }
+}
+
+void ApiService::uploadActivityLogs() {
+    if (m_activityUploadPolicy == ActivityUploadPolicy::Summaries) {
+        qDebug() << "Raw activity upload disabled by policy - only summaries are sent";
         return;
     }
-    
+    m_activityUploader->start();
+}
+
+void ApiService::queueScreenshotFile(const QString& filePath, const QString& userId, const QString& sessionId) {
+    QJsonObject payload;
+    payload["userId"] = userId;
+    payload["sessionId"] = sessionId;
+    if (m_uploadQueue->enqueue("screenshot", payload, filePath) == 0) {
+        emit screenshotUploaded(false, filePath);
+    }
+}
+
+QNetworkReply *ApiService::sendScreenshotFile(const QList<UploadJob>& jobs) {
+    const UploadJob& job = jobs.first();
+
+    QFile *file = new QFile(job.filePath);
+    if (!file->open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open screenshot file:" << job.filePath;
+        delete file;
+        return nullptr;
+    }
+
     // Create multipart form data
     QHttpMultiPart *multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
-    
-    // Read file data
-    QByteArray fileData = file.readAll();
-    file.close();
 
-    // Add file part
+    // Stream the file part straight from disk instead of reading it into memory
     QHttpPart filePart;
-    filePart.setHeader(QNetworkRequest::ContentTypeHeader, "image/jpeg");
+    filePart.setBodyDevice(file);
+    file->setParent(multiPart);
+
+    QNetworkReply *reply = postScreenshot(filePart, QFileInfo(job.filePath).fileName(),
+                                          job.payload["userId"].toString(), job.payload["sessionId"].toString(),
+                                          multiPart);
+    // Any response may be the first to advertise gzip support
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { m_requestCompressor.observe(reply); });
+    return reply;
+}
+
+QNetworkReply *ApiService::postScreenshot(QHttpPart& filePart, const QString& fileName, const QString& userId,
+                                          const QString& sessionId, QHttpMultiPart *multiPart) {
+    // Add file part; spilled files keep the extension of the encoder that wrote them
+    filePart.setHeader(QNetworkRequest::ContentTypeHeader, ScreenshotEncoder::mimeTypeForFile(fileName));
     filePart.setHeader(QNetworkRequest::ContentDispositionHeader,
-                      QVariant("form-data; name=\"file\"; filename=\"" + QFileInfo(filePath).fileName() + "\""));
-    filePart.setBody(fileData);
+                      QVariant("form-data; name=\"file\"; filename=\"" + fileName + "\""));
     multiPart->append(filePart);
     
     // Add userId part
@@ -103,86 +210,187 @@ void ApiService::uploadScreenshot(const QString& filePath, const QString& userId
     sessionIdPart.setBody(sessionId.toUtf8());
     multiPart->append(sessionIdPart);
     
-    QNetworkRequest request(QUrl(m_baseUrl + "/screenshots"));
-    request.setRawHeader("User-Agent", "TimeTracker-Client/1.0");
+    QNetworkRequest request = createRequest("/screenshots");
     
     QNetworkReply *reply = m_networkManager->post(request, multiPart);
-    reply->setProperty("filePath", filePath);
     multiPart->setParent(reply);
     
-    connect(reply, &QNetworkReply::finished, this, &ApiService::handleScreenshotResponse);
-    
-    qDebug() << "Uploading screenshot:" << filePath << "for user:" << userId;
+    qDebug() << "Uploading screenshot:" << fileName << "for user:" << userId;
+    return reply;
 }
 
-QJsonArray ApiService::readActivityLogs() {
-    QJsonArray logs;
-    QFile file("activity_log.txt");
+void ApiService::uploadScreenshots(const QVector<ScreenshotResult>& screens, const QString& userId,
+                                   const QString& sessionId) {
+    if (screens.isEmpty()) {
+        return;
+    }
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return logs;
+    // Deltas are meaningless without the server's previous frame, so only keyframes are spilled
+    QStringList filePaths;
+    QVariantList spillData;
+    QVariantList screenIndices;
+    for (const ScreenshotResult& screen : screens) {
+        filePaths.append(screen.filePath);
+        spillData.append(screen.delta.keyframe ? QVariant(screen.data) : QVariant());
+        screenIndices.append(screen.screen.index);
     }
 
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if (line.isEmpty()) continue;
+    QNetworkInformation *networkInfo = QNetworkInformation::instance();
+    if (networkInfo && networkInfo->reachability() == QNetworkInformation::Reachability::Disconnected) {
+        qDebug() << "Offline - spilling" << screens.size() << "screenshots to disk";
+        for (const ScreenshotResult& screen : screens) {
+            if (screen.delta.keyframe && spillScreenshot(screen.data, screen.filePath)) {
+                queueScreenshotFile(screen.filePath, userId, sessionId);
+            }
+            emit screenshotKeyframeRequired(screen.screen.index);
+            emit screenshotUploaded(false, screen.filePath);
+        }
+        return;
+    }
 
-        // Parse log line format: "2025-06-14 23:18:45.123 - EVENT_TYPE - DETAILS"
-        QStringList parts = line.split(" - ");
-        if (parts.size() >= 3) {
-            QJsonObject logEntry;
-            logEntry["timestamp"] = parts[0];
-            logEntry["eventType"] = parts[1];
-            logEntry["details"] = parts.mid(2).join(" - ");
-            logEntry["userId"] = "current_user@company.com"; // Replace with actual user
-            logEntry["sessionId"] = "1"; // Replace with actual session ID
+    // One request for the whole capture: a file part per screen plus their geometry
+    QHttpMultiPart *multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
 
-            logs.append(logEntry);
-        }
+    for (const ScreenshotResult& screen : screens) {
+        QHttpPart filePart;
+        filePart.setHeader(QNetworkRequest::ContentTypeHeader,
+                           screen.mimeType.isEmpty() ? ScreenshotEncoder::mimeTypeForFile(screen.filePath)
+                                                     : screen.mimeType);
+        filePart.setHeader(QNetworkRequest::ContentDispositionHeader,
+                          QVariant("form-data; name=\"files\"; filename=\"" + QFileInfo(screen.filePath).fileName() + "\""));
+        filePart.setBody(screen.data);
+        multiPart->append(filePart);
     }
 
-    return logs;
-}
+    QHttpPart metadataPart;
+    metadataPart.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    metadataPart.setHeader(QNetworkRequest::ContentDispositionHeader, QVariant("form-data; name=\"metadata\""));
+    metadataPart.setBody(screenMetadataJson(screens));
+    multiPart->append(metadataPart);
 
-void ApiService::handleActivityResponse() {
-    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) return;
+    QHttpPart userIdPart;
+    userIdPart.setHeader(QNetworkRequest::ContentDispositionHeader, QVariant("form-data; name=\"userId\""));
+    userIdPart.setBody(userId.toUtf8());
+    multiPart->append(userIdPart);
+
+    QHttpPart sessionIdPart;
+    sessionIdPart.setHeader(QNetworkRequest::ContentDispositionHeader, QVariant("form-data; name=\"sessionId\""));
+    sessionIdPart.setBody(sessionId.toUtf8());
+    multiPart->append(sessionIdPart);
 
-    QJsonArray uploadedLogs = reply->property("activityLogs").value<QJsonArray>();
+    QNetworkRequest request = createRequest("/screenshots/batch");
 
-    if (reply->error() == QNetworkReply::NoError) {
-        qDebug() << "Activity logs uploaded successfully";
-        clearUploadedLogs(uploadedLogs);
-        emit activityLogsUploaded(true);
-    } else {
-        qWarning() << "Failed to upload activity logs:" << reply->errorString();
-        emit activityLogsUploaded(false);
+    QNetworkReply *reply = m_networkManager->post(request, multiPart);
+    multiPart->setParent(reply);
+    reply->setProperty("filePaths", filePaths);
+    reply->setProperty("spillData", spillData);
+    reply->setProperty("screenIndices", screenIndices);
+    reply->setProperty("uploadStartTicks", ActivityClock::ticks());
+    reply->setProperty("userId", userId);
+    reply->setProperty("sessionId", sessionId);
+
+    connect(reply, &QNetworkReply::finished, this, &ApiService::handleScreenshotBatchResponse);
+
+    qDebug() << "Uploading" << screens.size() << "screenshots for user:" << userId;
+}
+
+QByteArray ApiService::screenMetadataJson(const QVector<ScreenshotResult>& screens) {
+    QJsonArray array;
+    for (const ScreenshotResult& screen : screens) {
+        QJsonObject object;
+        object["fileName"] = QFileInfo(screen.filePath).fileName();
+        object["screenIndex"] = screen.screen.index;
+        object["screenName"] = screen.screen.name;
+        object["x"] = screen.screen.geometry.x();
+        object["y"] = screen.screen.geometry.y();
+        object["width"] = screen.screen.geometry.width();
+        object["height"] = screen.screen.geometry.height();
+        object["devicePixelRatio"] = screen.screen.devicePixelRatio;
+        object["dpi"] = screen.screen.logicalDpi;
+        object["kind"] = screen.delta.keyframe ? "keyframe" : "delta";
+        object["sequence"] = static_cast<qint64>(screen.delta.sequence);
+        if (!screen.delta.keyframe) {
+            object["baseSequence"] = static_cast<qint64>(screen.delta.baseSequence);
+            object["frameWidth"] = screen.delta.frameSize.width();
+            object["frameHeight"] = screen.delta.frameSize.height();
+            object["tileSize"] = screen.delta.tileSize;
+            object["atlasColumns"] = screen.delta.atlasColumns;
+            QJsonArray tiles;
+            for (const QRect& tile : screen.delta.tiles) {
+                tiles.append(QJsonArray{tile.x(), tile.y(), tile.width(), tile.height()});
+            }
+            object["tiles"] = tiles;
+        }
+        array.append(object);
     }
+    return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
 
-    reply->deleteLater();
+void ApiService::handleActivityUploadFinished(bool success, int uploadedRecords) {
+    if (success) {
+        m_activityRetryAttempts = 0;
+        m_activityRetryTimer->stop();
+    } else {
+        const int delay = m_activityBackoff.delayMSecs(++m_activityRetryAttempts);
+        TT_METRIC_ADD(UploadRetries, 1);
+        qWarning() << "Activity log upload incomplete -" << uploadedRecords
+                   << "entries committed, retrying the rest in" << delay << "ms";
+        m_activityRetryTimer->start(delay);
+    }
+    emit activityLogsUploaded(success);
 }
 
-void ApiService::handleScreenshotResponse() {
+void ApiService::handleScreenshotBatchResponse() {
     QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
 
-    QString filePath = reply->property("filePath").toString();
+    m_requestCompressor.observe(reply);
 
-    if (reply->error() == QNetworkReply::NoError) {
-        qDebug() << "Screenshot uploaded successfully:" << filePath;
+    const QStringList filePaths = reply->property("filePaths").toStringList();
+    const QVariantList spillData = reply->property("spillData").toList();
+    const QVariantList screenIndices = reply->property("screenIndices").toList();
+    const bool success = reply->error() == QNetworkReply::NoError;
+    TT_METRIC_RECORD(ScreenshotUploadMSecs,
+                     Metrics::microsSince(reply->property("uploadStartTicks").toLongLong()) / 1000);
 
-        // Delete local file after successful upload
-        QFile::remove(filePath);
-        emit screenshotUploaded(true, filePath);
+    if (success) {
+        qDebug() << "Uploaded" << filePaths.size() << "screenshots successfully";
+
+        // Deltas whose base frame the server no longer has are dropped there
+        const QJsonArray resync = QJsonDocument::fromJson(reply->readAll()).object()["keyframeRequired"].toArray();
+        for (const QJsonValue& screenIndex : resync) {
+            qDebug() << "Server requested a keyframe for screen" << screenIndex.toInt();
+            emit screenshotKeyframeRequired(screenIndex.toInt());
+        }
     } else {
-        qWarning() << "Failed to upload screenshot:" << reply->errorString();
-        emit screenshotUploaded(false, filePath);
+        qWarning() << "Failed to upload screenshots:" << reply->errorString();
+        for (const QVariant& screenIndex : screenIndices) {
+            emit screenshotKeyframeRequired(screenIndex.toInt());
+        }
+    }
+
+    for (int i = 0; i < filePaths.size(); ++i) {
+        if (!success && i < spillData.size() && spillData.at(i).isValid()
+            && spillScreenshot(spillData.at(i).toByteArray(), filePaths.at(i))) {
+            queueScreenshotFile(filePaths.at(i), reply->property("userId").toString(),
+                                reply->property("sessionId").toString());
+        }
+        emit screenshotUploaded(success, filePaths.at(i));
     }
 
     reply->deleteLater();
 }
 
+bool ApiService::spillScreenshot(const QByteArray& jpegData, const QString& filePath) {
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(jpegData) != jpegData.size() || !file.commit()) {
+        qWarning() << "Failed to spill screenshot to disk:" << filePath;
+        return false;
+    }
+    qDebug() << "Screenshot kept on disk for a later upload:" << filePath;
+    return true;
+}
+
 void ApiService::uploadIdleTime(const IdleAnnotationData& data) {
     QMutexLocker locker(&m_uploadMutex);
 
@@ -206,41 +414,153 @@ void ApiService::uploadIdleTime(const IdleAnnotationData& data) {
     idleSessionJson["isRemoteSession"] = false; // TODO: Detect remote session
     idleSessionJson["activeApplication"] = "TimeTracker"; // TODO: Get actual active application
 
-    QJsonDocument doc(idleSessionJson);
-    QByteArray jsonData = doc.toJson();
+    // Persisted first; sessions recorded while offline go out together once the server is reachable
+    if (m_uploadQueue->enqueue("idletime", idleSessionJson) == 0) {
+        emit idleTimeUploaded(false);
+        return;
+    }
+
+    qDebug() << "Queued idle session - Reason:" << data.reason
+             << "Duration:" << data.durationSeconds << "seconds";
+}
+
+QNetworkReply *ApiService::sendIdleSessions(const QList<UploadJob>& jobs) {
+    QJsonArray sessions;
+    for (const UploadJob& job : jobs) {
+        sessions.append(job.payload);
+    }
 
-    QNetworkRequest request(QUrl(m_baseUrl + "/idletime"));
+    QNetworkRequest request = createRequest("/idletime/batch");
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    request.setRawHeader("User-Agent", "TimeTracker-Client/1.0");
 
-    QNetworkReply *reply = m_networkManager->post(request, jsonData);
-    connect(reply, &QNetworkReply::finished, this, &ApiService::handleIdleTimeResponse);
+    QByteArray body = QJsonDocument(sessions).toJson(QJsonDocument::Compact);
+    m_requestCompressor.prepare(request, body);
 
-    qDebug() << "Uploading idle session - Reason:" << data.reason
-             << "Duration:" << data.durationSeconds << "seconds";
+    qDebug() << "Uploading" << jobs.size() << "idle sessions";
+    QNetworkReply *reply = m_networkManager->post(request, body);
+    // Connected before the queue's handler, so a 415 turns compression off before the retry
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { m_requestCompressor.observe(reply); });
+    return reply;
 }
 
-void ApiService::handleIdleTimeResponse() {
-    // TODO: Implement idle time response handling
-    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) return;
+void ApiService::uploadActivitySummaries(const QVector<ActivityMinuteSummary>& summaries,
+                                         const QString& userId, const QString& sessionId) {
+    if (m_activityUploadPolicy == ActivityUploadPolicy::RawEvents || summaries.isEmpty()) {
+        return;
+    }
 
-    if (reply->error() == QNetworkReply::NoError) {
-        qDebug() << "Idle time uploaded successfully";
-        emit idleTimeUploaded(true);
-    } else {
-        qWarning() << "Failed to upload idle time:" << reply->errorString();
-        emit idleTimeUploaded(false);
+    int queued = 0;
+    for (const ActivityMinuteSummary& summary : summaries) {
+        QJsonObject summaryJson = summary.toJson();
+        summaryJson["userId"] = userId;
+        summaryJson["sessionId"] = sessionId;
+        if (m_uploadQueue->enqueue("summary", summaryJson) != 0) {
+            ++queued;
+        }
     }
 
-    reply->deleteLater();
+    if (queued < summaries.size()) {
+        qWarning() << "Failed to queue" << (summaries.size() - queued) << "activity summaries";
+        emit activitySummariesUploaded(false, static_cast<int>(summaries.size()) - queued);
+    }
 }
 
-void ApiService::clearUploadedLogs(const QJsonArray& uploadedLogs) {
-    // Clear the activity log file after successful upload
-    QFile file("activity_log.txt");
-    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        file.close();
-        qDebug() << "Activity log file cleared after successful upload";
+QNetworkReply *ApiService::sendActivitySummaries(const QList<UploadJob>& jobs) {
+    QJsonArray summaries;
+    for (const UploadJob& job : jobs) {
+        summaries.append(job.payload);
+    }
+
+    QNetworkRequest request = createRequest("/activity/summary");
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+
+    QByteArray body = QJsonDocument(summaries).toJson(QJsonDocument::Compact);
+    m_requestCompressor.prepare(request, body);
+
+    qDebug() << "Uploading" << jobs.size() << "activity minute summaries";
+    QNetworkReply *reply = m_networkManager->post(request, body);
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { m_requestCompressor.observe(reply); });
+    return reply;
+}
+
+void ApiService::uploadTelemetry(const QJsonObject& record, const QString& userId, const QString& sessionId) {
+    QJsonObject payload = record;
+    payload["userId"] = userId;
+    payload["sessionId"] = sessionId;
+
+    QNetworkRequest request = createRequest("/telemetry");
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+
+    QByteArray body = QJsonDocument(payload).toJson(QJsonDocument::Compact);
+    m_requestCompressor.prepare(request, body);
+
+    // Best effort: a lost record is not retried, the next one covers only its own interval
+    QNetworkReply *reply = m_networkManager->post(request, body);
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+        reply->deleteLater();
+        m_requestCompressor.observe(reply);
+        if (reply->error() != QNetworkReply::NoError
+            && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 404) {
+            qWarning() << "Failed to upload telemetry:" << reply->errorString();
+        }
+    });
+}
+
+void ApiService::fetchClientPolicy(const QString& userId) {
+    QNetworkRequest request = createRequest("/client/policy?userId=" + QUrl::toPercentEncoding(userId));
+    QNetworkReply *reply = m_networkManager->get(request);
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+        reply->deleteLater();
+        const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (reply->error() != QNetworkReply::NoError) {
+            // Servers without a policy keep the client on its local configuration
+            if (status != 404) {
+                qWarning() << "Failed to fetch client policy:" << reply->errorString();
+            }
+            return;
+        }
+        if (status == 204) {
+            emit clientPolicyReceived(QJsonObject());
+            return;
+        }
+
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(reply->readAll(), &parseError);
+        if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+            qWarning() << "Ignoring malformed client policy:" << parseError.errorString();
+            return;
+        }
+        emit clientPolicyReceived(document.object());
+    });
+}
+
+void ApiService::handleUploadJobFinished(const UploadJob& job, bool success, bool willRetry) {
+    if (job.kind == "idletime") {
+        if (success) {
+            qDebug() << "Idle time uploaded successfully";
+            emit idleTimeUploaded(true);
+        } else if (!willRetry || job.attempts == 1) {
+            // Reported once; later retries of the same session stay quiet
+            qWarning() << "Failed to upload idle time" << (willRetry ? "- queued for retry" : "- dropped");
+            emit idleTimeUploaded(false);
+        }
+    } else if (job.kind == "summary") {
+        if (!success && !willRetry) {
+            qWarning() << "Activity summary dropped by the server:" << job.payload["minuteStart"].toString();
+            emit activitySummariesUploaded(false, 1);
+        } else if (success) {
+            emit activitySummariesUploaded(true, 1);
+        }
+    } else if (job.kind == "screenshot") {
+        if (success) {
+            qDebug() << "Screenshot uploaded successfully:" << job.filePath;
+            QFile::remove(job.filePath);
+            emit screenshotUploaded(true, job.filePath);
+        } else if (!willRetry) {
+            // Nothing will post the spilled file again
+            qWarning() << "Screenshot dropped by the server:" << job.filePath;
+            QFile::remove(job.filePath);
+            emit screenshotUploaded(false, job.filePath);
+        }
     }
 }
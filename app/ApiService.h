@@ -3,47 +3,120 @@
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
+#include <QSslConfiguration>
 #include <QHttpMultiPart>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QTimer>
 #include <QMutex>
+#include "ActivityAggregator.h"
+#include "RequestCompressor.h"
+#include "ScreenshotPipeline.h"
+#include "UploadQueue.h"
 
-// Forward declaration
+// Forward declarations
 struct IdleAnnotationData;
+class ActivityUploader;
 
 class ApiService : public QObject {
     Q_OBJECT
 
 public:
+    /**
+     * @brief Which form of the activity stream is sent to the server
+     */
+    enum class ActivityUploadPolicy {
+        RawEvents,             ///< Journal entries only
+        Summaries,             ///< Per-minute summaries only; the journal stays on this machine
+        RawEventsAndSummaries  ///< Both
+    };
+
     explicit ApiService(QObject *parent = nullptr);
     ~ApiService();
 
+    UploadQueue *uploadQueue() const { return m_uploadQueue; }
+
+    void setActivityUploadPolicy(ActivityUploadPolicy policy) { m_activityUploadPolicy = policy; }
+    ActivityUploadPolicy activityUploadPolicy() const { return m_activityUploadPolicy; }
+
+    /**
+     * @brief Send every later request to another server
+     *
+     * Queued uploads and the next activity chunk use the new URL; gzip is
+     * negotiated with the new server again.
+     * @param baseUrl URL of the tracking data API
+     */
+    void setBaseUrl(const QString& baseUrl);
+    QString baseUrl() const { return m_baseUrl; }
+
+    /**
+     * @brief Set the user and session the activity journal is uploaded under
+     *
+     * Takes effect from the next activity chunk sent.
+     */
+    void setIdentity(const QString& userId, const QString& sessionId);
+
+    /**
+     * @brief Set how often the activity journal is uploaded; the running period restarts
+     * @param intervalMSecs The interval, at least 1
+     */
+    void setActivityUploadIntervalMSecs(int intervalMSecs);
+    int activityUploadIntervalMSecs() const { return m_uploadTimer->interval(); }
+
+    static const int IDLE_SESSION_BATCH_SIZE = 50;   ///< Idle sessions coalesced into one request
+    static const int SCREENSHOT_UPLOADS_IN_FLIGHT = 2; ///< Queued screenshot files posted at once
+    static const int ACTIVITY_SUMMARY_BATCH_SIZE = 120; ///< Minute summaries coalesced into one request
+    static const int DEFAULT_ACTIVITY_UPLOAD_INTERVAL_MS = 5 * 60 * 1000; ///< Periodic journal upload
+    static const int CONNECTION_WARM_INTERVAL_MS = 60 * 1000; ///< How often the upload connection is re-established if dropped
+
 public slots:
     void uploadActivityLogs();
-    void uploadScreenshot(const QString& filePath, const QString& userId, const QString& sessionId);
+    void uploadScreenshots(const QVector<ScreenshotResult>& screens, const QString& userId, const QString& sessionId);
     void uploadIdleTime(const IdleAnnotationData& data);
+    void uploadActivitySummaries(const QVector<ActivityMinuteSummary>& summaries,
+                                 const QString& userId, const QString& sessionId);
+    void fetchClientPolicy(const QString& userId);
+    void uploadTelemetry(const QJsonObject& record, const QString& userId, const QString& sessionId);
 
 signals:
     void activityLogsUploaded(bool success);
     void screenshotUploaded(bool success, const QString& filePath);
+    void screenshotKeyframeRequired(int screenIndex);
     void idleTimeUploaded(bool success);
+    void activitySummariesUploaded(bool success, int count);
+    void clientPolicyReceived(const QJsonObject& policy);
 
 private slots:
-    void handleActivityResponse();
-    void handleScreenshotResponse();
-    void handleIdleTimeResponse();
+    void warmUpConnection();
+    void handleActivityUploadFinished(bool success, int uploadedRecords);
+    void handleScreenshotBatchResponse();
+    void handleUploadJobFinished(const UploadJob& job, bool success, bool willRetry);
 
 private:
     void setupNetworkManager();
-    QJsonArray readActivityLogs();
-    void clearUploadedLogs(const QJsonArray& uploadedLogs);
+    QNetworkRequest createRequest(const QString& path) const;
+    QNetworkReply *postScreenshot(QHttpPart& filePart, const QString& fileName, const QString& userId,
+                                  const QString& sessionId, QHttpMultiPart *multiPart);
+    QNetworkReply *sendScreenshotFile(const QList<UploadJob>& jobs);
+    QNetworkReply *sendIdleSessions(const QList<UploadJob>& jobs);
+    QNetworkReply *sendActivitySummaries(const QList<UploadJob>& jobs);
+    void queueScreenshotFile(const QString& filePath, const QString& userId, const QString& sessionId);
+    static bool spillScreenshot(const QByteArray& jpegData, const QString& filePath);
+    static QByteArray screenMetadataJson(const QVector<ScreenshotResult>& screens);
     
     QNetworkAccessManager *m_networkManager;
+    QSslConfiguration m_sslConfiguration;  ///< Applied to every request so they share one connection
+    QTimer *m_connectionWarmTimer;
+    ActivityUploader *m_activityUploader;
+    UploadQueue *m_uploadQueue;
+    RequestCompressor m_requestCompressor;  ///< Shared by every JSON upload to m_baseUrl
     QTimer *m_uploadTimer;
+    QTimer *m_activityRetryTimer;          ///< Retries a failed activity upload before the next period
+    RetryBackoff m_activityBackoff;
+    int m_activityRetryAttempts = 0;
+    ActivityUploadPolicy m_activityUploadPolicy = ActivityUploadPolicy::RawEventsAndSummaries;
     QMutex m_uploadMutex;
     
     QString m_baseUrl;
-    QStringList m_pendingUploads;
 };
@@ -0,0 +1,342 @@
+#include "DesktopDuplicationCapture.h"
+#include <QDebug>
+#include <QScreen>
+#include <QSize>
+#include <QVector>
+#include <cstring>
+#include <d3d11.h>
+#include <dxgi1_2.h>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+struct DesktopDuplicationCapture::Output {
+    ComPtr<ID3D11Device> device;
+    ComPtr<ID3D11DeviceContext> context;
+    ComPtr<IDXGIOutputDuplication> duplication;
+    ComPtr<ID3D11Texture2D> staging;      ///< CPU-readable copy target, reused between captures
+    QImage image;                         ///< Last captured frame; only changed areas are rewritten
+    QByteArray metadata;                  ///< Move and dirty rectangle buffer
+};
+
+namespace {
+
+QString failure(const char *what, HRESULT hr)
+{
+    return QString("%1 failed (0x%2)").arg(what).arg(static_cast<quint32>(hr), 8, 16, QChar('0'));
+}
+
+QRect toQRect(const RECT& rect)
+{
+    return QRect(QPoint(rect.left, rect.top), QPoint(rect.right - 1, rect.bottom - 1));
+}
+
+// AcquireNextFrame fails until the previous frame is released
+class FrameReleaser
+{
+public:
+    explicit FrameReleaser(IDXGIOutputDuplication *duplication) : m_duplication(duplication) {}
+    ~FrameReleaser() { m_duplication->ReleaseFrame(); }
+
+private:
+    IDXGIOutputDuplication *m_duplication;
+};
+
+} // namespace
+
+DesktopDuplicationCapture::DesktopDuplicationCapture() = default;
+
+DesktopDuplicationCapture::~DesktopDuplicationCapture() = default;
+
+bool DesktopDuplicationCapture::isSupported()
+{
+    return GetSystemMetrics(SM_REMOTESESSION) == 0;
+}
+
+void DesktopDuplicationCapture::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled) {
+        reset();
+    }
+}
+
+void DesktopDuplicationCapture::reset()
+{
+    m_outputs.clear();
+    m_unsupported.clear();
+}
+
+HMONITOR DesktopDuplicationCapture::monitorForScreen(const QScreen *screen)
+{
+    if (!screen) {
+        return nullptr;
+    }
+    const QRect geometry = screen->geometry();
+    const qreal ratio = screen->devicePixelRatio();
+    const POINT centre{geometry.x() + qRound(geometry.width() * ratio / 2),
+                       geometry.y() + qRound(geometry.height() * ratio / 2)};
+    return MonitorFromPoint(centre, MONITOR_DEFAULTTONULL);
+}
+
+DesktopDuplicationCapture::Status DesktopDuplicationCapture::capture(const QScreen *screen, Frame *frame)
+{
+    if (!m_enabled) {
+        m_errorString = "Desktop Duplication is disabled";
+        return Status::Unavailable;
+    }
+    if (!isSupported()) {
+        m_errorString = "Desktop Duplication is not available in remote sessions";
+        return Status::Unavailable;
+    }
+
+    HMONITOR monitor = monitorForScreen(screen);
+    if (!monitor) {
+        m_errorString = "No monitor found for the screen";
+        return Status::Unavailable;
+    }
+
+    const quintptr key = reinterpret_cast<quintptr>(monitor);
+    if (m_unsupported.contains(key)) {
+        m_errorString = m_unsupported.value(key);
+        return Status::Unavailable;
+    }
+
+    Output *output = m_outputs.value(key).get();
+    if (!output) {
+        output = openOutput(monitor);
+        if (!output) {
+            return Status::Unavailable;
+        }
+    }
+
+    Status status = acquire(*output, frame);
+    if (status == Status::Unavailable && !output->duplication) {
+        // Access was lost to a mode change or desktop switch; a new duplication may work already
+        m_outputs.remove(key);
+        output = openOutput(monitor);
+        if (!output) {
+            return Status::Unavailable;
+        }
+        status = acquire(*output, frame);
+    }
+    return status;
+}
+
+DesktopDuplicationCapture::Output *DesktopDuplicationCapture::openOutput(HMONITOR monitor)
+{
+    const quintptr key = reinterpret_cast<quintptr>(monitor);
+
+    ComPtr<IDXGIFactory1> factory;
+    HRESULT hr = CreateDXGIFactory1(__uuidof(IDXGIFactory1), reinterpret_cast<void**>(factory.GetAddressOf()));
+    if (FAILED(hr)) {
+        m_errorString = failure("CreateDXGIFactory1", hr);
+        return nullptr;
+    }
+
+    // Duplicate on the adapter that drives the monitor, or hybrid laptops refuse it
+    ComPtr<IDXGIAdapter1> adapter;
+    ComPtr<IDXGIOutput> dxgiOutput;
+    DXGI_OUTPUT_DESC outputDesc{};
+    for (UINT a = 0; !dxgiOutput && factory->EnumAdapters1(a, adapter.ReleaseAndGetAddressOf()) != DXGI_ERROR_NOT_FOUND;
+         ++a) {
+        ComPtr<IDXGIOutput> candidate;
+        for (UINT o = 0; adapter->EnumOutputs(o, candidate.ReleaseAndGetAddressOf()) != DXGI_ERROR_NOT_FOUND; ++o) {
+            if (SUCCEEDED(candidate->GetDesc(&outputDesc)) && outputDesc.Monitor == monitor) {
+                dxgiOutput = candidate;
+                break;
+            }
+        }
+    }
+    if (!dxgiOutput) {
+        m_errorString = "No DXGI output drives the monitor";
+        return nullptr;
+    }
+    if (outputDesc.Rotation != DXGI_MODE_ROTATION_IDENTITY && outputDesc.Rotation != DXGI_MODE_ROTATION_UNSPECIFIED) {
+        m_errorString = "Rotated outputs are captured through GDI";
+        return nullptr;
+    }
+
+    ComPtr<IDXGIOutput1> output1;
+    hr = dxgiOutput.As(&output1);
+    if (FAILED(hr)) {
+        m_unsupported.insert(key, "Desktop Duplication requires Windows 8 or later");
+        m_errorString = m_unsupported.value(key);
+        return nullptr;
+    }
+
+    auto output = std::make_shared<Output>();
+    hr = D3D11CreateDevice(adapter.Get(), D3D_DRIVER_TYPE_UNKNOWN, nullptr, 0, nullptr, 0, D3D11_SDK_VERSION,
+                           output->device.GetAddressOf(), nullptr, output->context.GetAddressOf());
+    if (FAILED(hr)) {
+        m_errorString = failure("D3D11CreateDevice", hr);
+        return nullptr;
+    }
+
+    hr = output1->DuplicateOutput(output->device.Get(), output->duplication.GetAddressOf());
+    if (FAILED(hr)) {
+        m_errorString = failure("DuplicateOutput", hr);
+        if (hr == DXGI_ERROR_UNSUPPORTED) {
+            // Not a passing condition like the secure desktop or too many duplications
+            m_unsupported.insert(key, m_errorString);
+            qWarning() << "Desktop Duplication unsupported for monitor" << key << "-" << m_errorString;
+        }
+        return nullptr;
+    }
+
+    m_outputs.insert(key, output);
+    qDebug() << "Desktop Duplication opened for" << QString::fromWCharArray(outputDesc.DeviceName);
+    return output.get();
+}
+
+DesktopDuplicationCapture::Status DesktopDuplicationCapture::acquire(Output& output, Frame *frame)
+{
+    DXGI_OUTDUPL_FRAME_INFO info{};
+    ComPtr<IDXGIResource> resource;
+    const UINT timeout = output.image.isNull() ? FIRST_FRAME_TIMEOUT_MS : 0;
+    HRESULT hr = output.duplication->AcquireNextFrame(timeout, &info, resource.GetAddressOf());
+
+    if (hr == DXGI_ERROR_WAIT_TIMEOUT) {
+        if (output.image.isNull()) {
+            m_errorString = "No initial frame from Desktop Duplication";
+            return Status::Unavailable;
+        }
+        // No update since the last capture; hand out the same image without copying
+        frame->image = output.image;
+        frame->changedRegion = QRegion();
+        return Status::Unchanged;
+    }
+    if (hr == DXGI_ERROR_ACCESS_LOST) {
+        output.duplication.Reset();
+        m_errorString = failure("AcquireNextFrame", hr);
+        return Status::Unavailable;
+    }
+    if (FAILED(hr)) {
+        m_errorString = failure("AcquireNextFrame", hr);
+        return Status::Unavailable;
+    }
+
+    FrameReleaser releaser(output.duplication.Get());
+
+    // The frame's dirty and moved rects are not reported again, so after a failure
+    // from here on the cached image is stale and the next capture copies the whole screen
+    const auto discardFrame = [&](const QString& error) {
+        output.image = QImage();
+        m_errorString = error;
+        return Status::Unavailable;
+    };
+
+    if (info.LastPresentTime.QuadPart == 0 && !output.image.isNull()) {
+        // Only the pointer moved
+        frame->image = output.image;
+        frame->changedRegion = QRegion();
+        return Status::Unchanged;
+    }
+
+    ComPtr<ID3D11Texture2D> texture;
+    hr = resource.As(&texture);
+    if (FAILED(hr)) {
+        return discardFrame(failure("Querying the desktop texture", hr));
+    }
+
+    D3D11_TEXTURE2D_DESC desc{};
+    texture->GetDesc(&desc);
+    if (desc.Format != DXGI_FORMAT_B8G8R8A8_UNORM) {
+        return discardFrame(QString("Unsupported desktop format %1").arg(desc.Format));
+    }
+
+    const QSize size(static_cast<int>(desc.Width), static_cast<int>(desc.Height));
+    const QRect bounds(QPoint(0, 0), size);
+    QRegion changed;
+    bool full = output.image.size() != size;
+
+    if (!full && info.TotalMetadataBufferSize > 0) {
+        output.metadata.resize(static_cast<int>(info.TotalMetadataBufferSize));
+        char *buffer = output.metadata.data();
+
+        // Moved areas change at their destination; uncovered sources are reported as dirty
+        UINT moveBytes = 0;
+        hr = output.duplication->GetFrameMoveRects(info.TotalMetadataBufferSize,
+                                                   reinterpret_cast<DXGI_OUTDUPL_MOVE_RECT*>(buffer), &moveBytes);
+        full = FAILED(hr);
+        const auto *moves = reinterpret_cast<const DXGI_OUTDUPL_MOVE_RECT*>(buffer);
+        for (UINT i = 0; !full && i < moveBytes / sizeof(DXGI_OUTDUPL_MOVE_RECT); ++i) {
+            changed += toQRect(moves[i].DestinationRect);
+        }
+
+        UINT dirtyBytes = 0;
+        if (!full) {
+            hr = output.duplication->GetFrameDirtyRects(info.TotalMetadataBufferSize - moveBytes,
+                                                        reinterpret_cast<RECT*>(buffer + moveBytes), &dirtyBytes);
+            full = FAILED(hr);
+        }
+        const auto *dirty = reinterpret_cast<const RECT*>(buffer + moveBytes);
+        for (UINT i = 0; !full && i < dirtyBytes / sizeof(RECT); ++i) {
+            changed += toQRect(dirty[i]);
+        }
+        changed &= bounds;
+    }
+
+    if (full) {
+        if (output.image.size() != size) {
+            output.image = QImage(size, QImage::Format_RGB32);
+        }
+        changed = bounds;
+    }
+    if (changed.isEmpty()) {
+        frame->image = output.image;
+        frame->changedRegion = QRegion();
+        return Status::Unchanged;
+    }
+
+    if (output.staging) {
+        D3D11_TEXTURE2D_DESC stagingDesc{};
+        output.staging->GetDesc(&stagingDesc);
+        if (stagingDesc.Width != desc.Width || stagingDesc.Height != desc.Height) {
+            output.staging.Reset();
+        }
+    }
+    if (!output.staging) {
+        D3D11_TEXTURE2D_DESC stagingDesc = desc;
+        stagingDesc.Usage = D3D11_USAGE_STAGING;
+        stagingDesc.BindFlags = 0;
+        stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+        stagingDesc.MiscFlags = 0;
+        stagingDesc.MipLevels = 1;
+        stagingDesc.ArraySize = 1;
+        stagingDesc.SampleDesc.Count = 1;
+        stagingDesc.SampleDesc.Quality = 0;
+        hr = output.device->CreateTexture2D(&stagingDesc, nullptr, output.staging.GetAddressOf());
+        if (FAILED(hr)) {
+            return discardFrame(failure("Creating the staging texture", hr));
+        }
+    }
+
+    // Only the changed areas leave the GPU
+    for (const QRect& rect : changed) {
+        const D3D11_BOX box{static_cast<UINT>(rect.left()), static_cast<UINT>(rect.top()), 0,
+                            static_cast<UINT>(rect.right() + 1), static_cast<UINT>(rect.bottom() + 1), 1};
+        output.context->CopySubresourceRegion(output.staging.Get(), 0, box.left, box.top, 0, texture.Get(), 0, &box);
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    hr = output.context->Map(output.staging.Get(), 0, D3D11_MAP_READ, 0, &mapped);
+    if (FAILED(hr)) {
+        return discardFrame(failure("Mapping the staging texture", hr));
+    }
+
+    // Writing detaches the image from frames handed out before, which the delta encoder may still hold
+    const uchar *source = static_cast<const uchar*>(mapped.pData);
+    for (const QRect& rect : changed) {
+        const int bytes = rect.width() * 4;
+        for (int y = rect.top(); y <= rect.bottom(); ++y) {
+            std::memcpy(output.image.scanLine(y) + rect.left() * 4,
+                        source + static_cast<size_t>(y) * mapped.RowPitch + rect.left() * 4, bytes);
+        }
+    }
+    output.context->Unmap(output.staging.Get(), 0);
+
+    frame->image = output.image;
+    frame->changedRegion = changed;
+    return Status::Captured;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QRegion>
+#include <QString>
+#include <memory>
+#include <windows.h>
+
+class QScreen;
+
+/**
+ * @brief The DesktopDuplicationCapture class grabs screens through DXGI Desktop Duplication
+ *
+ * Each monitor gets its own IDXGIOutputDuplication on the adapter that
+ * drives it. Windows accumulates the areas that changed between two
+ * captures, so a capture only copies the dirty and moved rectangles from
+ * the GPU into a persistent QImage, and a screen that did not change at
+ * all costs neither a GPU readback nor a CPU copy. The changed region is
+ * reported with the frame for ScreenshotDeltaEncoder and dedup to use.
+ *
+ * Duplication is not available in remote sessions, on rotated outputs, or
+ * while the secure desktop (UAC, lock screen) is shown; capture() then
+ * returns Status::Unavailable and the caller falls back to QScreen::grabWindow().
+ * A duplication that loses access is recreated on the next capture.
+ *
+ * Not thread-safe; use from the GUI thread like QScreen::grabWindow().
+ */
+class DesktopDuplicationCapture
+{
+public:
+    /**
+     * @brief Outcome of a capture
+     */
+    enum class Status {
+        Captured,     ///< The frame changed; changedRegion lists where
+        Unchanged,    ///< Nothing changed since the previous capture of this screen
+        Unavailable   ///< Duplication cannot be used for this screen right now
+    };
+
+    /**
+     * @brief One captured screen
+     */
+    struct Frame {
+        QImage image;             ///< Whole screen in physical pixels, Format_RGB32
+        QRegion changedRegion;    ///< Dirty and moved areas since the previous capture
+    };
+
+    DesktopDuplicationCapture();
+    ~DesktopDuplicationCapture();
+
+    DesktopDuplicationCapture(const DesktopDuplicationCapture&) = delete;
+    DesktopDuplicationCapture& operator=(const DesktopDuplicationCapture&) = delete;
+
+    /**
+     * @brief Check whether Desktop Duplication can work in this session at all
+     * @return false in remote sessions, where only the GDI path sees the desktop
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Enable or disable duplication; while disabled capture() is always Unavailable
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Check whether duplication is enabled
+     */
+    bool isEnabled() const { return m_enabled; }
+
+    /**
+     * @brief Capture one screen
+     * @param screen The screen to capture
+     * @param frame Receives the image and changed region unless the result is Unavailable
+     * @return The outcome
+     */
+    Status capture(const QScreen *screen, Frame *frame);
+
+    /**
+     * @brief Release every duplication; the next capture of each screen is a full frame
+     */
+    void reset();
+
+    /**
+     * @brief Get the reason for the last Unavailable result
+     */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief Find the monitor a screen is shown on
+     *
+     * Qt keeps a screen's top-left corner in native pixels and scales only
+     * its size, so the native centre is the corner plus half the physical size.
+     */
+    static HMONITOR monitorForScreen(const QScreen *screen);
+
+    static const int FIRST_FRAME_TIMEOUT_MS = 100;  ///< Wait for the initial image of a new duplication
+
+private:
+    struct Output;
+
+    Output *openOutput(HMONITOR monitor);
+    Status acquire(Output& output, Frame *frame);
+
+    bool m_enabled = true;
+    QHash<quintptr, std::shared_ptr<Output>> m_outputs;  ///< Open duplications by HMONITOR
+    QHash<quintptr, QString> m_unsupported;              ///< Monitors that can never be duplicated
+    QString m_errorString;
+};
@@ -0,0 +1,144 @@
+#include "ForegroundWindowTracker.h"
+#include "ActivityClock.h"
+#include <QDebug>
+
+ForegroundWindowTracker* ForegroundWindowTracker::s_instance = nullptr;
+
+ForegroundWindowTracker::ForegroundWindowTracker(QObject *parent)
+    : QObject(parent)
+{
+    m_pollTimer = new QTimer(this);
+    m_pollTimer->setInterval(DEFAULT_POLL_INTERVAL_MS);
+    connect(m_pollTimer, &QTimer::timeout, this, &ForegroundWindowTracker::poll);
+}
+
+ForegroundWindowTracker::~ForegroundWindowTracker()
+{
+    stop();
+}
+
+void ForegroundWindowTracker::start(bool allowHooks)
+{
+    if (m_running) {
+        return;
+    }
+    m_running = true;
+
+    // Only one tracker can own the hook callback
+    if (allowHooks && !s_instance) {
+        s_instance = this;
+        const DWORD flags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+        m_foregroundHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+                                           nullptr, WinEventProc, 0, 0, flags);
+        m_nameChangeHook = SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE,
+                                           nullptr, WinEventProc, 0, 0, flags);
+
+        if (!m_foregroundHook || !m_nameChangeHook) {
+            qWarning() << "Failed to install foreground WinEvent hooks, error" << GetLastError()
+                       << "- falling back to polling";
+            if (m_foregroundHook) {
+                UnhookWinEvent(m_foregroundHook);
+                m_foregroundHook = nullptr;
+            }
+            if (m_nameChangeHook) {
+                UnhookWinEvent(m_nameChangeHook);
+                m_nameChangeHook = nullptr;
+            }
+            s_instance = nullptr;
+        }
+    }
+
+    if (isEventDriven()) {
+        qDebug() << "Foreground tracking is event-driven (WinEvent hooks)";
+    } else {
+        m_pollTimer->start();
+        qDebug() << "Foreground tracking polls every" << m_pollTimer->interval() << "ms";
+    }
+
+    // Report the window that is already in front
+    poll();
+}
+
+void ForegroundWindowTracker::stop()
+{
+    m_pollTimer->stop();
+    if (m_foregroundHook) {
+        UnhookWinEvent(m_foregroundHook);
+        m_foregroundHook = nullptr;
+    }
+    if (m_nameChangeHook) {
+        UnhookWinEvent(m_nameChangeHook);
+        m_nameChangeHook = nullptr;
+    }
+    if (s_instance == this) {
+        s_instance = nullptr;
+    }
+    m_running = false;
+}
+
+void ForegroundWindowTracker::poll()
+{
+    update(GetForegroundWindow(), ActivityClock::msecsSinceEpoch());
+}
+
+void CALLBACK ForegroundWindowTracker::WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject,
+                                                    LONG idChild, DWORD idEventThread, DWORD dwmsEventTime)
+{
+    Q_UNUSED(hook);
+    Q_UNUSED(idEventThread);
+
+    if (!s_instance || idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+        return;
+    }
+    // Title changes matter only for the window that is in front
+    if (event == EVENT_OBJECT_NAMECHANGE && hwnd != s_instance->m_window) {
+        return;
+    }
+
+    // dwmsEventTime is on the GetTickCount() clock; the unsigned difference survives wrap-around
+    const DWORD ageMSecs = GetTickCount() - dwmsEventTime;
+    const qint64 timestamp = ActivityClock::msecsSinceEpoch() - static_cast<qint64>(ageMSecs);
+    s_instance->update(event == EVENT_SYSTEM_FOREGROUND ? hwnd : s_instance->m_window, timestamp);
+}
+
+void ForegroundWindowTracker::update(HWND window, qint64 timestampMSecs)
+{
+    QString windowTitle;
+    QString processName;
+
+    if (window == NULL) {
+        // No foreground window (e.g., desktop focus) - handle gracefully
+        windowTitle = "Desktop/No Active Window";
+        processName = "Desktop";
+    } else {
+        windowTitle = windowTitleOf(window);
+        // The process behind a window never changes, so title updates skip OpenProcess
+        processName = (window == m_window && !m_processName.isEmpty()) ? m_processName : processNameOf(window);
+    }
+
+    m_window = window;
+    if (windowTitle == m_windowTitle && processName == m_processName) {
+        return;
+    }
+
+    m_windowTitle = windowTitle;
+    m_processName = processName;
+    emit foregroundChanged(processName, windowTitle, timestampMSecs);
+}
+
+QString ForegroundWindowTracker::windowTitleOf(HWND window)
+{
+    wchar_t windowTitle[256];
+    int titleLength = GetWindowTextW(window, windowTitle, sizeof(windowTitle) / sizeof(wchar_t));
+    return QString::fromWCharArray(windowTitle, titleLength);
+}
+
+QString ForegroundWindowTracker::processNameOf(HWND window)
+{
+    // Get the process ID from the window handle
+    DWORD processId = 0;
+    GetWindowThreadProcessId(window, &processId);
+
+    ProcessImageInfo info = m_processCache.lookup(processId);
+    return info.valid ? info.name : QString("Unknown");
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <windows.h>
+#include "ProcessNameCache.h"
+
+/**
+ * @brief The ForegroundWindowTracker class reports foreground application changes
+ *
+ * WinEvent hooks for EVENT_SYSTEM_FOREGROUND and EVENT_OBJECT_NAMECHANGE
+ * are registered out of context, so Windows posts the events to this
+ * thread's message loop and nothing runs while the user stays in one
+ * window. Each change is stamped with the event's own time rather than
+ * the time it was processed. If the hooks cannot be installed, the
+ * tracker falls back to polling the foreground window every
+ * pollIntervalMSecs().
+ *
+ * The process name is only looked up when the foreground window itself
+ * changes; a title change of the same window reuses the last name, and
+ * switching between the same few applications is answered by a
+ * ProcessNameCache.
+ */
+class ForegroundWindowTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Construct a new ForegroundWindowTracker object
+     * @param parent The parent QObject
+     */
+    explicit ForegroundWindowTracker(QObject *parent = nullptr);
+
+    /**
+     * @brief Destroy the ForegroundWindowTracker object, removing its hooks
+     */
+    ~ForegroundWindowTracker();
+
+    /**
+     * @brief Start tracking and report the current foreground window
+     * @param allowHooks false to force the polling fallback
+     */
+    void start(bool allowHooks = true);
+
+    /**
+     * @brief Stop tracking
+     */
+    void stop();
+
+    /**
+     * @brief Check whether the tracker is running
+     */
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief Check whether changes are event-driven (false while polling)
+     */
+    bool isEventDriven() const { return m_foregroundHook != nullptr; }
+
+    /**
+     * @brief Get the polling interval used by the fallback
+     */
+    int pollIntervalMSecs() const { return m_pollTimer->interval(); }
+
+    /**
+     * @brief Set the polling interval used by the fallback; a running poll restarts at it
+     * @param intervalMSecs The interval, at least 1
+     */
+    void setPollIntervalMSecs(int intervalMSecs) { m_pollTimer->setInterval(qMax(1, intervalMSecs)); }
+
+    /**
+     * @brief Re-read the foreground window and report it if it changed
+     *
+     * Called by the fallback timer; also safe to call at any time.
+     */
+    void poll();
+
+    /**
+     * @brief Get the executable name of the last reported foreground process
+     */
+    QString processName() const { return m_processName; }
+
+    /**
+     * @brief Get the title of the last reported foreground window
+     */
+    QString windowTitle() const { return m_windowTitle; }
+
+    /**
+     * @brief Get the cache used to resolve process names
+     */
+    const ProcessNameCache& processNameCache() const { return m_processCache; }
+
+    static const int DEFAULT_POLL_INTERVAL_MS = 5000;  ///< Fallback polling interval
+
+signals:
+    /**
+     * @brief Emitted when the foreground process or window title changes
+     * @param processName Executable name of the foreground process
+     * @param windowTitle Title of the foreground window
+     * @param timestampMSecs When the change happened, UTC milliseconds since epoch
+     */
+    void foregroundChanged(const QString& processName, const QString& windowTitle, qint64 timestampMSecs);
+
+private:
+    static void CALLBACK WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject,
+                                      LONG idChild, DWORD idEventThread, DWORD dwmsEventTime);
+    static ForegroundWindowTracker* s_instance;
+
+    void update(HWND window, qint64 timestampMSecs);
+    static QString windowTitleOf(HWND window);
+    QString processNameOf(HWND window);
+
+    HWINEVENTHOOK m_foregroundHook = nullptr;
+    HWINEVENTHOOK m_nameChangeHook = nullptr;
+    QTimer *m_pollTimer = nullptr;
+    bool m_running = false;
+    ProcessNameCache m_processCache;
+
+    HWND m_window = nullptr;       ///< Last reported foreground window
+    QString m_processName;
+    QString m_windowTitle;
+};
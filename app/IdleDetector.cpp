@@ -1,11 +1,26 @@
 #include "IdleDetector.h"
+#include "ActivityClock.h"
+#include "Metrics.h"
 #include <QDebug>
 #include <QMutexLocker>
+#include <windows.h>
+
+namespace {
+
+// Convert a GetLastInputInfo() time to ActivityClock ticks
+qint64 inputTimeToTicks(DWORD inputTime)
+{
+    // dwTime is on the GetTickCount() clock; the unsigned difference survives wrap-around
+    const DWORD ageMSecs = GetTickCount() - inputTime;
+    return ActivityClock::ticks() - ActivityClock::msecsToTicks(ageMSecs);
+}
+
+} // namespace
 
 IdleDetector::IdleDetector(QObject *parent)
     : QObject(parent)
     , m_checkTimer(new QTimer(this))
-    , m_lastActivityTime(QDateTime::currentDateTime())
+    , m_lastActivityTicks(ActivityClock::ticks())
     , m_isCurrentlyIdle(false)
     , m_idleThresholdSeconds(300) // Default: 5 minutes
 {
@@ -26,12 +41,23 @@ void IdleDetector::start()
 {
     QMutexLocker locker(&m_mutex);
     
-    if (!m_checkTimer->isActive()) {
-        m_lastActivityTime = QDateTime::currentDateTime();
-        m_isCurrentlyIdle = false;
-        m_checkTimer->start();
-        
-        qDebug() << "IdleDetector started with" << CHECK_INTERVAL_MS << "ms check interval";
+    if (!m_running) {
+        m_running = true;
+        m_lastActivityTicks.store(ActivityClock::ticks(), std::memory_order_relaxed);
+        m_isCurrentlyIdle.store(false);
+
+        if (m_activitySource == ActivitySource::SystemLastInput) {
+            m_checkTimer->setSingleShot(true);
+            m_lastSystemInputTime = 0;
+            locker.unlock();
+            syncSystemLastInput();
+            scheduleNextCheck();
+            qDebug() << "IdleDetector started with GetLastInputInfo deadline checks";
+        } else {
+            m_checkTimer->setSingleShot(false);
+            m_checkTimer->start(CHECK_INTERVAL_MS);
+            qDebug() << "IdleDetector started with" << CHECK_INTERVAL_MS << "ms check interval";
+        }
     }
 }
 
@@ -39,13 +65,14 @@ void IdleDetector::stop()
 {
     QMutexLocker locker(&m_mutex);
     
-    if (m_checkTimer->isActive()) {
+    if (m_running) {
+        m_running = false;
         m_checkTimer->stop();
         
         // If we were idle when stopping, emit idle ended signal
-        if (m_isCurrentlyIdle) {
-            int totalIdleDuration = m_idleStartTime.secsTo(QDateTime::currentDateTime());
-            m_isCurrentlyIdle = false;
+        if (m_isCurrentlyIdle.load()) {
+            int totalIdleDuration = secondsSince(m_idleStartTicks);
+            m_isCurrentlyIdle.store(false);
             
             // Emit signal outside of mutex lock
             locker.unlock();
@@ -60,13 +87,33 @@ void IdleDetector::stop()
 bool IdleDetector::isRunning() const
 {
     QMutexLocker locker(&m_mutex);
-    return m_checkTimer->isActive();
+    return m_running;
 }
 
-bool IdleDetector::isIdle() const
+void IdleDetector::setActivitySource(ActivitySource source)
 {
     QMutexLocker locker(&m_mutex);
-    return m_isCurrentlyIdle;
+    if (m_running) {
+        qWarning() << "IdleDetector activity source can only be changed while stopped";
+        return;
+    }
+    m_activitySource = source;
+}
+
+IdleDetector::ActivitySource IdleDetector::activitySource() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_activitySource;
+}
+
+int IdleDetector::nextCheckIntervalMSecs() const
+{
+    return m_checkTimer->isActive() ? m_checkTimer->interval() : -1;
+}
+
+bool IdleDetector::isIdle() const
+{
+    return m_isCurrentlyIdle.load();
 }
 
 int IdleDetector::getIdleThresholdSeconds() const
@@ -82,6 +129,12 @@ void IdleDetector::setIdleThresholdSeconds(int seconds)
     if (seconds > 0) {
         m_idleThresholdSeconds = seconds;
         qDebug() << "IdleDetector threshold set to:" << seconds << "seconds";
+
+        // The pending deadline was computed for the old threshold
+        if (m_running && m_activitySource == ActivitySource::SystemLastInput) {
+            locker.unlock();
+            scheduleNextCheck();
+        }
     } else {
         qWarning() << "Invalid idle threshold:" << seconds << "- must be positive";
     }
@@ -89,43 +142,42 @@ void IdleDetector::setIdleThresholdSeconds(int seconds)
 
 QDateTime IdleDetector::getLastActivityTime() const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_lastActivityTime;
+    return ActivityClock::toDateTime(m_lastActivityTicks.load(std::memory_order_relaxed));
 }
 
 int IdleDetector::getIdleDurationSeconds() const
 {
     QMutexLocker locker(&m_mutex);
     
-    if (!m_isCurrentlyIdle) {
+    if (!m_isCurrentlyIdle.load()) {
         return 0;
     }
     
-    return m_idleStartTime.secsTo(QDateTime::currentDateTime());
+    return secondsSince(m_idleStartTicks);
 }
 
 void IdleDetector::updateLastActivityTime()
 {
+    const qint64 now = ActivityClock::ticks();
+    m_lastActivityTicks.store(now, std::memory_order_relaxed);
+
+    // Hot path: nothing else to do while the user is active
+    if (!m_isCurrentlyIdle.load()) {
+        return;
+    }
+
     QMutexLocker locker(&m_mutex);
-    
-    QDateTime now = QDateTime::currentDateTime();
-    bool wasIdle = m_isCurrentlyIdle;
-    int totalIdleDuration = 0;
-    
-    if (wasIdle) {
-        totalIdleDuration = m_idleStartTime.secsTo(now);
-        m_isCurrentlyIdle = false;
-        
-        qDebug() << "Activity detected - ending idle state after" << totalIdleDuration << "seconds";
+    if (!m_isCurrentlyIdle.load()) {
+        return; // Another caller ended the idle period first
     }
-    
-    m_lastActivityTime = now;
-    
+
+    int totalIdleDuration = static_cast<int>(ActivityClock::ticksToMSecs(now - m_idleStartTicks) / 1000);
+    m_isCurrentlyIdle.store(false);
+    qDebug() << "Activity detected - ending idle state after" << totalIdleDuration << "seconds";
+
     // Emit signal outside of mutex lock
-    if (wasIdle) {
-        locker.unlock();
-        emit idleEnded(totalIdleDuration);
-    }
+    locker.unlock();
+    emit idleEnded(totalIdleDuration);
 }
 
 void IdleDetector::triggerIdleCheck()
@@ -135,15 +187,45 @@ void IdleDetector::triggerIdleCheck()
 
 void IdleDetector::checkIdleState()
 {
+    TT_METRIC_ADD(IdleWakeups, 1);
+
+    const bool deadlineMode = activitySource() == ActivitySource::SystemLastInput;
+    if (deadlineMode) {
+        syncSystemLastInput();
+        if (m_isCurrentlyIdle.load()) {
+            endIdleIfActive();
+        }
+    }
+
+    enterIdleIfInactive();
+
+    if (deadlineMode && isRunning()) {
+        scheduleNextCheck();
+    }
+}
+
+void IdleDetector::enterIdleIfInactive()
+{
+    if (m_isCurrentlyIdle.load()) {
+        return;
+    }
+
     QMutexLocker locker(&m_mutex);
-    
-    QDateTime now = QDateTime::currentDateTime();
-    int secondsSinceLastActivity = m_lastActivityTime.secsTo(now);
+
+    const qint64 lastActivityTicks = m_lastActivityTicks.load(std::memory_order_relaxed);
+    int secondsSinceLastActivity = secondsSince(lastActivityTicks);
     
     // Check if we should enter idle state
-    if (!m_isCurrentlyIdle && secondsSinceLastActivity >= m_idleThresholdSeconds) {
-        m_isCurrentlyIdle = true;
-        m_idleStartTime = m_lastActivityTime.addSecs(m_idleThresholdSeconds);
+    if (!m_isCurrentlyIdle.load() && secondsSinceLastActivity >= m_idleThresholdSeconds) {
+        m_idleStartTicks = lastActivityTicks + ActivityClock::msecsToTicks(m_idleThresholdSeconds * 1000LL);
+        m_idleActivityTicks = lastActivityTicks;
+        m_isCurrentlyIdle.store(true);
+
+        // Activity that raced with the transition cancels it; anything later ends it on the next event
+        if (m_lastActivityTicks.load(std::memory_order_relaxed) != lastActivityTicks) {
+            m_isCurrentlyIdle.store(false);
+            return;
+        }
         
         qDebug() << "User entered idle state after" << m_idleThresholdSeconds << "seconds of inactivity";
         
@@ -152,3 +234,60 @@ void IdleDetector::checkIdleState()
         emit idleStarted(m_idleThresholdSeconds);
     }
 }
+
+void IdleDetector::endIdleIfActive()
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 lastActivityTicks = m_lastActivityTicks.load(std::memory_order_relaxed);
+    if (!m_isCurrentlyIdle.load() || lastActivityTicks == m_idleActivityTicks) {
+        return;
+    }
+
+    int totalIdleDuration = static_cast<int>(ActivityClock::ticksToMSecs(lastActivityTicks - m_idleStartTicks) / 1000);
+    m_isCurrentlyIdle.store(false);
+    qDebug() << "System input detected - ending idle state after" << totalIdleDuration << "seconds";
+
+    locker.unlock();
+    emit idleEnded(totalIdleDuration);
+}
+
+void IdleDetector::scheduleNextCheck()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_running) {
+        return;
+    }
+
+    // While idle only a resume can happen next, so poll briefly;
+    // otherwise nothing can change before the threshold is reached
+    int intervalMSecs = RESUME_POLL_INTERVAL_MS;
+    if (!m_isCurrentlyIdle.load()) {
+        const qint64 elapsedMSecs = ActivityClock::ticksToMSecs(
+            ActivityClock::ticks() - m_lastActivityTicks.load(std::memory_order_relaxed));
+        const qint64 remainingMSecs = m_idleThresholdSeconds * 1000LL - elapsedMSecs;
+        intervalMSecs = static_cast<int>(qBound<qint64>(0, remainingMSecs, m_idleThresholdSeconds * 1000LL));
+    }
+    m_checkTimer->start(intervalMSecs);
+}
+
+void IdleDetector::syncSystemLastInput()
+{
+    LASTINPUTINFO info;
+    info.cbSize = sizeof(info);
+    if (!GetLastInputInfo(&info) || info.dwTime == m_lastSystemInputTime) {
+        return;
+    }
+    m_lastSystemInputTime = info.dwTime;
+
+    // Hooks may have seen newer activity than the system reports; keep the latest
+    const qint64 systemTicks = inputTimeToTicks(info.dwTime);
+    qint64 current = m_lastActivityTicks.load(std::memory_order_relaxed);
+    while (systemTicks > current
+           && !m_lastActivityTicks.compare_exchange_weak(current, systemTicks, std::memory_order_relaxed)) {
+    }
+}
+
+int IdleDetector::secondsSince(qint64 ticks)
+{
+    return static_cast<int>(ActivityClock::ticksToMSecs(ActivityClock::ticks() - ticks) / 1000);
+}
@@ -4,18 +4,42 @@
 #include <QTimer>
 #include <QDateTime>
 #include <QMutex>
+#include <atomic>
+#include <windows.h>
 
 /**
  * @brief The IdleDetector class provides idle time detection functionality
  * 
  * This class monitors user activity and detects when the user has been idle
  * for a configurable amount of time. It emits signals when idle state changes.
+ * Durations are measured on the monotonic ActivityClock, so adjusting the
+ * system clock neither starts nor extends an idle period.
+ *
+ * With ActivitySource::Hooks the detector relies on updateLastActivityTime()
+ * and checks every CHECK_INTERVAL_MS. With ActivitySource::SystemLastInput,
+ * GetLastInputInfo() is the source of truth as well: a single-shot timer
+ * is armed for the moment the threshold could first be crossed and re-armed
+ * from there, and only while idle is it polled every
+ * RESUME_POLL_INTERVAL_MS to notice a resume the hooks did not report.
+ *
+ * updateLastActivityTime() is called from the input hooks on every event.
+ * While the user is active it only performs a relaxed atomic store of the
+ * current ticks; the mutex guards the idle state machine and is only taken
+ * by the hooks on the first event after an idle period.
  */
 class IdleDetector : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * @brief Where user activity is learned from
+     */
+    enum class ActivitySource {
+        Hooks,           ///< Only updateLastActivityTime(), checked every CHECK_INTERVAL_MS
+        SystemLastInput  ///< GetLastInputInfo() and updateLastActivityTime(), checked at the idle deadline
+    };
+
     /**
      * @brief Construct a new IdleDetector object
      * @param parent The parent QObject
@@ -43,6 +67,23 @@ public:
      */
     bool isRunning() const;
 
+    /**
+     * @brief Choose where user activity is learned from; only while stopped
+     * @param source The activity source, ActivitySource::Hooks by default
+     */
+    void setActivitySource(ActivitySource source);
+
+    /**
+     * @brief Get the activity source
+     */
+    ActivitySource activitySource() const;
+
+    /**
+     * @brief Get the delay until the next scheduled idle check
+     * @return The delay in milliseconds, or -1 if no check is scheduled
+     */
+    int nextCheckIntervalMSecs() const;
+
     /**
      * @brief Check if the user is currently idle
      * @return true if idle, false otherwise
@@ -76,7 +117,9 @@ public:
 public slots:
     /**
      * @brief Update the last activity time to the current time
-     * This should be called whenever user activity is detected
+     * This should be called whenever user activity is detected. Wait-free
+     * unless it ends an idle period, in which case idleEnded() is emitted
+     * before it returns.
      */
     void updateLastActivityTime();
 
@@ -106,12 +149,23 @@ private slots:
     void checkIdleState();
 
 private:
+    void enterIdleIfInactive();
+    void endIdleIfActive();
+    void scheduleNextCheck();
+    void syncSystemLastInput();
+    static int secondsSince(qint64 ticks);
+
     QTimer *m_checkTimer;           ///< Timer for periodic idle state checks
-    QDateTime m_lastActivityTime;   ///< Timestamp of last user activity
-    QDateTime m_idleStartTime;      ///< Timestamp when idle state started
-    bool m_isCurrentlyIdle;         ///< Current idle state
+    std::atomic<qint64> m_lastActivityTicks; ///< ActivityClock ticks of last user activity, written by the hooks
+    std::atomic<bool> m_isCurrentlyIdle;     ///< Current idle state, only changed with m_mutex held
+    qint64 m_idleStartTicks = 0;    ///< ActivityClock ticks when idle state started
+    qint64 m_idleActivityTicks = 0; ///< Last activity ticks at the time idle state started
+    DWORD m_lastSystemInputTime = 0; ///< Last GetLastInputInfo() dwTime seen, timer thread only
+    bool m_running = false;         ///< Whether start() was called
+    ActivitySource m_activitySource = ActivitySource::Hooks;
     int m_idleThresholdSeconds;     ///< Idle threshold in seconds
-    mutable QMutex m_mutex;         ///< Mutex for thread safety
+    mutable QMutex m_mutex;         ///< Protects the idle state transitions, threshold and start time
 
     static const int CHECK_INTERVAL_MS = 1000; ///< Check interval in milliseconds (1 second)
+    static const int RESUME_POLL_INTERVAL_MS = 1000; ///< Resume poll interval while idle with SystemLastInput
 };
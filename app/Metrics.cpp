@@ -0,0 +1,189 @@
+#include "Metrics.h"
+#include <cmath>
+
+namespace Metrics {
+namespace detail {
+
+// Zero-initialized before any constructor runs, so hooks may record at any time
+std::atomic<bool> g_enabled{true};
+CounterSlot g_counters[COUNTER_COUNT];
+std::atomic<qint64> g_gauges[GAUGE_COUNT];
+HistogramSlot g_histograms[HISTOGRAM_COUNT];
+
+} // namespace detail
+} // namespace Metrics
+
+namespace {
+
+quint64 bucketUpperBound(int bucket)
+{
+    return bucket == 0 ? 0 : (quint64(1) << bucket) - 1;
+}
+
+} // namespace
+
+quint64 Metrics::HistogramSnapshot::percentile(double fraction) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    const quint64 rank = qMax<quint64>(1, static_cast<quint64>(std::ceil(qBound(0.0, fraction, 1.0) * count)));
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            return bucketUpperBound(bucket);
+        }
+    }
+    return bucketUpperBound(HISTOGRAM_BUCKETS - 1);
+}
+
+Metrics::Snapshot Metrics::Snapshot::since(const Snapshot& earlier) const
+{
+    Snapshot result = *this;
+    result.intervalTicks = ticks - earlier.ticks;
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        result.counters[i] = counters[i] >= earlier.counters[i] ? counters[i] - earlier.counters[i] : counters[i];
+    }
+    for (int i = 0; i < HISTOGRAM_COUNT; ++i) {
+        HistogramSnapshot& histogram = result.histograms[i];
+        const HistogramSnapshot& before = earlier.histograms[i];
+        if (histogram.count < before.count) {
+            // Reset in between; the totals are all there is
+            continue;
+        }
+        histogram.count = 0;
+        histogram.sum -= qMin(histogram.sum, before.sum);
+        for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+            histogram.buckets[bucket] -= qMin(histogram.buckets[bucket], before.buckets[bucket]);
+            histogram.count += histogram.buckets[bucket];
+        }
+    }
+    return result;
+}
+
+QJsonObject Metrics::Snapshot::toJson() const
+{
+    QJsonObject counterValues;
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        counterValues[name(static_cast<Counter>(i))] = static_cast<qint64>(counters[i]);
+    }
+
+    QJsonObject gaugeValues;
+    for (int i = 0; i < GAUGE_COUNT; ++i) {
+        gaugeValues[name(static_cast<Gauge>(i))] = gauges[i];
+    }
+
+    QJsonObject histogramValues;
+    for (int i = 0; i < HISTOGRAM_COUNT; ++i) {
+        const HistogramSnapshot& histogram = histograms[i];
+        QJsonObject summary;
+        summary["count"] = static_cast<qint64>(histogram.count);
+        if (histogram.count > 0) {
+            summary["sum"] = static_cast<qint64>(histogram.sum);
+            summary["p50"] = static_cast<qint64>(histogram.percentile(0.50));
+            summary["p95"] = static_cast<qint64>(histogram.percentile(0.95));
+            summary["p99"] = static_cast<qint64>(histogram.percentile(0.99));
+            summary["max"] = static_cast<qint64>(histogram.percentile(1.0));
+        }
+        histogramValues[name(static_cast<Histogram>(i))] = summary;
+    }
+
+    QJsonObject object;
+    object["counters"] = counterValues;
+    object["gauges"] = gaugeValues;
+    object["histograms"] = histogramValues;
+    if (intervalTicks > 0) {
+        const qint64 intervalMSecs = ActivityClock::ticksToMSecs(intervalTicks);
+        object["intervalMs"] = intervalMSecs;
+        if (intervalMSecs > 0) {
+            object["hookEventsPerSecond"] = static_cast<double>(counter(Counter::HookEvents)) * 1000.0 / intervalMSecs;
+        }
+    }
+    return object;
+}
+
+const char *Metrics::name(Counter id)
+{
+    switch (id) {
+        case Counter::HookEvents: return "hookEvents";
+        case Counter::HookCallbacksOverBudget: return "hookCallbacksOverBudget";
+        case Counter::RingBufferDrops: return "ringBufferDrops";
+        case Counter::ConsumerDrops: return "consumerDrops";
+        case Counter::JournalBytesWritten: return "journalBytesWritten";
+        case Counter::ScreenshotsCaptured: return "screenshotsCaptured";
+        case Counter::ScreenshotsUnchanged: return "screenshotsUnchanged";
+        case Counter::ScreenshotBytesEncoded: return "screenshotBytesEncoded";
+        case Counter::UploadRetries: return "uploadRetries";
+        case Counter::IdleWakeups: return "idleWakeups";
+        case Counter::Count: break;
+    }
+    return "unknown";
+}
+
+const char *Metrics::name(Gauge id)
+{
+    switch (id) {
+        case Gauge::UploadQueueDepth: return "uploadQueueDepth";
+        case Gauge::HookTimeoutMSecs: return "hookTimeoutMs";
+        case Gauge::Count: break;
+    }
+    return "unknown";
+}
+
+const char *Metrics::name(Histogram id)
+{
+    switch (id) {
+        case Histogram::HookLatencyMicros: return "hookLatencyUs";
+        case Histogram::ScreenshotGrabMicros: return "screenshotGrabUs";
+        case Histogram::ScreenshotEncodeMicros: return "screenshotEncodeUs";
+        case Histogram::ScreenshotUploadMSecs: return "screenshotUploadMs";
+        case Histogram::Count: break;
+    }
+    return "unknown";
+}
+
+void Metrics::setEnabled(bool enabled)
+{
+    detail::g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+Metrics::Snapshot Metrics::snapshot()
+{
+    Snapshot result;
+    result.ticks = ActivityClock::ticks();
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        result.counters[i] = detail::g_counters[i].value.load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < GAUGE_COUNT; ++i) {
+        result.gauges[i] = detail::g_gauges[i].load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < HISTOGRAM_COUNT; ++i) {
+        const detail::HistogramSlot& slot = detail::g_histograms[i];
+        HistogramSnapshot& histogram = result.histograms[i];
+        for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+            histogram.buckets[bucket] = slot.buckets[bucket].load(std::memory_order_relaxed);
+            histogram.count += histogram.buckets[bucket];
+        }
+        histogram.sum = slot.sum.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void Metrics::reset()
+{
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        detail::g_counters[i].value.store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < GAUGE_COUNT; ++i) {
+        detail::g_gauges[i].store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < HISTOGRAM_COUNT; ++i) {
+        detail::HistogramSlot& slot = detail::g_histograms[i];
+        for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+            slot.buckets[bucket].store(0, std::memory_order_relaxed);
+        }
+        slot.sum.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QtAlgorithms>
+#include <QtGlobal>
+#include <atomic>
+#include "ActivityClock.h"
+
+/**
+ * @file Metrics.h
+ * @brief Process-wide counters, gauges and histograms for the client's hot paths
+ *
+ * Every metric is a fixed slot in a static array, so recording one is a
+ * relaxed atomic add with no lookup, lock or allocation, and is safe on
+ * the hook thread. Histograms use power-of-two buckets, which keeps a
+ * sample to one bucket increment while still giving usable percentiles.
+ *
+ * Recording goes through the TT_METRIC_* macros. Building with
+ * TIMETRACKER_METRICS=0 compiles them out entirely; otherwise they cost
+ * one relaxed load while metrics are switched off with setEnabled().
+ *
+ * Snapshots are read without stopping the writers, so a snapshot taken
+ * during a burst may be a few samples inconsistent across metrics.
+ */
+
+#ifndef TIMETRACKER_METRICS
+#define TIMETRACKER_METRICS 1
+#endif
+
+namespace Metrics {
+
+/**
+ * @brief Monotonic counters
+ */
+enum class Counter {
+    HookEvents,               ///< Input events seen by the low-level hooks
+    HookCallbacksOverBudget,  ///< Hook callbacks slower than LowLevelHooksTimeout / HOOK_BUDGET_DIVISOR
+    RingBufferDrops,          ///< Input events lost to a full ring buffer (bus or journal writer)
+    ConsumerDrops,            ///< Events an event bus consumer lost to backpressure
+    JournalBytesWritten,      ///< Bytes appended to the activity journal
+    ScreenshotsCaptured,      ///< Screens captured and handed to the encoders
+    ScreenshotsUnchanged,     ///< Screens skipped because they had not changed
+    ScreenshotBytesEncoded,   ///< Encoded screenshot bytes
+    UploadRetries,            ///< Failed uploads scheduled for another attempt
+    IdleWakeups,              ///< Idle detector checks
+    Count
+};
+
+/**
+ * @brief Values that go up and down
+ */
+enum class Gauge {
+    UploadQueueDepth,         ///< Jobs in the durable upload queue
+    HookTimeoutMSecs,         ///< The system's LowLevelHooksTimeout
+    Count
+};
+
+/**
+ * @brief Latency distributions
+ */
+enum class Histogram {
+    HookLatencyMicros,        ///< Time spent in a hook callback before CallNextHookEx
+    ScreenshotGrabMicros,     ///< Capturing one screen on the GUI thread
+    ScreenshotEncodeMicros,   ///< Encoding one screen on a pipeline thread
+    ScreenshotUploadMSecs,    ///< Posting a screenshot request until its reply
+    Count
+};
+
+const int COUNTER_COUNT = static_cast<int>(Counter::Count);
+const int GAUGE_COUNT = static_cast<int>(Gauge::Count);
+const int HISTOGRAM_COUNT = static_cast<int>(Histogram::Count);
+const int HISTOGRAM_BUCKETS = 32;   ///< Bucket 0 holds 0, bucket i holds [2^(i-1), 2^i), the last one the rest
+const int HOOK_BUDGET_DIVISOR = 10; ///< A hook callback should stay under a tenth of LowLevelHooksTimeout
+
+/**
+ * @brief Counts of one histogram at a point in time
+ */
+struct HistogramSnapshot {
+    quint64 buckets[HISTOGRAM_BUCKETS] = {};
+    quint64 count = 0;
+    quint64 sum = 0;
+
+    /**
+     * @brief Get an upper bound of a percentile
+     * @param fraction The percentile as 0..1
+     * @return The upper end of the bucket the percentile falls in, 0 if empty
+     */
+    quint64 percentile(double fraction) const;
+};
+
+/**
+ * @brief Every metric at a point in time
+ */
+struct Snapshot {
+    qint64 ticks = 0;          ///< ActivityClock ticks when taken
+    qint64 intervalTicks = 0;  ///< Span covered by a since() difference, 0 for totals
+    quint64 counters[COUNTER_COUNT] = {};
+    qint64 gauges[GAUGE_COUNT] = {};
+    HistogramSnapshot histograms[HISTOGRAM_COUNT];
+
+    quint64 counter(Counter id) const { return counters[static_cast<int>(id)]; }
+    qint64 gauge(Gauge id) const { return gauges[static_cast<int>(id)]; }
+    const HistogramSnapshot& histogram(Histogram id) const { return histograms[static_cast<int>(id)]; }
+
+    /**
+     * @brief Get what happened between an earlier snapshot and this one
+     *
+     * Counters and histograms are differences; gauges keep this snapshot's values.
+     */
+    Snapshot since(const Snapshot& earlier) const;
+
+    /**
+     * @brief Convert to compact JSON
+     *
+     * Histograms are reduced to count, sum, p50, p95, p99 and max. A
+     * difference also carries its interval and the input event rate.
+     */
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief Get the name a metric is reported under
+ */
+const char *name(Counter id);
+const char *name(Gauge id);
+const char *name(Histogram id);
+
+namespace detail {
+
+struct alignas(64) CounterSlot {
+    std::atomic<quint64> value;
+};
+
+struct alignas(64) HistogramSlot {
+    std::atomic<quint64> buckets[HISTOGRAM_BUCKETS];  ///< The sample count is their total
+    std::atomic<quint64> sum;
+};
+
+extern std::atomic<bool> g_enabled;
+extern CounterSlot g_counters[COUNTER_COUNT];
+extern std::atomic<qint64> g_gauges[GAUGE_COUNT];
+extern HistogramSlot g_histograms[HISTOGRAM_COUNT];
+
+inline int bucketOf(quint64 value)
+{
+    if (value == 0) {
+        return 0;
+    }
+    const int bits = 64 - qCountLeadingZeroBits(value);
+    return bits < HISTOGRAM_BUCKETS ? bits : HISTOGRAM_BUCKETS - 1;
+}
+
+} // namespace detail
+
+/**
+ * @brief Check whether metrics are being recorded
+ */
+inline bool isEnabled()
+{
+    return detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Switch recording on or off; values recorded so far are kept
+ */
+void setEnabled(bool enabled);
+
+/**
+ * @brief Add to a counter
+ */
+inline void add(Counter id, quint64 amount = 1)
+{
+    detail::g_counters[static_cast<int>(id)].value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Set a gauge
+ */
+inline void set(Gauge id, qint64 value)
+{
+    detail::g_gauges[static_cast<int>(id)].store(value, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Record one histogram sample
+ */
+inline void record(Histogram id, quint64 value)
+{
+    detail::HistogramSlot& slot = detail::g_histograms[static_cast<int>(id)];
+    slot.buckets[detail::bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    slot.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the microseconds since an ActivityClock::ticks() value
+ */
+inline quint64 microsSince(qint64 startTicks)
+{
+    const qint64 elapsed = ActivityClock::ticks() - startTicks;
+    return elapsed > 0 ? static_cast<quint64>(elapsed) * 1000000 / static_cast<quint64>(ActivityClock::frequency()) : 0;
+}
+
+/**
+ * @brief Read every metric
+ */
+Snapshot snapshot();
+
+/**
+ * @brief Zero every metric (for tests)
+ */
+void reset();
+
+/**
+ * @brief Records the lifetime of a scope into a microsecond histogram
+ */
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(Histogram id) : m_id(id), m_startTicks(isEnabled() ? ActivityClock::ticks() : 0) {}
+    ~ScopedTimer()
+    {
+        if (m_startTicks != 0) {
+            record(m_id, microsSince(m_startTicks));
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram m_id;
+    qint64 m_startTicks;
+};
+
+} // namespace Metrics
+
+#define TT_METRIC_CONCAT_(a, b) a##b
+#define TT_METRIC_CONCAT(a, b) TT_METRIC_CONCAT_(a, b)
+
+#if TIMETRACKER_METRICS
+#define TT_METRIC_ADD(counter, amount) \
+    do { if (Metrics::isEnabled()) Metrics::add(Metrics::Counter::counter, (amount)); } while (0)
+#define TT_METRIC_SET(gauge, value) \
+    do { if (Metrics::isEnabled()) Metrics::set(Metrics::Gauge::gauge, (value)); } while (0)
+#define TT_METRIC_RECORD(histogram, value) \
+    do { if (Metrics::isEnabled()) Metrics::record(Metrics::Histogram::histogram, (value)); } while (0)
+#define TT_METRIC_SCOPED_TIMER(histogram) \
+    Metrics::ScopedTimer TT_METRIC_CONCAT(metricTimer_, __LINE__)(Metrics::Histogram::histogram)
+#else
+#define TT_METRIC_ADD(counter, amount) do { } while (0)
+#define TT_METRIC_SET(gauge, value) do { } while (0)
+#define TT_METRIC_RECORD(histogram, value) do { } while (0)
+#define TT_METRIC_SCOPED_TIMER(histogram) do { } while (0)
+#endif
@@ -0,0 +1,108 @@
+#include "MetricsReporter.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+MetricsReporter::MetricsReporter(const QString& filePath, QObject *parent)
+    : QObject(parent)
+    , m_filePath(filePath)
+{
+    m_writeTimer = new QTimer(this);
+    m_writeTimer->setInterval(DEFAULT_WRITE_INTERVAL_MS);
+    connect(m_writeTimer, &QTimer::timeout, this, &MetricsReporter::writeFile);
+
+    m_telemetryTimer = new QTimer(this);
+    m_telemetryTimer->setInterval(DEFAULT_TELEMETRY_INTERVAL_MS);
+    connect(m_telemetryTimer, &QTimer::timeout, this, &MetricsReporter::emitTelemetry);
+
+    m_lastWrite = Metrics::snapshot();
+    m_lastTelemetry = m_lastWrite;
+}
+
+QString MetricsReporter::defaultFilePath()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("metrics.json");
+}
+
+void MetricsReporter::setWriteIntervalMSecs(int intervalMSecs)
+{
+    applyInterval(m_writeTimer, intervalMSecs);
+}
+
+void MetricsReporter::setTelemetryIntervalMSecs(int intervalMSecs)
+{
+    applyInterval(m_telemetryTimer, intervalMSecs);
+}
+
+void MetricsReporter::start()
+{
+    m_running = true;
+    applyInterval(m_writeTimer, m_writeTimer->interval());
+    applyInterval(m_telemetryTimer, m_telemetryTimer->interval());
+}
+
+void MetricsReporter::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+    m_writeTimer->stop();
+    m_telemetryTimer->stop();
+    if (m_writeTimer->interval() > 0) {
+        writeFile();
+    }
+}
+
+bool MetricsReporter::writeFile()
+{
+    const Metrics::Snapshot current = Metrics::snapshot();
+
+    QJsonObject object;
+    object["generatedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    object["enabled"] = Metrics::isEnabled();
+    object["total"] = current.toJson();
+    object["lastInterval"] = current.since(m_lastWrite).toJson();
+    m_lastWrite = current;
+
+    // Readers never see a half-written file
+    const QString directory = QFileInfo(m_filePath).absolutePath();
+    QDir().mkpath(directory);
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open metrics file:" << m_filePath << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(object).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        qWarning() << "Failed to write metrics file:" << m_filePath << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void MetricsReporter::emitTelemetry()
+{
+    const Metrics::Snapshot current = Metrics::snapshot();
+    QJsonObject record = current.since(m_lastTelemetry).toJson();
+    record["v"] = TELEMETRY_VERSION;
+    record["generatedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    m_lastTelemetry = current;
+
+    emit telemetryReady(record);
+}
+
+void MetricsReporter::applyInterval(QTimer *timer, int intervalMSecs)
+{
+    const int interval = qMax(0, intervalMSecs);
+    timer->setInterval(interval);
+    if (m_running && interval > 0) {
+        timer->start();
+    } else {
+        timer->stop();
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include "Metrics.h"
+
+/**
+ * @brief The MetricsReporter class publishes the process metrics
+ *
+ * Two outputs, each on its own timer:
+ * - A local JSON file, rewritten every write interval with the totals
+ *   since start and the last interval's differences, for support staff
+ *   and for watching the client on a test machine.
+ * - A compact telemetry record of what changed since the previous one,
+ *   emitted every upload interval for ApiService to send.
+ *
+ * Both read Metrics::snapshot() on the thread the reporter lives on; the
+ * recording threads are never blocked.
+ */
+class MetricsReporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Construct a new MetricsReporter object
+     * @param filePath The local metrics file
+     * @param parent The parent object
+     */
+    explicit MetricsReporter(const QString& filePath, QObject *parent = nullptr);
+
+    /**
+     * @brief Get metrics.json in the application's data directory
+     */
+    static QString defaultFilePath();
+
+    /**
+     * @brief Get the local metrics file path
+     */
+    QString filePath() const { return m_filePath; }
+
+    /**
+     * @brief Set how often the local file is rewritten
+     * @param intervalMSecs The interval, 0 to stop writing the file
+     */
+    void setWriteIntervalMSecs(int intervalMSecs);
+    int writeIntervalMSecs() const { return m_writeTimer->interval(); }
+
+    /**
+     * @brief Set how often a telemetry record is emitted
+     * @param intervalMSecs The interval, 0 to stop emitting records
+     */
+    void setTelemetryIntervalMSecs(int intervalMSecs);
+    int telemetryIntervalMSecs() const { return m_telemetryTimer->interval(); }
+
+    /**
+     * @brief Start both timers with their intervals
+     */
+    void start();
+
+    /**
+     * @brief Stop both timers and write the file one last time
+     */
+    void stop();
+
+    /**
+     * @brief Rewrite the local file now
+     * @return true if the file was written
+     */
+    bool writeFile();
+
+    /**
+     * @brief Build and emit a telemetry record of the changes since the previous one
+     */
+    void emitTelemetry();
+
+    static const int DEFAULT_WRITE_INTERVAL_MS = 60 * 1000;        ///< Local file refresh
+    static const int DEFAULT_TELEMETRY_INTERVAL_MS = 15 * 60 * 1000; ///< Telemetry record period
+    static const int TELEMETRY_VERSION = 1;                         ///< Record layout version
+
+signals:
+    /**
+     * @brief Emitted with a telemetry record to send
+     */
+    void telemetryReady(const QJsonObject& record);
+
+private:
+    void applyInterval(QTimer *timer, int intervalMSecs);
+
+    QString m_filePath;
+    QTimer *m_writeTimer = nullptr;
+    QTimer *m_telemetryTimer = nullptr;
+    bool m_running = false;
+    Metrics::Snapshot m_lastWrite;      ///< Baseline of the file's last-interval section
+    Metrics::Snapshot m_lastTelemetry;  ///< Baseline of the next telemetry record
+};
@@ -0,0 +1,79 @@
+#include "ProcessNameCache.h"
+#include <QFileInfo>
+#include <QList>
+
+ProcessNameCache::Entry::~Entry()
+{
+    if (handle) {
+        CloseHandle(handle);
+    }
+}
+
+bool ProcessNameCache::Entry::hasExited() const
+{
+    return WaitForSingleObject(handle, 0) == WAIT_OBJECT_0;
+}
+
+ProcessNameCache::ProcessNameCache(int capacity)
+    : m_cache(qMax(1, capacity))
+{
+}
+
+ProcessImageInfo ProcessNameCache::lookup(DWORD processId)
+{
+    if (Entry *entry = m_cache.object(processId)) {
+        if (!entry->hasExited()) {
+            ++m_hitCount;
+            return entry->info;
+        }
+        // The PID is free for reuse once we let go of the handle
+        m_cache.remove(processId);
+    }
+    ++m_missCount;
+
+    // Misses already pay for syscalls; release handles of processes that are gone meanwhile
+    removeExited();
+
+    ProcessImageInfo info;
+    info.processId = processId;
+
+    HANDLE handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | SYNCHRONIZE, FALSE, processId);
+    if (handle == NULL) {
+        return info;
+    }
+
+    wchar_t processPath[MAX_PATH];
+    DWORD pathSize = MAX_PATH;
+    FILETIME creation, exit, kernel, user;
+    if (!QueryFullProcessImageNameW(handle, 0, processPath, &pathSize)
+        || !GetProcessTimes(handle, &creation, &exit, &kernel, &user)) {
+        CloseHandle(handle);
+        return info;
+    }
+
+    info.path = QString::fromWCharArray(processPath, pathSize);
+    info.name = QFileInfo(info.path).fileName();
+    info.creationTime = (static_cast<quint64>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+    info.valid = true;
+
+    Entry *entry = new Entry;
+    entry->handle = handle;
+    entry->info = info;
+    m_cache.insert(processId, entry);
+    return info;
+}
+
+int ProcessNameCache::removeExited()
+{
+    QList<DWORD> exited;
+    const QList<DWORD> keys = m_cache.keys();
+    for (DWORD processId : keys) {
+        if (const Entry *entry = m_cache.object(processId); entry && entry->hasExited()) {
+            exited.append(processId);
+        }
+    }
+    for (DWORD processId : exited) {
+        m_cache.remove(processId);
+    }
+    return exited.size();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QCache>
+#include <QString>
+#include <windows.h>
+
+/**
+ * @brief Image name and identity of a running process
+ */
+struct ProcessImageInfo {
+    DWORD processId = 0;       ///< Windows process ID
+    quint64 creationTime = 0;  ///< FILETIME of process creation; with the PID identifies the process
+    QString name;              ///< Executable file name, e.g. "code.exe"
+    QString path;              ///< Full path of the executable
+    bool valid = false;        ///< false if the process could not be queried
+};
+
+/**
+ * @brief The ProcessNameCache class caches PID-to-image-name lookups
+ *
+ * A miss opens the process once, reads its image path and creation time
+ * and keeps the handle. Windows never reuses a PID while a handle to the
+ * process is open, so a cached entry always belongs to the process it was
+ * created for; a hit only checks, without blocking, whether that process
+ * has exited. Exited processes are dropped and their handle released, on
+ * their next lookup or on any miss, and the next lookup of the PID queries
+ * the new owner. At most capacity()
+ * entries are kept, least recently used ones are evicted first.
+ *
+ * Not thread-safe; use from one thread.
+ */
+class ProcessNameCache
+{
+public:
+    /**
+     * @brief Construct a new ProcessNameCache object
+     * @param capacity Maximum number of cached processes
+     */
+    explicit ProcessNameCache(int capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Look up a process, querying it on a miss
+     * @param processId The process ID
+     * @return The process info; valid is false if the process could not be opened
+     */
+    ProcessImageInfo lookup(DWORD processId);
+
+    /**
+     * @brief Drop entries whose process has exited
+     * @return The number of entries removed
+     */
+    int removeExited();
+
+    /**
+     * @brief Drop all entries and release their handles
+     */
+    void clear() { m_cache.clear(); }
+
+    /**
+     * @brief Get the number of cached processes
+     */
+    int size() const { return m_cache.size(); }
+
+    /**
+     * @brief Get the maximum number of cached processes
+     */
+    int capacity() const { return static_cast<int>(m_cache.maxCost()); }
+
+    /**
+     * @brief Get the number of lookups answered from the cache
+     */
+    quint64 hitCount() const { return m_hitCount; }
+
+    /**
+     * @brief Get the number of lookups that had to query the process
+     */
+    quint64 missCount() const { return m_missCount; }
+
+    static const int DEFAULT_CAPACITY = 64;  ///< Default number of cached processes
+
+private:
+    struct Entry {
+        ~Entry();
+        bool hasExited() const;
+
+        HANDLE handle = nullptr;   ///< Keeps the PID from being reused
+        ProcessImageInfo info;
+    };
+
+    QCache<DWORD, Entry> m_cache;
+    quint64 m_hitCount = 0;
+    quint64 m_missCount = 0;
+};
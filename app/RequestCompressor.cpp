@@ -0,0 +1,99 @@
+#include "RequestCompressor.h"
+#include "ActivityJournal.h"
+#include <QDebug>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+namespace {
+
+const int QCOMPRESS_PREFIX_SIZE = 4;   ///< Big-endian uncompressed size written by qCompress
+const int ZLIB_HEADER_SIZE = 2;        ///< CMF and FLG bytes, no preset dictionary
+const int ZLIB_TRAILER_SIZE = 4;       ///< Adler-32 of the uncompressed data
+
+void appendLittleEndian(QByteArray& out, quint32 value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out.append(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+bool listsGzip(const QByteArray& acceptEncoding)
+{
+    for (const QByteArray& coding : acceptEncoding.split(',')) {
+        // Drop parameters such as ";q=0.5"
+        const QByteArray name = coding.split(';').first().trimmed().toLower();
+        if (name == "gzip" || name == "x-gzip") {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool RequestCompressor::prepare(QNetworkRequest& request, QByteArray& body) const
+{
+    if (!m_enabled || body.size() < MIN_COMPRESS_BYTES) {
+        return false;
+    }
+
+    QByteArray compressed = gzip(body);
+    if (compressed.isEmpty() || compressed.size() >= body.size()) {
+        return false;
+    }
+    body = compressed;
+    request.setRawHeader("Content-Encoding", "gzip");
+    return true;
+}
+
+void RequestCompressor::observe(const QNetworkReply *reply)
+{
+    observeResponse(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                    reply->rawHeader("Accept-Encoding"),
+                    reply->request().rawHeader("Content-Encoding") == "gzip");
+}
+
+void RequestCompressor::observeResponse(int statusCode, const QByteArray& acceptEncoding, bool requestCompressed)
+{
+    if (statusCode == 0) {
+        // No response, nothing learned about the server
+        return;
+    }
+
+    if (statusCode == 415 && requestCompressed) {
+        if (m_enabled) {
+            qWarning() << "Server rejected a gzip request body - sending uncompressed bodies";
+        }
+        m_enabled = false;
+        return;
+    }
+
+    if (!acceptEncoding.isEmpty()) {
+        const bool accepted = listsGzip(acceptEncoding);
+        if (accepted != m_enabled) {
+            qDebug() << "Server" << (accepted ? "accepts" : "no longer accepts") << "gzip request bodies";
+        }
+        m_enabled = accepted;
+    }
+}
+
+QByteArray RequestCompressor::gzip(const QByteArray& data, int compressionLevel)
+{
+    // qCompress wraps raw deflate data in a size prefix, a zlib header and an Adler-32 trailer
+    const QByteArray zlib = qCompress(data, compressionLevel);
+    const int wrapping = QCOMPRESS_PREFIX_SIZE + ZLIB_HEADER_SIZE + ZLIB_TRAILER_SIZE;
+    if (zlib.size() <= wrapping) {
+        return QByteArray();
+    }
+
+    // Magic, deflate, no flags, no modification time, no extra flags, unknown OS
+    static const char header[] = {'\x1f', '\x8b', '\x08', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xff'};
+
+    QByteArray out;
+    out.reserve(sizeof(header) + zlib.size() - wrapping + 8);
+    out.append(header, sizeof(header));
+    out.append(zlib.constData() + QCOMPRESS_PREFIX_SIZE + ZLIB_HEADER_SIZE, zlib.size() - wrapping);
+    appendLittleEndian(out, ActivityJournal::crc32(data.constData(), data.size()));
+    appendLittleEndian(out, static_cast<quint32>(data.size()));
+    return out;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QByteArray>
+
+class QNetworkReply;
+class QNetworkRequest;
+
+/**
+ * @brief The RequestCompressor class gzips request bodies the server can decode
+ *
+ * Compression is negotiated per server as in RFC 7694: requests go out
+ * uncompressed until a response carries an Accept-Encoding header that
+ * lists gzip, and a 415 Unsupported Media Type answer to a compressed
+ * request turns it off again. Older servers that never advertise the
+ * header therefore keep receiving plain JSON. Bodies smaller than
+ * MIN_COMPRESS_BYTES are always sent as they are.
+ *
+ * Not thread-safe; use from the thread that owns the network manager.
+ */
+class RequestCompressor
+{
+public:
+    /**
+     * @brief Compress a body and mark the request if the server accepts gzip
+     * @param request Request that receives the Content-Encoding header
+     * @param body The body, replaced by its gzip encoding when compressed
+     * @return true if the body was compressed
+     */
+    bool prepare(QNetworkRequest& request, QByteArray& body) const;
+
+    /**
+     * @brief Learn from a finished reply whether the server accepts gzip
+     * @param reply A reply to a request that went through prepare()
+     */
+    void observe(const QNetworkReply *reply);
+
+    /**
+     * @brief Learn from a response whether the server accepts gzip
+     * @param statusCode HTTP status code, 0 if there was no response
+     * @param acceptEncoding Value of the response's Accept-Encoding header
+     * @param requestCompressed true if the request body was gzipped
+     */
+    void observeResponse(int statusCode, const QByteArray& acceptEncoding, bool requestCompressed);
+
+    /**
+     * @brief Check whether request bodies are currently compressed
+     */
+    bool isEnabled() const { return m_enabled; }
+
+    /**
+     * @brief Turn compression on or off until the next response says otherwise
+     */
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+
+    /**
+     * @brief Encode data as a single gzip member (RFC 1952)
+     * @param data The data to compress
+     * @param compressionLevel zlib level 0-9, or -1 for the default
+     * @return The gzip stream, empty if compression failed
+     */
+    static QByteArray gzip(const QByteArray& data, int compressionLevel = -1);
+
+    static const int MIN_COMPRESS_BYTES = 1024;   ///< Smaller bodies gain less than the gzip overhead
+
+private:
+    bool m_enabled = false;
+};
@@ -0,0 +1,226 @@
+#include "RuntimeConfig.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QUrl>
+
+namespace {
+
+const int DAY_SECS = 24 * 60 * 60;
+
+int boundedInt(const QVariantMap& values, const QString& key, int fallback, int minimum, int maximum)
+{
+    const QVariant value = values.value(key);
+    if (!value.isValid()) {
+        return fallback;
+    }
+
+    bool ok = false;
+    const int number = value.toInt(&ok);
+    if (!ok) {
+        qWarning() << "Ignoring setting" << key << "- not a number:" << value;
+        return fallback;
+    }
+    return qBound(minimum, number, maximum);
+}
+
+void flatten(const QJsonObject& object, const QString& prefix, QVariantMap& values)
+{
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        const QString key = prefix + it.key();
+        if (it.value().isObject()) {
+            flatten(it.value().toObject(), key + '/', values);
+        } else {
+            values.insert(key, it.value().toVariant());
+        }
+    }
+}
+
+} // namespace
+
+RuntimeSettings RuntimeSettings::fromValues(const QVariantMap& values)
+{
+    RuntimeSettings result;
+    result.screenshotIntervalSecs =
+        boundedInt(values, "Screenshots/intervalSeconds", result.screenshotIntervalSecs, 1, DAY_SECS);
+    result.screenshotJitterPercent =
+        boundedInt(values, "Screenshots/jitterPercent", result.screenshotJitterPercent, 0, 100);
+    result.screenshotMinimumSpacingSecs =
+        boundedInt(values, "Screenshots/minimumSpacingSeconds", result.screenshotMinimumSpacingSecs, 0, DAY_SECS);
+    result.encoder = ScreenshotEncoderSettings::fromValues(values);
+    result.desktopDuplication =
+        values.value("Screenshots/captureBackend", "dxgi").toString().trimmed().compare("gdi", Qt::CaseInsensitive) != 0;
+
+    result.idleThresholdSecs = boundedInt(values, "Idle/thresholdSeconds", result.idleThresholdSecs, 1, DAY_SECS);
+    result.appPollIntervalSecs =
+        boundedInt(values, "Tracking/pollIntervalSeconds", result.appPollIntervalSecs, 1, 60 * 60);
+    result.moveCoalescingMSecs =
+        boundedInt(values, "Tracking/moveCoalescingMSecs", result.moveCoalescingMSecs, 0, 60 * 1000);
+    result.traceFilePath = values.value("Tracking/traceFile").toString().trimmed();
+
+    result.uploadIntervalSecs = boundedInt(values, "Upload/intervalSeconds", result.uploadIntervalSecs, 1, DAY_SECS);
+    result.policyRefreshSecs =
+        boundedInt(values, "Upload/policyRefreshSeconds", result.policyRefreshSecs, 0, 7 * DAY_SECS);
+
+    result.metricsEnabled = values.value("Metrics/enabled", result.metricsEnabled).toBool();
+    result.metricsFileIntervalSecs =
+        boundedInt(values, "Metrics/fileIntervalSeconds", result.metricsFileIntervalSecs, 0, DAY_SECS);
+    result.telemetryIntervalSecs =
+        boundedInt(values, "Metrics/uploadIntervalSeconds", result.telemetryIntervalSecs, 0, DAY_SECS);
+
+    if (values.contains("Upload/serverUrl")) {
+        const QString serverUrl = values.value("Upload/serverUrl").toString().trimmed();
+        const QUrl url(serverUrl, QUrl::StrictMode);
+        if (url.isValid() && (url.scheme() == "https" || url.scheme() == "http") && !url.host().isEmpty()) {
+            result.serverUrl = serverUrl;
+        } else {
+            qWarning() << "Ignoring setting Upload/serverUrl - not an HTTP URL:" << serverUrl;
+        }
+    }
+
+    if (values.contains("Upload/activity")) {
+        const QString activityUpload = values.value("Upload/activity").toString().trimmed().toLower();
+        if (activityUpload == "raw" || activityUpload == "summaries" || activityUpload == "both") {
+            result.activityUpload = activityUpload;
+        } else {
+            qWarning() << "Ignoring setting Upload/activity - expected raw, summaries or both:" << activityUpload;
+        }
+    }
+    return result;
+}
+
+bool RuntimeSettings::operator==(const RuntimeSettings& other) const
+{
+    return screenshotIntervalSecs == other.screenshotIntervalSecs
+        && screenshotJitterPercent == other.screenshotJitterPercent
+        && screenshotMinimumSpacingSecs == other.screenshotMinimumSpacingSecs
+        && encoder == other.encoder
+        && desktopDuplication == other.desktopDuplication
+        && idleThresholdSecs == other.idleThresholdSecs
+        && appPollIntervalSecs == other.appPollIntervalSecs
+        && moveCoalescingMSecs == other.moveCoalescingMSecs
+        && traceFilePath == other.traceFilePath
+        && uploadIntervalSecs == other.uploadIntervalSecs
+        && serverUrl == other.serverUrl
+        && activityUpload == other.activityUpload
+        && policyRefreshSecs == other.policyRefreshSecs
+        && metricsEnabled == other.metricsEnabled
+        && metricsFileIntervalSecs == other.metricsFileIntervalSecs
+        && telemetryIntervalSecs == other.telemetryIntervalSecs;
+}
+
+RuntimeConfig::RuntimeConfig(const QString& filePath, QObject *parent)
+    : QObject(parent)
+    , m_filePath(QFileInfo(filePath).absoluteFilePath())
+{
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &RuntimeConfig::onFileChanged);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &RuntimeConfig::onFileChanged);
+
+    reload();
+    qDebug() << "Runtime configuration file:" << m_filePath;
+}
+
+QString RuntimeConfig::defaultFilePath()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("timetracker.ini");
+}
+
+void RuntimeConfig::setBaseValues(const QVariantMap& values)
+{
+    m_baseValues = values;
+    update();
+}
+
+void RuntimeConfig::reload()
+{
+    watchFile();
+
+    QVariantMap values;
+    if (QFileInfo::exists(m_filePath)) {
+        QSettings file(m_filePath, QSettings::IniFormat);
+        if (file.status() != QSettings::NoError) {
+            // A half-written file keeps the values read before
+            qWarning() << "Failed to read runtime configuration" << m_filePath << "- keeping previous values";
+            return;
+        }
+        values = valuesOf(file);
+    }
+
+    m_fileValues = values;
+    update();
+}
+
+void RuntimeConfig::setServerPolicy(const QJsonObject& policy)
+{
+    m_policyValues = valuesOf(policy);
+    // A trace records window titles to a local file; only the machine's own configuration may ask for one
+    m_policyValues.remove("Tracking/traceFile");
+    // The server URL is also where the next policy comes from, so a policy must not move it
+    m_policyValues.remove("Upload/serverUrl");
+    update();
+}
+
+QVariantMap RuntimeConfig::valuesOf(const QSettings& settings)
+{
+    QVariantMap values;
+    for (const QString& key : settings.allKeys()) {
+        values.insert(key, settings.value(key));
+    }
+    return values;
+}
+
+QVariantMap RuntimeConfig::valuesOf(const QJsonObject& object)
+{
+    QVariantMap values;
+    flatten(object, QString(), values);
+    return values;
+}
+
+void RuntimeConfig::onFileChanged()
+{
+    // Editors often write a file in several steps; read it once they are done
+    if (m_reloadPending) {
+        return;
+    }
+    m_reloadPending = true;
+    QTimer::singleShot(RELOAD_DELAY_MS, this, [this]() {
+        m_reloadPending = false;
+        reload();
+    });
+}
+
+void RuntimeConfig::update()
+{
+    QVariantMap values = m_baseValues;
+    for (auto it = m_fileValues.constBegin(); it != m_fileValues.constEnd(); ++it) {
+        values.insert(it.key(), it.value());
+    }
+    for (auto it = m_policyValues.constBegin(); it != m_policyValues.constEnd(); ++it) {
+        values.insert(it.key(), it.value());
+    }
+
+    const RuntimeSettings settings = RuntimeSettings::fromValues(values);
+    if (settings == m_settings) {
+        return;
+    }
+
+    const RuntimeSettings previous = m_settings;
+    m_settings = settings;
+    qDebug() << "Runtime configuration changed";
+    emit settingsChanged(m_settings, previous);
+}
+
+void RuntimeConfig::watchFile()
+{
+    // Saving through a temporary file replaces the watched file, so the directory is watched too
+    const QString directory = QFileInfo(m_filePath).absolutePath();
+    if (QFileInfo(directory).isDir() && !m_watcher->directories().contains(directory)) {
+        m_watcher->addPath(directory);
+    }
+    if (QFileInfo::exists(m_filePath) && !m_watcher->files().contains(m_filePath)) {
+        m_watcher->addPath(m_filePath);
+    }
+}
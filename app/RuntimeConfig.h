@@ -0,0 +1,163 @@
+#pragma once
+
+#include <QFileSystemWatcher>
+#include <QJsonObject>
+#include <QObject>
+#include <QSettings>
+#include <QString>
+#include <QVariantMap>
+#include "ScreenshotEncoder.h"
+
+/**
+ * @brief Intervals, thresholds and pipeline modes the client applies while running
+ *
+ * Every value has a "Group/key" name, as used in QSettings files:
+ * - Screenshots/intervalSeconds, jitterPercent, minimumSpacingSeconds
+ * - Screenshots/encoder, quality, maxWidth, maxHeight (see ScreenshotEncoderSettings)
+ * - Screenshots/captureBackend: "dxgi" (default) or "gdi"
+ * - Idle/thresholdSeconds
+ * - Tracking/pollIntervalSeconds: foreground polling, used only when the WinEvent hooks fail
+ * - Tracking/moveCoalescingMSecs: mouse-move coalescing interval, 0 logs every move
+ * - Tracking/traceFile: record an activity trace to this file (see ActivityTrace.h), empty
+ *   for none; ignored in the server policy
+ * - Upload/intervalSeconds: periodic activity journal upload
+ * - Upload/serverUrl: tracking data API URL; ignored in the server policy
+ * - Upload/activity: "raw", "summaries" or "both"
+ * - Upload/policyRefreshSeconds: how often the server policy is fetched, 0 never
+ * - Metrics/enabled: record hot-path metrics (see Metrics.h)
+ * - Metrics/fileIntervalSeconds: local metrics file refresh, 0 never
+ * - Metrics/uploadIntervalSeconds: telemetry upload period, 0 never
+ *
+ * Out-of-range values are clamped and unparsable ones keep the default.
+ */
+struct RuntimeSettings {
+#ifdef QT_DEBUG
+    int screenshotIntervalSecs = 10;           ///< 10 seconds for development/testing
+#else
+    int screenshotIntervalSecs = 10 * 60;      ///< 10 minutes for production
+#endif
+    int screenshotJitterPercent = 10;          ///< Largest random delay as a share of the interval
+    int screenshotMinimumSpacingSecs = 5;      ///< Spacing application switch captures start from
+    ScreenshotEncoderSettings encoder;         ///< Encoder, quality and size limit
+    bool desktopDuplication = true;            ///< false captures through GDI only
+    int idleThresholdSecs = 5 * 60;            ///< Inactivity before the user counts as idle
+    int appPollIntervalSecs = 5;               ///< Foreground polling fallback interval
+    int moveCoalescingMSecs = 1000;            ///< Mouse-move coalescing interval, 0 for every move
+    QString traceFilePath;                     ///< Activity trace file, empty to record none
+    int uploadIntervalSecs = 5 * 60;           ///< Periodic activity journal upload
+    QString serverUrl = "https://localhost:7001/api/trackingdata";
+    QString activityUpload = "both";           ///< "raw", "summaries" or "both"
+    int policyRefreshSecs = 15 * 60;           ///< Server policy refresh, 0 never
+    bool metricsEnabled = true;                ///< Record hot-path metrics
+    int metricsFileIntervalSecs = 60;          ///< Local metrics file refresh, 0 never
+    int telemetryIntervalSecs = 15 * 60;       ///< Telemetry upload period, 0 never
+
+    /**
+     * @brief Read the settings from "Group/key" values, falling back to the defaults for missing keys
+     */
+    static RuntimeSettings fromValues(const QVariantMap& values);
+
+    bool operator==(const RuntimeSettings& other) const;
+    bool operator!=(const RuntimeSettings& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief The RuntimeConfig class provides the live RuntimeSettings and reports changes
+ *
+ * The settings are merged from layers, later ones overriding earlier ones:
+ * 1. The defaults in RuntimeSettings
+ * 2. Base values, which the application reads from its QSettings (the
+ *    deployment's registry keys)
+ * 3. A local INI file, watched and re-read when it is saved
+ * 4. The policy last fetched from the server
+ *
+ * settingsChanged() is emitted only when the merged settings differ, so
+ * saving the file without a change, or a server returning the same
+ * policy, costs nothing downstream.
+ */
+class RuntimeConfig : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Construct a new RuntimeConfig object and read the local file
+     * @param filePath INI file to read and watch; it does not have to exist yet
+     * @param parent The parent object
+     */
+    explicit RuntimeConfig(const QString& filePath, QObject *parent = nullptr);
+
+    /**
+     * @brief Get the local file in the application's data directory
+     */
+    static QString defaultFilePath();
+
+    /**
+     * @brief Get the local file path
+     */
+    QString filePath() const { return m_filePath; }
+
+    /**
+     * @brief Get the merged settings
+     */
+    const RuntimeSettings& settings() const { return m_settings; }
+
+    /**
+     * @brief Set the values the local file and server policy override
+     */
+    void setBaseValues(const QVariantMap& values);
+
+    /**
+     * @brief Re-read the local file now
+     */
+    void reload();
+
+    /**
+     * @brief Get the server policy currently applied, as "Group/key" values
+     */
+    QVariantMap serverPolicy() const { return m_policyValues; }
+
+    /**
+     * @brief Flatten QSettings into "Group/key" values
+     */
+    static QVariantMap valuesOf(const QSettings& settings);
+
+    /**
+     * @brief Flatten a policy object into "Group/key" values
+     *
+     * Nested objects ({"Screenshots": {"quality": 70}}) and flat keys
+     * ({"Screenshots/quality": 70}) are both accepted.
+     */
+    static QVariantMap valuesOf(const QJsonObject& object);
+
+    static const int RELOAD_DELAY_MS = 200; ///< Lets an editor finish writing before the file is read
+
+public slots:
+    /**
+     * @brief Apply the policy fetched from the server; an empty policy removes it
+     */
+    void setServerPolicy(const QJsonObject& policy);
+
+signals:
+    /**
+     * @brief Emitted when the merged settings change
+     * @param settings The new settings
+     * @param previous The settings before the change, to apply only what differs
+     */
+    void settingsChanged(const RuntimeSettings& settings, const RuntimeSettings& previous);
+
+private slots:
+    void onFileChanged();
+
+private:
+    void update();
+    void watchFile();
+
+    QString m_filePath;
+    QFileSystemWatcher *m_watcher = nullptr; ///< Watches the file and its directory, for replaced files
+    bool m_reloadPending = false;
+    QVariantMap m_baseValues;
+    QVariantMap m_fileValues;
+    QVariantMap m_policyValues;
+    RuntimeSettings m_settings;
+};
@@ -0,0 +1,103 @@
+#include "ScreenshotDeduplicator.h"
+#include <QtAlgorithms>
+
+ScreenshotDeduplicator::ScreenshotDeduplicator(int hammingThreshold)
+    : m_hammingThreshold(qMin(hammingThreshold, 64))
+{
+}
+
+bool ScreenshotDeduplicator::isDuplicate(int screenIndex, const QImage& image, int *distance)
+{
+    return isDuplicateHash(screenIndex, differenceHash(image), distance);
+}
+
+bool ScreenshotDeduplicator::isDuplicateHash(int screenIndex, quint64 hash, int *distance)
+{
+    ++m_checkedCount;
+
+    auto it = m_references.find(screenIndex);
+    const int hashDistance = it != m_references.end() ? hammingDistance(hash, it->hash) : -1;
+    if (distance) {
+        *distance = hashDistance;
+    }
+
+    if (hashDistance >= 0 && m_hammingThreshold >= 0 && hashDistance <= m_hammingThreshold) {
+        ++m_skippedCount;
+        m_savedBytes += it->encodedBytes;
+        return true;
+    }
+
+    Reference reference;
+    reference.hash = hash;
+    m_references.insert(screenIndex, reference);
+    return false;
+}
+
+void ScreenshotDeduplicator::recordEncodedBytes(int screenIndex, qint64 bytes)
+{
+    auto it = m_references.find(screenIndex);
+    if (it != m_references.end()) {
+        it->encodedBytes = bytes;
+    }
+}
+
+void ScreenshotDeduplicator::reset()
+{
+    m_references.clear();
+}
+
+quint64 ScreenshotDeduplicator::differenceHash(const QImage& image)
+{
+    if (image.isNull()) {
+        return 0;
+    }
+
+    const int samplesX = HASH_WIDTH * SAMPLES_PER_CELL;
+    const int samplesY = HASH_HEIGHT * SAMPLES_PER_CELL;
+
+    // Grabs are 32-bit RGB; anything else is shrunk to the sample grid before converting
+    QImage source = image;
+    if (source.format() != QImage::Format_RGB32 && source.format() != QImage::Format_ARGB32
+        && source.format() != QImage::Format_ARGB32_Premultiplied) {
+        source = image.scaled(samplesX, samplesY, Qt::IgnoreAspectRatio, Qt::FastTransformation)
+                     .convertToFormat(QImage::Format_RGB32);
+    }
+
+    const int width = source.width();
+    const int height = source.height();
+
+    // Sample positions: the centres of an even SAMPLES_PER_CELL grid inside every cell
+    int columns[samplesX];
+    for (int i = 0; i < samplesX; ++i) {
+        columns[i] = qMin(width - 1, static_cast<int>((2LL * i + 1) * width / (2LL * samplesX)));
+    }
+
+    quint32 cells[HASH_HEIGHT][HASH_WIDTH] = {};
+    for (int j = 0; j < samplesY; ++j) {
+        const int y = qMin(height - 1, static_cast<int>((2LL * j + 1) * height / (2LL * samplesY)));
+        const QRgb *line = reinterpret_cast<const QRgb*>(source.constScanLine(y));
+        quint32 *row = cells[j / SAMPLES_PER_CELL];
+
+        for (int i = 0; i < samplesX; ++i) {
+            const QRgb pixel = line[columns[i]];
+            // Integer Rec. 601 luma, weights sum to 256
+            row[i / SAMPLES_PER_CELL] += (77 * qRed(pixel) + 150 * qGreen(pixel) + 29 * qBlue(pixel)) >> 8;
+        }
+    }
+
+    // Every cell holds the same number of samples, so sums compare like averages.
+    // Near-ties count as "not brighter" so noise in flat areas cannot flip bits.
+    const quint32 tieMargin = SAMPLES_PER_CELL * SAMPLES_PER_CELL * HASH_TIE_LUMA;
+    quint64 hash = 0;
+    for (int y = 0; y < HASH_HEIGHT; ++y) {
+        for (int x = 0; x < HASH_WIDTH - 1; ++x) {
+            hash = (hash << 1) | (cells[y][x] > cells[y][x + 1] + tieMargin ? 1 : 0);
+        }
+    }
+    return hash;
+}
+
+int ScreenshotDeduplicator::hammingDistance(quint64 a, quint64 b)
+{
+    return qPopulationCount(a ^ b);
+}
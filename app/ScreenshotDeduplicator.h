@@ -0,0 +1,125 @@
+#pragma once
+
+#include <QHash>
+#include <QImage>
+
+/**
+ * @brief The ScreenshotDeduplicator class suppresses near-identical captures
+ *
+ * Each grab is reduced to a 64-bit difference hash (dHash): the image is
+ * box-sampled down to a 9x8 grayscale grid and every bit records whether a
+ * cell is clearly brighter than its right-hand neighbour. Two captures of the same
+ * screen whose hashes differ in at most hammingThreshold() bits are treated
+ * as duplicates and need not be encoded or uploaded.
+ *
+ * The reference for a screen is the last capture that was NOT a duplicate,
+ * so slow drift (a document scrolling line by line) eventually produces a
+ * new upload instead of being absorbed frame by frame.
+ */
+class ScreenshotDeduplicator
+{
+public:
+    /**
+     * @brief Construct a new ScreenshotDeduplicator object
+     * @param hammingThreshold Largest hash distance still treated as a duplicate, negative to disable
+     */
+    explicit ScreenshotDeduplicator(int hammingThreshold = DEFAULT_HAMMING_THRESHOLD);
+
+    /**
+     * @brief Set the largest hash distance still treated as a duplicate
+     * @param threshold Number of differing bits (0-64), negative to disable suppression
+     */
+    void setHammingThreshold(int threshold) { m_hammingThreshold = qMin(threshold, 64); }
+
+    /**
+     * @brief Get the largest hash distance still treated as a duplicate
+     */
+    int hammingThreshold() const { return m_hammingThreshold; }
+
+    /**
+     * @brief Compare a capture with the previous one from the same screen
+     *
+     * A capture that is not a duplicate becomes the new reference for its screen.
+     * @param screenIndex Screen the image was grabbed from
+     * @param image The grabbed image
+     * @param distance Receives the Hamming distance to the reference, or -1 if there was none (optional)
+     * @return true if the capture can be skipped
+     */
+    bool isDuplicate(int screenIndex, const QImage& image, int *distance = nullptr);
+
+    /**
+     * @brief Compare an already computed differenceHash() with the reference for its screen
+     *
+     * Same as isDuplicate() for callers that keep the hash, e.g. to record or replay it.
+     * @param screenIndex Screen the image was grabbed from
+     * @param hash differenceHash() of the grabbed image
+     * @param distance Receives the Hamming distance to the reference, or -1 if there was none (optional)
+     * @return true if the capture can be skipped
+     */
+    bool isDuplicateHash(int screenIndex, quint64 hash, int *distance = nullptr);
+
+    /**
+     * @brief Record the encoded size of the reference capture for a screen
+     *
+     * Used to estimate the bandwidth saved by later duplicates.
+     * @param screenIndex Screen the image was grabbed from
+     * @param bytes Size of the encoded screenshot
+     */
+    void recordEncodedBytes(int screenIndex, qint64 bytes);
+
+    /**
+     * @brief Forget the reference for one screen, e.g. when its capture was never uploaded
+     * @param screenIndex Screen the image was grabbed from
+     */
+    void forget(int screenIndex) { m_references.remove(screenIndex); }
+
+    /**
+     * @brief Forget all references so the next capture of every screen is uploaded
+     */
+    void reset();
+
+    /**
+     * @brief Get the number of captures checked since construction
+     */
+    quint64 checkedCount() const { return m_checkedCount; }
+
+    /**
+     * @brief Get the number of captures reported as duplicates
+     */
+    quint64 skippedCount() const { return m_skippedCount; }
+
+    /**
+     * @brief Get the estimated number of upload bytes saved by skipping duplicates
+     */
+    qint64 savedBytes() const { return m_savedBytes; }
+
+    /**
+     * @brief Compute the 64-bit difference hash of an image (thread-safe)
+     * @param image The image to hash
+     * @return The hash, 0 for a null image
+     */
+    static quint64 differenceHash(const QImage& image);
+
+    /**
+     * @brief Count the bits that differ between two hashes
+     */
+    static int hammingDistance(quint64 a, quint64 b);
+
+    static const int DEFAULT_HAMMING_THRESHOLD = 4;  ///< Default duplicate threshold in bits
+    static const int HASH_WIDTH = 9;                 ///< Sample grid columns (one more than hash bits per row)
+    static const int HASH_HEIGHT = 8;                ///< Sample grid rows
+    static const int SAMPLES_PER_CELL = 16;          ///< Samples per cell axis when box-sampling
+    static const int HASH_TIE_LUMA = 4;              ///< Average luma difference below which cells tie
+
+private:
+    struct Reference {
+        quint64 hash = 0;
+        qint64 encodedBytes = 0;
+    };
+
+    int m_hammingThreshold;
+    QHash<int, Reference> m_references;  ///< Last uploaded capture per screen index
+    quint64 m_checkedCount = 0;
+    quint64 m_skippedCount = 0;
+    qint64 m_savedBytes = 0;
+};
@@ -0,0 +1,149 @@
+#include "ScreenshotDeltaEncoder.h"
+#include <QtMath>
+#include <cstring>
+
+namespace {
+
+int tilesAlong(int length, int tileSize)
+{
+    return (length + tileSize - 1) / tileSize;
+}
+
+} // namespace
+
+ScreenshotDeltaEncoder::ScreenshotDeltaEncoder(int tileSize)
+    : m_tileSize(qMax(16, tileSize / 16 * 16))
+{
+}
+
+ScreenDelta ScreenshotDeltaEncoder::encode(int screenIndex, const QImage& frame, QImage& output,
+                                           const QRegion *changedHint)
+{
+    ScreenDelta delta;
+    delta.frameSize = frame.size();
+    const int frameTiles = tilesAlong(frame.width(), m_tileSize) * tilesAlong(frame.height(), m_tileSize);
+
+    auto it = m_screens.find(screenIndex);
+    bool keyframe = !m_enabled || it == m_screens.end()
+                    || it->previous.size() != frame.size() || it->previous.format() != frame.format()
+                    || it->capturesSinceKeyframe + 1 >= m_keyframeInterval;
+
+    if (!keyframe) {
+        QVector<QRect> tiles = changedTiles(it->previous, frame, m_tileSize, nullptr, changedHint);
+        if (tiles.isEmpty()) {
+            // The server already has this exact frame
+            delta.keyframe = false;
+            delta.sequence = it->sequence;
+            delta.baseSequence = it->sequence;
+            output = QImage();
+            return delta;
+        }
+
+        if (tiles.size() <= m_maxDeltaRatio * frameTiles) {
+            delta.keyframe = false;
+            delta.sequence = m_nextSequence++;
+            delta.baseSequence = it->sequence;
+            delta.tileSize = m_tileSize;
+            delta.atlasColumns = qCeil(qSqrt(tiles.size()));
+            delta.tiles = tiles;
+            output = packTiles(frame, tiles, m_tileSize, delta.atlasColumns);
+
+            it->previous = frame;
+            it->sequence = delta.sequence;
+            ++it->capturesSinceKeyframe;
+            ++m_deltaCount;
+            m_totalTileCount += frameTiles;
+            m_sentTileCount += tiles.size();
+            return delta;
+        }
+        // So much changed that the whole frame is cheaper to send
+    }
+
+    delta.keyframe = true;
+    delta.sequence = m_nextSequence++;
+    output = frame;
+
+    ScreenState state;
+    state.previous = frame;
+    state.sequence = delta.sequence;
+    m_screens.insert(screenIndex, state);
+    ++m_keyframeCount;
+    m_totalTileCount += frameTiles;
+    m_sentTileCount += frameTiles;
+    return delta;
+}
+
+QVector<QRect> ScreenshotDeltaEncoder::changedTiles(const QImage& previous, const QImage& current, int tileSize,
+                                                    int *tileCount, const QRegion *changedHint)
+{
+    const int columns = tilesAlong(current.width(), tileSize);
+    const int rows = tilesAlong(current.height(), tileSize);
+    if (tileCount) {
+        *tileCount = columns * rows;
+    }
+
+    QVector<QRect> changed;
+    const int bytesPerPixel = current.depth() / 8;
+    const bool comparable = previous.size() == current.size() && previous.format() == current.format()
+                            && current.depth() % 8 == 0;
+
+    for (int row = 0; row < rows; ++row) {
+        const int top = row * tileSize;
+        const int height = qMin(tileSize, current.height() - top);
+        QVector<bool> dirty(columns, !comparable);
+
+        // Tiles the hint rules out count as compared and clean
+        QVector<bool> skip(columns, false);
+        if (comparable && changedHint) {
+            for (int column = 0; column < columns; ++column) {
+                skip[column] = !changedHint->intersects(
+                    QRect(column * tileSize, top, qMin(tileSize, current.width() - column * tileSize), height));
+            }
+        }
+
+        for (int y = top; comparable && y < top + height; ++y) {
+            const uchar *previousLine = previous.constScanLine(y);
+            const uchar *currentLine = current.constScanLine(y);
+            for (int column = 0; column < columns; ++column) {
+                if (dirty[column] || skip[column]) {
+                    continue;
+                }
+                const int offset = column * tileSize * bytesPerPixel;
+                const int width = qMin(tileSize, current.width() - column * tileSize);
+                dirty[column] = std::memcmp(previousLine + offset, currentLine + offset, width * bytesPerPixel) != 0;
+            }
+        }
+
+        for (int column = 0; column < columns; ++column) {
+            if (dirty[column]) {
+                changed.append(QRect(column * tileSize, top,
+                                     qMin(tileSize, current.width() - column * tileSize), height));
+            }
+        }
+    }
+    return changed;
+}
+
+QImage ScreenshotDeltaEncoder::packTiles(const QImage& frame, const QVector<QRect>& tiles, int tileSize, int columns)
+{
+    if (tiles.isEmpty() || columns <= 0) {
+        return QImage();
+    }
+
+    const int rows = tilesAlong(tiles.size(), columns);
+    QImage atlas(columns * tileSize, rows * tileSize, frame.format());
+    atlas.fill(Qt::black);
+
+    const int bytesPerPixel = frame.depth() / 8;
+    for (int i = 0; i < tiles.size(); ++i) {
+        const QRect& tile = tiles.at(i);
+        const int atlasX = (i % columns) * tileSize;
+        const int atlasY = (i / columns) * tileSize;
+        for (int y = 0; y < tile.height(); ++y) {
+            std::memcpy(atlas.scanLine(atlasY + y) + atlasX * bytesPerPixel,
+                        frame.constScanLine(tile.y() + y) + tile.x() * bytesPerPixel,
+                        tile.width() * bytesPerPixel);
+        }
+    }
+    return atlas;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QRect>
+#include <QRegion>
+#include <QVector>
+#include "ScreenshotPipeline.h"
+
+/**
+ * @brief The ScreenshotDeltaEncoder class turns consecutive captures into tile deltas
+ *
+ * The frame is split into fixed tiles and each tile is compared with the
+ * last frame sent for the same screen. Only changed tiles are packed into
+ * a small atlas image for upload; the server pastes them onto its copy of
+ * the previous frame. A full keyframe is sent for the first capture, every
+ * keyframeInterval() captures, when the screen size changes, when more than
+ * maxDeltaRatio() of the tiles changed, and after reset().
+ *
+ * The previous frame is kept as an implicitly shared QImage, so holding it
+ * costs no copy. Tiles are compared row by row with memcmp, which the C
+ * runtime vectorizes. A capture backend that knows which areas changed,
+ * such as DesktopDuplicationCapture, can pass them as a hint so tiles
+ * outside them are not compared at all.
+ */
+class ScreenshotDeltaEncoder
+{
+public:
+    /**
+     * @brief Construct a new ScreenshotDeltaEncoder object
+     * @param tileSize Edge length of a tile in pixels, a multiple of 16
+     */
+    explicit ScreenshotDeltaEncoder(int tileSize = DEFAULT_TILE_SIZE);
+
+    /**
+     * @brief Enable or disable deltas; while disabled every capture is a keyframe
+     */
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+
+    /**
+     * @brief Check whether deltas are enabled
+     */
+    bool isEnabled() const { return m_enabled; }
+
+    /**
+     * @brief Set how many captures of a screen may pass between keyframes
+     * @param interval Captures per keyframe, at least 1
+     */
+    void setKeyframeInterval(int interval) { m_keyframeInterval = qMax(1, interval); }
+
+    /**
+     * @brief Get how many captures of a screen may pass between keyframes
+     */
+    int keyframeInterval() const { return m_keyframeInterval; }
+
+    /**
+     * @brief Set the fraction of changed tiles above which a keyframe is sent instead
+     * @param ratio Fraction between 0 and 1
+     */
+    void setMaxDeltaRatio(double ratio) { m_maxDeltaRatio = qBound(0.0, ratio, 1.0); }
+
+    /**
+     * @brief Get the fraction of changed tiles above which a keyframe is sent instead
+     */
+    double maxDeltaRatio() const { return m_maxDeltaRatio; }
+
+    /**
+     * @brief Get the tile edge length
+     */
+    int tileSize() const { return m_tileSize; }
+
+    /**
+     * @brief Encode a capture against the previous frame of its screen
+     *
+     * The capture becomes the new reference for its screen. If nothing
+     * changed, the returned delta has no tiles and output is null; the
+     * caller can skip the upload.
+     * @param screenIndex Screen the image was grabbed from
+     * @param frame The grabbed image
+     * @param output Receives the image to upload: the frame itself or the tile atlas
+     * @param changedHint Every area that changed since the previous frame of this screen, or nullptr if unknown
+     * @return Description of the keyframe or delta
+     */
+    ScreenDelta encode(int screenIndex, const QImage& frame, QImage& output, const QRegion *changedHint = nullptr);
+
+    /**
+     * @brief Check whether the server has a frame of a screen to apply deltas to
+     */
+    bool hasReference(int screenIndex) const { return m_screens.contains(screenIndex); }
+
+    /**
+     * @brief Force the next capture of a screen to be a keyframe
+     * @param screenIndex Screen whose server-side copy may be stale
+     */
+    void reset(int screenIndex) { m_screens.remove(screenIndex); }
+
+    /**
+     * @brief Force the next capture of every screen to be a keyframe
+     */
+    void resetAll() { m_screens.clear(); }
+
+    /**
+     * @brief Get the number of keyframes produced since construction
+     */
+    quint64 keyframeCount() const { return m_keyframeCount; }
+
+    /**
+     * @brief Get the number of deltas produced since construction
+     */
+    quint64 deltaCount() const { return m_deltaCount; }
+
+    /**
+     * @brief Get the number of tiles covered by all captures
+     */
+    quint64 totalTileCount() const { return m_totalTileCount; }
+
+    /**
+     * @brief Get the number of tiles actually sent (keyframes count all their tiles)
+     */
+    quint64 sentTileCount() const { return m_sentTileCount; }
+
+    /**
+     * @brief List the tiles that differ between two frames of the same size and format
+     * @param previous The frame the server has
+     * @param current The new capture
+     * @param tileSize Tile edge length
+     * @param tileCount Receives the number of tiles in the frame (optional)
+     * @param changedHint Only tiles touching this region are compared (optional)
+     * @return Changed tiles in row-major order, clipped to the frame
+     */
+    static QVector<QRect> changedTiles(const QImage& previous, const QImage& current, int tileSize,
+                                       int *tileCount = nullptr, const QRegion *changedHint = nullptr);
+
+    /**
+     * @brief Copy tiles of a frame into an atlas, row by row
+     * @param frame The source frame
+     * @param tiles Tiles to copy, each at most tileSize square
+     * @param tileSize Atlas slot edge length
+     * @param columns Slots per atlas row
+     * @return The atlas image
+     */
+    static QImage packTiles(const QImage& frame, const QVector<QRect>& tiles, int tileSize, int columns);
+
+    static const int DEFAULT_TILE_SIZE = 128;          ///< Multiple of the 16x16 JPEG MCU
+    static const int DEFAULT_KEYFRAME_INTERVAL = 12;   ///< Captures per keyframe
+    static constexpr double DEFAULT_MAX_DELTA_RATIO = 0.5;  ///< Changed fraction that forces a keyframe
+
+private:
+    struct ScreenState {
+        QImage previous;               ///< Last frame sent
+        quint64 sequence = 0;          ///< Its frame number
+        int capturesSinceKeyframe = 0;
+    };
+
+    int m_tileSize;
+    bool m_enabled = true;
+    int m_keyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
+    double m_maxDeltaRatio = DEFAULT_MAX_DELTA_RATIO;
+    QHash<int, ScreenState> m_screens;
+    quint64 m_nextSequence = 1;
+    quint64 m_keyframeCount = 0;
+    quint64 m_deltaCount = 0;
+    quint64 m_totalTileCount = 0;
+    quint64 m_sentTileCount = 0;
+};
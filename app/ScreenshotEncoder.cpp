@@ -0,0 +1,202 @@
+#include "ScreenshotEncoder.h"
+#include <QBuffer>
+#include <QDebug>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <limits>
+
+#ifdef TIMETRACKER_HAVE_TURBOJPEG
+#include <turbojpeg.h>
+#endif
+
+namespace {
+
+// Any format with a Qt image writer plugin
+class QtImageEncoder : public ScreenshotEncoder
+{
+public:
+    QtImageEncoder(const QString& name, const QByteArray& format, const QByteArray& mimeType, const QString& extension)
+        : m_name(name), m_format(format), m_mimeType(mimeType), m_extension(extension)
+    {
+    }
+
+    QString name() const override { return m_name; }
+    QByteArray mimeType() const override { return m_mimeType; }
+    QString fileExtension() const override { return m_extension; }
+
+    bool encode(const QImage& image, int quality, QByteArray *data, QString *errorString) const override
+    {
+        QBuffer buffer(data);
+        buffer.open(QIODevice::WriteOnly);
+        QImageWriter writer(&buffer, m_format);
+        writer.setQuality(quality);
+        const bool success = writer.write(image);
+        buffer.close();
+
+        if (!success && errorString) {
+            *errorString = writer.errorString();
+        }
+        return success;
+    }
+
+    bool isAvailable() const
+    {
+        return QImageWriter::supportedImageFormats().contains(m_format);
+    }
+
+private:
+    QString m_name;
+    QByteArray m_format;
+    QByteArray m_mimeType;
+    QString m_extension;
+};
+
+#ifdef TIMETRACKER_HAVE_TURBOJPEG
+// Compresses the grabbed 32-bit pixels in place, without Qt's scanline conversion
+class TurboJpegEncoder : public ScreenshotEncoder
+{
+public:
+    QString name() const override { return "turbojpeg"; }
+    QByteArray mimeType() const override { return "image/jpeg"; }
+    QString fileExtension() const override { return "jpg"; }
+
+    bool encode(const QImage& image, int quality, QByteArray *data, QString *errorString) const override
+    {
+        if (image.isNull()) {
+            if (errorString) {
+                *errorString = "Image is empty";
+            }
+            return false;
+        }
+
+        // Handles are not thread-safe; each encoder thread keeps its own
+        thread_local std::unique_ptr<void, int (*)(tjhandle)> handle(tjInitCompress(), tjDestroy);
+        if (!handle) {
+            if (errorString) {
+                *errorString = QString::fromLocal8Bit(tjGetErrorStr());
+            }
+            return false;
+        }
+
+        // QImage stores 32-bit pixels as native-endian 0xAARRGGBB, which is BGRX in memory here
+        const QImage source = (image.format() == QImage::Format_RGB32 || image.format() == QImage::Format_ARGB32)
+            ? image
+            : image.convertToFormat(QImage::Format_RGB32);
+
+        unsigned char *jpegBuffer = nullptr;
+        unsigned long jpegSize = 0;
+        const int result = tjCompress2(handle.get(), source.constBits(), source.width(),
+                                       static_cast<int>(source.bytesPerLine()), source.height(), TJPF_BGRX,
+                                       &jpegBuffer, &jpegSize, TJSAMP_420, qBound(1, quality, 100), TJFLAG_FASTDCT);
+        if (result != 0) {
+            if (errorString) {
+                *errorString = QString::fromLocal8Bit(tjGetErrorStr2(handle.get()));
+            }
+            tjFree(jpegBuffer);
+            return false;
+        }
+
+        *data = QByteArray(reinterpret_cast<const char*>(jpegBuffer), static_cast<int>(jpegSize));
+        tjFree(jpegBuffer);
+        return true;
+    }
+};
+#endif
+
+std::shared_ptr<const QtImageEncoder> makeQtJpegEncoder()
+{
+    return std::make_shared<QtImageEncoder>("jpeg", "jpeg", "image/jpeg", "jpg");
+}
+
+std::shared_ptr<const QtImageEncoder> makeQtWebpEncoder()
+{
+    return std::make_shared<QtImageEncoder>("webp", "webp", "image/webp", "webp");
+}
+
+} // namespace
+
+ScreenshotEncoderSettings ScreenshotEncoderSettings::fromSettings(const QSettings& settings)
+{
+    QVariantMap values;
+    for (const QString& key : settings.allKeys()) {
+        values.insert(key, settings.value(key));
+    }
+    return fromValues(values);
+}
+
+ScreenshotEncoderSettings ScreenshotEncoderSettings::fromValues(const QVariantMap& values)
+{
+    ScreenshotEncoderSettings result;
+    result.encoder = values.value("Screenshots/encoder", result.encoder).toString().trimmed().toLower();
+    result.quality = qBound(0, values.value("Screenshots/quality", result.quality).toInt(), 100);
+    result.maxSize = QSize(qMax(0, values.value("Screenshots/maxWidth", 0).toInt()),
+                           qMax(0, values.value("Screenshots/maxHeight", 0).toInt()));
+    return result;
+}
+
+std::shared_ptr<const ScreenshotEncoder> ScreenshotEncoder::create(const QString& name)
+{
+    const QString encoderName = name.isEmpty() ? defaultEncoderName() : name;
+
+#ifdef TIMETRACKER_HAVE_TURBOJPEG
+    if (encoderName == "turbojpeg") {
+        return std::make_shared<TurboJpegEncoder>();
+    }
+#endif
+    if (encoderName == "jpeg") {
+        std::shared_ptr<const QtImageEncoder> encoder = makeQtJpegEncoder();
+        return encoder->isAvailable() ? encoder : nullptr;
+    }
+    if (encoderName == "webp") {
+        std::shared_ptr<const QtImageEncoder> encoder = makeQtWebpEncoder();
+        return encoder->isAvailable() ? encoder : nullptr;
+    }
+    return nullptr;
+}
+
+QStringList ScreenshotEncoder::availableEncoders()
+{
+    QStringList names;
+#ifdef TIMETRACKER_HAVE_TURBOJPEG
+    names.append("turbojpeg");
+#endif
+    if (makeQtJpegEncoder()->isAvailable()) {
+        names.append("jpeg");
+    }
+    if (makeQtWebpEncoder()->isAvailable()) {
+        names.append("webp");
+    }
+    return names;
+}
+
+QString ScreenshotEncoder::defaultEncoderName()
+{
+#ifdef TIMETRACKER_HAVE_TURBOJPEG
+    return "turbojpeg";
+#else
+    return "jpeg";
+#endif
+}
+
+QByteArray ScreenshotEncoder::mimeTypeForFile(const QString& filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == "webp") {
+        return "image/webp";
+    }
+    if (suffix == "png") {
+        return "image/png";
+    }
+    return "image/jpeg";
+}
+
+QImage ScreenshotEncoder::scaledToFit(const QImage& image, const QSize& maxSize)
+{
+    const int maxWidth = maxSize.width() > 0 ? maxSize.width() : std::numeric_limits<int>::max();
+    const int maxHeight = maxSize.height() > 0 ? maxSize.height() : std::numeric_limits<int>::max();
+    if (image.isNull() || (image.width() <= maxWidth && image.height() <= maxHeight)) {
+        return image;
+    }
+    return image.scaled(qMin(maxWidth, image.width()), qMin(maxHeight, image.height()),
+                        Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QSettings>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <memory>
+
+/**
+ * @brief How screenshots are encoded, as configured for the deployment
+ *
+ * Read from the "Screenshots" group of the application settings, which
+ * on Windows is HKCU\Software\TimeTracker\TimeTrackerApp and can be
+ * pushed by policy. RuntimeConfig layers its local file and the server
+ * policy over these keys:
+ * - encoder: a ScreenshotEncoder::availableEncoders() name, empty for the fastest available
+ * - quality: 0-100
+ * - maxWidth, maxHeight: downscale larger screens to fit, 0 leaves that dimension unbounded
+ */
+struct ScreenshotEncoderSettings {
+    QString encoder;               ///< Encoder name, empty for ScreenshotEncoder::defaultEncoderName()
+    int quality = 85;              ///< Encoder quality (0-100)
+    QSize maxSize{0, 0};           ///< Bounding box to downscale to; 0 leaves a dimension unbounded
+
+    /**
+     * @brief Read the settings, falling back to the defaults for missing keys
+     */
+    static ScreenshotEncoderSettings fromSettings(const QSettings& settings);
+
+    /**
+     * @brief Read the settings from "Group/key" values, falling back to the defaults for missing keys
+     */
+    static ScreenshotEncoderSettings fromValues(const QVariantMap& values);
+
+    bool operator==(const ScreenshotEncoderSettings& other) const
+    {
+        return encoder == other.encoder && quality == other.quality && maxSize == other.maxSize;
+    }
+    bool operator!=(const ScreenshotEncoderSettings& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief The ScreenshotEncoder class is the interface for screenshot image encoders
+ *
+ * Implementations are stateless and encode() is called from the
+ * ScreenshotPipeline worker threads, several at a time.
+ *
+ * Available encoders:
+ * - "turbojpeg": libjpeg-turbo's SIMD compressor straight from the
+ *   captured 32-bit pixels, when built with TIMETRACKER_HAVE_TURBOJPEG
+ * - "jpeg": Qt's JPEG image writer
+ * - "webp": Qt's WebP image writer, when the qwebp plugin is deployed
+ */
+class ScreenshotEncoder
+{
+public:
+    virtual ~ScreenshotEncoder() = default;
+
+    /**
+     * @brief Get the name the encoder is configured by
+     */
+    virtual QString name() const = 0;
+
+    /**
+     * @brief Get the MIME type of the encoded data
+     */
+    virtual QByteArray mimeType() const = 0;
+
+    /**
+     * @brief Get the file extension for spilled screenshots, without the dot
+     */
+    virtual QString fileExtension() const = 0;
+
+    /**
+     * @brief Encode an image into memory (thread-safe)
+     * @param image The image to encode
+     * @param quality Encoder quality (0-100)
+     * @param data Receives the encoded bytes
+     * @param errorString Receives the reason if encoding fails, may be null
+     * @return true on success
+     */
+    virtual bool encode(const QImage& image, int quality, QByteArray *data, QString *errorString) const = 0;
+
+    /**
+     * @brief Create an encoder by name
+     * @param name An availableEncoders() name, empty for defaultEncoderName()
+     * @return The encoder, or nullptr if it is unknown or not available in this build
+     */
+    static std::shared_ptr<const ScreenshotEncoder> create(const QString& name);
+
+    /**
+     * @brief Get the names of the encoders usable in this build and deployment, fastest first
+     */
+    static QStringList availableEncoders();
+
+    /**
+     * @brief Get the fastest available JPEG encoder's name
+     */
+    static QString defaultEncoderName();
+
+    /**
+     * @brief Get the MIME type for a spilled screenshot by its file extension
+     */
+    static QByteArray mimeTypeForFile(const QString& filePath);
+
+    /**
+     * @brief Downscale an image to fit a bounding box, keeping its aspect ratio
+     * @param image The captured image
+     * @param maxSize The bounding box; a dimension of 0 or less is unbounded
+     */
+    static QImage scaledToFit(const QImage& image, const QSize& maxSize);
+};
@@ -0,0 +1,286 @@
+#include "ScreenshotPipeline.h"
+#include "Metrics.h"
+#include "ScreenshotDeduplicator.h"
+#include "ScreenshotDeltaEncoder.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtConcurrent>
+
+namespace {
+
+struct ScaledScreen {
+    QImage image;       ///< The capture after downscaling
+    quint64 hash = 0;   ///< differenceHash() of image
+};
+
+} // namespace
+
+/**
+ * @brief Outcome of the prepare stage for one capture
+ */
+struct ScreenshotPipeline::PreparedCapture {
+    QVector<PreparedScreen> screens;   ///< One decision per submitted screen
+    QList<CapturedScreen> changed;     ///< The screens to encode, with their image and delta filled in
+};
+
+ScreenshotPipeline::ScreenshotPipeline(QObject *parent)
+    : QObject(parent)
+    , m_deltaEncoder(std::make_unique<ScreenshotDeltaEncoder>())
+    , m_deduplicator(std::make_unique<ScreenshotDeduplicator>())
+{
+    qRegisterMetaType<ScreenshotResult>();
+    qRegisterMetaType<QVector<ScreenshotResult>>();
+    qRegisterMetaType<PreparedScreen>();
+    qRegisterMetaType<QVector<PreparedScreen>>();
+    m_prepareThreadPool.setMaxThreadCount(1);
+    updateThreadCount();
+    setEncoder(nullptr);
+}
+
+ScreenshotPipeline::~ScreenshotPipeline()
+{
+    // The prepare thread downscales on m_threadPool, so it finishes first
+    m_prepareThreadPool.waitForDone();
+    m_threadPool.waitForDone();
+}
+
+void ScreenshotPipeline::setMaxPending(int count)
+{
+    m_maxPending = qMax(1, count);
+    updateThreadCount();
+}
+
+void ScreenshotPipeline::setEncoder(std::shared_ptr<const ScreenshotEncoder> encoder)
+{
+    m_encoder = encoder ? std::move(encoder) : ScreenshotEncoder::create("jpeg");
+}
+
+void ScreenshotPipeline::updateThreadCount()
+{
+    // Enough threads to encode several screens of one capture side by side
+    m_threadPool.setMaxThreadCount(qMax(m_maxPending, QThread::idealThreadCount()));
+}
+
+bool ScreenshotPipeline::submitScreens(const QList<CapturedScreen>& screens, int quality, const QSize& maxSize)
+{
+    if (screens.isEmpty()) {
+        return false;
+    }
+    if (m_pending >= m_maxPending) {
+        qWarning() << "Screenshot encoder busy -" << m_pending << "captures pending, skipping"
+                   << screens.size() << "screens";
+        return false;
+    }
+
+    ++m_pending;
+    auto *watcher = new QFutureWatcher<PreparedCapture>(this);
+    std::shared_ptr<const ScreenshotEncoder> encoder = m_encoder;
+    connect(watcher, &QFutureWatcher<PreparedCapture>::finished, this, [this, watcher, quality, encoder]() {
+        const PreparedCapture prepared = watcher->result();
+        watcher->deleteLater();
+        emit screensPrepared(prepared.screens);
+
+        if (prepared.changed.isEmpty()) {
+            --m_pending;
+            return;
+        }
+        encodeScreens(prepared.changed, quality, encoder);
+    });
+
+    watcher->setFuture(QtConcurrent::run(&m_prepareThreadPool, [this, screens, maxSize]() {
+        return prepare(screens, maxSize);
+    }));
+    return true;
+}
+
+void ScreenshotPipeline::encodeScreens(const QList<CapturedScreen>& screens, int quality,
+                                       std::shared_ptr<const ScreenshotEncoder> encoder)
+{
+    auto *watcher = new QFutureWatcher<ScreenshotResult>(this);
+    connect(watcher, &QFutureWatcher<ScreenshotResult>::finished, this, [this, watcher]() {
+        --m_pending;
+        const QVector<ScreenshotResult> results = watcher->future().results();
+        watcher->deleteLater();
+        {
+            // Lets later duplicates estimate the bandwidth they saved
+            QMutexLocker locker(&m_stateMutex);
+            for (const ScreenshotResult& result : results) {
+                if (result.success) {
+                    m_deduplicator->recordEncodedBytes(result.screen.index, result.bytes);
+                }
+            }
+        }
+        emit screenshotsEncoded(results);
+    });
+
+    // One task per screen; mapped() keeps the results in submission order
+    watcher->setFuture(QtConcurrent::mapped(&m_threadPool, screens, [quality, encoder](const CapturedScreen& captured) {
+        ScreenshotResult result = encode(captured.image, captured.filePath, quality, encoder.get());
+        result.screen = captured.screen;
+        result.delta = captured.delta;
+        return result;
+    }));
+}
+
+ScreenshotPipeline::PreparedCapture ScreenshotPipeline::prepare(const QList<CapturedScreen>& screens,
+                                                                const QSize& maxSize)
+{
+    applyKeyframeRequests();
+
+    PreparedCapture prepared;
+    prepared.screens.resize(screens.size());
+
+    // Screens the backend saw unchanged since their delta reference need no pixel work at all
+    QList<CapturedScreen> changed;
+    QList<int> changedPositions;
+    for (int i = 0; i < screens.size(); ++i) {
+        const CapturedScreen& captured = screens[i];
+        const int index = captured.screen.index;
+        prepared.screens[i].screen = captured.screen;
+
+        const bool changesKnown = captured.changesKnown && m_changesSinceReference.contains(index);
+        if (changesKnown && m_deltaEncoder->hasReference(index)
+            && (m_changesSinceReference[index] + captured.changedRegion).isEmpty()) {
+            prepared.screens[i].outcome = PreparedScreen::Outcome::Unchanged;
+            continue;
+        }
+        changed.append(captured);
+        changedPositions.append(i);
+    }
+
+    // Downscale before comparing, so dedup and deltas work on what is uploaded; screens side by side
+    const QList<ScaledScreen> scaled = QtConcurrent::blockingMapped(&m_threadPool, changed,
+                                                                    [maxSize](const CapturedScreen& captured) {
+        ScaledScreen result;
+        result.image = ScreenshotEncoder::scaledToFit(captured.image, maxSize);
+        result.hash = ScreenshotDeduplicator::differenceHash(result.image);
+        return result;
+    });
+
+    for (int i = 0; i < changed.size(); ++i) {
+        CapturedScreen captured = changed[i];
+        PreparedScreen& decision = prepared.screens[changedPositions[i]];
+        const int index = captured.screen.index;
+        decision.size = scaled[i].image.size();
+        decision.hash = scaled[i].hash;
+
+        const bool changesKnown = captured.changesKnown && m_changesSinceReference.contains(index);
+        const QRegion changes = changesKnown ? m_changesSinceReference[index] + captured.changedRegion : QRegion();
+
+        bool duplicate;
+        {
+            QMutexLocker locker(&m_stateMutex);
+            duplicate = m_deduplicator->isDuplicateHash(index, decision.hash, &decision.distance);
+            if (duplicate) {
+                qDebug() << "Screen" << index << "unchanged (hash distance" << decision.distance << ") - skipped"
+                         << m_deduplicator->skippedCount() << "of" << m_deduplicator->checkedCount()
+                         << "captures, ~" << (m_deduplicator->savedBytes() / 1024) << "KB saved";
+            }
+        }
+        if (duplicate) {
+            // The delta reference stays, so its changes keep adding up
+            decision.outcome = PreparedScreen::Outcome::Duplicate;
+            if (changesKnown) {
+                m_changesSinceReference[index] = changes;
+            } else {
+                m_changesSinceReference.remove(index);
+            }
+            continue;
+        }
+
+        // Backend changes are in capture pixels and do not apply to a downscaled frame
+        const bool hintUsable = changesKnown && scaled[i].image.size() == captured.image.size();
+        decision.delta = m_deltaEncoder->encode(index, scaled[i].image, captured.image,
+                                                hintUsable ? &changes : nullptr);
+        m_changesSinceReference[index] = QRegion();
+        if (captured.image.isNull()) {
+            decision.outcome = PreparedScreen::Outcome::Identical;
+            continue;
+        }
+
+        if (!decision.delta.keyframe) {
+            qDebug() << "Screen" << index << "delta:" << decision.delta.tiles.size() << "changed tiles -"
+                     << m_deltaEncoder->sentTileCount() << "of" << m_deltaEncoder->totalTileCount()
+                     << "tiles sent so far";
+        }
+        captured.delta = decision.delta;
+        prepared.changed.append(captured);
+    }
+    return prepared;
+}
+
+void ScreenshotPipeline::requestKeyframe(int screenIndex)
+{
+    QMutexLocker locker(&m_stateMutex);
+    m_keyframeRequests.insert(screenIndex);
+}
+
+void ScreenshotPipeline::requestKeyframes()
+{
+    QMutexLocker locker(&m_stateMutex);
+    m_allKeyframesRequested = true;
+}
+
+void ScreenshotPipeline::applyKeyframeRequests()
+{
+    QMutexLocker locker(&m_stateMutex);
+    if (m_allKeyframesRequested) {
+        m_deltaEncoder->resetAll();
+        m_changesSinceReference.clear();
+        m_allKeyframesRequested = false;
+    }
+    for (int screenIndex : std::as_const(m_keyframeRequests)) {
+        m_deltaEncoder->reset(screenIndex);
+        m_changesSinceReference.remove(screenIndex);
+        m_deduplicator->forget(screenIndex);
+    }
+    m_keyframeRequests.clear();
+}
+
+void ScreenshotPipeline::waitForIdle()
+{
+    // Encodes only start once the prepared capture is delivered, so keep delivering
+    while (m_pending > 0) {
+        m_prepareThreadPool.waitForDone();
+        m_threadPool.waitForDone();
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+}
+
+ScreenshotResult ScreenshotPipeline::encode(const QImage& image, const QString& filePath, int quality,
+                                            const ScreenshotEncoder *encoder)
+{
+    static const std::shared_ptr<const ScreenshotEncoder> s_jpegEncoder = ScreenshotEncoder::create("jpeg");
+    if (!encoder) {
+        encoder = s_jpegEncoder.get();
+    }
+
+    ScreenshotResult result;
+    result.filePath = filePath;
+    result.size = image.size();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!encoder) {
+        result.errorString = "No image encoder available";
+    } else {
+        TT_METRIC_SCOPED_TIMER(ScreenshotEncodeMicros);
+        result.mimeType = encoder->mimeType();
+        result.success = encoder->encode(image, quality, &result.data, &result.errorString);
+    }
+
+    if (result.success) {
+        result.bytes = result.data.size();
+        TT_METRIC_ADD(ScreenshotBytesEncoded, static_cast<quint64>(result.bytes));
+    } else {
+        result.data.clear();
+    }
+
+    result.encodeMSecs = timer.elapsed();
+    return result;
+}
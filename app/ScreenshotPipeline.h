@@ -0,0 +1,245 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QRect>
+#include <QRegion>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <memory>
+#include "ScreenshotEncoder.h"
+
+class ScreenshotDeduplicator;
+class ScreenshotDeltaEncoder;
+
+/**
+ * @brief Geometry of the screen a screenshot was taken from
+ */
+struct ScreenInfo {
+    int index = 0;                 ///< Position in QGuiApplication::screens()
+    QString name;                  ///< QScreen::name()
+    QRect geometry;                ///< Virtual desktop geometry in device-independent pixels
+    qreal devicePixelRatio = 1.0;  ///< Physical pixels per device-independent pixel
+    qreal logicalDpi = 96.0;       ///< QScreen::logicalDotsPerInch()
+};
+
+/**
+ * @brief How a captured image relates to the screen's previous upload
+ *
+ * A keyframe carries the whole screen. A delta carries only the tiles
+ * that changed since frame baseSequence, packed row by row into an atlas
+ * of atlasColumns tiles per row, in the order listed in tiles.
+ */
+struct ScreenDelta {
+    bool keyframe = true;          ///< true if the image is the full screen
+    quint64 sequence = 0;          ///< Frame number of this capture on its screen
+    quint64 baseSequence = 0;      ///< Frame the tiles apply to (deltas only)
+    QSize frameSize;               ///< Size of the full screen image
+    int tileSize = 0;              ///< Edge length of a tile in pixels (deltas only)
+    int atlasColumns = 0;          ///< Tiles per atlas row (deltas only)
+    QVector<QRect> tiles;          ///< Changed regions in frame coordinates (deltas only)
+};
+
+/**
+ * @brief One grabbed screen waiting to be encoded
+ */
+struct CapturedScreen {
+    QImage image;              ///< The grabbed image; once prepared, the image to encode or the tile atlas
+    QString filePath;          ///< Spill path for this screen
+    ScreenInfo screen;         ///< Where the image came from
+    ScreenDelta delta;         ///< Keyframe or delta description, filled in by the pipeline
+    bool changesKnown = false; ///< true if changedRegion holds every change since the screen's last submitted capture
+    QRegion changedRegion;     ///< Areas the capture backend reported changed (if changesKnown)
+};
+
+/**
+ * @brief What the pipeline decided for one screen of a capture before encoding
+ */
+struct PreparedScreen {
+    enum class Outcome {
+        Encode,      ///< The image goes to the encoder
+        Unchanged,   ///< The capture backend reported no change; the image was not looked at
+        Duplicate,   ///< The hash is within the deduplicator's threshold of the last upload
+        Identical    ///< No tile differs from the last frame sent
+    };
+
+    ScreenInfo screen;                 ///< Where the image came from
+    Outcome outcome = Outcome::Encode; ///< The decision
+    QSize size;                        ///< Size after downscaling (all but Unchanged)
+    quint64 hash = 0;                  ///< differenceHash() after downscaling (all but Unchanged)
+    int distance = -1;                 ///< Hash distance to the reference (Duplicate only)
+    ScreenDelta delta;                 ///< Keyframe or delta description (Encode only)
+};
+
+/**
+ * @brief Outcome of encoding one screenshot
+ */
+struct ScreenshotResult {
+    QString filePath;          ///< Where to spill the image if it cannot be uploaded
+    ScreenInfo screen;         ///< Source screen, for multi-screen captures
+    ScreenDelta delta;         ///< Keyframe or delta description
+    bool success = false;      ///< true if the image was encoded
+    QByteArray data;           ///< Encoded image bytes
+    QByteArray mimeType;       ///< Type of data, from the encoder
+    QSize size;                ///< Image dimensions
+    qint64 bytes = 0;          ///< Size of the encoded data
+    qint64 encodeMSecs = 0;    ///< Time spent encoding
+    QString errorString;       ///< Encoder error if success is false
+};
+
+/**
+ * @brief The ScreenshotPipeline class prepares and encodes screenshots on a worker pool
+ *
+ * The caller grabs the screens on the GUI thread and hands them to
+ * submitScreens(); everything per pixel happens here. Each screen is
+ * downscaled and hashed on a private thread pool, then compared with the
+ * last upload of its screen by a ScreenshotDeduplicator and turned into a
+ * keyframe or tile delta by a ScreenshotDeltaEncoder. Comparisons depend
+ * on the previous capture, so they run for one capture at a time in
+ * submission order. screensPrepared() reports every decision back on the
+ * pipeline's thread.
+ *
+ * The screens that changed are then encoded by the configured
+ * ScreenshotEncoder, JPEG by default, into in-memory buffers, one task per
+ * screen, and screenshotsEncoded() reports them together. Nothing is
+ * written to disk here; the buffers are uploaded as is.
+ * At most maxPending() captures are in the pipeline at a time; further
+ * submissions are rejected so slow encodes cannot pile up frames.
+ */
+class ScreenshotPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Construct a new ScreenshotPipeline object
+     * @param parent The parent QObject
+     */
+    explicit ScreenshotPipeline(QObject *parent = nullptr);
+
+    /**
+     * @brief Destroy the ScreenshotPipeline object, waiting for running encodes
+     */
+    ~ScreenshotPipeline();
+
+    /**
+     * @brief Queue all screens of one capture, preparing and encoding them in parallel
+     * @param screens The grabbed screens
+     * @param quality Encoder quality (0-100)
+     * @param maxSize Bounding box to downscale to; a dimension of 0 or less is unbounded
+     * @return true if queued, false if empty or too many captures are already pending
+     */
+    bool submitScreens(const QList<CapturedScreen>& screens, int quality, const QSize& maxSize = QSize());
+
+    /**
+     * @brief Send the next capture of a screen in full, e.g. after its upload failed
+     *
+     * The screen's duplicate reference is dropped as well, since the
+     * server may not have the last upload. Applies from the next capture
+     * prepared.
+     * @param screenIndex Screen whose server-side copy may be stale
+     */
+    void requestKeyframe(int screenIndex);
+
+    /**
+     * @brief Send the next capture of every screen in full, e.g. after the encoder changed
+     */
+    void requestKeyframes();
+
+    /**
+     * @brief Get the number of captures currently being encoded
+     */
+    int pendingCount() const { return m_pending; }
+
+    /**
+     * @brief Set the maximum number of captures encoded at a time
+     * @param count The limit, at least 1
+     */
+    void setMaxPending(int count);
+
+    /**
+     * @brief Get the maximum number of captures encoded at a time
+     */
+    int maxPending() const { return m_maxPending; }
+
+    /**
+     * @brief Set the encoder used for later submissions
+     * @param encoder The encoder; nullptr restores the default JPEG encoder
+     */
+    void setEncoder(std::shared_ptr<const ScreenshotEncoder> encoder);
+
+    /**
+     * @brief Get the encoder used for new submissions
+     */
+    std::shared_ptr<const ScreenshotEncoder> encoder() const { return m_encoder; }
+
+    /**
+     * @brief Block until all queued screenshots are prepared, encoded and reported
+     */
+    void waitForIdle();
+
+    /**
+     * @brief Encode an image into memory (thread-safe)
+     * @param image The image to encode
+     * @param filePath Spill path stored in the result
+     * @param quality Encoder quality (0-100)
+     * @param encoder The encoder to use, nullptr for Qt's JPEG writer
+     * @return The outcome
+     */
+    static ScreenshotResult encode(const QImage& image, const QString& filePath, int quality,
+                                   const ScreenshotEncoder *encoder = nullptr);
+
+    static const int DEFAULT_MAX_PENDING = 2;  ///< Default encode limit
+
+signals:
+    /**
+     * @brief Emitted on the pipeline's thread when every screen of a capture has been compared
+     * @param screens One decision per submitted screen, in submission order
+     */
+    void screensPrepared(const QVector<PreparedScreen>& screens);
+
+    /**
+     * @brief Emitted on the pipeline's thread when every changed screen of a capture has been encoded
+     *
+     * Not emitted for a capture in which no screen changed.
+     * @param results One outcome per encoded screen, in submission order
+     */
+    void screenshotsEncoded(const QVector<ScreenshotResult>& results);
+
+private:
+    struct PreparedCapture;
+
+    PreparedCapture prepare(const QList<CapturedScreen>& screens, const QSize& maxSize);
+    void encodeScreens(const QList<CapturedScreen>& screens, int quality,
+                       std::shared_ptr<const ScreenshotEncoder> encoder);
+    void applyKeyframeRequests();
+    void updateThreadCount();
+
+    QThreadPool m_threadPool;       ///< Downscaling and encoder threads, separate from the global pool
+    QThreadPool m_prepareThreadPool; ///< One thread, so captures are compared in submission order
+    std::shared_ptr<const ScreenshotEncoder> m_encoder; ///< Shared with the encodes still running
+    int m_pending = 0;              ///< Submitted but not yet reported
+    int m_maxPending = DEFAULT_MAX_PENDING;
+
+    // Comparison state, used by the prepare thread only
+    std::unique_ptr<ScreenshotDeltaEncoder> m_deltaEncoder;
+    QHash<int, QRegion> m_changesSinceReference; ///< Backend changes since each delta reference, if known
+
+    // Shared with the pipeline's thread
+    QMutex m_stateMutex;
+    std::unique_ptr<ScreenshotDeduplicator> m_deduplicator; ///< Guarded by m_stateMutex
+    QSet<int> m_keyframeRequests;                ///< Guarded by m_stateMutex
+    bool m_allKeyframesRequested = false;        ///< Guarded by m_stateMutex
+};
+
+Q_DECLARE_METATYPE(ScreenshotResult)
+Q_DECLARE_METATYPE(QVector<ScreenshotResult>)
+Q_DECLARE_METATYPE(PreparedScreen)
+Q_DECLARE_METATYPE(QVector<PreparedScreen>)
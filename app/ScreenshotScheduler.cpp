@@ -0,0 +1,168 @@
+#include "ScreenshotScheduler.h"
+#include <QDebug>
+#include <QRandomGenerator>
+
+ScreenshotScheduler::ScreenshotScheduler(int intervalMSecs, QObject *parent)
+    : QObject(parent)
+{
+    const int interval = qMax(1, intervalMSecs);
+
+    m_periodTimer = new QTimer(this);
+    m_periodTimer->setInterval(interval);
+    connect(m_periodTimer, &QTimer::timeout, this, &ScreenshotScheduler::onPeriodElapsed);
+
+    m_captureTimer = new QTimer(this);
+    m_captureTimer->setSingleShot(true);
+    connect(m_captureTimer, &QTimer::timeout, this, &ScreenshotScheduler::onCaptureDue);
+
+    m_jitterMSecs = interval / 100 * DEFAULT_JITTER_PERCENT;
+    m_minimumSpacingMSecs = qMin(DEFAULT_MINIMUM_SPACING_MS, interval);
+    m_spacingMSecs = m_minimumSpacingMSecs;
+    m_clock.start();
+}
+
+void ScreenshotScheduler::start()
+{
+    if (m_running) {
+        return;
+    }
+    m_running = true;
+
+    if (!isPaused()) {
+        m_periodTimer->start();
+    }
+}
+
+void ScreenshotScheduler::stop()
+{
+    m_running = false;
+    m_periodTimer->stop();
+    m_captureTimer->stop();
+}
+
+void ScreenshotScheduler::setIntervalMSecs(int intervalMSecs)
+{
+    const int interval = qMax(1, intervalMSecs);
+    if (interval == m_periodTimer->interval()) {
+        return;
+    }
+
+    // setInterval() restarts an active timer, so the new period counts from now
+    m_periodTimer->setInterval(interval);
+    m_jitterMSecs = qMin(m_jitterMSecs, interval);
+    m_minimumSpacingMSecs = qMin(m_minimumSpacingMSecs, interval);
+    m_spacingMSecs = qMin(m_spacingMSecs, interval);
+}
+
+void ScreenshotScheduler::setJitterMSecs(int jitterMSecs)
+{
+    m_jitterMSecs = qBound(0, jitterMSecs, intervalMSecs());
+}
+
+void ScreenshotScheduler::setMinimumSpacingMSecs(int spacingMSecs)
+{
+    m_minimumSpacingMSecs = qBound(0, spacingMSecs, intervalMSecs());
+    m_spacingMSecs = m_minimumSpacingMSecs;
+}
+
+void ScreenshotScheduler::setIdle(bool idle)
+{
+    const bool wasPaused = isPaused();
+    m_idle = idle;
+    updatePaused(wasPaused);
+}
+
+void ScreenshotScheduler::setSessionLocked(bool locked)
+{
+    const bool wasPaused = isPaused();
+    m_sessionLocked = locked;
+    updatePaused(wasPaused);
+}
+
+void ScreenshotScheduler::notifyForegroundChanged(const QString& processName)
+{
+    if (processName == m_processName) {
+        return;
+    }
+    m_processName = processName;
+
+    if (!m_running || isPaused()) {
+        return;
+    }
+
+    // The burst is over once a whole interval passed without a switch capture
+    const qint64 now = m_clock.elapsed();
+    if (m_lastSwitchCaptureMSecs >= 0 && now - m_lastSwitchCaptureMSecs >= intervalMSecs()) {
+        m_spacingMSecs = m_minimumSpacingMSecs;
+    }
+
+    qint64 delay = SETTLE_DELAY_MS;
+    if (m_lastCaptureMSecs >= 0) {
+        delay = qMax(delay, m_lastCaptureMSecs + m_spacingMSecs - now);
+    }
+    schedule(Trigger::ForegroundChanged, static_cast<int>(delay));
+}
+
+void ScreenshotScheduler::onPeriodElapsed()
+{
+    // A switch or resume capture is already on its way
+    if (m_captureTimer->isActive()) {
+        return;
+    }
+    schedule(Trigger::Periodic, randomJitter());
+}
+
+void ScreenshotScheduler::onCaptureDue()
+{
+    if (!m_running || isPaused()) {
+        return;
+    }
+
+    const Trigger trigger = m_pendingTrigger;
+    m_lastCaptureMSecs = m_clock.elapsed();
+
+    if (trigger != Trigger::Periodic) {
+        // Count the interval from this capture so a periodic one does not follow right away
+        m_periodTimer->start();
+    }
+    if (trigger == Trigger::ForegroundChanged) {
+        m_lastSwitchCaptureMSecs = m_lastCaptureMSecs;
+        m_spacingMSecs = qMin(qMax(1, m_spacingMSecs * 2), intervalMSecs());
+    }
+
+    emit captureRequested(trigger);
+}
+
+void ScreenshotScheduler::schedule(Trigger trigger, int delayMSecs)
+{
+    // Only one capture is ever pending; keep whichever is due first
+    if (m_captureTimer->isActive() && m_captureTimer->remainingTime() <= delayMSecs) {
+        return;
+    }
+
+    m_pendingTrigger = trigger;
+    m_captureTimer->start(qMax(0, delayMSecs));
+}
+
+void ScreenshotScheduler::updatePaused(bool wasPaused)
+{
+    const bool paused = isPaused();
+    if (paused == wasPaused || !m_running) {
+        return;
+    }
+
+    if (paused) {
+        m_periodTimer->stop();
+        m_captureTimer->stop();
+        qDebug() << "Screenshot capture paused -" << (m_sessionLocked ? "session locked" : "user idle");
+    } else {
+        m_periodTimer->start();
+        schedule(Trigger::Resumed, SETTLE_DELAY_MS + randomJitter());
+        qDebug() << "Screenshot capture resumed";
+    }
+}
+
+int ScreenshotScheduler::randomJitter() const
+{
+    return m_jitterMSecs > 0 ? static_cast<int>(QRandomGenerator::global()->bounded(m_jitterMSecs + 1)) : 0;
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+/**
+ * @brief The ScreenshotScheduler class decides when a screenshot is taken
+ *
+ * A repeating timer keeps the configured interval, but each periodic
+ * capture is delayed by a random jitter of up to jitterMSecs() so that
+ * clients started together do not upload in the same second. Nothing is
+ * captured while the user is idle or the session is locked; when both
+ * end, one capture follows shortly.
+ *
+ * Switching to another application captures soon after the switch. Such
+ * captures are kept at least currentSpacingMSecs() apart from any other
+ * capture; the spacing doubles with every switch capture, up to the
+ * interval, and falls back to minimumSpacingMSecs() once no switch has
+ * been captured for a whole interval. A switch capture restarts the
+ * interval, so the next periodic capture does not follow right after it.
+ */
+class ScreenshotScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Why a capture was requested
+     */
+    enum class Trigger {
+        Periodic,           ///< The interval elapsed
+        ForegroundChanged,  ///< Another application came to the front
+        Resumed             ///< The user came back from idle or unlocked the session
+    };
+    Q_ENUM(Trigger)
+
+    /**
+     * @brief Construct a new ScreenshotScheduler object
+     * @param intervalMSecs Time between periodic captures
+     * @param parent The parent QObject
+     */
+    explicit ScreenshotScheduler(int intervalMSecs, QObject *parent = nullptr);
+
+    /**
+     * @brief Start scheduling captures
+     */
+    void start();
+
+    /**
+     * @brief Stop scheduling and drop any pending capture
+     */
+    void stop();
+
+    /**
+     * @brief Check whether the scheduler was started
+     */
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief Check whether captures are suspended because the user is idle or locked out
+     */
+    bool isPaused() const { return m_idle || m_sessionLocked; }
+
+    /**
+     * @brief Get the time between periodic captures
+     */
+    int intervalMSecs() const { return m_periodTimer->interval(); }
+
+    /**
+     * @brief Change the time between periodic captures
+     *
+     * A running period restarts at the new length, and jitter and spacing
+     * are clamped to it. A pending capture is kept.
+     * @param intervalMSecs The new interval, at least 1
+     */
+    void setIntervalMSecs(int intervalMSecs);
+
+    /**
+     * @brief Set the largest random delay added to a periodic capture
+     * @param jitterMSecs Clamped to 0..intervalMSecs()
+     */
+    void setJitterMSecs(int jitterMSecs);
+
+    /**
+     * @brief Get the largest random delay added to a periodic capture
+     */
+    int jitterMSecs() const { return m_jitterMSecs; }
+
+    /**
+     * @brief Set the spacing application switch captures start from
+     * @param spacingMSecs Clamped to 0..intervalMSecs()
+     */
+    void setMinimumSpacingMSecs(int spacingMSecs);
+
+    /**
+     * @brief Get the spacing application switch captures start from
+     */
+    int minimumSpacingMSecs() const { return m_minimumSpacingMSecs; }
+
+    /**
+     * @brief Get the spacing the next application switch capture has to keep
+     */
+    int currentSpacingMSecs() const { return m_spacingMSecs; }
+
+    /**
+     * @brief Suspend or resume captures because of the user's idle state
+     */
+    void setIdle(bool idle);
+
+    /**
+     * @brief Suspend or resume captures because the session is locked
+     */
+    void setSessionLocked(bool locked);
+
+    /**
+     * @brief Report the foreground application
+     * @param processName Executable name; a change of window title alone is ignored
+     */
+    void notifyForegroundChanged(const QString& processName);
+
+    static const int DEFAULT_JITTER_PERCENT = 10;       ///< Default jitter as a share of the interval
+    static const int DEFAULT_MINIMUM_SPACING_MS = 5000; ///< Default spacing of switch captures
+    static const int SETTLE_DELAY_MS = 750;             ///< Lets the new window paint before it is captured
+
+signals:
+    /**
+     * @brief Emitted when a screenshot should be taken now
+     */
+    void captureRequested(ScreenshotScheduler::Trigger trigger);
+
+private slots:
+    void onPeriodElapsed();
+    void onCaptureDue();
+
+private:
+    void schedule(Trigger trigger, int delayMSecs);
+    void updatePaused(bool wasPaused);
+    int randomJitter() const;
+
+    QTimer *m_periodTimer = nullptr;      ///< Repeats at the capture interval
+    QTimer *m_captureTimer = nullptr;     ///< Fires the one pending capture
+    Trigger m_pendingTrigger = Trigger::Periodic;
+    QElapsedTimer m_clock;
+
+    bool m_running = false;
+    bool m_idle = false;
+    bool m_sessionLocked = false;
+    int m_jitterMSecs = 0;
+    int m_minimumSpacingMSecs = DEFAULT_MINIMUM_SPACING_MS;
+    int m_spacingMSecs = DEFAULT_MINIMUM_SPACING_MS;
+
+    QString m_processName;                ///< Last reported foreground process
+    qint64 m_lastCaptureMSecs = -1;       ///< m_clock time of the last capture, -1 if none
+    qint64 m_lastSwitchCaptureMSecs = -1; ///< m_clock time of the last switch capture, -1 if none
+};
@@ -2,6 +2,17 @@
 #include "ApiService.h"
 #include "IdleDetector.h"
 #include "IdleAnnotationDialog.h"
+#include "ActivityClock.h"
+#include "ActivityCollector.h"
+#include "ActivityEventBus.h"
+#include "ActivityLogWriter.h"
+#include "ActivityTrace.h"
+#include "ScreenshotPipeline.h"
+#include "ForegroundWindowTracker.h"
+#include "Metrics.h"
+#include "MetricsReporter.h"
+#include "RuntimeConfig.h"
+#include "ScreenshotScheduler.h"
 #include <QApplication>
 #include <QLabel>
 #include <QVBoxLayout>
@@ -14,124 +25,14 @@
 #include <QDateTime>
 #include <QDebug>
 #include <QFileInfo>
+#include <QSettings>
 #include <windows.h>
-#include <fstream>
-#include <chrono>
-#include <ctime>
-#include <iomanip>
-#include <sstream>
 #include <Psapi.h>
-
-// Static instance pointer for Windows hooks
-TimeTrackerMainWindow* TimeTrackerMainWindow::s_instance = nullptr;
-
-// Static callback functions for Windows hooks
-LRESULT CALLBACK TimeTrackerMainWindow::LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam)
-{
-    if (nCode == HC_ACTION) {
-        // Update idle detector if instance exists
-        if (s_instance && s_instance->m_idleDetector) {
-            s_instance->m_idleDetector->updateLastActivityTime();
-        }
-        std::ofstream log("activity_log.txt", std::ios::app);
-        if (log.is_open()) {
-            // Get current timestamp
-            auto now = std::chrono::system_clock::now();
-            std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-            std::tm tm;
-            localtime_s(&tm, &now_c);
-
-            // Format timestamp
-            std::stringstream ss;
-            ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-
-            // Log keyboard event
-            std::string eventType;
-            switch (wParam) {
-                case WM_KEYDOWN:
-                    eventType = "KEY_DOWN";
-                    break;
-                case WM_KEYUP:
-                    eventType = "KEY_UP";
-                    break;
-                case WM_SYSKEYDOWN:
-                    eventType = "SYSKEY_DOWN";
-                    break;
-                case WM_SYSKEYUP:
-                    eventType = "SYSKEY_UP";
-                    break;
-                default:
-                    eventType = "KEY_OTHER";
-                    break;
-            }
-
-            KBDLLHOOKSTRUCT* p = reinterpret_cast<KBDLLHOOKSTRUCT*>(lParam);
-            log << ss.str() << " - " << eventType << " - VK Code: " << p->vkCode << std::endl;
-            log.close();
-        }
-    }
-    return CallNextHookEx(NULL, nCode, wParam, lParam);
-}
-
-LRESULT CALLBACK TimeTrackerMainWindow::LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam)
-{
-    if (nCode == HC_ACTION) {
-        // Update idle detector if instance exists
-        if (s_instance && s_instance->m_idleDetector) {
-            s_instance->m_idleDetector->updateLastActivityTime();
-        }
-        std::ofstream log("activity_log.txt", std::ios::app);
-        if (log.is_open()) {
-            // Get current timestamp
-            auto now = std::chrono::system_clock::now();
-            std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-            std::tm tm;
-            localtime_s(&tm, &now_c);
-
-            // Format timestamp
-            std::stringstream ss;
-            ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-
-            // Log mouse event
-            std::string eventType;
-            switch (wParam) {
-                case WM_LBUTTONDOWN:
-                    eventType = "MOUSE_LEFT_DOWN";
-                    break;
-                case WM_LBUTTONUP:
-                    eventType = "MOUSE_LEFT_UP";
-                    break;
-                case WM_RBUTTONDOWN:
-                    eventType = "MOUSE_RIGHT_DOWN";
-                    break;
-                case WM_RBUTTONUP:
-                    eventType = "MOUSE_RIGHT_UP";
-                    break;
-                case WM_MOUSEMOVE:
-                    eventType = "MOUSE_MOVE";
-                    break;
-                case WM_MOUSEWHEEL:
-                    eventType = "MOUSE_WHEEL";
-                    break;
-                default:
-                    eventType = "MOUSE_OTHER";
-                    break;
-            }
-
-            MSLLHOOKSTRUCT* p = reinterpret_cast<MSLLHOOKSTRUCT*>(lParam);
-            log << ss.str() << " - " << eventType << " - X: " << p->pt.x << ", Y: " << p->pt.y << std::endl;
-            log.close();
-        }
-    }
-    return CallNextHookEx(NULL, nCode, wParam, lParam);
-}
+#include <wtsapi32.h>
 
 TimeTrackerMainWindow::TimeTrackerMainWindow(QWidget *parent)
     : QMainWindow(parent)
 {
-    // Set static instance for hook callbacks
-    s_instance = this;
-
     setWindowTitle("Time Tracker Application");
     setFixedSize(400, 300);
 
@@ -159,14 +60,29 @@ TimeTrackerMainWindow::TimeTrackerMainWindow(QWidget *parent)
     layout->addWidget(versionLabel);
     layout->addStretch();
 
+    // Intervals, thresholds and pipeline modes every component below starts from
+    setupRuntimeConfig();
+
+    // Start the background activity log writer before anything can log
+    setupActivityLogging();
+    applyTraceSettings(m_runtimeConfig->settings());
+
     // Setup system tray icon
     setupSystemTray();
 
-    // Setup screenshot directory and timer
+    // Setup screenshot directory, encoder and timer
     setupScreenshotDirectory();
+    setupScreenshotPipeline();
     configureScreenshotTimer();
 
-    // Setup application tracking timer
+    // Hold screenshots while the workstation is locked
+    m_sessionNotificationsRegistered =
+        WTSRegisterSessionNotification(reinterpret_cast<HWND>(winId()), NOTIFY_FOR_THIS_SESSION) != FALSE;
+    if (!m_sessionNotificationsRegistered) {
+        qWarning() << "Failed to register for session lock notifications, error" << GetLastError();
+    }
+
+    // Setup application tracking
     configureAppTracker();
 
     // Setup idle detection
@@ -174,6 +90,8 @@ TimeTrackerMainWindow::TimeTrackerMainWindow(QWidget *parent)
 
     // Initialize API service for backend communication
     m_apiService = new ApiService(this);
+    m_apiService->setIdentity(getCurrentUserEmail(), getCurrentSessionId());
+    applyUploadSettings(m_runtimeConfig->settings());
 
     // Connect API service signals
     connect(m_apiService, &ApiService::screenshotUploaded,
@@ -184,6 +102,8 @@ TimeTrackerMainWindow::TimeTrackerMainWindow(QWidget *parent)
                     qWarning() << "Screenshot upload failed:" << filePath;
                 }
             });
+    connect(m_apiService, &ApiService::screenshotKeyframeRequired,
+            this, &TimeTrackerMainWindow::onScreenshotKeyframeRequired);
 
     connect(m_apiService, &ApiService::activityLogsUploaded,
             this, [this](bool success) {
@@ -203,51 +123,73 @@ TimeTrackerMainWindow::TimeTrackerMainWindow(QWidget *parent)
                 }
             });
 
-    // Setup Windows hooks for activity tracking
-    m_keyboardHook = SetWindowsHookExW(WH_KEYBOARD_LL, LowLevelKeyboardProc, GetModuleHandle(NULL), 0);
-    m_mouseHook = SetWindowsHookExW(WH_MOUSE_LL, LowLevelMouseProc, GetModuleHandle(NULL), 0);
+    // A user going idle is a natural point to upload what was recorded so far
+    ApiService *apiService = m_apiService;
+    m_eventBus->subscribe("uploader", ActivityEventBus::typeBit(ActivityEventType::IdleStarted),
+                          [apiService](const QVector<ActivityEvent>&) { apiService->uploadActivityLogs(); },
+                          m_apiService);
 
-    if (m_keyboardHook == NULL || m_mouseHook == NULL) {
+    // Completed minutes are queued for upload alongside or instead of the raw journal
+    m_summaryTimer = new QTimer(this);
+    connect(m_summaryTimer, &QTimer::timeout, this, &TimeTrackerMainWindow::flushActivitySummaries);
+    m_summaryTimer->start(SUMMARY_FLUSH_INTERVAL_MS);
+
+    // Install the input hooks on their own thread so a busy GUI thread never delays input
+    m_activityCollector = new ActivityCollector(m_eventBus, this);
+    if (!m_activityCollector->start()) {
         QString errorMsg = QString("Failed to set up activity tracking hooks.\n");
-        if (m_keyboardHook == NULL) {
-            errorMsg += QString("Keyboard hook failed. Error: %1\n").arg(GetLastError());
-        }
-        if (m_mouseHook == NULL) {
-            errorMsg += QString("Mouse hook failed. Error: %1\n").arg(GetLastError());
-        }
+        errorMsg += m_activityCollector->errorString();
         errorMsg += "This may require administrator privileges.";
         QMessageBox::warning(this, "Hook Setup", errorMsg);
     } else {
         // Create initial log entry to confirm hooks are working
-        std::ofstream log("activity_log.txt", std::ios::app);
-        if (log.is_open()) {
-            auto now = std::chrono::system_clock::now();
-            std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-            std::tm tm;
-            localtime_s(&tm, &now_c);
-            std::stringstream ss;
-            ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-            log << ss.str() << " - SYSTEM - Activity tracking started" << std::endl;
-            log.close();
-        }
+        m_activityLogWriter->logSystemMessage("Activity tracking started");
+    }
+
+    // Later changes to the file or server policy are applied to the running components
+    connect(m_apiService, &ApiService::clientPolicyReceived, m_runtimeConfig, &RuntimeConfig::setServerPolicy);
+    connect(m_runtimeConfig, &RuntimeConfig::settingsChanged, this, &TimeTrackerMainWindow::applyRuntimeSettings);
+    m_policyTimer = new QTimer(this);
+    connect(m_policyTimer, &QTimer::timeout, this, &TimeTrackerMainWindow::fetchClientPolicy);
+    if (m_runtimeConfig->settings().policyRefreshSecs > 0) {
+        m_policyTimer->start(m_runtimeConfig->settings().policyRefreshSecs * 1000);
+        fetchClientPolicy();
     }
+
+    m_metricsReporter = new MetricsReporter(MetricsReporter::defaultFilePath(), this);
+    applyMetricsSettings(m_runtimeConfig->settings());
+    connect(m_metricsReporter, &MetricsReporter::telemetryReady, this, [this](const QJsonObject& record) {
+        m_apiService->uploadTelemetry(record, getCurrentUserEmail(), getCurrentSessionId());
+    });
+    m_metricsReporter->start();
 }
 
 TimeTrackerMainWindow::~TimeTrackerMainWindow()
 {
-    // Reset static instance
-    s_instance = nullptr;
+    // Remove the input hooks and stop the collector thread
+    if (m_activityCollector) {
+        m_activityCollector->stop();
+    }
 
-    // Stop screenshot timer
-    if (m_screenshotTimer) {
-        m_screenshotTimer->stop();
-        qDebug() << "Screenshot timer stopped";
+    // Deliver the last events to the journal before the writer stops
+    if (m_eventBus) {
+        m_eventBus->stop();
+        qDebug() << "Activity event bus stopped - dropped events:" << m_eventBus->droppedEventCount();
     }
 
-    // Stop application tracking timer
-    if (m_appTrackerTimer) {
-        m_appTrackerTimer->stop();
-        qDebug() << "Application tracking timer stopped";
+    // Stop screenshot scheduling
+    if (m_sessionNotificationsRegistered) {
+        WTSUnRegisterSessionNotification(reinterpret_cast<HWND>(winId()));
+    }
+    if (m_screenshotScheduler) {
+        m_screenshotScheduler->stop();
+        qDebug() << "Screenshot scheduler stopped";
+    }
+
+    // Stop application tracking
+    if (m_foregroundTracker) {
+        m_foregroundTracker->stop();
+        qDebug() << "Application tracking stopped";
     }
 
     // Stop idle detector
@@ -256,15 +198,20 @@ TimeTrackerMainWindow::~TimeTrackerMainWindow()
         qDebug() << "Idle detector stopped";
     }
 
-    // Clean up Windows hooks
-    if (m_keyboardHook != nullptr) {
-        UnhookWindowsHookEx(m_keyboardHook);
-        m_keyboardHook = nullptr;
+    // The trace ends with the journal; a batch still on the bus is not recorded
+    if (m_traceWriter) {
+        m_traceWriter->close();
+    }
+
+    // Flush and stop the activity log writer once no more hook events can arrive
+    if (m_activityLogWriter) {
+        m_activityLogWriter->stop();
+        qDebug() << "Activity log writer stopped - dropped events:" << m_activityLogWriter->droppedEventCount();
     }
 
-    if (m_mouseHook != nullptr) {
-        UnhookWindowsHookEx(m_mouseHook);
-        m_mouseHook = nullptr;
+    // Last, so the file holds the final counts of every component
+    if (m_metricsReporter) {
+        m_metricsReporter->stop();
     }
 
     qDebug() << "TimeTrackerMainWindow destroyed and all resources cleaned up";
@@ -334,7 +281,7 @@ void TimeTrackerMainWindow::closeEvent(QCloseEvent *event)
     QString message = QString("Screenshot capture and activity logging continue in background.\n"
                              "Capturing every %1 seconds at %2% quality.")
                      .arg(m_screenshotInterval / 1000)
-                     .arg(m_jpegQuality);
+                     .arg(m_encoderSettings.quality);
 
     m_trayIcon->showMessage(
         "Time Tracker is Active",
@@ -347,6 +294,62 @@ void TimeTrackerMainWindow::closeEvent(QCloseEvent *event)
     event->ignore();
 }
 
+bool TimeTrackerMainWindow::nativeEvent(const QByteArray& eventType, void *message, qintptr *result)
+{
+    const MSG *msg = static_cast<const MSG*>(message);
+    if (eventType == "windows_generic_MSG" && msg->message == WM_WTSSESSION_CHANGE && m_screenshotScheduler) {
+        if (msg->wParam == WTS_SESSION_LOCK) {
+            m_screenshotScheduler->setSessionLocked(true);
+        } else if (msg->wParam == WTS_SESSION_UNLOCK) {
+            m_screenshotScheduler->setSessionLocked(false);
+        }
+    }
+    return QMainWindow::nativeEvent(eventType, message, result);
+}
+
+void TimeTrackerMainWindow::setupRuntimeConfig()
+{
+    // The deployment's registry settings sit under the local file and the server policy
+    m_runtimeConfig = new RuntimeConfig(RuntimeConfig::defaultFilePath(), this);
+    m_runtimeConfig->setBaseValues(RuntimeConfig::valuesOf(QSettings()));
+}
+
+void TimeTrackerMainWindow::setupActivityLogging()
+{
+    m_activityLogWriter = new ActivityLogWriter(ActivityJournal::DEFAULT_FILE_NAME, this);
+
+    // Entries from older builds are converted into the journal on the writer thread
+    m_activityLogWriter->setLegacyLogFilePath("activity_log.txt");
+    m_activityLogWriter->setMoveCoalescingIntervalMSecs(m_runtimeConfig->settings().moveCoalescingMSecs);
+    m_activityLogWriter->start();
+
+    qDebug() << "Activity log writer started:" << m_activityLogWriter->journalFilePath();
+
+    // Input events reach the journal through the bus; the bus thread is the writer's only producer
+    m_eventBus = new ActivityEventBus(this);
+    ActivityLogWriter *writer = m_activityLogWriter;
+    m_eventBus->subscribe("journal", ActivityEventBus::INPUT_EVENTS, [writer](const QVector<ActivityEvent>& events) {
+        for (const ActivityEvent& event : events) {
+            writer->pushEvent(event);
+        }
+    });
+
+    // Folded into per-minute summaries on the bus thread, so a busy GUI thread loses no counts
+    m_eventBus->subscribe("summary",
+                          ActivityEventBus::INPUT_EVENTS
+                              | ActivityEventBus::typeBit(ActivityEventType::IdleStarted)
+                              | ActivityEventBus::typeBit(ActivityEventType::IdleEnded),
+                          [this](const QVector<ActivityEvent>& events) { m_activityAggregator.addEvents(events); });
+
+    // Status changes update the tray tooltip once per batch on the GUI thread
+    m_eventBus->subscribe("tray",
+                          ActivityEventBus::typeBit(ActivityEventType::ScreenshotCaptured)
+                              | ActivityEventBus::typeBit(ActivityEventType::IdleStarted)
+                              | ActivityEventBus::typeBit(ActivityEventType::IdleEnded),
+                          [this](const QVector<ActivityEvent>& events) { updateTrayStatus(events); }, this);
+    m_eventBus->start();
+}
+
 void TimeTrackerMainWindow::setupScreenshotDirectory()
 {
     // Get the standard AppData location for this application
@@ -368,186 +371,294 @@ void TimeTrackerMainWindow::setupScreenshotDirectory()
     }
 }
 
-void TimeTrackerMainWindow::configureScreenshotTimer()
+void TimeTrackerMainWindow::setupScreenshotPipeline()
 {
-    // Initialize screenshot timer
-    m_screenshotTimer = new QTimer(this);
-    connect(m_screenshotTimer, &QTimer::timeout, this, &TimeTrackerMainWindow::captureScreenshot);
+    m_screenshotPipeline = new ScreenshotPipeline(this);
+    connect(m_screenshotPipeline, &ScreenshotPipeline::screensPrepared,
+            this, &TimeTrackerMainWindow::onScreensPrepared);
+    connect(m_screenshotPipeline, &ScreenshotPipeline::screenshotsEncoded,
+            this, &TimeTrackerMainWindow::onScreenshotsEncoded);
+
+    // Encoder and size targets come from the runtime configuration
+    applyEncoderSettings(m_runtimeConfig->settings().encoder);
+
+    // Desktop Duplication unless the configuration asks for the GDI grab
+    m_desktopDuplication.setEnabled(m_runtimeConfig->settings().desktopDuplication);
+    qDebug() << "Screen capture backend:"
+             << (m_desktopDuplication.isEnabled() && DesktopDuplicationCapture::isSupported()
+                     ? "Desktop Duplication" : "GDI");
+
+    // Monitor handles and screen indices change with the display layout
+    auto resetCapture = [this]() {
+        m_desktopDuplication.reset();
+        m_screenChanges.clear();
+    };
+    connect(qApp, &QGuiApplication::screenAdded, this, resetCapture);
+    connect(qApp, &QGuiApplication::screenRemoved, this, resetCapture);
+}
 
-    // Configure interval based on build type
-#ifdef QT_DEBUG
-    m_screenshotInterval = 10 * 1000;      // 10 seconds for development/testing
-#else
-    m_screenshotInterval = 10 * 60 * 1000; // 10 minutes for production
-#endif
+void TimeTrackerMainWindow::applyEncoderSettings(const ScreenshotEncoderSettings& settings)
+{
+    m_encoderSettings = settings;
+    std::shared_ptr<const ScreenshotEncoder> encoder = ScreenshotEncoder::create(m_encoderSettings.encoder);
+    if (!encoder) {
+        qWarning() << "Screenshot encoder" << m_encoderSettings.encoder << "is not available (available:"
+                   << ScreenshotEncoder::availableEncoders() << ") - using" << ScreenshotEncoder::defaultEncoderName();
+        encoder = ScreenshotEncoder::create(QString());
+    }
+    m_screenshotPipeline->setEncoder(encoder);
+
+    qDebug() << "Screenshot encoder:" << (encoder ? encoder->name() : QString("none"))
+             << "Quality:" << m_encoderSettings.quality << "Max size:" << m_encoderSettings.maxSize;
+}
 
-    m_screenshotTimer->setInterval(m_screenshotInterval);
-    m_screenshotTimer->start();
+void TimeTrackerMainWindow::configureScreenshotTimer()
+{
+    // The default interval depends on the build type: 10 seconds in debug, 10 minutes in release
+    m_screenshotInterval = m_runtimeConfig->settings().screenshotIntervalSecs * 1000;
+
+    m_screenshotScheduler = new ScreenshotScheduler(m_screenshotInterval, this);
+    applyScreenshotSchedule(m_runtimeConfig->settings());
+    connect(m_screenshotScheduler, &ScreenshotScheduler::captureRequested,
+            this, [this](ScreenshotScheduler::Trigger trigger) {
+                qDebug() << "Screenshot triggered by" << trigger;
+                captureScreenshot();
+            });
+    m_screenshotScheduler->start();
 
-    qDebug() << "Screenshot timer configured and started:";
+    qDebug() << "Screenshot scheduler configured and started:";
     qDebug() << "  Interval:" << m_screenshotInterval << "ms ("
              << (m_screenshotInterval / 1000) << "seconds)";
-    qDebug() << "  Quality:" << m_jpegQuality << "%";
+    qDebug() << "  Jitter: up to" << m_screenshotScheduler->jitterMSecs() << "ms";
+    qDebug() << "  Quality:" << m_encoderSettings.quality << "%";
     qDebug() << "  Directory:" << m_screenshotDirectory;
 }
 
+void TimeTrackerMainWindow::applyScreenshotSchedule(const RuntimeSettings& settings)
+{
+    m_screenshotInterval = settings.screenshotIntervalSecs * 1000;
+    m_screenshotScheduler->setIntervalMSecs(m_screenshotInterval);
+    m_screenshotScheduler->setJitterMSecs(m_screenshotInterval / 100 * settings.screenshotJitterPercent);
+    m_screenshotScheduler->setMinimumSpacingMSecs(settings.screenshotMinimumSpacingSecs * 1000);
+}
+
 void TimeTrackerMainWindow::configureAppTracker()
 {
-    // Initialize application tracking timer
-    m_appTrackerTimer = new QTimer(this);
-    connect(m_appTrackerTimer, &QTimer::timeout, this, &TimeTrackerMainWindow::trackActiveApplication);
-
-    // Set 5-second interval as specified in Sprint 6 requirements
-    m_appTrackerTimer->setInterval(5 * 1000);
-    m_appTrackerTimer->start();
-
-    qDebug() << "Application tracking timer configured and started:";
-    qDebug() << "  Interval: 5 seconds";
-    qDebug() << "  Tracking active window and process name changes";
-}
-
-void TimeTrackerMainWindow::trackActiveApplication()
-{
-    // Get the handle to the foreground window
-    HWND foregroundWindow = GetForegroundWindow();
-    if (foregroundWindow == NULL) {
-        // No foreground window (e.g., desktop focus) - handle gracefully
-        QString currentWindowTitle = "Desktop/No Active Window";
-        QString currentProcessName = "Desktop";
-
-        // Check if this is different from last known state
-        if (currentWindowTitle != m_lastWindowTitle || currentProcessName != m_lastProcessName) {
-            // Log the desktop focus state
-            std::ofstream logFile("activity_log.txt", std::ios::app);
-            if (logFile.is_open()) {
-                // Get current timestamp with milliseconds
-                auto now = std::chrono::system_clock::now();
-                std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-                std::tm tm;
-                localtime_s(&tm, &now_c);
-                auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    now.time_since_epoch()) % 1000;
-
-                std::stringstream timestamp;
-                timestamp << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << "."
-                         << std::setfill('0') << std::setw(3) << milliseconds.count();
-
-                logFile << timestamp.str() << " - ACTIVE_APP - PROCESS: " << currentProcessName.toStdString()
-                       << " - TITLE: " << currentWindowTitle.toStdString() << std::endl;
-                logFile.close();
-            }
+    // Foreground changes arrive as WinEvents; the 5-second poll only runs if the hooks fail
+    m_foregroundTracker = new ForegroundWindowTracker(this);
+    m_foregroundTracker->setPollIntervalMSecs(m_runtimeConfig->settings().appPollIntervalSecs * 1000);
+    connect(m_foregroundTracker, &ForegroundWindowTracker::foregroundChanged,
+            this, &TimeTrackerMainWindow::logActiveApplication);
+    m_foregroundTracker->start();
+
+    qDebug() << "Application tracking started:";
+    qDebug() << "  Mode:" << (m_foregroundTracker->isEventDriven()
+                                  ? QString("event-driven")
+                                  : QString("polling every %1 ms").arg(m_foregroundTracker->pollIntervalMSecs()));
+}
 
-            // Update last known state
-            m_lastWindowTitle = currentWindowTitle;
-            m_lastProcessName = currentProcessName;
+void TimeTrackerMainWindow::logActiveApplication(const QString& processName, const QString& windowTitle,
+                                                 qint64 timestampMSecs)
+{
+    if (m_activityLogWriter) {
+        m_activityLogWriter->logActiveApplication(processName, windowTitle, timestampMSecs);
+    }
+    if (m_traceWriter) {
+        m_traceWriter->writeForeground(processName, windowTitle);
+    }
+    if (m_eventBus) {
+        m_eventBus->post(ActivityEventType::AppSwitch);
+    }
+    if (m_screenshotScheduler) {
+        m_screenshotScheduler->notifyForegroundChanged(processName);
+    }
+    m_activityAggregator.setForegroundApplication(processName, windowTitle,
+                                                  timestampMSecs > 0 ? timestampMSecs : ActivityClock::msecsSinceEpoch());
+    qDebug() << "Active application changed to:" << processName << "-" << windowTitle;
+}
 
-            qDebug() << "Active application changed to:" << currentProcessName << "-" << currentWindowTitle;
-        }
+void TimeTrackerMainWindow::captureScreenshot()
+{
+    QMutexLocker locker(&m_screenshotMutex);
+    qDebug() << "Capturing screenshot...";
+
+    // Generate enhanced timestamp-based filename with milliseconds
+    QString timestamp = ActivityClock::currentDateTime().toString("yyyyMMdd_hhmmss_zzz");
+
+    if (m_screenCaptureMode == ScreenCaptureMode::AllScreens && QGuiApplication::screens().size() > 1) {
+        captureScreens(QGuiApplication::screens(), timestamp);
+        return;
+    }
+
+    // Get the primary screen
+    QScreen *primaryScreen = QGuiApplication::primaryScreen();
+    if (!primaryScreen) {
+        qWarning() << "Failed to get primary screen";
         return;
     }
+    captureScreens({primaryScreen}, timestamp);
+}
+
+void TimeTrackerMainWindow::captureScreens(const QList<QScreen*>& screens, const QString& timestamp)
+{
+    // Grab the screens back to back; downscaling, comparison and encoding run off the GUI thread
+    const QList<QScreen*> allScreens = QGuiApplication::screens();
+    QList<CapturedScreen> captures;
+    captures.reserve(screens.size());
+    const std::shared_ptr<const ScreenshotEncoder> encoder = m_screenshotPipeline->encoder();
+    const QString extension = encoder ? encoder->fileExtension() : QString("jpg");
+
+    for (QScreen *screen : screens) {
+        const int index = qMax(0, allScreens.indexOf(screen));
+        CapturedScreen capture;
+
+        // Desktop Duplication copies only what changed since the last capture
+        DesktopDuplicationCapture::Frame frame;
+#if TIMETRACKER_METRICS
+        qint64 grabStartTicks = ActivityClock::ticks();
+#endif
+        const DesktopDuplicationCapture::Status status = m_desktopDuplication.capture(screen, &frame);
+        if (status == DesktopDuplicationCapture::Status::Unavailable) {
+#if TIMETRACKER_METRICS
+            grabStartTicks = ActivityClock::ticks();
+#endif
+            qDebug() << "Screen" << index << "captured through GDI -" << m_desktopDuplication.errorString();
+            m_screenChanges.remove(index);
+
+            // Capture the entire screen; only the grab has to happen on the GUI thread
+            QPixmap screenshot = screen->grabWindow(0);
+            if (screenshot.isNull()) {
+                qWarning() << "Failed to capture screen" << index << screen->name() << "- grabWindow returned null";
+                continue;
+            }
 
-    // Get the window title
-    wchar_t windowTitle[256];
-    int titleLength = GetWindowTextW(foregroundWindow, windowTitle, sizeof(windowTitle) / sizeof(wchar_t));
-    QString currentWindowTitle = QString::fromWCharArray(windowTitle, titleLength);
+            // QPixmap is GUI-thread only; on the raster backend toImage() shares the
+            // grabbed buffer rather than converting it.
+            capture.image = screenshot.toImage();
+            TT_METRIC_RECORD(ScreenshotGrabMicros, Metrics::microsSince(grabStartTicks));
+        } else {
+            TT_METRIC_RECORD(ScreenshotGrabMicros, Metrics::microsSince(grabStartTicks));
+            // Changes only count from a capture the pipeline compared, not across a GDI capture
+            capture.changesKnown = m_screenChanges.contains(index);
+            QRegion& changes = m_screenChanges[index];
+            changes += frame.changedRegion;
+            capture.changedRegion = changes;
+            capture.image = frame.image;
+        }
 
-    // Get the process ID from the window handle
-    DWORD processId;
-    GetWindowThreadProcessId(foregroundWindow, &processId);
+        QString filename = screens.size() > 1
+            ? QString("screenshot_%1_screen%2.%3").arg(timestamp).arg(index).arg(extension)
+            : QString("screenshot_%1.%2").arg(timestamp, extension);
+        capture.filePath = QDir(m_screenshotDirectory).filePath(filename);
+        capture.screen.index = index;
+        capture.screen.name = screen->name();
+        capture.screen.geometry = screen->geometry();
+        capture.screen.devicePixelRatio = screen->devicePixelRatio();
+        capture.screen.logicalDpi = screen->logicalDotsPerInch();
+        captures.append(capture);
+    }
 
-    // Open the process to get more information
-    HANDLE processHandle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
-    QString currentProcessName = "Unknown";
+    if (captures.isEmpty()) {
+        qWarning() << "Failed to capture any of" << screens.size() << "screens";
+        return;
+    }
 
-    if (processHandle != NULL) {
-        // Get the full path of the executable
-        wchar_t processPath[MAX_PATH];
-        DWORD pathSize = MAX_PATH;
+    if (!m_screenshotPipeline->submitScreens(captures, m_encoderSettings.quality, m_encoderSettings.maxSize)) {
+        // Nothing was compared; the changes carry over to the next capture
+        return;
+    }
+    for (const CapturedScreen& capture : captures) {
+        // Later duplication changes are relative to this capture
+        if (m_screenChanges.contains(capture.screen.index)) {
+            m_screenChanges[capture.screen.index] = QRegion();
+        }
+    }
+}
 
-        if (QueryFullProcessImageNameW(processHandle, 0, processPath, &pathSize)) {
-            QString fullPath = QString::fromWCharArray(processPath);
-            // Extract just the executable name from the full path
-            QFileInfo fileInfo(fullPath);
-            currentProcessName = fileInfo.fileName();
+void TimeTrackerMainWindow::onScreensPrepared(const QVector<PreparedScreen>& screens)
+{
+    int capturedCount = 0;
+    int unchangedCount = 0;
+    for (const PreparedScreen& prepared : screens) {
+        const int index = prepared.screen.index;
+        if (prepared.outcome == PreparedScreen::Outcome::Unchanged) {
+            if (m_traceWriter) {
+                m_traceWriter->writeUnchangedScreenshot(index);
+            }
+            logUnchangedScreen(index, 0);
+            ++unchangedCount;
+            continue;
         }
 
-        // Close the process handle
-        CloseHandle(processHandle);
-    }
-
-    // Check if the current window title or process name has changed
-    if (currentWindowTitle != m_lastWindowTitle || currentProcessName != m_lastProcessName) {
-        // Log the application change
-        std::ofstream logFile("activity_log.txt", std::ios::app);
-        if (logFile.is_open()) {
-            // Get current timestamp with milliseconds
-            auto now = std::chrono::system_clock::now();
-            std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-            std::tm tm;
-            localtime_s(&tm, &now_c);
-            auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now.time_since_epoch()) % 1000;
-
-            std::stringstream timestamp;
-            timestamp << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << "."
-                     << std::setfill('0') << std::setw(3) << milliseconds.count();
-
-            logFile << timestamp.str() << " - ACTIVE_APP - PROCESS: " << currentProcessName.toStdString()
-                   << " - TITLE: " << currentWindowTitle.toStdString() << std::endl;
-            logFile.close();
+        if (m_traceWriter) {
+            m_traceWriter->writeScreenshot(index, prepared.size, prepared.hash);
+        }
+        switch (prepared.outcome) {
+            case PreparedScreen::Outcome::Duplicate:
+                logUnchangedScreen(index, prepared.distance);
+                ++unchangedCount;
+                break;
+            case PreparedScreen::Outcome::Identical:
+                // Identical to the last frame sent for this screen
+                if (m_traceWriter) {
+                    m_traceWriter->writeScreenshotEncoded(index, 0);
+                }
+                ++unchangedCount;
+                break;
+            default:
+                ++capturedCount;
+                break;
         }
+    }
 
-        // Update last known state
-        m_lastWindowTitle = currentWindowTitle;
-        m_lastProcessName = currentProcessName;
+    TT_METRIC_ADD(ScreenshotsCaptured, static_cast<quint64>(capturedCount));
+    TT_METRIC_ADD(ScreenshotsUnchanged, static_cast<quint64>(unchangedCount));
 
-        qDebug() << "Active application changed to:" << currentProcessName << "-" << currentWindowTitle;
+    if (m_eventBus && capturedCount > 0) {
+        m_eventBus->post(ActivityEventType::ScreenshotCaptured, static_cast<std::int32_t>(capturedCount));
     }
 }
 
-void TimeTrackerMainWindow::captureScreenshot()
+void TimeTrackerMainWindow::logUnchangedScreen(int screenIndex, int distance)
 {
-    QMutexLocker locker(&m_screenshotMutex);
-    qDebug() << "Capturing screenshot...";
-
-    // Get the primary screen
-    QScreen *primaryScreen = QGuiApplication::primaryScreen();
-    if (!primaryScreen) {
-        qWarning() << "Failed to get primary screen";
-        return;
+    // A journal entry stands in for the skipped upload so the capture still shows on the timeline
+    if (m_activityLogWriter) {
+        m_activityLogWriter->logSystemMessage(
+            QString("Screenshot unchanged - Screen: %1, Distance: %2").arg(screenIndex).arg(distance));
     }
+}
 
-    // Capture the entire screen
-    QPixmap screenshot = primaryScreen->grabWindow(0);
-    if (screenshot.isNull()) {
-        qWarning() << "Failed to capture screenshot - grabWindow returned null";
-        return;
+void TimeTrackerMainWindow::onScreenshotsEncoded(const QVector<ScreenshotResult>& results)
+{
+    QVector<ScreenshotResult> encoded;
+    for (const ScreenshotResult& result : results) {
+        if (result.success) {
+            qDebug() << "Screen" << result.screen.index << result.screen.name << "encoded:"
+                     << "Size:" << result.size
+                     << "Bytes:" << result.bytes
+                     << "Encoded in:" << result.encodeMSecs << "ms";
+            if (m_traceWriter) {
+                m_traceWriter->writeScreenshotEncoded(result.screen.index, result.bytes);
+            }
+            encoded.append(result);
+        } else {
+            qWarning() << "Failed to encode screen" << result.screen.index << "-" << result.errorString;
+            onScreenshotKeyframeRequired(result.screen.index);
+        }
     }
 
-    // Generate enhanced timestamp-based filename with milliseconds
-    QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss_zzz");
-    QString filename = QString("screenshot_%1.jpg").arg(timestamp);
-    QString fullPath = QDir(m_screenshotDirectory).filePath(filename);
-
-    // Save the screenshot as JPEG with configurable quality
-    if (screenshot.save(fullPath, "JPEG", m_jpegQuality)) {
-        qDebug() << "Screenshot saved successfully:" << fullPath
-                 << "Size:" << screenshot.size()
-                 << "Quality:" << m_jpegQuality << "%";
-
-        // Upload screenshot to server
-        if (m_apiService) {
-            QString userId = getCurrentUserEmail();
-            QString sessionId = getCurrentSessionId();
-            m_apiService->uploadScreenshot(fullPath, userId, sessionId);
-        }
-    } else {
-        qWarning() << "Failed to save screenshot:" << fullPath;
-        qWarning() << "Directory exists:" << QDir(m_screenshotDirectory).exists();
-        qWarning() << "Directory writable:" << QFileInfo(m_screenshotDirectory).isWritable();
+    // All screens of the capture go up in a single multipart request
+    if (m_apiService && !encoded.isEmpty()) {
+        m_apiService->uploadScreenshots(encoded, getCurrentUserEmail(), getCurrentSessionId());
     }
 }
 
+void TimeTrackerMainWindow::onScreenshotKeyframeRequired(int screenIndex)
+{
+    // The server may not have the last frame of this screen; start over with a full one
+    m_screenshotPipeline->requestKeyframe(screenIndex);
+}
+
 QString TimeTrackerMainWindow::getCurrentUserEmail()
 {
     // For now, return a placeholder email
@@ -568,8 +679,11 @@ void TimeTrackerMainWindow::configureIdleDetection()
     // Initialize idle detector
     m_idleDetector = new IdleDetector(this);
 
-    // Set 5-minute threshold (industry standard)
-    m_idleDetector->setIdleThresholdSeconds(5 * 60); // 5 minutes = 300 seconds
+    // 5 minutes (industry standard) unless configured otherwise
+    m_idleDetector->setIdleThresholdSeconds(m_runtimeConfig->settings().idleThresholdSecs);
+
+    // Wake only at the idle deadline instead of every second
+    m_idleDetector->setActivitySource(IdleDetector::ActivitySource::SystemLastInput);
 
     // Connect idle detector signals
     connect(m_idleDetector, &IdleDetector::idleStarted,
@@ -577,35 +691,42 @@ void TimeTrackerMainWindow::configureIdleDetection()
     connect(m_idleDetector, &IdleDetector::idleEnded,
             this, &TimeTrackerMainWindow::onIdleEnded);
 
+    m_activityAggregator.setIdleThresholdSeconds(m_idleDetector->getIdleThresholdSeconds());
+
+    // Hook activity arrives once per bus drain cycle instead of once per event
+    IdleDetector *idleDetector = m_idleDetector;
+    m_eventBus->subscribe("idle", ActivityEventBus::INPUT_EVENTS, [idleDetector](const QVector<ActivityEvent>&) {
+        idleDetector->updateLastActivityTime();
+    });
+
     // Start the idle detector
     m_idleDetector->start();
 
     qDebug() << "Idle detection configured and started:";
-    qDebug() << "  Threshold: 5 minutes (300 seconds)";
-    qDebug() << "  Check interval: 30 seconds";
+    qDebug() << "  Threshold:" << m_idleDetector->getIdleThresholdSeconds() << "seconds";
+    qDebug() << "  Checks: at the idle deadline (GetLastInputInfo)";
 }
 
 void TimeTrackerMainWindow::onIdleStarted(int idleThresholdSeconds)
 {
     // Record when idle state started
-    m_idleStartTime = QDateTime::currentDateTime().addSecs(-idleThresholdSeconds);
+    m_idleStartTime = ActivityClock::currentDateTime().addSecs(-idleThresholdSeconds);
 
     qDebug() << "User entered idle state after" << idleThresholdSeconds << "seconds of inactivity";
     qDebug() << "Idle start time:" << m_idleStartTime.toString(Qt::ISODate);
 
-    // Update system tray to show idle status
-    if (m_trayIcon) {
-        m_trayIcon->setToolTip("Time Tracker - User Idle");
-    }
+    m_eventBus->post(ActivityEventType::IdleStarted, idleThresholdSeconds);
+    m_screenshotScheduler->setIdle(true);
 }
 
 void TimeTrackerMainWindow::onIdleEnded(int idleDurationSeconds)
 {
     qDebug() << "User activity resumed after" << idleDurationSeconds << "seconds of idle time";
 
-    // Update system tray to show active status
+    m_eventBus->post(ActivityEventType::IdleEnded, idleDurationSeconds);
+    m_screenshotScheduler->setIdle(false);
+
     if (m_trayIcon) {
-        m_trayIcon->setToolTip("Time Tracker - Active");
         m_trayIcon->showMessage("Activity Resumed",
             QString("Idle period of %1 detected").arg(formatDuration(idleDurationSeconds)),
             QSystemTrayIcon::Information, 3000);
@@ -617,9 +738,167 @@ void TimeTrackerMainWindow::onIdleEnded(int idleDurationSeconds)
     }
 }
 
+void TimeTrackerMainWindow::flushActivitySummaries()
+{
+    const QVector<ActivityMinuteSummary> completed = m_activityAggregator.takeCompleted(ActivityClock::msecsSinceEpoch());
+    if (!completed.isEmpty() && m_apiService) {
+        m_apiService->uploadActivitySummaries(completed, getCurrentUserEmail(), getCurrentSessionId());
+    }
+}
+
+void TimeTrackerMainWindow::fetchClientPolicy()
+{
+    if (m_apiService) {
+        m_apiService->fetchClientPolicy(getCurrentUserEmail());
+    }
+}
+
+void TimeTrackerMainWindow::applyUploadSettings(const RuntimeSettings& settings)
+{
+    ApiService::ActivityUploadPolicy policy = ApiService::ActivityUploadPolicy::RawEventsAndSummaries;
+    if (settings.activityUpload == "raw") {
+        policy = ApiService::ActivityUploadPolicy::RawEvents;
+    } else if (settings.activityUpload == "summaries") {
+        policy = ApiService::ActivityUploadPolicy::Summaries;
+    }
+
+    m_apiService->setBaseUrl(settings.serverUrl);
+    m_apiService->setActivityUploadIntervalMSecs(settings.uploadIntervalSecs * 1000);
+    m_apiService->setActivityUploadPolicy(policy);
+}
+
+void TimeTrackerMainWindow::applyMetricsSettings(const RuntimeSettings& settings)
+{
+    // Switched off, the file and telemetry keep reporting the values recorded so far
+    Metrics::setEnabled(settings.metricsEnabled);
+    m_metricsReporter->setWriteIntervalMSecs(settings.metricsFileIntervalSecs * 1000);
+    m_metricsReporter->setTelemetryIntervalMSecs(settings.telemetryIntervalSecs * 1000);
+}
+
+void TimeTrackerMainWindow::applyTraceSettings(const RuntimeSettings& settings)
+{
+    if (m_traceWriter) {
+        m_eventBus->unsubscribe(m_traceConsumerId);
+        m_traceConsumerId = -1;
+        m_traceWriter->close();
+        qDebug() << "Activity trace closed:" << m_traceWriter->filePath() << "-" << m_traceWriter->recordCount()
+                 << "records";
+        m_traceWriter.reset();
+    }
+    if (settings.traceFilePath.isEmpty()) {
+        return;
+    }
+
+    auto writer = std::make_shared<ActivityTraceWriter>(settings.traceFilePath);
+    if (!writer->open()) {
+        return;
+    }
+    m_traceWriter = writer;
+
+    // Recorded on the bus thread ahead of coalescing; the consumer keeps the writer alive
+    // until a batch already in flight has been written
+    m_traceConsumerId = m_eventBus->subscribe("trace",
+                                              ActivityEventBus::INPUT_EVENTS
+                                                  | ActivityEventBus::typeBit(ActivityEventType::IdleStarted)
+                                                  | ActivityEventBus::typeBit(ActivityEventType::IdleEnded),
+                                              [writer](const QVector<ActivityEvent>& events) {
+                                                  for (const ActivityEvent& event : events) {
+                                                      writer->writeEvent(event);
+                                                  }
+                                              });
+    qDebug() << "Recording activity trace:" << settings.traceFilePath;
+}
+
+void TimeTrackerMainWindow::applyRuntimeSettings(const RuntimeSettings& settings, const RuntimeSettings& previous)
+{
+    // Only what changed is touched; the hooks and threads keep running throughout
+    if (settings.screenshotIntervalSecs != previous.screenshotIntervalSecs
+        || settings.screenshotJitterPercent != previous.screenshotJitterPercent
+        || settings.screenshotMinimumSpacingSecs != previous.screenshotMinimumSpacingSecs) {
+        applyScreenshotSchedule(settings);
+        qDebug() << "Screenshot interval now" << m_screenshotInterval / 1000 << "seconds";
+    }
+
+    if (settings.encoder != previous.encoder) {
+        applyEncoderSettings(settings.encoder);
+        // Tiles in another format or size cannot patch the server's last frame
+        m_screenshotPipeline->requestKeyframes();
+    }
+
+    if (settings.desktopDuplication != previous.desktopDuplication) {
+        m_desktopDuplication.setEnabled(settings.desktopDuplication);
+        m_desktopDuplication.reset();
+        m_screenChanges.clear();
+    }
+
+    if (settings.idleThresholdSecs != previous.idleThresholdSecs) {
+        m_idleDetector->setIdleThresholdSeconds(settings.idleThresholdSecs);
+        m_activityAggregator.setIdleThresholdSeconds(settings.idleThresholdSecs);
+    }
+
+    if (settings.appPollIntervalSecs != previous.appPollIntervalSecs) {
+        m_foregroundTracker->setPollIntervalMSecs(settings.appPollIntervalSecs * 1000);
+    }
+
+    if (settings.moveCoalescingMSecs != previous.moveCoalescingMSecs) {
+        m_activityLogWriter->setMoveCoalescingIntervalMSecs(settings.moveCoalescingMSecs);
+    }
+
+    if (settings.traceFilePath != previous.traceFilePath) {
+        applyTraceSettings(settings);
+    }
+
+    applyUploadSettings(settings);
+
+    if (settings.metricsEnabled != previous.metricsEnabled
+        || settings.metricsFileIntervalSecs != previous.metricsFileIntervalSecs
+        || settings.telemetryIntervalSecs != previous.telemetryIntervalSecs) {
+        applyMetricsSettings(settings);
+    }
+
+    if (settings.policyRefreshSecs != previous.policyRefreshSecs) {
+        if (settings.policyRefreshSecs > 0) {
+            m_policyTimer->start(settings.policyRefreshSecs * 1000);
+        } else {
+            m_policyTimer->stop();
+        }
+    }
+
+    m_activityLogWriter->logSystemMessage("Runtime configuration applied");
+}
+
+void TimeTrackerMainWindow::updateTrayStatus(const QVector<ActivityEvent>& events)
+{
+    if (!m_trayIcon) {
+        return;
+    }
+
+    for (const ActivityEvent& event : events) {
+        switch (event.type) {
+            case ActivityEventType::IdleStarted:
+                m_trayStatus = "User Idle";
+                break;
+            case ActivityEventType::IdleEnded:
+                m_trayStatus = "Active";
+                break;
+            case ActivityEventType::ScreenshotCaptured:
+                m_lastScreenshotTime = ActivityClock::toDateTime(event.ticks);
+                break;
+            default:
+                break;
+        }
+    }
+
+    QString toolTip = QString("Time Tracker - %1").arg(m_trayStatus);
+    if (m_lastScreenshotTime.isValid()) {
+        toolTip += QString("\nLast screenshot: %1").arg(m_lastScreenshotTime.toString("hh:mm:ss"));
+    }
+    m_trayIcon->setToolTip(toolTip);
+}
+
 void TimeTrackerMainWindow::showIdleAnnotationDialog(int idleDurationSeconds)
 {
-    QDateTime endTime = QDateTime::currentDateTime();
+    QDateTime endTime = ActivityClock::currentDateTime();
     QDateTime startTime = m_idleStartTime;
 
     // Create and show the idle annotation dialog
@@ -642,7 +921,7 @@ void TimeTrackerMainWindow::showIdleAnnotationDialog(int idleDurationSeconds)
 
 void TimeTrackerMainWindow::onIdleAnnotationSubmitted(const QString& reason, const QString& note)
 {
-    QDateTime endTime = QDateTime::currentDateTime();
+    QDateTime endTime = ActivityClock::currentDateTime();
     QDateTime startTime = m_idleStartTime;
     int durationSeconds = startTime.secsTo(endTime);
 
@@ -660,21 +939,8 @@ void TimeTrackerMainWindow::onIdleAnnotationSubmitted(const QString& reason, con
     }
 
     // Log locally for backup
-    std::ofstream logFile("activity_log.txt", std::ios::app);
-    if (logFile.is_open()) {
-        auto now = std::chrono::system_clock::now();
-        std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-        std::tm tm;
-        localtime_s(&tm, &now_c);
-
-        std::stringstream timestamp;
-        timestamp << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-
-        logFile << timestamp.str() << " - IDLE_ANNOTATED"
-               << " - DURATION: " << durationSeconds << "s"
-               << " - REASON: " << reason.toStdString()
-               << " - NOTE: " << note.toStdString() << std::endl;
-        logFile.close();
+    if (m_activityLogWriter) {
+        m_activityLogWriter->logIdleAnnotation(durationSeconds, reason, note);
     }
 
     qDebug() << "Idle time annotated:" << reason << "Note:" << note << "Duration:" << durationSeconds << "seconds";
@@ -15,13 +15,27 @@
 #include <QMutex>
 #include <windows.h>
 #include <Psapi.h>
+#include <memory>
 #include <string>
 #include <vector>
+#include "ActivityAggregator.h"
+#include "ActivityEvent.h"
+#include "DesktopDuplicationCapture.h"
+#include "ScreenshotPipeline.h"
 
 // Forward declarations
 class ApiService;
 class IdleDetector;
 class IdleAnnotationDialog;
+class ActivityCollector;
+class ActivityEventBus;
+class ActivityLogWriter;
+class ActivityTraceWriter;
+class ForegroundWindowTracker;
+class MetricsReporter;
+class RuntimeConfig;
+class ScreenshotScheduler;
+struct RuntimeSettings;
 
 QT_BEGIN_NAMESPACE
 class QLabel;
@@ -41,51 +55,96 @@ public:
 
 protected:
     void closeEvent(QCloseEvent *event) override;
+    bool nativeEvent(const QByteArray& eventType, void *message, qintptr *result) override;
 
 private slots:
     void showWindow();
     void exitApplication();
     void captureScreenshot();
-    void trackActiveApplication();
+    void onScreensPrepared(const QVector<PreparedScreen>& screens);
+    void onScreenshotsEncoded(const QVector<ScreenshotResult>& results);
+    void onScreenshotKeyframeRequired(int screenIndex);
     void onIdleStarted(int idleThresholdSeconds);
     void onIdleEnded(int idleDurationSeconds);
     void onIdleAnnotationSubmitted(const QString& reason, const QString& note);
+    void flushActivitySummaries();
+    void fetchClientPolicy();
+    void applyRuntimeSettings(const RuntimeSettings& settings, const RuntimeSettings& previous);
 
 private:
+    void setupRuntimeConfig();
+    void setupActivityLogging();
     void setupSystemTray();
     void setupScreenshotDirectory();
+    void setupScreenshotPipeline();
     void configureScreenshotTimer();
+    void applyScreenshotSchedule(const RuntimeSettings& settings);
+    void applyEncoderSettings(const ScreenshotEncoderSettings& settings);
+    void applyUploadSettings(const RuntimeSettings& settings);
+    void applyMetricsSettings(const RuntimeSettings& settings);
+    void applyTraceSettings(const RuntimeSettings& settings);
+    void captureScreens(const QList<QScreen*>& screens, const QString& timestamp);
+    void logUnchangedScreen(int screenIndex, int distance);
     void configureAppTracker();
     void configureIdleDetection();
     void showIdleAnnotationDialog(int idleDurationSeconds);
+    void updateTrayStatus(const QVector<ActivityEvent>& events);
+    void logActiveApplication(const QString& processName, const QString& windowTitle, qint64 timestampMSecs);
     QString formatDuration(int seconds);
     QString getCurrentUserEmail();
     QString getCurrentSessionId();
 
-    // Windows API hook callbacks
-    static LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam);
-    static LRESULT CALLBACK LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam);
-    static TimeTrackerMainWindow* s_instance;
-
     QSystemTrayIcon *m_trayIcon = nullptr;
 
-    // Screenshot functionality
-    QTimer *m_screenshotTimer = nullptr;
+    // Intervals, thresholds and pipeline modes; the local file and server policy apply live
+    RuntimeConfig *m_runtimeConfig = nullptr;
+    QTimer *m_policyTimer = nullptr;
+
+    // Hot-path counters and latencies, written locally and sent as telemetry
+    MetricsReporter *m_metricsReporter = nullptr;
+
+    // Screenshot functionality; paused while idle or locked, sooner on application switches
+    ScreenshotScheduler *m_screenshotScheduler = nullptr;
+    bool m_sessionNotificationsRegistered = false;
     QString m_screenshotDirectory;
     QMutex m_screenshotMutex;
+    ScreenshotPipeline *m_screenshotPipeline = nullptr; // Downscales, dedups, deltas and encodes off the GUI thread
+    DesktopDuplicationCapture m_desktopDuplication;     // Copies only changed areas; grabWindow() as fallback
+    QHash<int, QRegion> m_screenChanges;                // Duplication changes since each screen's last submitted capture
+
+    // Which screens a capture covers
+    enum class ScreenCaptureMode {
+        PrimaryScreen,  // Only QGuiApplication::primaryScreen()
+        AllScreens      // Every screen, encoded in parallel and uploaded together
+    };
 
     // Configuration settings
-    int m_screenshotInterval = 10 * 1000;  // 10 seconds for testing
-    int m_jpegQuality = 85;                // 85% quality for good compression
+    ScreenCaptureMode m_screenCaptureMode = ScreenCaptureMode::AllScreens;
+    int m_screenshotInterval = 10 * 1000;  // Follows Screenshots/intervalSeconds
+    ScreenshotEncoderSettings m_encoderSettings; // Encoder, quality and size limit for this deployment
+
+    // Application tracking: WinEvent hooks, polling only as a fallback
+    ForegroundWindowTracker *m_foregroundTracker = nullptr;
+
+    // Owns the keyboard and mouse hooks on a dedicated high-priority thread
+    ActivityCollector *m_activityCollector = nullptr;
+
+    // Fans hook and status events out to the journal, idle detector, uploader and tray
+    ActivityEventBus *m_eventBus = nullptr;
+    QString m_trayStatus = "Active";
+    QDateTime m_lastScreenshotTime;
+
+    // Per-minute summaries of the activity stream, fed from the bus thread
+    ActivityAggregator m_activityAggregator;
+    QTimer *m_summaryTimer = nullptr;
+    static const int SUMMARY_FLUSH_INTERVAL_MS = 60 * 1000;
 
-    // Application tracking components
-    QTimer *m_appTrackerTimer = nullptr;
-    QString m_lastWindowTitle;
-    QString m_lastProcessName;
+    // Background writer fed by the hooks through a lock-free ring buffer
+    ActivityLogWriter *m_activityLogWriter = nullptr;
 
-    // Windows hook handles for activity tracking
-    HHOOK m_keyboardHook = nullptr;
-    HHOOK m_mouseHook = nullptr;
+    // Raw activity trace for replaying this machine's load, only while Tracking/traceFile is set
+    std::shared_ptr<ActivityTraceWriter> m_traceWriter;  // Shared with the bus thread's consumer
+    int m_traceConsumerId = -1;
 
     // API service for backend communication
     ApiService *m_apiService = nullptr;
@@ -0,0 +1,404 @@
+#include "UploadQueue.h"
+#include "Metrics.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QNetworkInformation>
+#include <QNetworkReply>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QVariantList>
+
+namespace {
+
+const qint64 MAX_TIMER_DELAY_MS = 24 * 60 * 60 * 1000;  ///< Keeps far-off retries within QTimer's range
+
+} // namespace
+
+RetryBackoff::RetryBackoff(int baseMSecs, int maxMSecs)
+    : m_baseMSecs(qMax(1, baseMSecs))
+    , m_maxMSecs(qMax(m_baseMSecs, maxMSecs))
+{
+}
+
+int RetryBackoff::ceilingMSecs(int attempts) const
+{
+    // Doubling past 2^20 overflows long before any sensible maximum
+    const int doublings = qBound(0, attempts - 1, 20);
+    return static_cast<int>(qMin<qint64>(m_maxMSecs, static_cast<qint64>(m_baseMSecs) << doublings));
+}
+
+int RetryBackoff::delayMSecs(int attempts) const
+{
+    const int ceiling = ceilingMSecs(attempts);
+    const int floor = ceiling / 2;
+    return floor + static_cast<int>(QRandomGenerator::global()->bounded(ceiling - floor + 1));
+}
+
+UploadQueue::UploadQueue(const QString& directory, QObject *parent)
+    : QObject(parent)
+    , m_directory(directory)
+{
+    m_dispatchTimer = new QTimer(this);
+    m_dispatchTimer->setSingleShot(true);
+    connect(m_dispatchTimer, &QTimer::timeout, this, &UploadQueue::dispatch);
+
+    if (!QDir().mkpath(m_directory)) {
+        qWarning() << "Failed to create upload queue directory:" << m_directory;
+    }
+    loadJobs();
+
+    if (QNetworkInformation *networkInfo = QNetworkInformation::instance()) {
+        connect(networkInfo, &QNetworkInformation::reachabilityChanged, this,
+                [this](QNetworkInformation::Reachability reachability) {
+                    if (reachability == QNetworkInformation::Reachability::Disconnected) {
+                        m_dispatchTimer->stop();
+                    } else {
+                        resume();
+                    }
+                });
+    }
+}
+
+UploadQueue::~UploadQueue()
+{
+    for (const QPointer<QNetworkReply>& reply : m_replies) {
+        if (!reply) continue;
+        disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+        reply->deleteLater();
+    }
+}
+
+void UploadQueue::registerKind(const QString& kind, const Sender& sender, int maxInFlight, int maxBatch)
+{
+    KindPolicy& policy = m_kinds[kind];
+    policy.sender = sender;
+    policy.maxInFlight = qMax(1, maxInFlight);
+    policy.maxBatch = qMax(1, maxBatch);
+    scheduleNextDispatch();
+}
+
+quint64 UploadQueue::enqueue(const QString& kind, const QJsonObject& payload, const QString& filePath)
+{
+    UploadJob job;
+    job.id = m_nextId;
+    job.kind = kind;
+    job.payload = payload;
+    job.filePath = filePath;
+    job.nextAttemptMSecs = QDateTime::currentMSecsSinceEpoch();
+
+    if (!saveJob(job)) {
+        return 0;
+    }
+    ++m_nextId;
+    m_jobs.insert(job.id, job);
+
+    // Sent from the event loop, so callers reacting to jobFinished can enqueue safely
+    scheduleNextDispatch();
+    return job.id;
+}
+
+int UploadQueue::pendingCount(const QString& kind) const
+{
+    if (kind.isEmpty()) {
+        return m_jobs.size();
+    }
+    int count = 0;
+    for (const UploadJob& job : m_jobs) {
+        if (job.kind == kind) ++count;
+    }
+    return count;
+}
+
+int UploadQueue::inFlightCount(const QString& kind) const
+{
+    int count = 0;
+    for (auto it = m_kinds.constBegin(); it != m_kinds.constEnd(); ++it) {
+        if (kind.isEmpty() || it.key() == kind) {
+            count += it.value().inFlight;
+        }
+    }
+    return count;
+}
+
+void UploadQueue::resume()
+{
+    // One offset for the whole queue: this client's backlog still drains in full batches
+    const qint64 dueTime = QDateTime::currentMSecsSinceEpoch()
+                           + QRandomGenerator::global()->bounded(RECONNECT_SPREAD_MS + 1);
+    for (UploadJob& job : m_jobs) {
+        if (!m_inFlight.contains(job.id) && job.nextAttemptMSecs > dueTime) {
+            job.nextAttemptMSecs = dueTime;
+        }
+    }
+    scheduleNextDispatch();
+}
+
+void UploadQueue::dispatch()
+{
+    if (isOffline()) {
+        // Resumed by the reachability change
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QList<UploadJob> dropped;
+
+    for (auto it = m_kinds.begin(); it != m_kinds.end(); ++it) {
+        KindPolicy& policy = it.value();
+        while (policy.inFlight < policy.maxInFlight) {
+            QList<UploadJob> batch;
+            for (const UploadJob& job : std::as_const(m_jobs)) {
+                if (job.kind != it.key() || m_inFlight.contains(job.id) || job.nextAttemptMSecs > now) {
+                    continue;
+                }
+                if (m_isolated.contains(job.id)) {
+                    if (batch.isEmpty()) {
+                        batch.append(job);
+                        break;
+                    }
+                    continue;
+                }
+                batch.append(job);
+                if (batch.size() >= policy.maxBatch) break;
+            }
+            if (batch.isEmpty()) break;
+
+            QNetworkReply *reply = policy.sender ? policy.sender(batch) : nullptr;
+            if (!reply) {
+                qWarning() << "Dropping" << batch.size() << it.key() << "upload(s) that cannot be sent";
+                for (const UploadJob& job : batch) {
+                    removeJob(job.id);
+                }
+                dropped.append(batch);
+                continue;
+            }
+
+            QVariantList ids;
+            for (const UploadJob& job : batch) {
+                m_inFlight.insert(job.id);
+                ids.append(job.id);
+            }
+            reply->setProperty("uploadKind", it.key());
+            reply->setProperty("uploadJobIds", ids);
+            reply->setProperty("uploadStartTicks", ActivityClock::ticks());
+            connect(reply, &QNetworkReply::finished, this, &UploadQueue::handleReply);
+            m_replies.append(reply);
+            ++policy.inFlight;
+        }
+    }
+
+    scheduleNextDispatch();
+
+    for (const UploadJob& job : dropped) {
+        emit jobFinished(job, false, false);
+    }
+}
+
+void UploadQueue::handleReply()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    m_replies.removeAll(reply);
+    reply->deleteLater();
+
+    const QString kind = reply->property("uploadKind").toString();
+    auto policy = m_kinds.find(kind);
+    if (policy != m_kinds.end()) {
+        --policy->inFlight;
+    }
+
+    QList<quint64> ids;
+    for (const QVariant& id : reply->property("uploadJobIds").toList()) {
+        const quint64 jobId = id.toULongLong();
+        m_inFlight.remove(jobId);
+        if (m_jobs.contains(jobId)) {
+            ids.append(jobId);
+        }
+    }
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (kind == "screenshot") {
+        TT_METRIC_RECORD(ScreenshotUploadMSecs,
+                         Metrics::microsSince(reply->property("uploadStartTicks").toLongLong()) / 1000);
+    }
+
+    if (reply->error() == QNetworkReply::NoError) {
+        QList<UploadJob> accepted;
+        for (quint64 id : ids) {
+            accepted.append(m_jobs.value(id));
+            removeJob(id);
+        }
+        // The endpoint is back; older jobs of this kind need not wait out their backoff
+        for (UploadJob& job : m_jobs) {
+            if (job.kind == kind && !m_inFlight.contains(job.id) && job.nextAttemptMSecs > now) {
+                job.nextAttemptMSecs = now;
+            }
+        }
+        scheduleNextDispatch();
+        for (const UploadJob& job : accepted) {
+            emit jobFinished(job, true, false);
+        }
+        return;
+    }
+
+    // 415 usually means a compressed body the sender stops compressing on the next attempt
+    const bool permanent = status >= 400 && status < 500 && status != 408 && status != 415 && status != 429;
+    if (permanent && ids.size() > 1) {
+        qWarning() << "Batch of" << ids.size() << kind << "uploads rejected with" << status
+                   << "- retrying them one by one";
+        for (quint64 id : ids) {
+            m_isolated.insert(id);
+        }
+        retryLater(ids, now, 0, false);
+        return;
+    }
+    if (permanent) {
+        qWarning() << kind << "upload rejected with" << status << "-" << reply->errorString() << "- dropping it";
+        QList<UploadJob> rejected;
+        for (quint64 id : ids) {
+            rejected.append(m_jobs.value(id));
+            removeJob(id);
+        }
+        scheduleNextDispatch();
+        for (const UploadJob& job : rejected) {
+            emit jobFinished(job, false, false);
+        }
+        return;
+    }
+
+    // Retry-After is only honoured as seconds; HTTP dates fall back to the backoff
+    bool hasRetryAfter = false;
+    const int retryAfterSeconds = reply->rawHeader("Retry-After").trimmed().toInt(&hasRetryAfter);
+    const int minimumDelay = hasRetryAfter ? qBound(0, retryAfterSeconds, 24 * 60 * 60) * 1000 : 0;
+
+    qWarning() << kind << "upload failed:" << reply->errorString() << "- will retry";
+    retryLater(ids, now, minimumDelay, true);
+}
+
+void UploadQueue::retryLater(const QList<quint64>& ids, qint64 now, int minimumDelayMSecs, bool backOff)
+{
+    QList<UploadJob> failed;
+    for (quint64 id : ids) {
+        UploadJob& job = m_jobs[id];
+        ++job.attempts;
+        const int delay = backOff ? qMax(m_backoff.delayMSecs(job.attempts), minimumDelayMSecs) : minimumDelayMSecs;
+        job.nextAttemptMSecs = now + delay;
+        saveJob(job);
+        failed.append(job);
+    }
+    TT_METRIC_ADD(UploadRetries, static_cast<quint64>(failed.size()));
+    scheduleNextDispatch();
+    for (const UploadJob& job : failed) {
+        emit jobFinished(job, false, true);
+    }
+}
+
+void UploadQueue::scheduleNextDispatch()
+{
+    // Called after every change to the queue
+    TT_METRIC_SET(UploadQueueDepth, m_jobs.size());
+
+    if (isOffline()) {
+        m_dispatchTimer->stop();
+        return;
+    }
+
+    qint64 earliest = -1;
+    for (const UploadJob& job : std::as_const(m_jobs)) {
+        auto policy = m_kinds.constFind(job.kind);
+        // Saturated kinds are looked at again when one of their requests finishes
+        if (policy == m_kinds.constEnd() || policy->inFlight >= policy->maxInFlight || m_inFlight.contains(job.id)) {
+            continue;
+        }
+        if (earliest < 0 || job.nextAttemptMSecs < earliest) {
+            earliest = job.nextAttemptMSecs;
+        }
+    }
+
+    if (earliest < 0) {
+        m_dispatchTimer->stop();
+        return;
+    }
+    const qint64 delay = qBound<qint64>(0, earliest - QDateTime::currentMSecsSinceEpoch(), MAX_TIMER_DELAY_MS);
+    m_dispatchTimer->start(static_cast<int>(delay));
+}
+
+bool UploadQueue::isOffline() const
+{
+    const QNetworkInformation *networkInfo = QNetworkInformation::instance();
+    return networkInfo && networkInfo->reachability() == QNetworkInformation::Reachability::Disconnected;
+}
+
+QString UploadQueue::jobFilePath(quint64 id) const
+{
+    // Zero-padded so a directory listing is in enqueue order
+    return QDir(m_directory).filePath(QString("%1.job").arg(id, 16, 10, QLatin1Char('0')));
+}
+
+bool UploadQueue::saveJob(const UploadJob& job) const
+{
+    QJsonObject object;
+    object["kind"] = job.kind;
+    object["payload"] = job.payload;
+    if (!job.filePath.isEmpty()) {
+        object["filePath"] = job.filePath;
+    }
+    object["attempts"] = job.attempts;
+    object["nextAttempt"] = job.nextAttemptMSecs;
+
+    const QByteArray data = QJsonDocument(object).toJson(QJsonDocument::Compact);
+    QSaveFile file(jobFilePath(job.id));
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Failed to persist upload job:" << file.fileName() << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void UploadQueue::removeJob(quint64 id)
+{
+    m_jobs.remove(id);
+    m_isolated.remove(id);
+    QFile::remove(jobFilePath(id));
+}
+
+void UploadQueue::loadJobs()
+{
+    const QFileInfoList files = QDir(m_directory).entryInfoList(QStringList() << "*.job", QDir::Files, QDir::Name);
+    for (const QFileInfo& info : files) {
+        bool validId = false;
+        const quint64 id = info.completeBaseName().toULongLong(&validId);
+
+        QFile file(info.filePath());
+        const QJsonObject object = file.open(QIODevice::ReadOnly)
+                                       ? QJsonDocument::fromJson(file.readAll()).object()
+                                       : QJsonObject();
+        file.close();
+        if (!validId || id == 0 || object["kind"].toString().isEmpty()) {
+            qWarning() << "Discarding unreadable upload job:" << info.filePath();
+            QFile::remove(info.filePath());
+            continue;
+        }
+
+        UploadJob job;
+        job.id = id;
+        job.kind = object["kind"].toString();
+        job.payload = object["payload"].toObject();
+        job.filePath = object["filePath"].toString();
+        job.attempts = object["attempts"].toInt();
+        job.nextAttemptMSecs = object["nextAttempt"].toInteger();
+        m_jobs.insert(id, job);
+        m_nextId = qMax(m_nextId, id + 1);
+    }
+
+    if (!m_jobs.isEmpty()) {
+        qDebug() << "Loaded" << m_jobs.size() << "pending uploads from" << m_directory;
+    }
+}
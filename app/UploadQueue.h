@@ -0,0 +1,224 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QMetaType>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <functional>
+
+class QNetworkReply;
+
+/**
+ * @brief One upload waiting in the UploadQueue
+ */
+struct UploadJob {
+    quint64 id = 0;              ///< Queue-wide sequence number, also the job file name
+    QString kind;                ///< Endpoint the job is sent to, e.g. "idletime"
+    QJsonObject payload;         ///< Request data for the endpoint
+    QString filePath;            ///< File to upload, empty for payload-only jobs
+    int attempts = 0;            ///< Failed attempts so far
+    qint64 nextAttemptMSecs = 0; ///< Earliest next attempt, UTC milliseconds since epoch
+};
+
+Q_DECLARE_METATYPE(UploadJob)
+
+/**
+ * @brief The RetryBackoff class computes jittered exponential retry delays
+ *
+ * The ceiling doubles with every failed attempt, starting at baseMSecs()
+ * and capped at maxMSecs(). The actual delay is drawn uniformly from the
+ * upper half of the ceiling, so clients that failed together spread out
+ * without ever retrying immediately.
+ */
+class RetryBackoff
+{
+public:
+    /**
+     * @brief Construct a new RetryBackoff object
+     * @param baseMSecs Ceiling after the first failure
+     * @param maxMSecs Largest ceiling
+     */
+    explicit RetryBackoff(int baseMSecs = DEFAULT_BASE_MS, int maxMSecs = DEFAULT_MAX_MS);
+
+    /**
+     * @brief Get the delay ceiling after a number of failed attempts
+     * @param attempts Failed attempts so far, at least 1
+     */
+    int ceilingMSecs(int attempts) const;
+
+    /**
+     * @brief Draw a delay after a number of failed attempts
+     * @param attempts Failed attempts so far, at least 1
+     * @return A delay in [ceilingMSecs() / 2, ceilingMSecs()]
+     */
+    int delayMSecs(int attempts) const;
+
+    int baseMSecs() const { return m_baseMSecs; }
+    int maxMSecs() const { return m_maxMSecs; }
+
+    static const int DEFAULT_BASE_MS = 2000;        ///< Default ceiling after the first failure
+    static const int DEFAULT_MAX_MS = 10 * 60000;   ///< Default largest ceiling
+
+private:
+    int m_baseMSecs;
+    int m_maxMSecs;
+};
+
+/**
+ * @brief The UploadQueue class is a durable queue of uploads with retry
+ *
+ * Every job is written to its own file in directory() before enqueue()
+ * returns and removed once the server accepted it, so pending uploads
+ * survive crashes and restarts; jobs found in the directory are loaded on
+ * construction.
+ *
+ * Each kind of job is bound to an endpoint with registerKind(), which
+ * supplies a sender that turns up to maxBatch jobs into one request and a
+ * limit on how many of its requests run at once. The oldest due jobs of a
+ * kind go first. A failed request is retried after a RetryBackoff delay,
+ * or after the server's Retry-After if that is longer, and any accepted
+ * request makes the waiting jobs of its kind due again at once. 415 is
+ * retried too, since a sender may encode the body differently next time;
+ * other client errors except 408 and 429 are permanent and drop the job, after
+ * retrying the jobs of a failed batch one by one so a single bad record
+ * does not take its neighbours with it.
+ *
+ * No requests are made while QNetworkInformation reports the network as
+ * disconnected. When it comes back, waiting jobs become due after a short
+ * random delay, so a fleet of clients does not reconnect in lockstep, and
+ * the backlog drains in full batches up to the concurrency limits.
+ */
+class UploadQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Builds and posts the request for a batch of jobs
+     *
+     * Returns nullptr if the jobs cannot be sent at all, e.g. because
+     * their file is gone; they are then dropped.
+     */
+    using Sender = std::function<QNetworkReply*(const QList<UploadJob>& jobs)>;
+
+    /**
+     * @brief Construct a new UploadQueue object and load persisted jobs
+     * @param directory Directory holding the job files, created if missing
+     * @param parent The parent QObject
+     */
+    explicit UploadQueue(const QString& directory, QObject *parent = nullptr);
+
+    /**
+     * @brief Destroy the UploadQueue object, aborting running requests
+     *
+     * Aborted jobs stay on disk and are sent again by the next instance.
+     */
+    ~UploadQueue();
+
+    /**
+     * @brief Bind a kind of job to an endpoint and start sending its jobs
+     * @param kind The job kind
+     * @param sender Builds and posts the request for a batch of jobs
+     * @param maxInFlight Maximum number of requests of this kind at once
+     * @param maxBatch Maximum number of jobs per request
+     */
+    void registerKind(const QString& kind, const Sender& sender, int maxInFlight = 1, int maxBatch = 1);
+
+    /**
+     * @brief Persist a job and send it as soon as its kind allows
+     * @param kind The job kind
+     * @param payload Request data for the endpoint
+     * @param filePath File to upload, if any
+     * @return The job ID, or 0 if the job could not be written to disk
+     */
+    quint64 enqueue(const QString& kind, const QJsonObject& payload, const QString& filePath = QString());
+
+    /**
+     * @brief Set the retry delays for failed requests
+     */
+    void setBackoff(const RetryBackoff& backoff) { m_backoff = backoff; }
+
+    /**
+     * @brief Get the retry delays for failed requests
+     */
+    RetryBackoff backoff() const { return m_backoff; }
+
+    /**
+     * @brief Get the number of jobs waiting or running
+     * @param kind Count only this kind; all kinds if empty
+     */
+    int pendingCount(const QString& kind = QString()) const;
+
+    /**
+     * @brief Get the number of requests currently running
+     * @param kind Count only this kind; all kinds if empty
+     */
+    int inFlightCount(const QString& kind = QString()) const;
+
+    /**
+     * @brief Get the waiting and running jobs in enqueue order
+     */
+    QList<UploadJob> jobs() const { return m_jobs.values(); }
+
+    /**
+     * @brief Get the directory holding the job files
+     */
+    QString directory() const { return m_directory; }
+
+    static const int RECONNECT_SPREAD_MS = 5000;   ///< Largest random delay before sending after a reconnect
+    static constexpr char DEFAULT_DIRECTORY[] = "upload_queue";   ///< Default job directory
+
+public slots:
+    /**
+     * @brief Make every waiting job due within RECONNECT_SPREAD_MS
+     *
+     * Called when the network comes back; failed attempts are kept, so a
+     * server that is still failing keeps getting the longer delays.
+     */
+    void resume();
+
+signals:
+    /**
+     * @brief Emitted when a request for a job has finished
+     * @param job The job, with attempts including this one if it failed
+     * @param success true if the server accepted the job
+     * @param willRetry true if the job stays queued for another attempt
+     */
+    void jobFinished(const UploadJob& job, bool success, bool willRetry);
+
+private slots:
+    void dispatch();
+    void handleReply();
+
+private:
+    struct KindPolicy {
+        Sender sender;
+        int maxInFlight = 1;
+        int maxBatch = 1;
+        int inFlight = 0;
+    };
+
+    void loadJobs();
+    bool saveJob(const UploadJob& job) const;
+    void removeJob(quint64 id);
+    QString jobFilePath(quint64 id) const;
+    bool isOffline() const;
+    void retryLater(const QList<quint64>& ids, qint64 now, int minimumDelayMSecs, bool backOff);
+    void scheduleNextDispatch();
+
+    QString m_directory;
+    QMap<quint64, UploadJob> m_jobs;     ///< Waiting and running jobs by ID
+    QHash<QString, KindPolicy> m_kinds;
+    QSet<quint64> m_inFlight;            ///< Jobs with a running request
+    QSet<quint64> m_isolated;            ///< Jobs of a rejected batch, now sent alone
+    QList<QPointer<QNetworkReply>> m_replies;
+    QTimer *m_dispatchTimer = nullptr;   ///< Fires when the earliest waiting job is due
+    RetryBackoff m_backoff;
+    quint64 m_nextId = 1;
+};
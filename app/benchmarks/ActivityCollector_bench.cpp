@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include <QThread>
+#include <vector>
+#include <windows.h>
+#include "ActivityClock.h"
+#include "ActivityCollector.h"
+#include "ActivityEvent.h"
+#include "ActivityRingBuffer.h"
+#include "Metrics.h"
+
+/**
+ * @file ActivityCollector_bench.cpp
+ * @brief Benchmarks of the input hook path
+ *
+ * Benchmarks:
+ * - The work a hook callback does per event, with metrics on and off
+ * - Events delivered through the real low-level hooks per second
+ */
+
+namespace {
+
+const std::size_t RING_CAPACITY = 16384;  ///< Same as ActivityEventBus
+const std::size_t DRAIN_BATCH = 1024;
+
+} // namespace
+
+// What ActivityCollector's callbacks and dispatch() do for one event:
+// stamp it, copy it into the ring buffer and record the hook metrics.
+// The buffer is drained inline every DRAIN_BATCH events in place of the
+// bus thread, so the figure includes one popBatch() share per event.
+static void BM_HookCallbackPublish(benchmark::State& state)
+{
+    Metrics::setEnabled(state.range(0) != 0);
+    const quint64 budgetMicros =
+        static_cast<quint64>(ActivityCollector::DEFAULT_HOOK_TIMEOUT_MS) * 1000 / Metrics::HOOK_BUDGET_DIVISOR;
+
+    ActivityRingBuffer<ActivityEvent> ring(RING_CAPACITY);
+    std::vector<ActivityEvent> drained(DRAIN_BATCH);
+    std::int32_t x = 0;
+    for (auto _ : state) {
+        ActivityEvent event{};
+        event.ticks = ActivityClock::ticks();
+        event.type = ActivityEventType::MouseMove;
+        event.x = x++ & 1023;
+        event.y = 540;
+        benchmark::DoNotOptimize(ring.tryPush(event));
+
+#if TIMETRACKER_METRICS
+        if (Metrics::isEnabled()) {
+            const quint64 micros = Metrics::microsSince(event.ticks);
+            Metrics::add(Metrics::Counter::HookEvents);
+            Metrics::record(Metrics::Histogram::HookLatencyMicros, micros);
+            if (micros > budgetMicros) {
+                Metrics::add(Metrics::Counter::HookCallbacksOverBudget);
+            }
+        }
+#else
+        Q_UNUSED(budgetMicros);
+#endif
+
+        if (ring.size() >= DRAIN_BATCH) {
+            ring.popBatch(drained.data(), DRAIN_BATCH);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["dropped"] = static_cast<double>(ring.droppedCount());
+    state.SetLabel(state.range(0) != 0 ? "metrics on" : "metrics off");
+    Metrics::setEnabled(true);
+}
+BENCHMARK(BM_HookCallbackPublish)->Arg(0)->Arg(1);
+
+// Zero-pixel mouse moves injected with SendInput still pass through
+// WH_MOUSE_LL, so this measures the full round trip through Windows and
+// the collector thread without moving the cursor.
+static void BM_HookDeliveryThroughput(benchmark::State& state)
+{
+    const int batchSize = static_cast<int>(state.range(0));
+    ActivityCollector collector(nullptr);
+    if (!collector.start()) {
+        state.SkipWithError(("Input hooks unavailable: " + collector.errorString().toStdString()).c_str());
+        return;
+    }
+
+    std::vector<INPUT> inputs(batchSize);
+    for (INPUT& input : inputs) {
+        input = INPUT{};
+        input.type = INPUT_MOUSE;
+        input.mi.dwFlags = MOUSEEVENTF_MOVE;
+    }
+
+    for (auto _ : state) {
+        const quint64 expected = collector.eventCount() + static_cast<quint64>(batchSize);
+        if (SendInput(static_cast<UINT>(batchSize), inputs.data(), sizeof(INPUT)) != static_cast<UINT>(batchSize)) {
+            state.SkipWithError("SendInput is not available in this session");
+            break;
+        }
+
+        const qint64 deadline = ActivityClock::ticks() + ActivityClock::frequency() * 2;
+        while (collector.eventCount() < expected && ActivityClock::ticks() < deadline) {
+            QThread::yieldCurrentThread();
+        }
+        if (collector.eventCount() < expected) {
+            state.SkipWithError("Injected input did not reach the hooks within 2 seconds");
+            break;
+        }
+    }
+
+    collector.stop();
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_HookDeliveryThroughput)->Arg(1)->Arg(64)->UseRealTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,218 @@
+#include <benchmark/benchmark.h>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtEndian>
+#include "ActivityJournal.h"
+#include "ActivityUploader.h"
+#include "bench_utils.h"
+
+/**
+ * @file ActivityJournal_bench.cpp
+ * @brief Benchmarks of activity log parsing, serialization and upload reads
+ *
+ * Benchmarks:
+ * - Parsing and formatting activity_log.txt lines
+ * - Encoding and decoding journal blocks
+ * - The legacy text log read and upload body against the journal chunk reader
+ *
+ * Every benchmark replays the same generated stream at each size.
+ */
+
+namespace {
+
+const int BLOCK_RECORDS = 256;  ///< Records per journal block, as one writer drain cycle
+
+struct Workload {
+    QVector<ActivityJournalRecord> records;
+    QStringList lines;
+    qint64 lineBytes = 0;
+    QVector<QByteArray> blocks;  ///< Encoded journal blocks of BLOCK_RECORDS records
+    QTemporaryDir directory;
+    QString textLogPath;
+    QString journalPath;
+};
+
+const Workload& workload(int count)
+{
+    static QHash<int, Workload*> workloads;
+    Workload*& entry = workloads[count];
+    if (entry) {
+        return *entry;
+    }
+
+    entry = new Workload;
+    entry->records = TimeTrackerBench::generateActivityRecords(count);
+    entry->lines = TimeTrackerBench::toTextLines(entry->records);
+    for (const QString& line : entry->lines) {
+        entry->lineBytes += line.toUtf8().size() + 1;
+    }
+    for (int start = 0; start < count; start += BLOCK_RECORDS) {
+        entry->blocks.append(ActivityJournalWriter::encodeBlock(entry->records.mid(start, BLOCK_RECORDS)));
+    }
+
+    entry->textLogPath = entry->directory.filePath("activity_log.txt");
+    entry->journalPath = entry->directory.filePath("activity_journal.000001.ttj");
+    if (!TimeTrackerBench::writeTextLog(entry->records, entry->textLogPath)
+        || !TimeTrackerBench::writeJournal(entry->records, entry->journalPath, BLOCK_RECORDS)) {
+        qFatal("Failed to write the benchmark activity logs to %s", qPrintable(entry->directory.path()));
+    }
+    return *entry;
+}
+
+// ApiService::readActivityLogs() as it was before the journal: the whole
+// text log parsed into one JSON array on every upload.
+QJsonArray readActivityLogs(const QString& filePath)
+{
+    QJsonArray logs;
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return logs;
+    }
+
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        QStringList parts = line.split(" - ");
+        if (parts.size() >= 3) {
+            QJsonObject logEntry;
+            logEntry["timestamp"] = parts[0];
+            logEntry["eventType"] = parts[1];
+            logEntry["details"] = parts.mid(2).join(" - ");
+            logEntry["userId"] = "current_user@company.com";
+            logEntry["sessionId"] = "1";
+
+            logs.append(logEntry);
+        }
+    }
+
+    return logs;
+}
+
+} // namespace
+
+static void BM_ParseTextLines(benchmark::State& state)
+{
+    const Workload& data = workload(static_cast<int>(state.range(0)));
+    ActivityJournalRecord record;
+    for (auto _ : state) {
+        for (const QString& line : data.lines) {
+            benchmark::DoNotOptimize(ActivityJournal::parseTextLine(line, record));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * data.lines.size());
+    state.SetBytesProcessed(state.iterations() * data.lineBytes);
+}
+BENCHMARK(BM_ParseTextLines)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_FormatTextLines(benchmark::State& state)
+{
+    const Workload& data = workload(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        for (const ActivityJournalRecord& record : data.records) {
+            benchmark::DoNotOptimize(ActivityJournal::toTextLine(record));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * data.records.size());
+}
+BENCHMARK(BM_FormatTextLines)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_EncodeJournalBlocks(benchmark::State& state)
+{
+    const Workload& data = workload(static_cast<int>(state.range(0)));
+    QVector<QVector<ActivityJournalRecord>> slices;
+    for (int start = 0; start < data.records.size(); start += BLOCK_RECORDS) {
+        slices.append(data.records.mid(start, BLOCK_RECORDS));
+    }
+
+    qint64 bytes = 0;
+    for (auto _ : state) {
+        bytes = 0;
+        for (const QVector<ActivityJournalRecord>& slice : slices) {
+            bytes += ActivityJournalWriter::encodeBlock(slice).size();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * data.records.size());
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["bytesPerRecord"] = static_cast<double>(bytes) / data.records.size();
+}
+BENCHMARK(BM_EncodeJournalBlocks)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_DecodeJournalBlocks(benchmark::State& state)
+{
+    const Workload& data = workload(static_cast<int>(state.range(0)));
+    qint64 bytes = 0;
+    for (const QByteArray& block : data.blocks) {
+        bytes += block.size();
+    }
+
+    QVector<ActivityJournalRecord> records;
+    records.reserve(BLOCK_RECORDS);
+    for (auto _ : state) {
+        for (const QByteArray& block : data.blocks) {
+            // Header: magic, record count, payload size, base timestamp, CRC
+            const quint32 recordCount = qFromLittleEndian<quint32>(block.constData() + 4);
+            const qint64 baseTimestamp = qFromLittleEndian<qint64>(block.constData() + 12);
+            QVector<QString> strings;
+            records.clear();
+            ActivityJournalReader::decodePayload(block.mid(ActivityJournal::BLOCK_HEADER_SIZE), recordCount,
+                                                 baseTimestamp, records, strings);
+            benchmark::DoNotOptimize(records.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * data.records.size());
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_DecodeJournalBlocks)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_LegacyReadActivityLogs(benchmark::State& state)
+{
+    const Workload& data = workload(static_cast<int>(state.range(0)));
+    qint64 uploadBytes = 0;
+    for (auto _ : state) {
+        const QByteArray body = QJsonDocument(readActivityLogs(data.textLogPath)).toJson();
+        uploadBytes = body.size();
+        benchmark::DoNotOptimize(body.constData());
+    }
+    state.SetItemsProcessed(state.iterations() * data.records.size());
+    state.SetBytesProcessed(state.iterations() * QFileInfo(data.textLogPath).size());
+    state.counters["fileBytes"] = static_cast<double>(QFileInfo(data.textLogPath).size());
+    state.counters["uploadBytes"] = static_cast<double>(uploadBytes);
+}
+BENCHMARK(BM_LegacyReadActivityLogs)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_JournalReadChunks(benchmark::State& state)
+{
+    const Workload& data = workload(static_cast<int>(state.range(0)));
+    qint64 uploadBytes = 0;
+    int chunks = 0;
+    for (auto _ : state) {
+        uploadBytes = 0;
+        chunks = 0;
+        ActivityJournalReader reader(data.journalPath);
+        if (!reader.open()) {
+            state.SkipWithError("Failed to open the benchmark journal");
+            break;
+        }
+        ActivityUploadChunk chunk;
+        while (ActivityUploader::readChunk(reader, ActivityUploader::DEFAULT_MAX_CHUNK_RECORDS,
+                                           ActivityUploader::DEFAULT_MAX_CHUNK_BYTES, chunk)) {
+            uploadBytes += ActivityUploader::chunkBody(chunk, "current_user@company.com", "1").size();
+            ++chunks;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * data.records.size());
+    state.SetBytesProcessed(state.iterations() * QFileInfo(data.journalPath).size());
+    state.counters["fileBytes"] = static_cast<double>(QFileInfo(data.journalPath).size());
+    state.counters["uploadBytes"] = static_cast<double>(uploadBytes);
+    state.counters["chunks"] = chunks;
+}
+BENCHMARK(BM_JournalReadChunks)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
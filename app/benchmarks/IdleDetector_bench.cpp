@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include "IdleDetector.h"
+
+/**
+ * @file IdleDetector_bench.cpp
+ * @brief Benchmarks of concurrent activity updates on the idle detector
+ *
+ * Benchmarks:
+ * - updateLastActivityTime() from several threads at once, the way the
+ *   collector thread, the event bus and the GUI thread all report input
+ * - The same with one thread reading the idle state in a loop
+ */
+
+namespace {
+
+IdleDetector *g_detector = nullptr;
+
+} // namespace
+
+static void BM_IdleUpdateContention(benchmark::State& state)
+{
+    if (state.thread_index() == 0) {
+        g_detector = new IdleDetector;
+    }
+
+    for (auto _ : state) {
+        g_detector->updateLastActivityTime();
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        delete g_detector;
+        g_detector = nullptr;
+    }
+}
+BENCHMARK(BM_IdleUpdateContention)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_IdleUpdateWhileReading(benchmark::State& state)
+{
+    if (state.thread_index() == 0) {
+        g_detector = new IdleDetector;
+    }
+
+    // Thread 0 plays the GUI thread polling the state, the others report input
+    const bool reader = state.thread_index() == 0;
+    for (auto _ : state) {
+        if (reader) {
+            benchmark::DoNotOptimize(g_detector->isIdle());
+            benchmark::DoNotOptimize(g_detector->getIdleDurationSeconds());
+        } else {
+            g_detector->updateLastActivityTime();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        delete g_detector;
+        g_detector = nullptr;
+    }
+}
+BENCHMARK(BM_IdleUpdateWhileReading)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
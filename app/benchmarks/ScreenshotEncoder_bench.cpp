@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QString>
+#include "ScreenshotEncoder.h"
+#include "bench_utils.h"
+
+/**
+ * @file ScreenshotEncoder_bench.cpp
+ * @brief Benchmarks of screenshot encoding
+ *
+ * Benchmarks:
+ * - Encoding a desktop-like screen with each encoder at common resolutions
+ * - Downscaling a 4K screen to the usual size limits
+ *
+ * Encoders missing from the build (turbojpeg without libjpeg-turbo, webp
+ * without the plugin) are reported as skipped rather than left out, so
+ * result files list the same benchmarks.
+ */
+
+namespace {
+
+const int QUALITY = 85;  ///< ScreenshotEncoderSettings default
+
+const QImage& screen(int width, int height)
+{
+    static QHash<qint64, QImage> screens;
+    const qint64 key = (static_cast<qint64>(width) << 32) | height;
+    auto it = screens.find(key);
+    if (it == screens.end()) {
+        it = screens.insert(key, TimeTrackerBench::generateScreen(QSize(width, height)));
+    }
+    return it.value();
+}
+
+void applyResolutions(benchmark::internal::Benchmark *bench)
+{
+    bench->Args({1280, 720})->Args({1920, 1080})->Args({2560, 1440})->Args({3840, 2160});
+    bench->Unit(benchmark::kMillisecond);
+}
+
+} // namespace
+
+static void BM_EncodeScreen(benchmark::State& state, const char *encoderName)
+{
+    const std::shared_ptr<const ScreenshotEncoder> encoder = ScreenshotEncoder::create(encoderName);
+    if (!encoder) {
+        state.SkipWithError(QString("Encoder %1 is not available in this build").arg(encoderName).toStdString().c_str());
+        return;
+    }
+
+    const QImage& image = screen(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    QByteArray data;
+    QString errorString;
+    for (auto _ : state) {
+        data.clear();
+        if (!encoder->encode(image, QUALITY, &data, &errorString)) {
+            state.SkipWithError(errorString.toStdString().c_str());
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * image.sizeInBytes());
+    state.counters["encodedBytes"] = data.size();
+    state.counters["megapixels"] = image.width() * image.height() / 1e6;
+}
+BENCHMARK_CAPTURE(BM_EncodeScreen, turbojpeg, "turbojpeg")->Apply(applyResolutions);
+BENCHMARK_CAPTURE(BM_EncodeScreen, jpeg, "jpeg")->Apply(applyResolutions);
+BENCHMARK_CAPTURE(BM_EncodeScreen, webp, "webp")->Apply(applyResolutions);
+
+static void BM_DownscaleScreen(benchmark::State& state)
+{
+    const QImage& image = screen(3840, 2160);
+    const QSize maxSize(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ScreenshotEncoder::scaledToFit(image, maxSize).constBits());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DownscaleScreen)->Args({1920, 1080})->Args({1280, 720})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include <random>
+#include "ActivityJournal.h"
+
+/**
+ * @file bench_utils.h
+ * @brief Synthetic workloads shared by the TimeTracker benchmarks
+ *
+ * Everything is generated from a fixed seed, so two runs of the same
+ * build measure exactly the same data and results can be compared
+ * between releases.
+ */
+
+namespace TimeTrackerBench {
+
+const quint32 DEFAULT_SEED = 20250615;
+
+/**
+ * @brief Generate an activity stream shaped like a real activity_log.txt
+ *
+ * Mostly mouse moves in short strokes, with key presses, clicks, the
+ * occasional application switch between a handful of applications and
+ * rare system messages, about 30 ms apart.
+ * @param count Number of records
+ * @param seed Random seed
+ */
+inline QVector<ActivityJournalRecord> generateActivityRecords(int count, quint32 seed = DEFAULT_SEED)
+{
+    static const char *const processes[][2] = {
+        {"chrome.exe", "Pull requests - Google Chrome"},
+        {"Code.exe", "ActivityJournal.cpp - timetracker - Visual Studio Code"},
+        {"OUTLOOK.EXE", "Inbox - user@company.com - Outlook"},
+        {"Teams.exe", "Daily standup | Microsoft Teams"},
+        {"EXCEL.EXE", "Q3 forecast.xlsx - Excel"},
+        {"explorer.exe", "Downloads"},
+    };
+    const int processCount = static_cast<int>(sizeof(processes) / sizeof(processes[0]));
+
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> step(-25, 25);
+    std::uniform_int_distribution<int> gap(5, 60);
+
+    QVector<ActivityJournalRecord> records;
+    records.reserve(count);
+    qint64 timestamp = 1749985500000;  // 2025-06-15 11:05:00 UTC
+    int x = 960;
+    int y = 540;
+    for (int i = 0; i < count; ++i) {
+        timestamp += gap(random);
+        ActivityJournalRecord record;
+        record.timestampMSecs = timestamp;
+
+        const int roll = percent(random);
+        if (roll < 70) {
+            x = qBound(0, x + step(random), 1919);
+            y = qBound(0, y + step(random), 1079);
+            record.type = JournalRecordType::Input;
+            record.inputType = ActivityEventType::MouseMove;
+            record.x = x;
+            record.y = y;
+        } else if (roll < 90) {
+            record.type = JournalRecordType::Input;
+            record.inputType = roll % 2 == 0 ? ActivityEventType::KeyDown : ActivityEventType::KeyUp;
+            record.x = 0x41 + roll % 26;
+        } else if (roll < 97) {
+            record.type = JournalRecordType::Input;
+            record.inputType = roll % 2 == 0 ? ActivityEventType::MouseLeftDown : ActivityEventType::MouseLeftUp;
+            record.x = x;
+            record.y = y;
+        } else if (roll < 99) {
+            const int process = static_cast<int>(random() % processCount);
+            record.type = JournalRecordType::ActiveApp;
+            record.text = QString::fromLatin1(processes[process][0]);
+            record.detail = QString::fromLatin1(processes[process][1]);
+        } else {
+            record.type = JournalRecordType::System;
+            record.text = QStringLiteral("Activity tracking started");
+        }
+        records.append(record);
+    }
+    return records;
+}
+
+/**
+ * @brief Format records as legacy activity_log.txt lines
+ */
+inline QStringList toTextLines(const QVector<ActivityJournalRecord>& records)
+{
+    QStringList lines;
+    lines.reserve(records.size());
+    for (const ActivityJournalRecord& record : records) {
+        lines.append(ActivityJournal::toTextLine(record));
+    }
+    return lines;
+}
+
+/**
+ * @brief Write records as a legacy activity_log.txt file
+ * @return true on success
+ */
+inline bool writeTextLog(const QVector<ActivityJournalRecord>& records, const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream out(&file);
+    for (const QString& line : toTextLines(records)) {
+        out << line << '\n';
+    }
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+/**
+ * @brief Write records as an activity journal file, flushing a block every blockRecords records
+ *
+ * Matches the ActivityLogWriter, which flushes one block per drain cycle.
+ * @return true on success
+ */
+inline bool writeJournal(const QVector<ActivityJournalRecord>& records, const QString& filePath,
+                         int blockRecords = 256)
+{
+    QFile::remove(filePath);
+    ActivityJournalWriter writer(filePath);
+    for (int i = 0; i < records.size(); ++i) {
+        writer.append(records.at(i));
+        if ((i + 1) % blockRecords == 0 && !writer.flush()) {
+            return false;
+        }
+    }
+    return writer.flush();
+}
+
+/**
+ * @brief Paint a desktop-like screen: a background, overlapping windows with title bars and text
+ *
+ * Gives the encoders flat areas, edges and glyphs in proportions close to
+ * a real screenshot, which a noise or gradient image would not.
+ * @param size Screen size in pixels
+ * @param seed Random seed
+ */
+inline QImage generateScreen(const QSize& size, quint32 seed = DEFAULT_SEED)
+{
+    QImage image(size, QImage::Format_RGB32);
+    image.fill(QColor(0, 90, 158));
+
+    std::mt19937 random(seed);
+    QPainter painter(&image);
+    QFont font = painter.font();
+    font.setPixelSize(qMax(10, size.height() / 80));
+    painter.setFont(font);
+    const int lineHeight = font.pixelSize() + 4;
+
+    for (int window = 0; window < 4; ++window) {
+        const int width = size.width() / 2 + static_cast<int>(random() % (size.width() / 3));
+        const int height = size.height() / 2 + static_cast<int>(random() % (size.height() / 3));
+        const QRect frame(static_cast<int>(random() % (size.width() - width + 1)),
+                          static_cast<int>(random() % (size.height() - height + 1)), width, height);
+        painter.fillRect(frame, QColor(250, 250, 250));
+        painter.fillRect(QRect(frame.topLeft(), QSize(frame.width(), lineHeight + 8)), QColor(32, 32, 32));
+        painter.setPen(Qt::white);
+        painter.drawText(frame.adjusted(8, 4, -8, 0), Qt::AlignLeft | Qt::AlignTop,
+                         QString("Window %1 - TimeTracker").arg(window));
+
+        painter.setPen(QColor(30, 30, 30));
+        for (int line = 2; (line + 1) * lineHeight < frame.height(); ++line) {
+            QString text;
+            const int words = 4 + static_cast<int>(random() % 12);
+            for (int word = 0; word < words; ++word) {
+                const int letters = 1 + static_cast<int>(random() % 9);
+                for (int letter = 0; letter < letters; ++letter) {
+                    text += QChar('a' + static_cast<int>(random() % 26));
+                }
+                text += ' ';
+            }
+            painter.drawText(QPoint(frame.left() + 12, frame.top() + line * lineHeight), text);
+        }
+    }
+    return image;
+}
+
+} // namespace TimeTrackerBench
@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+#include <QGuiApplication>
+#include <QSysInfo>
+#include "Metrics.h"
+#include "ScreenshotEncoder.h"
+
+/**
+ * @file main_bench.cpp
+ * @brief Entry point of TimeTrackerBench
+ *
+ * Usage: TimeTrackerBench [--benchmark_filter=<regex>] [--benchmark_out=<file>]
+ *                         [--benchmark_out_format=json] ...
+ *
+ * Takes the usual Google Benchmark options. The run_benchmarks target
+ * writes the results to benchmarks.json in the build directory; the
+ * context section records the build options and Qt version, so two
+ * result files show whether they are comparable.
+ */
+int main(int argc, char *argv[])
+{
+    // Fonts and images need a GUI application, a window system does not
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    benchmark::AddCustomContext("qtVersion", qVersion());
+    benchmark::AddCustomContext("os", QSysInfo::prettyProductName().toStdString());
+    benchmark::AddCustomContext("metrics", TIMETRACKER_METRICS ? "compiled in" : "compiled out");
+    benchmark::AddCustomContext("encoders", ScreenshotEncoder::availableEncoders().join(',').toStdString());
+#ifdef QT_DEBUG
+    benchmark::AddCustomContext("buildType", "debug");
+#else
+    benchmark::AddCustomContext("buildType", "release");
+#endif
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
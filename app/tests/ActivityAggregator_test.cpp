@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "ActivityAggregator.h"
+#include "ActivityClock.h"
+
+/**
+ * @file ActivityAggregator_test.cpp
+ * @brief Unit tests for the per-minute activity aggregator
+ *
+ * Tests cover:
+ * - Counting keys, clicks, pointer travel and active seconds per minute
+ * - Holding back minutes an idle period could still reach
+ * - Splitting idle periods across minutes
+ * - Picking the foreground application with the most time
+ */
+
+class ActivityAggregatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        baseTicks_ = ActivityClock::ticks();
+        baseMSecs_ = ActivityClock::toMSecsSinceEpoch(baseTicks_);
+        // Start of the next full minute
+        minute_ = baseMSecs_ - baseMSecs_ % ActivityAggregator::MINUTE_MS + ActivityAggregator::MINUTE_MS;
+    }
+
+    // Event at a point in time relative to the first minute
+    ActivityEvent eventAt(qint64 offsetMSecs, ActivityEventType type, int x = 0, int y = 0) const {
+        ActivityEvent event{};
+        event.ticks = baseTicks_ + ActivityClock::msecsToTicks(minute_ + offsetMSecs - baseMSecs_);
+        event.type = type;
+        event.x = x;
+        event.y = y;
+        return event;
+    }
+
+    qint64 at(qint64 offsetMSecs) const { return minute_ + offsetMSecs; }
+
+    qint64 baseTicks_ = 0;
+    qint64 baseMSecs_ = 0;
+    qint64 minute_ = 0;
+};
+
+TEST_F(ActivityAggregatorTest, CountsInputPerMinute) {
+    ActivityAggregator aggregator;
+    aggregator.addEvents({
+        eventAt(1500, ActivityEventType::KeyDown),
+        eventAt(1700, ActivityEventType::KeyDown),
+        eventAt(1800, ActivityEventType::KeyUp),
+        eventAt(10500, ActivityEventType::SysKeyDown),
+        eventAt(20500, ActivityEventType::MouseLeftDown),
+        eventAt(20600, ActivityEventType::MouseLeftUp),
+        eventAt(30500, ActivityEventType::MouseMove, 0, 0),
+        eventAt(30600, ActivityEventType::MouseMove, 3, 4),
+        eventAt(30700, ActivityEventType::MouseMove, 3, 10),
+        eventAt(60500, ActivityEventType::KeyDown)
+    });
+    EXPECT_EQ(aggregator.openMinuteCount(), 2);
+
+    // The second minute could still be reached by an idle period starting at its last input
+    QVector<ActivityMinuteSummary> completed = aggregator.takeCompleted(at(2 * 60000 + 1000));
+    ASSERT_EQ(completed.size(), 1);
+    const ActivityMinuteSummary& first = completed.first();
+    EXPECT_EQ(first.minuteStartMSecs, minute_);
+    EXPECT_EQ(first.keyCount, 3) << "Key releases are not counted";
+    EXPECT_EQ(first.clickCount, 1);
+    EXPECT_EQ(first.mouseDistance, 11);
+    EXPECT_EQ(first.activeSeconds, 4);
+    EXPECT_EQ(first.idleSeconds, 0);
+
+    EXPECT_TRUE(aggregator.takeCompleted(at(3 * 60000)).isEmpty());
+
+    completed = aggregator.takeCompleted(at(60500 + 5 * 60000 + 60000));
+    ASSERT_EQ(completed.size(), 1);
+    EXPECT_EQ(completed.first().minuteStartMSecs, minute_ + 60000);
+    EXPECT_EQ(completed.first().keyCount, 1);
+    EXPECT_EQ(aggregator.openMinuteCount(), 0);
+
+    // Late events for a minute already handed out are ignored
+    aggregator.addEvents({eventAt(2000, ActivityEventType::KeyDown)});
+    EXPECT_EQ(aggregator.openMinuteCount(), 0);
+}
+
+TEST_F(ActivityAggregatorTest, SplitsIdlePeriodAcrossMinutes) {
+    ActivityAggregator aggregator;
+    aggregator.setIdleThresholdSeconds(120);
+    aggregator.addEvents({
+        eventAt(10500, ActivityEventType::KeyDown),
+        eventAt(130500, ActivityEventType::IdleStarted, 120),
+        eventAt(200500, ActivityEventType::IdleEnded, 190),
+        eventAt(200600, ActivityEventType::MouseMove, 5, 5)
+    });
+
+    const QVector<ActivityMinuteSummary> completed = aggregator.takeCompleted(at(200600 + 120000 + 60000));
+    ASSERT_EQ(completed.size(), 4);
+    EXPECT_EQ(completed[0].activeSeconds, 1);
+    EXPECT_EQ(completed[0].idleSeconds, 49) << "Idle from 10.5 s, second 10 also had input";
+    EXPECT_EQ(completed[1].activeSeconds, 0);
+    EXPECT_EQ(completed[1].idleSeconds, 60);
+    EXPECT_EQ(completed[2].idleSeconds, 60);
+    EXPECT_EQ(completed[3].idleSeconds, 20) << "Idle until 20.5 s into the fourth minute, second 20 had input";
+    EXPECT_EQ(completed[3].activeSeconds, 1);
+}
+
+TEST_F(ActivityAggregatorTest, ReportsMinutesOfRunningIdlePeriod) {
+    ActivityAggregator aggregator;
+    aggregator.addEvents({eventAt(5 * 60000 + 500, ActivityEventType::IdleStarted, 300)});
+
+    // While idle nothing can change the past, so every finished minute is complete
+    QVector<ActivityMinuteSummary> completed = aggregator.takeCompleted(at(6 * 60000 + 30000));
+    ASSERT_EQ(completed.size(), 6);
+    for (const ActivityMinuteSummary& summary : completed) {
+        EXPECT_EQ(summary.idleSeconds, 60);
+        EXPECT_EQ(summary.activeSeconds, 0);
+    }
+
+    aggregator.addEvents({
+        eventAt(7 * 60000 + 500, ActivityEventType::IdleEnded, 420),
+        eventAt(7 * 60000 + 500, ActivityEventType::KeyDown)
+    });
+    completed = aggregator.takeCompleted(at(8 * 60000 + 1000));
+    ASSERT_EQ(completed.size(), 1);
+    EXPECT_EQ(completed.first().minuteStartMSecs, minute_ + 6 * 60000);
+    EXPECT_EQ(completed.first().idleSeconds, 60);
+}
+
+TEST_F(ActivityAggregatorTest, PicksForegroundApplicationWithMostTime) {
+    ActivityAggregator aggregator;
+    aggregator.setIdleThresholdSeconds(0);
+    aggregator.setForegroundApplication("code.exe", "main.cpp", at(0));
+    aggregator.setForegroundApplication("chrome.exe", "Docs", at(10000));
+    aggregator.setForegroundApplication("code.exe", "notes.md", at(25000));
+    aggregator.setForegroundApplication("code.exe", "main.cpp", at(40000));
+
+    const QVector<ActivityMinuteSummary> completed = aggregator.takeCompleted(at(60000));
+    ASSERT_EQ(completed.size(), 1);
+    EXPECT_EQ(completed.first().processName, "code.exe") << "45 s across two titles beats 15 s";
+    EXPECT_EQ(completed.first().windowTitle, "main.cpp");
+
+    const QJsonObject json = completed.first().toJson();
+    EXPECT_TRUE(json["minuteStart"].toString().endsWith("Z"));
+    EXPECT_EQ(json["processName"].toString(), "code.exe");
+    EXPECT_EQ(json["activeSeconds"].toInt(), 0);
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <QDateTime>
+#include <QThread>
+#include "ActivityClock.h"
+
+/**
+ * @file ActivityClock_test.cpp
+ * @brief Unit tests for the shared activity time source
+ *
+ * Tests cover:
+ * - Tick/millisecond conversions
+ * - Agreement of converted ticks with the system clock
+ * - Monotonic tick readings
+ */
+
+TEST(ActivityClockTest, ConvertsBetweenTicksAndMilliseconds) {
+    const qint64 frequency = ActivityClock::frequency();
+    ASSERT_GT(frequency, 0);
+
+    EXPECT_EQ(ActivityClock::ticksToMSecs(frequency), 1000);
+    EXPECT_EQ(ActivityClock::ticksToMSecs(frequency * 3600), 3600 * 1000);
+    EXPECT_EQ(ActivityClock::msecsToTicks(1000), frequency);
+    EXPECT_EQ(ActivityClock::ticksToMSecs(ActivityClock::msecsToTicks(1234)), 1234);
+
+    // Long uptimes must not overflow the intermediate product
+    const qint64 yearTicks = frequency * 3600 * 24 * 365;
+    EXPECT_EQ(ActivityClock::ticksToMSecs(yearTicks * 50), 50LL * 365 * 24 * 3600 * 1000);
+}
+
+TEST(ActivityClockTest, MatchesSystemClock) {
+    const qint64 before = QDateTime::currentMSecsSinceEpoch();
+    const qint64 clock = ActivityClock::msecsSinceEpoch();
+    const qint64 after = QDateTime::currentMSecsSinceEpoch();
+
+    // Timer resolution on Windows can be as coarse as ~16ms
+    EXPECT_GE(clock, before - 50);
+    EXPECT_LE(clock, after + 50);
+
+    const qint64 ticks = ActivityClock::ticks();
+    EXPECT_NEAR(static_cast<double>(ActivityClock::toMSecsSinceEpoch(ticks)),
+                static_cast<double>(QDateTime::currentMSecsSinceEpoch()), 50.0);
+    EXPECT_NEAR(static_cast<double>(ActivityClock::toDateTime(ticks).toMSecsSinceEpoch()),
+                static_cast<double>(ActivityClock::toMSecsSinceEpoch(ticks)), 1.0);
+}
+
+TEST(ActivityClockTest, TicksAreMonotonic) {
+    const qint64 first = ActivityClock::ticks();
+    QThread::msleep(20);
+    const qint64 second = ActivityClock::ticks();
+
+    EXPECT_GT(second, first);
+    EXPECT_GE(ActivityClock::ticksToMSecs(second - first), 15);
+
+    // Recalibrating only moves the wall-clock offset, never the ticks
+    const qint64 converted = ActivityClock::toMSecsSinceEpoch(first);
+    ActivityClock::recalibrate();
+    EXPECT_NEAR(static_cast<double>(ActivityClock::toMSecsSinceEpoch(first)),
+                static_cast<double>(converted), 50.0);
+    EXPECT_GT(ActivityClock::ticks(), second);
+}
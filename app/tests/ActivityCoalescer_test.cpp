@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "ActivityCoalescer.h"
+
+/**
+ * @file ActivityCoalescer_test.cpp
+ * @brief Unit tests for mouse-move coalescing
+ *
+ * Tests cover:
+ * - Merging moves within an interval into one summary
+ * - Pass-through and ordering of non-move records
+ * - Interval expiry, single-move intervals and disabled coalescing
+ */
+
+namespace {
+
+ActivityJournalRecord makeInput(qint64 timestamp, ActivityEventType type, qint32 x, qint32 y)
+{
+    ActivityJournalRecord record;
+    record.type = JournalRecordType::Input;
+    record.timestampMSecs = timestamp;
+    record.inputType = type;
+    record.x = x;
+    record.y = y;
+    return record;
+}
+
+} // namespace
+
+class ActivityCoalescerTest : public ::testing::Test {
+protected:
+    const qint64 base_ = 1750000000000;
+    ActivityCoalescer coalescer_{1000};
+    QVector<ActivityJournalRecord> output_;
+};
+
+TEST_F(ActivityCoalescerTest, MergesMovesWithinIntervalIntoSummary) {
+    coalescer_.process(makeInput(base_, ActivityEventType::MouseMove, 0, 0), output_);
+    coalescer_.process(makeInput(base_ + 10, ActivityEventType::MouseMove, 3, 4), output_);
+    coalescer_.process(makeInput(base_ + 20, ActivityEventType::MouseMove, 3, -6), output_);
+    EXPECT_TRUE(output_.isEmpty());
+    EXPECT_TRUE(coalescer_.hasPendingMoves());
+
+    coalescer_.flush(output_);
+    ASSERT_EQ(output_.size(), 1);
+
+    const ActivityJournalRecord& summary = output_[0];
+    EXPECT_EQ(summary.type, JournalRecordType::MouseMoveSummary);
+    EXPECT_EQ(summary.timestampMSecs, base_);
+    EXPECT_EQ(summary.moveCount, 3);
+    EXPECT_EQ(summary.pathLength, 15);
+    EXPECT_EQ(summary.spanMSecs, 20);
+    EXPECT_EQ(summary.x, 0);
+    EXPECT_EQ(summary.y, 0);
+    EXPECT_EQ(summary.lastX, 3);
+    EXPECT_EQ(summary.lastY, -6);
+    EXPECT_EQ(summary.minX, 0);
+    EXPECT_EQ(summary.minY, -6);
+    EXPECT_EQ(summary.maxX, 3);
+    EXPECT_EQ(summary.maxY, 4);
+    EXPECT_FALSE(coalescer_.hasPendingMoves());
+}
+
+TEST_F(ActivityCoalescerTest, NonMoveRecordsPassThroughInOrder) {
+    coalescer_.process(makeInput(base_, ActivityEventType::MouseMove, 1, 1), output_);
+    coalescer_.process(makeInput(base_ + 5, ActivityEventType::MouseMove, 2, 2), output_);
+    coalescer_.process(makeInput(base_ + 6, ActivityEventType::MouseLeftDown, 2, 2), output_);
+    coalescer_.process(makeInput(base_ + 7, ActivityEventType::KeyDown, 65, 0), output_);
+
+    ASSERT_EQ(output_.size(), 3);
+    EXPECT_EQ(output_[0].type, JournalRecordType::MouseMoveSummary);
+    EXPECT_EQ(output_[1].inputType, ActivityEventType::MouseLeftDown);
+    EXPECT_EQ(output_[2].inputType, ActivityEventType::KeyDown);
+    EXPECT_EQ(output_[2].x, 65);
+}
+
+TEST_F(ActivityCoalescerTest, StartsNewSummaryAfterInterval) {
+    for (int i = 0; i < 10; ++i) {
+        coalescer_.process(makeInput(base_ + i * 250, ActivityEventType::MouseMove, i, i), output_);
+    }
+    coalescer_.flush(output_);
+
+    // 0..750 ms, 1000..1750 ms, 2000..2250 ms
+    ASSERT_EQ(output_.size(), 3);
+    EXPECT_EQ(output_[0].moveCount, 4);
+    EXPECT_EQ(output_[1].moveCount, 4);
+    EXPECT_EQ(output_[1].timestampMSecs, base_ + 1000);
+    EXPECT_EQ(output_[2].moveCount, 2);
+    EXPECT_EQ(coalescer_.inputMoveCount(), 10u);
+    EXPECT_EQ(coalescer_.outputMoveRecordCount(), 3u);
+}
+
+TEST_F(ActivityCoalescerTest, SingleMoveIntervalStaysRawEvent) {
+    coalescer_.process(makeInput(base_, ActivityEventType::MouseMove, 40, 50), output_);
+    coalescer_.flush(output_);
+
+    ASSERT_EQ(output_.size(), 1);
+    EXPECT_EQ(output_[0].type, JournalRecordType::Input);
+    EXPECT_EQ(output_[0].inputType, ActivityEventType::MouseMove);
+    EXPECT_EQ(output_[0].x, 40);
+    EXPECT_EQ(output_[0].y, 50);
+}
+
+TEST_F(ActivityCoalescerTest, FlushExpiredOnlyClosesFullIntervals) {
+    coalescer_.process(makeInput(base_, ActivityEventType::MouseMove, 0, 0), output_);
+    coalescer_.process(makeInput(base_ + 100, ActivityEventType::MouseMove, 5, 0), output_);
+
+    coalescer_.flushExpired(base_ + 500, output_);
+    EXPECT_TRUE(output_.isEmpty());
+
+    coalescer_.flushExpired(base_ + 1000, output_);
+    ASSERT_EQ(output_.size(), 1);
+    EXPECT_EQ(output_[0].moveCount, 2);
+}
+
+TEST_F(ActivityCoalescerTest, ZeroIntervalDisablesCoalescing) {
+    coalescer_.setIntervalMSecs(0);
+    coalescer_.process(makeInput(base_, ActivityEventType::MouseMove, 0, 0), output_);
+    coalescer_.process(makeInput(base_ + 1, ActivityEventType::MouseMove, 1, 0), output_);
+
+    ASSERT_EQ(output_.size(), 2);
+    EXPECT_EQ(output_[0].type, JournalRecordType::Input);
+    EXPECT_EQ(output_[1].type, JournalRecordType::Input);
+    EXPECT_FALSE(coalescer_.hasPendingMoves());
+}
+
+TEST_F(ActivityCoalescerTest, ReducesTypicalMoveStreamByAnOrderOfMagnitude) {
+    // 125 Hz mouse moving for ten seconds
+    for (int i = 0; i < 1250; ++i) {
+        coalescer_.process(makeInput(base_ + i * 8, ActivityEventType::MouseMove, 500 + i % 200, 400), output_);
+    }
+    coalescer_.flush(output_);
+
+    EXPECT_LE(output_.size() * 10, 1250);
+}
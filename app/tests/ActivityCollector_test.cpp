@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QSignalSpy>
+#include <QTest>
+#include <windows.h>
+#include "ActivityCollector.h"
+#include "ActivityEventBus.h"
+#include "IdleDetector.h"
+
+/**
+ * @file ActivityCollector_test.cpp
+ * @brief Unit tests for the input hook collector thread
+ *
+ * Tests cover:
+ * - Starting and stopping the collector thread
+ * - Receiving injected input while the GUI thread is blocked
+ * - Ending an idle period through the event bus and a queued signal
+ */
+
+namespace {
+
+// Moves the cursor by zero pixels, which still reaches WH_MOUSE_LL
+bool injectMouseMove()
+{
+    INPUT input{};
+    input.type = INPUT_MOUSE;
+    input.mi.dwFlags = MOUSEEVENTF_MOVE;
+    return SendInput(1, &input, sizeof(INPUT)) == 1;
+}
+
+} // namespace
+
+class ActivityCollectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!QApplication::instance()) {
+            int argc = 0;
+            char* argv[] = {nullptr};
+            app_ = new QApplication(argc, argv);
+        }
+    }
+
+    void TearDown() override {
+        delete app_;
+        app_ = nullptr;
+    }
+
+    QApplication* app_ = nullptr;
+};
+
+TEST_F(ActivityCollectorTest, StartsAndStopsCollectorThread) {
+    ActivityCollector collector(nullptr);
+    if (!collector.start()) {
+        GTEST_SKIP() << "Input hooks unavailable: " << collector.errorString().toStdString();
+    }
+
+    EXPECT_TRUE(collector.isRunning());
+    EXPECT_TRUE(collector.isCollecting());
+
+    collector.stop();
+    EXPECT_FALSE(collector.isRunning());
+    EXPECT_FALSE(collector.isCollecting());
+
+    // A stopped collector can be started again
+    ASSERT_TRUE(collector.start());
+    EXPECT_TRUE(collector.isCollecting());
+}
+
+TEST_F(ActivityCollectorTest, ReceivesInputWhileGuiThreadIsBlocked) {
+    ActivityCollector collector(nullptr);
+    if (!collector.start()) {
+        GTEST_SKIP() << "Input hooks unavailable: " << collector.errorString().toStdString();
+    }
+    if (!injectMouseMove()) {
+        GTEST_SKIP() << "SendInput is not available in this session";
+    }
+
+    // No events are processed here; only the collector thread can see the input
+    const quint64 before = collector.eventCount();
+    for (int i = 0; i < 50 && collector.eventCount() == before; ++i) {
+        QThread::msleep(20);
+    }
+    EXPECT_GT(collector.eventCount(), before);
+}
+
+TEST_F(ActivityCollectorTest, InputEndsIdlePeriodThroughQueuedSignal) {
+    IdleDetector detector;
+    detector.setActivitySource(IdleDetector::ActivitySource::Hooks);
+    detector.setIdleThresholdSeconds(1);
+    QSignalSpy startedSpy(&detector, &IdleDetector::idleStarted);
+    QSignalSpy endedSpy(&detector, &IdleDetector::idleEnded);
+    detector.start();
+
+    ActivityEventBus bus;
+    bus.subscribe("idle", ActivityEventBus::INPUT_EVENTS, [&detector](const QVector<ActivityEvent>&) {
+        detector.updateLastActivityTime();
+    });
+    bus.start();
+
+    ActivityCollector collector(&bus);
+    if (!collector.start()) {
+        GTEST_SKIP() << "Input hooks unavailable: " << collector.errorString().toStdString();
+    }
+
+    ASSERT_TRUE(startedSpy.wait(5000));
+    if (!injectMouseMove()) {
+        GTEST_SKIP() << "SendInput is not available in this session";
+    }
+
+    // Emitted on the bus thread, delivered here by the event loop
+    ASSERT_TRUE(endedSpy.wait(2000));
+    EXPECT_FALSE(detector.isIdle());
+}
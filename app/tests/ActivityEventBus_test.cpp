@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QTest>
+#include <QThread>
+#include <atomic>
+#include "ActivityEventBus.h"
+
+/**
+ * @file ActivityEventBus_test.cpp
+ * @brief Unit tests for the batched activity event bus
+ *
+ * Tests cover:
+ * - One batch per drain cycle in capture order
+ * - Type mask filtering
+ * - Delivery on the context object's thread
+ * - Per-consumer backpressure
+ * - Unsubscribing and draining on stop
+ */
+
+namespace {
+
+ActivityEvent makeInput(qint64 ticks, std::int32_t x, ActivityEventType type = ActivityEventType::MouseMove)
+{
+    ActivityEvent event{};
+    event.ticks = ticks;
+    event.type = type;
+    event.x = x;
+    return event;
+}
+
+// Waits without running the event loop, so queued deliveries stay pending
+bool waitWithoutEvents(const std::function<bool()>& condition, int timeoutMSecs = 5000)
+{
+    for (int waited = 0; waited < timeoutMSecs; waited += 5) {
+        if (condition()) {
+            return true;
+        }
+        QThread::msleep(5);
+    }
+    return condition();
+}
+
+} // namespace
+
+class ActivityEventBusTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!QApplication::instance()) {
+            int argc = 0;
+            char* argv[] = {nullptr};
+            app_ = new QApplication(argc, argv);
+        }
+    }
+
+    void TearDown() override {
+        delete app_;
+        app_ = nullptr;
+    }
+
+    QApplication* app_ = nullptr;
+};
+
+TEST_F(ActivityEventBusTest, DeliversOneBatchPerDrainCycleInCaptureOrder) {
+    ActivityEventBus bus;
+    std::atomic<int> batches{0};
+    QVector<ActivityEvent> received;
+    bus.subscribe("all", ActivityEventBus::ALL_EVENTS, [&](const QVector<ActivityEvent>& events) {
+        ++batches;
+        received += events;
+    });
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(bus.publish(makeInput(i + 1, i)));
+    }
+    bus.post(ActivityEventType::IdleEnded, 42);
+    bus.start();
+    bus.stop();
+
+    ASSERT_EQ(received.size(), 101);
+    EXPECT_EQ(batches.load(), 1) << "Everything published before a drain arrives together";
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(received[i].x, i);
+    }
+    // Posted now, so after the old input events
+    EXPECT_EQ(received[100].type, ActivityEventType::IdleEnded);
+    EXPECT_EQ(received[100].x, 42);
+}
+
+TEST_F(ActivityEventBusTest, FiltersEventsByTypeMask) {
+    ActivityEventBus bus;
+    QVector<ActivityEvent> input;
+    QVector<ActivityEvent> idle;
+    bus.subscribe("input", ActivityEventBus::INPUT_EVENTS,
+                  [&](const QVector<ActivityEvent>& events) { input += events; });
+    bus.subscribe("idle", ActivityEventBus::typeBit(ActivityEventType::IdleStarted),
+                  [&](const QVector<ActivityEvent>& events) { idle += events; });
+
+    bus.publish(makeInput(1, 0, ActivityEventType::KeyDown));
+    bus.publish(makeInput(2, 0, ActivityEventType::MouseOther));
+    bus.post(ActivityEventType::IdleStarted, 300);
+    bus.post(ActivityEventType::ScreenshotCaptured, 2);
+    bus.start();
+    bus.stop();
+
+    ASSERT_EQ(input.size(), 2);
+    EXPECT_EQ(input[0].type, ActivityEventType::KeyDown);
+    EXPECT_EQ(input[1].type, ActivityEventType::MouseOther);
+    ASSERT_EQ(idle.size(), 1);
+    EXPECT_EQ(idle[0].x, 300);
+}
+
+TEST_F(ActivityEventBusTest, DeliversOnContextThread) {
+    ActivityEventBus bus;
+    QObject context;
+    QThread *deliveryThread = nullptr;
+    int received = 0;
+    bus.subscribe("ui", ActivityEventBus::ALL_EVENTS, [&](const QVector<ActivityEvent>& events) {
+        deliveryThread = QThread::currentThread();
+        received += events.size();
+    }, &context);
+
+    bus.start();
+    bus.post(ActivityEventType::AppSwitch);
+
+    ASSERT_TRUE(QTest::qWaitFor([&]() { return received == 1; }, 5000));
+    EXPECT_EQ(deliveryThread, QThread::currentThread());
+}
+
+TEST_F(ActivityEventBusTest, BlockedConsumerDropsOldestWithoutSlowingOthers) {
+    ActivityEventBus bus;
+    QObject context;
+    std::atomic<int> directCount{0};
+    QVector<ActivityEvent> queued;
+    int queuedBatches = 0;
+    bus.subscribe("journal", ActivityEventBus::ALL_EVENTS,
+                  [&](const QVector<ActivityEvent>& events) { directCount += events.size(); });
+    const int blocked = bus.subscribe("ui", ActivityEventBus::ALL_EVENTS, [&](const QVector<ActivityEvent>& events) {
+        ++queuedBatches;
+        queued += events;
+    }, &context, 10);
+    bus.start();
+
+    // This thread runs no events meanwhile, so the ui consumer falls behind
+    for (int i = 0; i < 30; ++i) {
+        bus.publish(makeInput(i + 1, i));
+    }
+    ASSERT_TRUE(waitWithoutEvents([&]() { return directCount.load() == 30; }));
+    for (int i = 30; i < 60; ++i) {
+        bus.publish(makeInput(i + 1, i));
+    }
+    ASSERT_TRUE(waitWithoutEvents([&]() { return directCount.load() == 60; }));
+
+    ASSERT_TRUE(QTest::qWaitFor([&]() { return !queued.isEmpty(); }, 5000));
+    QTest::qWait(3 * ActivityEventBus::DRAIN_INTERVAL_MS);
+    EXPECT_EQ(queuedBatches, 1) << "One delivery in flight at a time";
+    ASSERT_EQ(queued.size(), 10);
+    EXPECT_EQ(queued.first().x, 50) << "The newest events are kept";
+    EXPECT_EQ(queued.last().x, 59);
+    EXPECT_EQ(bus.consumerDroppedCount(blocked), 50u);
+}
+
+TEST_F(ActivityEventBusTest, UnsubscribedConsumerReceivesNothing) {
+    ActivityEventBus bus;
+    int received = 0;
+    const int id = bus.subscribe("gone", ActivityEventBus::ALL_EVENTS,
+                                 [&](const QVector<ActivityEvent>& events) { received += events.size(); });
+    bus.unsubscribe(id);
+
+    bus.publish(makeInput(1, 0));
+    bus.start();
+    bus.stop();
+
+    EXPECT_EQ(received, 0);
+    EXPECT_EQ(bus.consumerDroppedCount(id), 0u);
+}
+
+TEST_F(ActivityEventBusTest, StopDeliversEverythingPublished) {
+    ActivityEventBus bus;
+    std::atomic<int> received{0};
+    bus.subscribe("journal", ActivityEventBus::INPUT_EVENTS,
+                  [&](const QVector<ActivityEvent>& events) { received += events.size(); });
+    bus.start();
+
+    for (int i = 0; i < 500; ++i) {
+        bus.publish(makeInput(i + 1, i));
+    }
+    bus.stop();
+
+    EXPECT_EQ(received.load(), 500);
+    EXPECT_EQ(bus.droppedEventCount(), 0u);
+}
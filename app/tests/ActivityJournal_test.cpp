@@ -0,0 +1,406 @@
+#include <gtest/gtest.h>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QDateTime>
+#include "ActivityJournal.h"
+
+/**
+ * @file ActivityJournal_test.cpp
+ * @brief Unit tests for the binary activity journal format
+ *
+ * Tests cover:
+ * - Write/read round trips for every record type
+ * - Interning process names and window titles per file
+ * - Legacy text formatting and parsing
+ * - Checksum validation and partially written tails
+ * - Cutting a torn tail before appending the next block
+ */
+
+namespace {
+
+ActivityJournalRecord makeInput(qint64 timestamp, ActivityEventType type, qint32 x, qint32 y)
+{
+    ActivityJournalRecord record;
+    record.type = JournalRecordType::Input;
+    record.timestampMSecs = timestamp;
+    record.inputType = type;
+    record.x = x;
+    record.y = y;
+    return record;
+}
+
+ActivityJournalRecord makeActiveApp(qint64 timestamp, const QString& process, const QString& title)
+{
+    ActivityJournalRecord record;
+    record.type = JournalRecordType::ActiveApp;
+    record.timestampMSecs = timestamp;
+    record.text = process;
+    record.detail = title;
+    return record;
+}
+
+} // namespace
+
+class ActivityJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(tempDir_.isValid());
+        journalPath_ = tempDir_.filePath("journal.ttj");
+    }
+
+    QTemporaryDir tempDir_;
+    QString journalPath_;
+};
+
+TEST_F(ActivityJournalTest, RoundTripsAllRecordTypes) {
+    const qint64 base = QDateTime::currentMSecsSinceEpoch();
+
+    ActivityJournalWriter writer(journalPath_);
+    writer.append(makeInput(base, ActivityEventType::KeyDown, 65, 0));
+    writer.append(makeInput(base + 15, ActivityEventType::MouseMove, -1920, 1080));
+    writer.append(makeActiveApp(base + 20, "chrome.exe", QString::fromUtf8("Résumé - Google Docs")));
+
+    ActivityJournalRecord system;
+    system.type = JournalRecordType::System;
+    system.timestampMSecs = base + 30;
+    system.text = "Activity tracking started";
+    writer.append(system);
+
+    ActivityJournalRecord idle;
+    idle.type = JournalRecordType::IdleAnnotated;
+    idle.timestampMSecs = base + 40;
+    idle.durationSeconds = 420;
+    idle.text = "Meeting";
+    idle.detail = "Standup";
+    writer.append(idle);
+
+    ASSERT_TRUE(writer.flush());
+    EXPECT_EQ(writer.pendingRecordCount(), 0);
+
+    ActivityJournalReader reader(journalPath_);
+    ASSERT_TRUE(reader.open());
+    QVector<ActivityJournalRecord> records = reader.readAll();
+    ASSERT_EQ(records.size(), 5);
+
+    EXPECT_EQ(records[0].inputType, ActivityEventType::KeyDown);
+    EXPECT_EQ(records[0].x, 65);
+    EXPECT_EQ(records[0].timestampMSecs, base);
+    EXPECT_EQ(records[1].x, -1920);
+    EXPECT_EQ(records[1].y, 1080);
+    EXPECT_EQ(records[1].timestampMSecs, base + 15);
+    EXPECT_EQ(records[2].text, "chrome.exe");
+    EXPECT_EQ(records[2].detail, QString::fromUtf8("Résumé - Google Docs"));
+    EXPECT_EQ(records[3].text, "Activity tracking started");
+    EXPECT_EQ(records[4].durationSeconds, 420);
+    EXPECT_EQ(records[4].detail, "Standup");
+    EXPECT_EQ(reader.corruptBlockCount(), 0);
+    EXPECT_EQ(reader.position(), QFile(journalPath_).size());
+}
+
+TEST_F(ActivityJournalTest, AppendsMultipleBlocksWithSingleHeader) {
+    const qint64 base = 1750000000000;
+
+    ActivityJournalWriter writer(journalPath_);
+    writer.append(makeInput(base, ActivityEventType::MouseLeftDown, 1, 2));
+    ASSERT_TRUE(writer.flush());
+    writer.append(makeInput(base + 1000, ActivityEventType::MouseLeftUp, 3, 4));
+    ASSERT_TRUE(writer.flush());
+
+    ActivityJournalReader reader(journalPath_);
+    ASSERT_TRUE(reader.open());
+
+    QVector<ActivityJournalRecord> records;
+    ASSERT_TRUE(reader.readNextBlock(records));
+    ASSERT_TRUE(reader.readNextBlock(records));
+    EXPECT_FALSE(reader.readNextBlock(records));
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[1].timestampMSecs, base + 1000);
+}
+
+TEST_F(ActivityJournalTest, RecordsAreMuchSmallerThanTextLines) {
+    const qint64 base = 1750000000000;
+    ActivityJournalWriter writer(journalPath_);
+    QByteArray text;
+    for (int i = 0; i < 1000; ++i) {
+        ActivityJournalRecord record = makeInput(base + i * 8, ActivityEventType::MouseMove, 1000 + i, 900 + i);
+        writer.append(record);
+        text += ActivityJournal::toTextLine(record).toUtf8() + "\n";
+    }
+    ASSERT_TRUE(writer.flush());
+
+    EXPECT_LT(writer.bytesWritten() * 4, text.size())
+        << "Binary journal should be at least 4x smaller than the text log";
+}
+
+TEST_F(ActivityJournalTest, InternsRepeatedApplicationStrings) {
+    const qint64 base = 1750000000000;
+    const QString title = "TimeTrackerMainWindow.cpp - timetracker - Visual Studio Code";
+
+    ActivityJournalWriter writer(journalPath_);
+    for (int i = 0; i < 100; ++i) {
+        writer.append(makeActiveApp(base + i * 1000, "code.exe", title));
+        writer.append(makeActiveApp(base + i * 1000 + 500, "chrome.exe", "Inbox"));
+        ASSERT_TRUE(writer.flush());
+    }
+    EXPECT_EQ(writer.stringCount(), 4);
+    EXPECT_LT(writer.bytesWritten(), 200 * 24 + 200)
+        << "Repeated strings should cost an id, not their text";
+
+    ActivityJournalReader reader(journalPath_);
+    ASSERT_TRUE(reader.open());
+    QVector<ActivityJournalRecord> records = reader.readAll();
+    ASSERT_EQ(records.size(), 200);
+    EXPECT_EQ(records[198].type, JournalRecordType::ActiveApp);
+    EXPECT_EQ(records[198].text, "code.exe");
+    EXPECT_EQ(records[198].detail, title);
+    EXPECT_EQ(records[199].text, "chrome.exe");
+    EXPECT_EQ(records[0].textId, records[198].textId);
+    EXPECT_NE(records[0].detailId, records[1].detailId);
+    EXPECT_EQ(reader.strings().size(), 4);
+}
+
+TEST_F(ActivityJournalTest, SeekingForwardResolvesEarlierDefinitions) {
+    const qint64 base = 1750000000000;
+    ActivityJournalWriter writer(journalPath_);
+    writer.append(makeActiveApp(base, "code.exe", "main.cpp"));
+    ASSERT_TRUE(writer.flush());
+    const qint64 secondBlock = writer.bytesWritten();
+    writer.append(makeActiveApp(base + 1, "code.exe", "main.cpp"));
+    ASSERT_TRUE(writer.flush());
+
+    ActivityJournalReader reader(journalPath_);
+    ASSERT_TRUE(reader.open());
+    ASSERT_TRUE(reader.seek(secondBlock));
+    QVector<ActivityJournalRecord> records = reader.readAll();
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].timestampMSecs, base + 1);
+    EXPECT_EQ(records[0].text, "code.exe");
+    EXPECT_EQ(records[0].detail, "main.cpp");
+}
+
+TEST_F(ActivityJournalTest, ReopenedWriterContinuesStringTable) {
+    const qint64 base = 1750000000000;
+    {
+        ActivityJournalWriter writer(journalPath_);
+        writer.append(makeActiveApp(base, "code.exe", "main.cpp"));
+        ASSERT_TRUE(writer.flush());
+    }
+
+    ActivityJournalWriter writer(journalPath_);
+    writer.append(makeActiveApp(base + 1, "code.exe", "notes.txt"));
+    ASSERT_TRUE(writer.flush());
+    EXPECT_EQ(writer.stringCount(), 3) << "Existing ids are reused, new ones follow them";
+
+    // A new file starts its own table
+    ASSERT_TRUE(writer.setFilePath(tempDir_.filePath("other.ttj")));
+    writer.append(makeActiveApp(base + 2, "code.exe", "main.cpp"));
+    EXPECT_EQ(writer.stringCount(), 2);
+    ASSERT_TRUE(writer.flush());
+
+    ActivityJournalReader reader(journalPath_);
+    ASSERT_TRUE(reader.open());
+    QVector<ActivityJournalRecord> records = reader.readAll();
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[1].text, "code.exe");
+    EXPECT_EQ(records[1].detail, "notes.txt");
+    EXPECT_EQ(records[1].textId, records[0].textId);
+}
+
+TEST_F(ActivityJournalTest, ReadsInlineApplicationRecords) {
+    // Block written before interning: ActiveApp, delta 0, "code.exe", "main"
+    const QByteArray payload = QByteArray("\x02\x00\x08" "code.exe" "\x04" "main", 16);
+    QVector<ActivityJournalRecord> records;
+    QVector<QString> strings;
+    ASSERT_TRUE(ActivityJournalReader::decodePayload(payload, 1, 1750000000000, records, strings));
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].text, "code.exe");
+    EXPECT_EQ(records[0].detail, "main");
+    EXPECT_EQ(records[0].textId, 0u);
+}
+
+TEST_F(ActivityJournalTest, SkipsBlocksWithBadChecksum) {
+    const qint64 base = 1750000000000;
+    ActivityJournalWriter writer(journalPath_);
+    writer.append(makeInput(base, ActivityEventType::KeyDown, 10, 0));
+    ASSERT_TRUE(writer.flush());
+    writer.append(makeInput(base + 1, ActivityEventType::KeyUp, 11, 0));
+    ASSERT_TRUE(writer.flush());
+
+    // Flip a payload byte inside the first block
+    QFile file(journalPath_);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    QByteArray data = file.readAll();
+    data[ActivityJournal::FILE_HEADER_SIZE + ActivityJournal::BLOCK_HEADER_SIZE + 2] ^= 0x55;
+    file.seek(0);
+    file.write(data);
+    file.close();
+
+    ActivityJournalReader reader(journalPath_);
+    ASSERT_TRUE(reader.open());
+    QVector<ActivityJournalRecord> records = reader.readAll();
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].inputType, ActivityEventType::KeyUp);
+    EXPECT_EQ(reader.corruptBlockCount(), 1);
+}
+
+TEST_F(ActivityJournalTest, StopsAtPartiallyWrittenTail) {
+    const qint64 base = 1750000000000;
+    ActivityJournalWriter writer(journalPath_);
+    writer.append(makeInput(base, ActivityEventType::KeyDown, 10, 0));
+    ASSERT_TRUE(writer.flush());
+    const qint64 firstBlockEnd = QFile(journalPath_).size();
+
+    // Simulate a block that is only half on disk
+    QByteArray nextBlock = ActivityJournalWriter::encodeBlock({makeInput(base + 5, ActivityEventType::KeyUp, 10, 0)});
+    QFile file(journalPath_);
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write(nextBlock.left(nextBlock.size() / 2));
+    file.close();
+
+    ActivityJournalReader reader(journalPath_);
+    ASSERT_TRUE(reader.open());
+    QVector<ActivityJournalRecord> records = reader.readAll();
+    EXPECT_EQ(records.size(), 1);
+    EXPECT_EQ(reader.position(), firstBlockEnd);
+    EXPECT_EQ(reader.corruptBlockCount(), 0);
+}
+
+TEST_F(ActivityJournalTest, CutsTornTailBeforeAppending) {
+    const qint64 base = 1750000000000;
+    {
+        ActivityJournalWriter writer(journalPath_);
+        writer.append(makeInput(base, ActivityEventType::KeyDown, 10, 0));
+        ASSERT_TRUE(writer.flush());
+    }
+    const qint64 firstBlockEnd = QFile(journalPath_).size();
+
+    // Simulate a block that was only half written before the process stopped
+    QByteArray tornBlock = ActivityJournalWriter::encodeBlock({makeInput(base + 5, ActivityEventType::KeyUp, 10, 0)});
+    QFile file(journalPath_);
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write(tornBlock.left(tornBlock.size() / 2));
+    file.close();
+
+    ActivityJournalWriter writer(journalPath_);
+    writer.append(makeInput(base + 10, ActivityEventType::MouseLeftDown, 20, 30));
+    ASSERT_TRUE(writer.flush());
+
+    // The good block starts where the torn one did, so the reader gets past it
+    ActivityJournalReader reader(journalPath_);
+    ASSERT_TRUE(reader.open());
+    QVector<ActivityJournalRecord> records = reader.readAll();
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].inputType, ActivityEventType::KeyDown);
+    EXPECT_EQ(records[1].inputType, ActivityEventType::MouseLeftDown);
+    EXPECT_EQ(records[1].timestampMSecs, base + 10);
+    EXPECT_EQ(reader.position(), firstBlockEnd + writer.bytesWritten());
+    EXPECT_EQ(reader.position(), QFile(journalPath_).size());
+    EXPECT_EQ(reader.corruptBlockCount(), 0);
+}
+
+TEST_F(ActivityJournalTest, RejectsFilesWithoutJournalHeader) {
+    QFile file(journalPath_);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("2025-06-15 11:05:07 - MOUSE_MOVE - X: 1099, Y: 949\n");
+    file.close();
+
+    ActivityJournalReader reader(journalPath_);
+    EXPECT_FALSE(reader.open());
+}
+
+TEST_F(ActivityJournalTest, FormatsRecordsAsLegacyTextLines) {
+    QDateTime time = QDateTime::fromString("2025-06-15 11:05:07", "yyyy-MM-dd hh:mm:ss");
+
+    ActivityJournalRecord move = makeInput(time.toMSecsSinceEpoch(), ActivityEventType::MouseMove, 1099, 949);
+    EXPECT_EQ(ActivityJournal::toTextLine(move), "2025-06-15 11:05:07 - MOUSE_MOVE - X: 1099, Y: 949");
+
+    ActivityJournalRecord key = makeInput(time.toMSecsSinceEpoch(), ActivityEventType::KeyDown, 65, 0);
+    EXPECT_EQ(ActivityJournal::toTextLine(key), "2025-06-15 11:05:07 - KEY_DOWN - VK Code: 65");
+
+    ActivityJournalRecord app = makeActiveApp(time.toMSecsSinceEpoch() + 123, "code.exe", "main.cpp");
+    EXPECT_EQ(ActivityJournal::toTextLine(app),
+              "2025-06-15 11:05:07.123 - ACTIVE_APP - PROCESS: code.exe - TITLE: main.cpp");
+}
+
+TEST_F(ActivityJournalTest, ParsesLegacyTextLines) {
+    ActivityJournalRecord record;
+    ASSERT_TRUE(ActivityJournal::parseTextLine(
+        "2025-06-15 11:05:07.250 - ACTIVE_APP - PROCESS: code.exe - TITLE: main.cpp", record));
+    EXPECT_EQ(record.type, JournalRecordType::Text);
+    EXPECT_EQ(ActivityJournal::eventTypeName(record), "ACTIVE_APP");
+    EXPECT_EQ(ActivityJournal::details(record), "PROCESS: code.exe - TITLE: main.cpp");
+    EXPECT_EQ(record.timestampMSecs % 1000, 250);
+
+    EXPECT_FALSE(ActivityJournal::parseTextLine("garbage", record));
+    EXPECT_FALSE(ActivityJournal::parseTextLine("not a date - SYSTEM - started", record));
+}
+
+TEST_F(ActivityJournalTest, Crc32MatchesReferenceValue) {
+    const char data[] = "123456789";
+    EXPECT_EQ(ActivityJournal::crc32(data, 9), 0xCBF43926u);
+
+    // Incremental computation gives the same result
+    quint32 partial = ActivityJournal::crc32(data, 4);
+    EXPECT_EQ(ActivityJournal::crc32(data + 4, 5, partial), 0xCBF43926u);
+}
+
+TEST_F(ActivityJournalTest, RoundTripsMouseMoveSummary) {
+    const qint64 base = 1750000000000;
+
+    ActivityJournalRecord summary;
+    summary.type = JournalRecordType::MouseMoveSummary;
+    summary.timestampMSecs = base;
+    summary.moveCount = 120;
+    summary.pathLength = 843;
+    summary.spanMSecs = 990;
+    summary.x = 1000;
+    summary.y = 500;
+    summary.lastX = 1210;
+    summary.lastY = 430;
+    summary.minX = 990;
+    summary.minY = 420;
+    summary.maxX = 1215;
+    summary.maxY = 512;
+
+    ActivityJournalWriter writer(journalPath_);
+    writer.append(summary);
+    ASSERT_TRUE(writer.flush());
+
+    ActivityJournalReader reader(journalPath_);
+    ASSERT_TRUE(reader.open());
+    QVector<ActivityJournalRecord> records = reader.readAll();
+    ASSERT_EQ(records.size(), 1);
+
+    const ActivityJournalRecord& decoded = records[0];
+    EXPECT_EQ(decoded.type, JournalRecordType::MouseMoveSummary);
+    EXPECT_EQ(decoded.moveCount, 120);
+    EXPECT_EQ(decoded.pathLength, 843);
+    EXPECT_EQ(decoded.spanMSecs, 990);
+    EXPECT_EQ(decoded.lastX, 1210);
+    EXPECT_EQ(decoded.lastY, 430);
+    EXPECT_EQ(decoded.minX, 990);
+    EXPECT_EQ(decoded.minY, 420);
+    EXPECT_EQ(decoded.maxX, 1215);
+    EXPECT_EQ(decoded.maxY, 512);
+    EXPECT_EQ(ActivityJournal::eventTypeName(decoded), "MOUSE_MOVE_SUMMARY");
+    EXPECT_EQ(ActivityJournal::details(decoded),
+              "Count: 120, Path: 843, Span: 990ms, Box: (990,420)-(1215,512), First: (1000,500), Last: (1210,430)");
+}
+
+TEST_F(ActivityJournalTest, ListsSegmentsInSequenceOrder) {
+    const QString basePath = tempDir_.filePath("activity_journal.ttj");
+    EXPECT_TRUE(ActivityJournal::segmentSequences(basePath).isEmpty());
+
+    EXPECT_TRUE(ActivityJournal::segmentFilePath(basePath, 42).endsWith("activity_journal.000042.ttj"));
+    EXPECT_EQ(ActivityJournal::segmentFilePath("activity_journal.ttj", 1), "activity_journal.000001.ttj");
+
+    for (quint32 sequence : {12u, 3u, 7u}) {
+        QFile file(ActivityJournal::segmentFilePath(basePath, sequence));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    }
+    // Neither the base file nor the cursor count as segments
+    QFile(basePath).open(QIODevice::WriteOnly);
+    QFile(basePath + ".cursor").open(QIODevice::WriteOnly);
+
+    EXPECT_EQ(ActivityJournal::segmentSequences(basePath), (QList<quint32>{3, 7, 12}));
+}
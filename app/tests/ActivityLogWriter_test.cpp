@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include "ActivityLogWriter.h"
+#include "ActivityUploader.h"
+
+/**
+ * @file ActivityLogWriter_test.cpp
+ * @brief Unit tests for the background activity journal writer
+ *
+ * Tests cover:
+ * - Draining queued records into the journal on stop
+ * - Rotating into a new segment when the active one is full
+ * - Importing a large legacy text log in chunk-sized blocks
+ */
+
+class ActivityLogWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(tempDir_.isValid());
+        basePath_ = tempDir_.filePath("activity_journal.ttj");
+    }
+
+    QVector<ActivityJournalRecord> readSegments() {
+        QVector<ActivityJournalRecord> records;
+        for (quint32 sequence : ActivityJournal::segmentSequences(basePath_)) {
+            ActivityJournalReader reader(ActivityJournal::segmentFilePath(basePath_, sequence));
+            EXPECT_TRUE(reader.open());
+            records += reader.readAll();
+        }
+        return records;
+    }
+
+    QTemporaryDir tempDir_;
+    QString basePath_;
+};
+
+TEST_F(ActivityLogWriterTest, WritesQueuedRecordsOnStop) {
+    ActivityLogWriter writer(basePath_);
+    writer.start();
+    writer.logSystemMessage("Activity tracking started");
+    writer.logActiveApplication("code.exe", "main.cpp");
+    writer.stop();
+
+    QVector<ActivityJournalRecord> records = readSegments();
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].text, "Activity tracking started");
+    EXPECT_EQ(records[1].detail, "main.cpp");
+    EXPECT_EQ(writer.writtenEventCount(), 2u);
+}
+
+TEST_F(ActivityLogWriterTest, RotatesSegmentsWhenFull) {
+    ActivityLogWriter writer(basePath_);
+    writer.setSegmentSize(64);
+    writer.start();
+    for (int i = 0; i < 5; ++i) {
+        writer.logSystemMessage(QString("Message %1 with enough text to fill a small segment").arg(i));
+        QThread::msleep(250);   // One drain cycle per message
+    }
+    writer.stop();
+
+    EXPECT_GE(ActivityJournal::segmentSequences(basePath_).size(), 5);
+    QVector<ActivityJournalRecord> records = readSegments();
+    ASSERT_EQ(records.size(), 5);
+    EXPECT_TRUE(records[4].text.startsWith("Message 4"));
+}
+
+TEST_F(ActivityLogWriterTest, ImportsLegacyLogInChunkSizedBlocks) {
+    const int lines = ActivityUploader::DEFAULT_MAX_CHUNK_RECORDS * 2 + 500;
+    const QString legacyPath = tempDir_.filePath("activity_log.txt");
+    {
+        QFile legacyFile(legacyPath);
+        ASSERT_TRUE(legacyFile.open(QIODevice::WriteOnly | QIODevice::Text));
+        QTextStream out(&legacyFile);
+        for (int i = 0; i < lines; ++i) {
+            out << QString("2025-06-15 10:%1:%2 - KEY_DOWN - VK Code: %3\n")
+                       .arg(i / 60 % 60, 2, 10, QChar('0')).arg(i % 60, 2, 10, QChar('0')).arg(65 + i % 10);
+        }
+    }
+
+    ActivityLogWriter writer(basePath_);
+    writer.setLegacyLogFilePath(legacyPath);
+    writer.setSegmentSize(1024);
+    writer.start();
+    writer.stop();
+
+    EXPECT_FALSE(QFile::exists(legacyPath));
+    const QList<quint32> sequences = ActivityJournal::segmentSequences(basePath_);
+    EXPECT_GT(sequences.size(), 1) << "Segments rotate during the import";
+
+    int imported = 0;
+    int blocks = 0;
+    for (quint32 sequence : sequences) {
+        ActivityJournalReader reader(ActivityJournal::segmentFilePath(basePath_, sequence));
+        ASSERT_TRUE(reader.open());
+        QVector<ActivityJournalRecord> records;
+        while (reader.readNextBlock(records)) {
+            EXPECT_LE(records.size(), ActivityUploader::DEFAULT_MAX_CHUNK_RECORDS);
+            imported += records.size();
+            ++blocks;
+            records.clear();
+        }
+    }
+    EXPECT_EQ(imported, lines);
+    EXPECT_EQ(blocks, 3);
+}
@@ -7,6 +7,7 @@
 #include <QFileInfo>
 #include <windows.h>
 #include "../TimeTrackerMainWindow.h"
+#include "../ActivityJournal.h"
 #include "test_utils.h"
 
 /**
@@ -15,8 +16,8 @@
  * 
  * Tests cover:
  * - Windows hook setup and cleanup
- * - Activity log file creation
- * - Log file format and content
+ * - Activity journal file creation
+ * - Journal content and legacy text formatting
  * - Hook installation verification
  * - Error handling for hook failures
  * 
@@ -42,9 +43,9 @@ protected:
         // Change to temp directory for log file testing
         QDir::setCurrent(tempDir_->path());
         
-        // Clean up any existing activity log
-        if (QFile::exists("activity_log.txt")) {
-            QFile::remove("activity_log.txt");
+        // Clean up any existing activity journal segments
+        for (quint32 sequence : ActivityJournal::segmentSequences(ActivityJournal::DEFAULT_FILE_NAME)) {
+            QFile::remove(ActivityJournal::segmentFilePath(ActivityJournal::DEFAULT_FILE_NAME, sequence));
         }
     }
 
@@ -60,6 +61,14 @@ protected:
         QtTestFixture::TearDown();
     }
 
+    // Path of the segment the writer appends to, empty if none exists yet
+    QString activeJournalSegment() {
+        QList<quint32> sequences = ActivityJournal::segmentSequences(ActivityJournal::DEFAULT_FILE_NAME);
+        return sequences.isEmpty()
+            ? QString()
+            : ActivityJournal::segmentFilePath(ActivityJournal::DEFAULT_FILE_NAME, sequences.last());
+    }
+
     TimeTrackerMainWindow* createMainWindow() {
         mainWindow_ = new TimeTrackerMainWindow();
         return mainWindow_;
@@ -95,9 +104,9 @@ TEST_F(ActivityLoggingTest, ActivityLogFileIsCreatedOnStartup) {
     // Process events to ensure initialization is complete
     WidgetTestHelper::processEvents(500);
     
-    // Check if activity log file exists
-    EXPECT_TRUE(QFile::exists("activity_log.txt")) 
-        << "Activity log file should be created on startup";
+    // Check if an activity journal segment exists
+    EXPECT_FALSE(activeJournalSegment().isEmpty())
+        << "Activity journal segment should be created on startup";
 }
 
 TEST_F(ActivityLoggingTest, ActivityLogFileIsWritable) {
@@ -106,10 +115,10 @@ TEST_F(ActivityLoggingTest, ActivityLogFileIsWritable) {
     // Process events to ensure initialization is complete
     WidgetTestHelper::processEvents(500);
     
-    if (QFile::exists("activity_log.txt")) {
-        QFileInfo logInfo("activity_log.txt");
+    if (!activeJournalSegment().isEmpty()) {
+        QFileInfo logInfo(activeJournalSegment());
         EXPECT_TRUE(logInfo.isWritable()) 
-            << "Activity log file should be writable";
+            << "Activity journal file should be writable";
     }
 }
 
@@ -119,17 +128,19 @@ TEST_F(ActivityLoggingTest, ActivityLogContainsStartupEntry) {
     // Process events to ensure initialization is complete
     WidgetTestHelper::processEvents(500);
     
-    if (QFile::exists("activity_log.txt")) {
-        QFile logFile("activity_log.txt");
-        if (logFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream stream(&logFile);
-            QString content = stream.readAll();
-            
-            EXPECT_TRUE(content.contains("Activity tracking started")) 
-                << "Log should contain startup entry";
-            EXPECT_TRUE(content.contains("SYSTEM")) 
-                << "Startup entry should be marked as SYSTEM event";
+    if (!activeJournalSegment().isEmpty()) {
+        ActivityJournalReader reader(activeJournalSegment());
+        ASSERT_TRUE(reader.open()) << "Journal should have a valid header";
+
+        QString content;
+        for (const ActivityJournalRecord& record : reader.readAll()) {
+            content += ActivityJournal::toTextLine(record) + "\n";
         }
+
+        EXPECT_TRUE(content.contains("Activity tracking started")) 
+            << "Log should contain startup entry";
+        EXPECT_TRUE(content.contains("SYSTEM")) 
+            << "Startup entry should be marked as SYSTEM event";
     }
 }
 
@@ -194,23 +205,20 @@ TEST_F(ActivityLoggingTest, LogEntryFormatIsCorrect) {
     // Process events to ensure initialization is complete
     WidgetTestHelper::processEvents(500);
     
-    if (QFile::exists("activity_log.txt")) {
-        QFile logFile("activity_log.txt");
-        if (logFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QTextStream stream(&logFile);
-            QString firstLine = stream.readLine();
+    if (!activeJournalSegment().isEmpty()) {
+        ActivityJournalReader reader(activeJournalSegment());
+        QVector<ActivityJournalRecord> records;
+        if (reader.open() && reader.readNextBlock(records) && !records.isEmpty()) {
+            // Text form should be: YYYY-MM-DD HH:MM:SS - EVENT_TYPE - Details
+            QString firstLine = ActivityJournal::toTextLine(records.first());
+            QStringList parts = firstLine.split(" - ");
+            EXPECT_GE(parts.size(), 2) << "Log entry should have timestamp and event type";
             
-            if (!firstLine.isEmpty()) {
-                // Log format should be: YYYY-MM-DD HH:MM:SS - EVENT_TYPE - Details
-                QStringList parts = firstLine.split(" - ");
-                EXPECT_GE(parts.size(), 2) << "Log entry should have timestamp and event type";
-                
-                // First part should be timestamp (YYYY-MM-DD HH:MM:SS format)
-                QString timestamp = parts[0];
-                EXPECT_EQ(timestamp.length(), 19) << "Timestamp should be 19 characters";
-                EXPECT_TRUE(timestamp.contains("-")) << "Timestamp should contain date separators";
-                EXPECT_TRUE(timestamp.contains(":")) << "Timestamp should contain time separators";
-            }
+            // First part should be timestamp (YYYY-MM-DD HH:MM:SS format)
+            QString timestamp = parts[0];
+            EXPECT_EQ(timestamp.length(), 19) << "Timestamp should be 19 characters";
+            EXPECT_TRUE(timestamp.contains("-")) << "Timestamp should contain date separators";
+            EXPECT_TRUE(timestamp.contains(":")) << "Timestamp should contain time separators";
         }
     }
 }
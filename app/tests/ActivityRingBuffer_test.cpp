@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "ActivityEvent.h"
+#include "ActivityRingBuffer.h"
+
+/**
+ * @file ActivityRingBuffer_test.cpp
+ * @brief Unit tests for the lock-free hook event ring buffer
+ *
+ * Tests cover:
+ * - Capacity rounding
+ * - FIFO ordering and batch pops
+ * - Overflow dropping and drop counting
+ * - Concurrent single-producer/single-consumer use
+ */
+
+namespace {
+
+ActivityEvent makeEvent(std::int64_t ticks)
+{
+    ActivityEvent event{};
+    event.ticks = ticks;
+    event.type = ActivityEventType::MouseMove;
+    event.x = static_cast<std::int32_t>(ticks);
+    event.y = static_cast<std::int32_t>(ticks * 2);
+    return event;
+}
+
+} // namespace
+
+TEST(ActivityRingBufferTest, CapacityIsRoundedUpToPowerOfTwo) {
+    ActivityRingBuffer<ActivityEvent> buffer(1000);
+    EXPECT_EQ(buffer.capacity(), 1024u);
+    EXPECT_TRUE(buffer.isEmpty());
+}
+
+TEST(ActivityRingBufferTest, PopsEventsInFifoOrder) {
+    ActivityRingBuffer<ActivityEvent> buffer(16);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(buffer.tryPush(makeEvent(i)));
+    }
+    EXPECT_EQ(buffer.size(), 10u);
+
+    ActivityEvent out[4];
+    ASSERT_EQ(buffer.popBatch(out, 4), 4u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(out[i].ticks, i);
+        EXPECT_EQ(out[i].y, i * 2);
+    }
+
+    ActivityEvent rest[16];
+    ASSERT_EQ(buffer.popBatch(rest, 16), 6u);
+    EXPECT_EQ(rest[0].ticks, 4);
+    EXPECT_EQ(rest[5].ticks, 9);
+    EXPECT_TRUE(buffer.isEmpty());
+}
+
+TEST(ActivityRingBufferTest, DropsAndCountsEventsWhenFull) {
+    ActivityRingBuffer<ActivityEvent> buffer(8);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(buffer.tryPush(makeEvent(i)));
+    }
+    EXPECT_FALSE(buffer.tryPush(makeEvent(100)));
+    EXPECT_FALSE(buffer.tryPush(makeEvent(101)));
+    EXPECT_EQ(buffer.droppedCount(), 2u);
+
+    // Space frees up again after the consumer drains
+    ActivityEvent out[8];
+    EXPECT_EQ(buffer.popBatch(out, 8), 8u);
+    EXPECT_EQ(out[7].ticks, 7);
+    EXPECT_TRUE(buffer.tryPush(makeEvent(200)));
+    EXPECT_EQ(buffer.droppedCount(), 2u);
+}
+
+TEST(ActivityRingBufferTest, WrapsAroundCorrectly) {
+    ActivityRingBuffer<ActivityEvent> buffer(4);
+    ActivityEvent out[4];
+    for (int round = 0; round < 10; ++round) {
+        ASSERT_TRUE(buffer.tryPush(makeEvent(round * 3)));
+        ASSERT_TRUE(buffer.tryPush(makeEvent(round * 3 + 1)));
+        ASSERT_TRUE(buffer.tryPush(makeEvent(round * 3 + 2)));
+        ASSERT_EQ(buffer.popBatch(out, 4), 3u);
+        EXPECT_EQ(out[0].ticks, round * 3);
+        EXPECT_EQ(out[2].ticks, round * 3 + 2);
+    }
+}
+
+TEST(ActivityRingBufferTest, ConcurrentProducerAndConsumerSeeEveryEvent) {
+    const int eventCount = 200000;
+    ActivityRingBuffer<ActivityEvent> buffer(1024);
+
+    std::thread producer([&buffer]() {
+        for (int i = 0; i < eventCount; ++i) {
+            while (!buffer.tryPush(makeEvent(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<ActivityEvent> batch(256);
+    std::int64_t expected = 0;
+    bool ordered = true;
+    while (expected < eventCount) {
+        std::size_t count = buffer.popBatch(batch.data(), batch.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            ordered = ordered && batch[i].ticks == expected;
+            ++expected;
+        }
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    EXPECT_TRUE(ordered) << "Events must arrive in production order";
+    EXPECT_EQ(expected, eventCount);
+    EXPECT_TRUE(buffer.isEmpty());
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+#include "ActivityClock.h"
+#include "ActivityTrace.h"
+
+/**
+ * @file ActivityTrace_test.cpp
+ * @brief Unit tests for the activity trace format
+ *
+ * Tests cover:
+ * - Write/read round trips for every record kind
+ * - Event times taken from the event's own ticks
+ * - Cutting overlong strings
+ * - Partially written tails and foreign files
+ */
+
+namespace {
+
+ActivityEvent makeEvent(qint64 ticks, ActivityEventType type, qint32 x, qint32 y)
+{
+    ActivityEvent event{};
+    event.ticks = ticks;
+    event.type = type;
+    event.x = x;
+    event.y = y;
+    return event;
+}
+
+QVector<ActivityTraceRecord> readAll(const QString& path)
+{
+    QVector<ActivityTraceRecord> records;
+    ActivityTraceReader reader(path);
+    if (!reader.open()) {
+        return records;
+    }
+    ActivityTraceRecord record;
+    while (reader.readNext(record)) {
+        records.append(record);
+    }
+    return records;
+}
+
+} // namespace
+
+class ActivityTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(tempDir_.isValid());
+        tracePath_ = tempDir_.filePath("trace.tttr");
+    }
+
+    QTemporaryDir tempDir_;
+    QString tracePath_;
+};
+
+TEST_F(ActivityTraceTest, RoundTripsAllRecordKinds) {
+    const qint64 before = QDateTime::currentMSecsSinceEpoch();
+    ActivityTraceWriter writer(tracePath_);
+    ASSERT_TRUE(writer.open());
+
+    const qint64 now = ActivityClock::ticks();
+    writer.writeEvent(makeEvent(now, ActivityEventType::KeyDown, 65, 0));
+    writer.writeEvent(makeEvent(now + ActivityClock::msecsToTicks(15), ActivityEventType::MouseMove, -1920, 1080));
+    writer.writeForeground("chrome.exe", QString::fromUtf8("Résumé - Google Docs"));
+    writer.writeScreenshot(1, QSize(2560, 1440), 0xF0E1D2C3B4A59687ULL);
+    writer.writeUnchangedScreenshot(0);
+    writer.writeScreenshotEncoded(1, 183456);
+    EXPECT_EQ(writer.recordCount(), 6u);
+    writer.close();
+
+    ActivityTraceReader reader(tracePath_);
+    ASSERT_TRUE(reader.open());
+    EXPECT_GE(reader.startMSecs(), before - 1000);
+    EXPECT_LE(reader.startMSecs(), QDateTime::currentMSecsSinceEpoch() + 1000);
+
+    QVector<ActivityTraceRecord> records;
+    ActivityTraceRecord record;
+    while (reader.readNext(record)) {
+        records.append(record);
+    }
+    ASSERT_EQ(records.size(), 6);
+
+    EXPECT_EQ(records[0].kind, ActivityTraceRecord::Kind::Event);
+    EXPECT_EQ(records[0].eventType, ActivityEventType::KeyDown);
+    EXPECT_EQ(records[0].x, 65);
+
+    EXPECT_EQ(records[1].eventType, ActivityEventType::MouseMove);
+    EXPECT_EQ(records[1].x, -1920);
+    EXPECT_EQ(records[1].y, 1080);
+    EXPECT_NEAR(records[1].offsetMicros - records[0].offsetMicros, 15000, 1);
+
+    EXPECT_EQ(records[2].kind, ActivityTraceRecord::Kind::Foreground);
+    EXPECT_EQ(records[2].processName, "chrome.exe");
+    EXPECT_EQ(records[2].windowTitle, QString::fromUtf8("Résumé - Google Docs"));
+
+    EXPECT_EQ(records[3].kind, ActivityTraceRecord::Kind::Screenshot);
+    EXPECT_EQ(records[3].screenIndex, 1);
+    EXPECT_EQ(records[3].size, QSize(2560, 1440));
+    EXPECT_EQ(records[3].hash, 0xF0E1D2C3B4A59687ULL);
+    EXPECT_FALSE(records[3].unchanged);
+
+    EXPECT_EQ(records[4].kind, ActivityTraceRecord::Kind::Screenshot);
+    EXPECT_EQ(records[4].screenIndex, 0);
+    EXPECT_TRUE(records[4].unchanged);
+
+    EXPECT_EQ(records[5].kind, ActivityTraceRecord::Kind::ScreenshotEncoded);
+    EXPECT_EQ(records[5].screenIndex, 1);
+    EXPECT_EQ(records[5].encodedBytes, 183456);
+}
+
+TEST_F(ActivityTraceTest, KeepsEventTimesWrittenOutOfOrder) {
+    ActivityTraceWriter writer(tracePath_);
+    ASSERT_TRUE(writer.open());
+
+    // A bus batch lands after a foreground change that happened later
+    const qint64 eventTicks = ActivityClock::ticks();
+    writer.writeForeground("code.exe", "main.cpp");
+    writer.writeEvent(makeEvent(eventTicks - ActivityClock::msecsToTicks(40), ActivityEventType::KeyUp, 65, 0));
+    writer.close();
+
+    const QVector<ActivityTraceRecord> records = readAll(tracePath_);
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_LT(records[1].offsetMicros, records[0].offsetMicros);
+}
+
+TEST_F(ActivityTraceTest, CutsOverlongStringsOnCharacterBoundary) {
+    ActivityTraceWriter writer(tracePath_);
+    ASSERT_TRUE(writer.open());
+    writer.writeForeground("app.exe", QString(ActivityTrace::MAX_STRING_BYTES, QChar(0x00E9)));
+    writer.close();
+
+    const QVector<ActivityTraceRecord> records = readAll(tracePath_);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].windowTitle, QString(ActivityTrace::MAX_STRING_BYTES / 2, QChar(0x00E9)));
+}
+
+TEST_F(ActivityTraceTest, StopsAtPartiallyWrittenTail) {
+    ActivityTraceWriter writer(tracePath_);
+    ASSERT_TRUE(writer.open());
+    const qint64 now = ActivityClock::ticks();
+    for (int i = 0; i < 100; ++i) {
+        writer.writeEvent(makeEvent(now + i, ActivityEventType::MouseMove, i, i));
+    }
+    writer.writeForeground("notepad.exe", "Untitled - Notepad");
+    writer.close();
+
+    QFile file(tracePath_);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.resize(file.size() - 5));
+    file.close();
+
+    const QVector<ActivityTraceRecord> records = readAll(tracePath_);
+    ASSERT_EQ(records.size(), 100);
+    EXPECT_EQ(records.last().x, 99);
+}
+
+TEST_F(ActivityTraceTest, ReadsAcrossReadBufferBoundaries) {
+    ActivityTraceWriter writer(tracePath_);
+    ASSERT_TRUE(writer.open());
+    const qint64 now = ActivityClock::ticks();
+    const int count = ActivityTraceReader::READ_BUFFER_SIZE / 4;
+    for (int i = 0; i < count; ++i) {
+        writer.writeEvent(makeEvent(now + i * 1000, ActivityEventType::MouseMove, i, -i));
+    }
+    writer.close();
+
+    const QVector<ActivityTraceRecord> records = readAll(tracePath_);
+    ASSERT_EQ(records.size(), count);
+    for (int i = 0; i < count; ++i) {
+        ASSERT_EQ(records[i].x, i);
+        ASSERT_EQ(records[i].y, -i);
+    }
+}
+
+TEST_F(ActivityTraceTest, RejectsForeignFiles) {
+    QFile file(tracePath_);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("TTAJ\x01\x00\x00\x00garbage!", 16);
+    file.close();
+
+    ActivityTraceReader reader(tracePath_);
+    EXPECT_FALSE(reader.open());
+}
+
+TEST_F(ActivityTraceTest, IgnoresRecordsWhenClosed) {
+    ActivityTraceWriter writer(tracePath_);
+    writer.writeForeground("app.exe", "before open");
+    ASSERT_TRUE(writer.open());
+    writer.writeForeground("app.exe", "recorded");
+    writer.close();
+    writer.writeForeground("app.exe", "after close");
+
+    const QVector<ActivityTraceRecord> records = readAll(tracePath_);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].windowTitle, "recorded");
+}
@@ -0,0 +1,445 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QTimer>
+#include "ActivityUploader.h"
+#include "test_utils.h"
+
+/**
+ * @file ActivityUploader_test.cpp
+ * @brief Unit tests for the streaming activity uploader
+ *
+ * Tests cover:
+ * - Chunking the journal by record count and JSON size on block boundaries
+ * - Compact JSON serialization of journal records
+ * - Shipping interned strings once per chunk
+ * - Persisting the committed cursor
+ * - Advancing across segments and releasing acknowledged ones
+ * - Keeping the cursor when a chunk upload fails
+ * - Rejecting acknowledgements for another journal range
+ * - Skipping chunks whose payload the server refuses
+ * - Retrying chunks refused for authentication or routing
+ * - Resending chunks refused as too large in smaller pieces
+ */
+
+namespace {
+
+ActivityJournalRecord makeKey(qint64 timestamp, int vkCode)
+{
+    ActivityJournalRecord record;
+    record.type = JournalRecordType::Input;
+    record.timestampMSecs = timestamp;
+    record.inputType = ActivityEventType::KeyDown;
+    record.x = vkCode;
+    return record;
+}
+
+ActivityJournalRecord makeActiveApp(qint64 timestamp, const QString& process, const QString& title)
+{
+    ActivityJournalRecord record;
+    record.type = JournalRecordType::ActiveApp;
+    record.timestampMSecs = timestamp;
+    record.text = process;
+    record.detail = title;
+    return record;
+}
+
+/**
+ * @brief Fake activity endpoint that acknowledges every chunk it receives
+ *
+ * The acknowledged journal range is shifted by setAcknowledgedOffsetShift()
+ * to simulate a confused server. The first setRejectedRequests() requests
+ * are answered with an error status instead, 400 Bad Request by default.
+ */
+class FakeActivityEndpoint : public TimeTrackerTest::FakeHttpEndpoint
+{
+public:
+    FakeActivityEndpoint() {
+        setStatusCallback([this](int request, const QByteArray&) {
+            return request < m_rejectedRequests ? m_rejectedStatus : 200;
+        });
+        setBodyHook([this](int request, const QByteArray& body) {
+            if (request < m_rejectedRequests) {
+                return QByteArray("Invalid activity entry");
+            }
+            const QJsonObject chunk = QJsonDocument::fromJson(body).object();
+            QJsonObject acknowledged;
+            acknowledged["segment"] = chunk["segment"];
+            acknowledged["startOffset"] = chunk["startOffset"];
+            acknowledged["endOffset"] = chunk["endOffset"].toInteger() + m_offsetShift;
+            QJsonObject response;
+            response["acknowledged"] = acknowledged;
+            return QJsonDocument(response).toJson(QJsonDocument::Compact);
+        });
+    }
+
+    QUrl url() const { return FakeHttpEndpoint::url("/activity"); }
+    int receivedRecords() const {
+        int records = 0;
+        for (const QByteArray& body : requestBodies()) {
+            records += QJsonDocument::fromJson(body).object()["entries"].toArray().size();
+        }
+        return records;
+    }
+    void setAcknowledgedOffsetShift(qint64 shift) { m_offsetShift = shift; }
+    void setRejectedRequests(int count, int status = 400) {
+        m_rejectedRequests = count;
+        m_rejectedStatus = status;
+    }
+
+private:
+    qint64 m_offsetShift = 0;
+    int m_rejectedRequests = 0;
+    int m_rejectedStatus = 400;
+};
+
+} // namespace
+
+class ActivityUploaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!QApplication::instance()) {
+            int argc = 0;
+            char* argv[] = {nullptr};
+            app_ = new QApplication(argc, argv);
+        }
+        ASSERT_TRUE(tempDir_.isValid());
+        basePath_ = tempDir_.filePath("activity_journal.ttj");
+    }
+
+    void TearDown() override {
+        QThreadPool::globalInstance()->waitForDone();
+        delete app_;
+        app_ = nullptr;
+    }
+
+    // Write `blocks` blocks of `recordsPerBlock` key events each to a segment
+    void writeSegment(quint32 segment, int blocks, int recordsPerBlock) {
+        ActivityJournalWriter writer(segmentPath(segment));
+        qint64 timestamp = 1750000000000 + segment * 100000;
+        for (int b = 0; b < blocks; ++b) {
+            for (int r = 0; r < recordsPerBlock; ++r) {
+                writer.append(makeKey(timestamp++, 65 + r % 10));
+            }
+            ASSERT_TRUE(writer.flush());
+        }
+    }
+
+    QString segmentPath(quint32 segment) const {
+        return ActivityJournal::segmentFilePath(basePath_, segment);
+    }
+
+    bool waitForFinished(ActivityUploader& uploader) {
+        QSignalSpy finishedSpy(&uploader, &ActivityUploader::uploadFinished);
+        return finishedSpy.count() > 0 || finishedSpy.wait(5000);
+    }
+
+    QApplication* app_ = nullptr;
+    QTemporaryDir tempDir_;
+    QString basePath_;
+};
+
+TEST_F(ActivityUploaderTest, ChunksRespectRecordLimitOnBlockBoundaries) {
+    writeSegment(1, 5, 10);
+
+    ActivityJournalReader reader(segmentPath(1));
+    ASSERT_TRUE(reader.open());
+
+    QList<ActivityUploadChunk> chunks;
+    ActivityUploadChunk chunk;
+    while (ActivityUploader::readChunk(reader, 25, 1024 * 1024, chunk)) {
+        chunks.append(chunk);
+    }
+
+    // 25 records fit two whole blocks; the third block starts the next chunk
+    ASSERT_EQ(chunks.size(), 3);
+    EXPECT_EQ(chunks[0].recordCount, 20);
+    EXPECT_EQ(chunks[1].recordCount, 20);
+    EXPECT_EQ(chunks[2].recordCount, 10);
+    EXPECT_EQ(chunks[0].startOffset, ActivityJournal::FILE_HEADER_SIZE);
+    EXPECT_EQ(chunks[1].startOffset, chunks[0].endOffset);
+    EXPECT_EQ(chunks[2].startOffset, chunks[1].endOffset);
+    EXPECT_EQ(chunks[2].endOffset, QFile(segmentPath(1)).size());
+
+    QJsonDocument doc = QJsonDocument::fromJson(chunks[0].entries);
+    ASSERT_TRUE(doc.isArray());
+    EXPECT_EQ(doc.array().size(), 20);
+    EXPECT_TRUE(chunks[0].strings.isEmpty());
+}
+
+TEST_F(ActivityUploaderTest, ChunksRespectByteLimit) {
+    writeSegment(1, 8, 5);
+
+    ActivityJournalReader reader(segmentPath(1));
+    ASSERT_TRUE(reader.open());
+
+    const int oneBlockBytes = ActivityUploader::toJson(makeKey(0, 65)).size() * 5 + 8;
+    int totalRecords = 0;
+    ActivityUploadChunk chunk;
+    while (ActivityUploader::readChunk(reader, 100000, oneBlockBytes * 2, chunk)) {
+        EXPECT_LE(chunk.entries.size(), oneBlockBytes * 2);
+        EXPECT_GT(chunk.recordCount, 0);
+        totalRecords += chunk.recordCount;
+    }
+    EXPECT_EQ(totalRecords, 40);
+}
+
+TEST_F(ActivityUploaderTest, SerializesRecordsAsCompactJson) {
+    QByteArray json = ActivityUploader::toJson(makeKey(1750000000123, 65));
+    EXPECT_FALSE(json.contains('\n'));
+
+    QJsonObject object = QJsonDocument::fromJson(json).object();
+    EXPECT_EQ(object["eventType"].toString(), "KEY_DOWN");
+    EXPECT_EQ(object["details"].toString(), "VK Code: 65");
+    EXPECT_EQ(object["timestamp"].toString(), "2025-06-15T15:06:40.123Z") << "Uploads carry ISO-8601 UTC";
+    EXPECT_FALSE(object.contains("userId")) << "Identity is sent once per chunk";
+}
+
+TEST_F(ActivityUploaderTest, ChunksCarryEachInternedStringOnce) {
+    {
+        ActivityJournalWriter writer(segmentPath(1));
+        qint64 timestamp = 1750000000000;
+        for (int b = 0; b < 4; ++b) {
+            writer.append(makeActiveApp(timestamp++, "code.exe", "main.cpp - timetracker"));
+            writer.append(makeActiveApp(timestamp++, "chrome.exe", "Docs"));
+            writer.append(makeKey(timestamp++, 65));
+            ASSERT_TRUE(writer.flush());
+        }
+    }
+
+    ActivityJournalReader reader(segmentPath(1));
+    ASSERT_TRUE(reader.open());
+
+    // The second chunk starts after the definitions, yet is self-contained
+    QList<ActivityUploadChunk> chunks;
+    ActivityUploadChunk chunk;
+    while (ActivityUploader::readChunk(reader, 6, 1024 * 1024, chunk)) {
+        chunks.append(chunk);
+    }
+    ASSERT_EQ(chunks.size(), 2);
+
+    for (const ActivityUploadChunk& uploaded : chunks) {
+        QJsonObject body = QJsonDocument::fromJson(
+            ActivityUploader::chunkBody(uploaded, "user@company.com", "42")).object();
+        EXPECT_EQ(body["userId"].toString(), "user@company.com");
+        EXPECT_EQ(body["sessionId"].toString(), "42");
+        EXPECT_EQ(body["startOffset"].toInteger(), uploaded.startOffset);
+        EXPECT_EQ(body["endOffset"].toInteger(), uploaded.endOffset);
+
+        QJsonObject strings = body["strings"].toObject();
+        EXPECT_EQ(strings.size(), 4);
+
+        QJsonArray entries = body["entries"].toArray();
+        ASSERT_EQ(entries.size(), 6);
+        QJsonObject app = entries[0].toObject();
+        EXPECT_EQ(app["eventType"].toString(), "ACTIVE_APP");
+        EXPECT_FALSE(app.contains("details"));
+        EXPECT_EQ(strings[QString::number(app["process"].toInt())].toString(), "code.exe");
+        EXPECT_EQ(strings[QString::number(app["title"].toInt())].toString(), "main.cpp - timetracker");
+        EXPECT_EQ(entries[2].toObject()["details"].toString(), "VK Code: 65");
+    }
+}
+
+TEST_F(ActivityUploaderTest, PersistsCommittedCursor) {
+    const QString cursorPath = basePath_ + ".cursor";
+    ActivityJournalCursor cursor = ActivityUploader::loadCursor(cursorPath);
+    EXPECT_EQ(cursor.segment, 0u);
+    EXPECT_EQ(cursor.offset, 0);
+
+    cursor.segment = 7;
+    cursor.offset = 123456;
+    ASSERT_TRUE(ActivityUploader::saveCursor(cursorPath, cursor));
+    cursor = ActivityUploader::loadCursor(cursorPath);
+    EXPECT_EQ(cursor.segment, 7u);
+    EXPECT_EQ(cursor.offset, 123456);
+
+    QFile file(cursorPath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("garbage");
+    file.close();
+    EXPECT_EQ(ActivityUploader::loadCursor(cursorPath).offset, 0);
+}
+
+TEST_F(ActivityUploaderTest, UploadsAllSegmentsAndReleasesAcknowledgedOnes) {
+    writeSegment(1, 3, 10);
+    writeSegment(2, 2, 10);
+    writeSegment(3, 1, 10);   // Newest segment, still being appended to
+
+    FakeActivityEndpoint endpoint;
+    QNetworkAccessManager manager;
+    ActivityUploader uploader(&manager, endpoint.url(), basePath_);
+    uploader.setMaxChunkRecords(10);
+
+    uploader.start();
+    ASSERT_TRUE(uploader.isUploading());
+    ASSERT_TRUE(waitForFinished(uploader));
+    QThreadPool::globalInstance()->waitForDone();
+
+    EXPECT_EQ(endpoint.receivedRecords(), 60);
+    EXPECT_EQ(endpoint.receivedRequests(), 6);
+
+    ActivityJournalCursor cursor = uploader.committedCursor();
+    EXPECT_EQ(cursor.segment, 3u);
+    EXPECT_EQ(cursor.offset, QFile(segmentPath(3)).size());
+    EXPECT_EQ(ActivityJournal::segmentSequences(basePath_), (QList<quint32>{3}));
+
+    // Data appended to the newest segment afterwards is picked up from the cursor
+    ActivityJournalWriter writer(segmentPath(3));
+    writer.append(makeKey(1760000000000, 70));
+    ASSERT_TRUE(writer.flush());
+
+    uploader.start();
+    ASSERT_TRUE(waitForFinished(uploader));
+    EXPECT_EQ(endpoint.receivedRecords(), 61);
+}
+
+TEST_F(ActivityUploaderTest, FailedUploadKeepsCursorAndSegments) {
+    writeSegment(1, 3, 10);
+    const qint64 segmentSize = QFile(segmentPath(1)).size();
+
+    QNetworkAccessManager manager;
+    ActivityUploader uploader(&manager, QUrl("http://127.0.0.1:1/api/trackingdata/activity"), basePath_);
+    uploader.setMaxChunkRecords(10);
+    QSignalSpy finishedSpy(&uploader, &ActivityUploader::uploadFinished);
+
+    uploader.start();
+    EXPECT_TRUE(uploader.isUploading());
+    ASSERT_TRUE(finishedSpy.wait(5000));
+
+    EXPECT_FALSE(finishedSpy.at(0).at(0).toBool());
+    EXPECT_FALSE(uploader.isUploading());
+    EXPECT_EQ(uploader.committedCursor().offset, 0);
+    EXPECT_EQ(QFile(segmentPath(1)).size(), segmentSize);
+}
+
+TEST_F(ActivityUploaderTest, MismatchedAcknowledgementKeepsCursor) {
+    writeSegment(1, 2, 10);
+
+    FakeActivityEndpoint endpoint;
+    endpoint.setAcknowledgedOffsetShift(-1);
+    QNetworkAccessManager manager;
+    ActivityUploader uploader(&manager, endpoint.url(), basePath_);
+    uploader.setMaxChunkRecords(10);
+    uploader.setMaxInFlight(1);
+    QSignalSpy finishedSpy(&uploader, &ActivityUploader::uploadFinished);
+
+    uploader.start();
+    ASSERT_TRUE(finishedSpy.wait(5000));
+
+    EXPECT_FALSE(finishedSpy.at(0).at(0).toBool());
+    EXPECT_EQ(endpoint.receivedRequests(), 1) << "The session stops at the mismatched chunk";
+    EXPECT_EQ(uploader.committedCursor().offset, 0);
+}
+
+TEST_F(ActivityUploaderTest, PermanentlyRejectedChunkIsSkipped) {
+    writeSegment(1, 3, 10);
+    writeSegment(2, 1, 10);
+
+    FakeActivityEndpoint endpoint;
+    endpoint.setRejectedRequests(1);
+    QNetworkAccessManager manager;
+    ActivityUploader uploader(&manager, endpoint.url(), basePath_);
+    uploader.setMaxChunkRecords(10);
+    uploader.setMaxInFlight(1);
+    QSignalSpy finishedSpy(&uploader, &ActivityUploader::uploadFinished);
+    QSignalSpy rejectedSpy(&uploader, &ActivityUploader::chunkRejected);
+
+    uploader.start();
+    ASSERT_TRUE(finishedSpy.wait(5000));
+    QThreadPool::globalInstance()->waitForDone();
+
+    // The refused chunk does not hold back the rest of the journal
+    EXPECT_TRUE(finishedSpy.at(0).at(0).toBool());
+    EXPECT_EQ(finishedSpy.at(0).at(1).toInt(), 30);
+    EXPECT_EQ(endpoint.receivedRequests(), 4);
+    ASSERT_EQ(rejectedSpy.count(), 1);
+    EXPECT_EQ(rejectedSpy.at(0).at(0).toUInt(), 1u);
+    EXPECT_EQ(rejectedSpy.at(0).at(1).toLongLong(), ActivityJournal::FILE_HEADER_SIZE);
+    EXPECT_EQ(rejectedSpy.at(0).at(3).toInt(), 10);
+    EXPECT_EQ(rejectedSpy.at(0).at(4).toInt(), 400);
+
+    EXPECT_EQ(uploader.committedCursor().segment, 2u);
+    EXPECT_EQ(uploader.committedCursor().offset, QFile(segmentPath(2)).size());
+    EXPECT_EQ(ActivityJournal::segmentSequences(basePath_), (QList<quint32>{2}));
+
+    // Nothing is resent on the next session
+    uploader.start();
+    EXPECT_FALSE(uploader.isUploading());
+    EXPECT_EQ(endpoint.receivedRequests(), 4);
+}
+
+TEST_F(ActivityUploaderTest, NotFoundKeepsCursorAndSegments) {
+    writeSegment(1, 3, 10);
+    writeSegment(2, 1, 10);
+    const qint64 segmentSize = QFile(segmentPath(1)).size();
+
+    FakeActivityEndpoint endpoint;
+    endpoint.setRejectedRequests(1, 404);
+    QNetworkAccessManager manager;
+    ActivityUploader uploader(&manager, endpoint.url(), basePath_);
+    uploader.setMaxChunkRecords(10);
+    uploader.setMaxInFlight(1);
+    QSignalSpy finishedSpy(&uploader, &ActivityUploader::uploadFinished);
+    QSignalSpy rejectedSpy(&uploader, &ActivityUploader::chunkRejected);
+
+    uploader.start();
+    ASSERT_TRUE(finishedSpy.wait(5000));
+    QThreadPool::globalInstance()->waitForDone();
+
+    // A misrouted request says nothing about the chunk, so nothing is dropped
+    EXPECT_FALSE(finishedSpy.at(0).at(0).toBool());
+    EXPECT_EQ(endpoint.receivedRequests(), 1);
+    EXPECT_EQ(rejectedSpy.count(), 0);
+    EXPECT_EQ(uploader.committedCursor().segment, 1u);
+    EXPECT_EQ(uploader.committedCursor().offset, 0);
+    EXPECT_EQ(ActivityJournal::segmentSequences(basePath_), (QList<quint32>{1, 2}));
+    EXPECT_EQ(QFile(segmentPath(1)).size(), segmentSize);
+
+    // The next session resends the same chunk
+    uploader.start();
+    ASSERT_TRUE(waitForFinished(uploader));
+    EXPECT_EQ(endpoint.receivedRecords(), 50);
+    EXPECT_EQ(uploader.committedCursor().segment, 2u);
+}
+
+TEST_F(ActivityUploaderTest, TooLargeChunkIsResentSmaller) {
+    writeSegment(1, 4, 10);
+
+    FakeActivityEndpoint endpoint;
+    endpoint.setRejectedRequests(1, 413);
+    QNetworkAccessManager manager;
+    ActivityUploader uploader(&manager, endpoint.url(), basePath_);
+    const int blockBytes = ActivityUploader::toJson(makeKey(0, 65)).size() * 10 + 10;
+    uploader.setMaxChunkBytes(blockBytes * 4);
+    uploader.setMaxInFlight(1);
+    QSignalSpy finishedSpy(&uploader, &ActivityUploader::uploadFinished);
+    QSignalSpy rejectedSpy(&uploader, &ActivityUploader::chunkRejected);
+
+    uploader.start();
+    ASSERT_TRUE(finishedSpy.wait(5000));
+
+    // The refused chunk of four blocks is reread in the same session as two chunks of two
+    EXPECT_EQ(uploader.maxChunkBytes(), blockBytes * 2);
+    ASSERT_EQ(endpoint.receivedRequests(), 3);
+    EXPECT_EQ(QJsonDocument::fromJson(endpoint.requestBodies().at(0)).object()["entries"].toArray().size(), 40);
+    EXPECT_EQ(QJsonDocument::fromJson(endpoint.requestBodies().at(1)).object()["entries"].toArray().size(), 20);
+    EXPECT_TRUE(finishedSpy.at(0).at(0).toBool());
+    EXPECT_EQ(finishedSpy.at(0).at(1).toInt(), 40);
+    EXPECT_EQ(rejectedSpy.count(), 0);
+    EXPECT_EQ(uploader.committedCursor().offset, QFile(segmentPath(1)).size());
+}
+
+TEST_F(ActivityUploaderTest, StartWithoutJournalDoesNothing) {
+    QNetworkAccessManager manager;
+    ActivityUploader uploader(&manager, QUrl("http://127.0.0.1:1/"), basePath_);
+    uploader.start();
+    EXPECT_FALSE(uploader.isUploading());
+}
@@ -7,8 +7,13 @@
 #include <QJsonObject>
 #include <QApplication>
 #include <QDateTime>
+#include <QDir>
 #include <QEventLoop>
+#include <QSslConfiguration>
+#include <QTemporaryDir>
+#include <QThreadPool>
 #include <QTimer>
+#include "ActivityJournal.h"
 #include "ApiService.h"
 #include "IdleAnnotationDialog.h"
 
@@ -100,4 +105,77 @@ TEST_F(ApiServiceTest, ShouldEmitSignalOnIdleTimeUploadComplete) {
     EXPECT_GE(uploadSpy.count(), 1);
 }
 
+// Test Case 4: Activity, screenshot, idle and summary uploads share the HTTP/2 request setup
+TEST_F(ApiServiceTest, ShouldAllowHttp2OnEveryUploadPath) {
+    // The journal and upload queue live relative to the working directory
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString previousDir = QDir::currentPath();
+    ASSERT_TRUE(QDir::setCurrent(tempDir.path()));
+
+    {
+        ActivityJournalWriter writer(ActivityJournal::segmentFilePath(ActivityJournal::DEFAULT_FILE_NAME, 1));
+        ActivityJournalRecord record;
+        record.type = JournalRecordType::Input;
+        record.timestampMSecs = QDateTime::currentMSecsSinceEpoch();
+        record.inputType = ActivityEventType::KeyDown;
+        record.x = 65;
+        writer.append(record);
+        writer.flush();
+    }
 
+    QMap<QString, QNetworkRequest> requests;
+    {
+        ApiService service;
+        QNetworkAccessManager* manager = service.findChild<QNetworkAccessManager*>();
+        ASSERT_NE(manager, nullptr);
+        QObject::connect(manager, &QNetworkAccessManager::finished, [&requests](QNetworkReply* reply) {
+            requests.insert(reply->request().url().path(), reply->request());
+        });
+
+        // Nothing listens on port 1, so every request fails fast
+        service.setBaseUrl("https://127.0.0.1:1/api/trackingdata");
+
+        service.uploadActivityLogs();
+
+        ScreenshotResult screen;
+        screen.filePath = tempDir.filePath("screen0.jpg");
+        screen.success = true;
+        screen.data = QByteArray("jpeg");
+        screen.mimeType = "image/jpeg";
+        service.uploadScreenshots({screen}, "user@test.com", "session1");
+
+        IdleAnnotationData idle;
+        idle.reason = "Meeting";
+        idle.startTime = QDateTime::currentDateTime().addSecs(-300);
+        idle.endTime = QDateTime::currentDateTime();
+        idle.durationSeconds = 300;
+        service.uploadIdleTime(idle);
+
+        ActivityMinuteSummary summary;
+        summary.minuteStartMSecs = QDateTime::currentMSecsSinceEpoch() / 60000 * 60000;
+        summary.keyCount = 1;
+        service.uploadActivitySummaries({summary}, "user@test.com", "session1");
+
+        // A disconnected machine spills the screenshot batch, which the queue then posts to /screenshots
+        const QString base = "/api/trackingdata";
+        EXPECT_TRUE(QTest::qWaitFor([&]() {
+            return requests.contains(base + "/activity/chunk")
+                && (requests.contains(base + "/screenshots/batch") || requests.contains(base + "/screenshots"))
+                && requests.contains(base + "/idletime/batch")
+                && requests.contains(base + "/activity/summary");
+        }, 10000));
+    }
+    QThreadPool::globalInstance()->waitForDone();
+    QDir::setCurrent(previousDir);
+
+    ASSERT_FALSE(requests.isEmpty());
+    const QSslConfiguration shared = requests.first().sslConfiguration();
+    for (auto it = requests.cbegin(); it != requests.cend(); ++it) {
+        SCOPED_TRACE(it.key().toStdString());
+        EXPECT_TRUE(it.value().attribute(QNetworkRequest::Http2AllowedAttribute).toBool());
+        EXPECT_TRUE(it.value().sslConfiguration().allowedNextProtocols().contains(QSslConfiguration::ALPNProtocolHTTP2));
+        EXPECT_TRUE(it.value().sslConfiguration() == shared);
+        EXPECT_EQ(it.value().rawHeader("User-Agent"), QByteArray("TimeTracker-Client/1.0"));
+    }
+}
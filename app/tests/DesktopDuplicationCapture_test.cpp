@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QScreen>
+#include "DesktopDuplicationCapture.h"
+
+/**
+ * @file DesktopDuplicationCapture_test.cpp
+ * @brief Unit tests for Desktop Duplication screen capture
+ *
+ * Tests cover:
+ * - Capturing the primary screen at its physical size
+ * - The first frame reporting the whole screen as changed
+ * - Re-capturing without copying an unchanged frame
+ * - Reporting Unavailable while disabled
+ *
+ * Duplication needs a local console session with a GPU output, so the
+ * capture tests are skipped on CI machines and in remote sessions.
+ */
+
+class DesktopDuplicationCaptureTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!QApplication::instance()) {
+            int argc = 0;
+            char* argv[] = {nullptr};
+            app_ = new QApplication(argc, argv);
+        }
+        screen_ = QGuiApplication::primaryScreen();
+        ASSERT_NE(screen_, nullptr);
+    }
+
+    void TearDown() override {
+        delete app_;
+        app_ = nullptr;
+    }
+
+    QApplication* app_ = nullptr;
+    QScreen* screen_ = nullptr;
+};
+
+TEST_F(DesktopDuplicationCaptureTest, CapturesWholeScreenFirst) {
+    DesktopDuplicationCapture capture;
+    DesktopDuplicationCapture::Frame frame;
+    if (capture.capture(screen_, &frame) == DesktopDuplicationCapture::Status::Unavailable) {
+        GTEST_SKIP() << capture.errorString().toStdString();
+    }
+
+    const QSize physicalSize = screen_->geometry().size() * screen_->devicePixelRatio();
+    EXPECT_EQ(frame.image.size(), physicalSize);
+    EXPECT_EQ(frame.image.format(), QImage::Format_RGB32);
+    EXPECT_EQ(frame.changedRegion, QRegion(frame.image.rect()));
+}
+
+TEST_F(DesktopDuplicationCaptureTest, RecaptureReusesUnchangedFrame) {
+    DesktopDuplicationCapture capture;
+    DesktopDuplicationCapture::Frame first;
+    if (capture.capture(screen_, &first) == DesktopDuplicationCapture::Status::Unavailable) {
+        GTEST_SKIP() << capture.errorString().toStdString();
+    }
+
+    DesktopDuplicationCapture::Frame second;
+    const DesktopDuplicationCapture::Status status = capture.capture(screen_, &second);
+    ASSERT_NE(status, DesktopDuplicationCapture::Status::Unavailable) << capture.errorString().toStdString();
+    EXPECT_EQ(second.image.size(), first.image.size());
+    if (status == DesktopDuplicationCapture::Status::Unchanged) {
+        EXPECT_TRUE(second.changedRegion.isEmpty());
+        EXPECT_EQ(second.image.constBits(), first.image.constBits()) << "An unchanged frame is not copied";
+    } else {
+        EXPECT_FALSE(second.changedRegion.isEmpty());
+    }
+}
+
+TEST_F(DesktopDuplicationCaptureTest, DisabledCaptureIsUnavailable) {
+    DesktopDuplicationCapture capture;
+    capture.setEnabled(false);
+    EXPECT_FALSE(capture.isEnabled());
+
+    DesktopDuplicationCapture::Frame frame;
+    EXPECT_EQ(capture.capture(screen_, &frame), DesktopDuplicationCapture::Status::Unavailable);
+    EXPECT_FALSE(capture.errorString().isEmpty());
+}
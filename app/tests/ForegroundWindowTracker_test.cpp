@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QDateTime>
+#include <QSignalSpy>
+#include <QTimer>
+#include "ForegroundWindowTracker.h"
+
+/**
+ * @file ForegroundWindowTracker_test.cpp
+ * @brief Unit tests for event-driven foreground window tracking
+ *
+ * Tests cover:
+ * - Reporting the current foreground window on start
+ * - Suppressing unchanged polls
+ * - Hook ownership and the polling fallback
+ */
+
+class ForegroundWindowTrackerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!QApplication::instance()) {
+            int argc = 0;
+            char* argv[] = {nullptr};
+            app_ = new QApplication(argc, argv);
+        }
+    }
+
+    void TearDown() override {
+        delete app_;
+        app_ = nullptr;
+    }
+
+    QApplication* app_ = nullptr;
+};
+
+TEST_F(ForegroundWindowTrackerTest, ReportsForegroundWindowOnStart) {
+    ForegroundWindowTracker tracker;
+    QSignalSpy changedSpy(&tracker, &ForegroundWindowTracker::foregroundChanged);
+
+    const qint64 before = QDateTime::currentMSecsSinceEpoch();
+    tracker.start();
+    EXPECT_TRUE(tracker.isRunning());
+    ASSERT_EQ(changedSpy.count(), 1);
+    EXPECT_FALSE(changedSpy.at(0).at(0).toString().isEmpty());
+    EXPECT_GE(changedSpy.at(0).at(2).toLongLong(), before);
+    EXPECT_EQ(tracker.processName(), changedSpy.at(0).at(0).toString());
+
+    // Nothing changed, nothing reported
+    tracker.poll();
+    EXPECT_EQ(changedSpy.count(), 1);
+
+    tracker.stop();
+    EXPECT_FALSE(tracker.isRunning());
+    EXPECT_FALSE(tracker.isEventDriven());
+}
+
+TEST_F(ForegroundWindowTrackerTest, FallsBackToPolling) {
+    ForegroundWindowTracker tracker;
+    tracker.start(false);
+
+    EXPECT_FALSE(tracker.isEventDriven());
+    EXPECT_EQ(tracker.pollIntervalMSecs(), ForegroundWindowTracker::DEFAULT_POLL_INTERVAL_MS);
+    auto timers = tracker.findChildren<QTimer*>();
+    ASSERT_EQ(timers.size(), 1);
+    EXPECT_TRUE(timers.first()->isActive());
+
+    tracker.stop();
+    EXPECT_FALSE(timers.first()->isActive());
+}
+
+TEST_F(ForegroundWindowTrackerTest, OnlyOneTrackerOwnsTheHooks) {
+    ForegroundWindowTracker first;
+    first.start();
+    if (!first.isEventDriven()) {
+        GTEST_SKIP() << "WinEvent hooks unavailable in this session";
+    }
+
+    ForegroundWindowTracker second;
+    second.start();
+    EXPECT_FALSE(second.isEventDriven()) << "A second tracker must poll instead";
+
+    first.stop();
+    EXPECT_FALSE(first.isEventDriven());
+
+    ForegroundWindowTracker third;
+    third.start();
+    EXPECT_TRUE(third.isEventDriven()) << "Hooks are free again once the owner stops";
+}
@@ -4,6 +4,9 @@
 #include <QTimer>
 #include <QDateTime>
 #include <QCoreApplication>
+#include <thread>
+#include <vector>
+#include <windows.h>
 #include "IdleDetector.h"
 
 class IdleDetectorTest : public ::testing::Test {
@@ -182,3 +185,98 @@ TEST_F(IdleDetectorTest, ShouldResetIdleStateOnActivity) {
     
     detector.stop();
 }
+
+// Test Case 9: Activity updates from another thread are picked up without locking
+TEST_F(IdleDetectorTest, ShouldAcceptActivityFromOtherThreads) {
+    IdleDetector detector;
+    detector.setIdleThresholdSeconds(1);
+    detector.start();
+
+    QTest::qWait(1200);
+    detector.triggerIdleCheck();
+    ASSERT_TRUE(detector.isIdle());
+
+    QSignalSpy idleEndedSpy(&detector, &IdleDetector::idleEnded);
+    std::vector<std::thread> hooks;
+    for (int t = 0; t < 4; ++t) {
+        hooks.emplace_back([&detector]() {
+            for (int i = 0; i < 10000; ++i) {
+                detector.updateLastActivityTime();
+            }
+        });
+    }
+    for (std::thread& hook : hooks) {
+        hook.join();
+    }
+
+    // Only the first event after the idle period ends it
+    EXPECT_FALSE(detector.isIdle());
+    EXPECT_EQ(idleEndedSpy.count(), 1);
+    EXPECT_LE(detector.getLastActivityTime().msecsTo(QDateTime::currentDateTime()), 1000);
+
+    detector.triggerIdleCheck();
+    EXPECT_FALSE(detector.isIdle());
+
+    detector.stop();
+}
+
+// Test Case 10: GetLastInputInfo mode arms a single deadline instead of polling
+TEST_F(IdleDetectorTest, ShouldScheduleDeadlineWithSystemLastInput) {
+    IdleDetector detector;
+    detector.setIdleThresholdSeconds(60);
+    detector.setActivitySource(IdleDetector::ActivitySource::SystemLastInput);
+    EXPECT_EQ(detector.activitySource(), IdleDetector::ActivitySource::SystemLastInput);
+
+    detector.start();
+    ASSERT_TRUE(detector.isRunning());
+    EXPECT_GT(detector.nextCheckIntervalMSecs(), 59000) << "First check is due at the threshold";
+    EXPECT_LE(detector.nextCheckIntervalMSecs(), 60000);
+
+    // The source cannot change while running
+    detector.setActivitySource(IdleDetector::ActivitySource::Hooks);
+    EXPECT_EQ(detector.activitySource(), IdleDetector::ActivitySource::SystemLastInput);
+
+    // A later threshold moves the deadline
+    detector.setIdleThresholdSeconds(120);
+    EXPECT_GT(detector.nextCheckIntervalMSecs(), 119000);
+
+    detector.stop();
+    EXPECT_EQ(detector.nextCheckIntervalMSecs(), -1);
+}
+
+// Test Case 11: GetLastInputInfo mode enters idle at the deadline and polls only while idle
+TEST_F(IdleDetectorTest, ShouldDetectIdleAtDeadlineWithSystemLastInput) {
+    IdleDetector detector;
+    detector.setIdleThresholdSeconds(1);
+    detector.setActivitySource(IdleDetector::ActivitySource::SystemLastInput);
+    QSignalSpy idleStartedSpy(&detector, &IdleDetector::idleStarted);
+    QSignalSpy idleEndedSpy(&detector, &IdleDetector::idleEnded);
+
+    // Compare the raw input time; converted ticks drift with GetTickCount() granularity
+    LASTINPUTINFO inputBefore;
+    inputBefore.cbSize = sizeof(inputBefore);
+    ASSERT_TRUE(GetLastInputInfo(&inputBefore));
+    detector.start();
+    QTest::qWait(1500);
+    LASTINPUTINFO inputAfter;
+    inputAfter.cbSize = sizeof(inputAfter);
+    ASSERT_TRUE(GetLastInputInfo(&inputAfter));
+    if (inputAfter.dwTime != inputBefore.dwTime) {
+        GTEST_SKIP() << "Real user input arrived during the test";
+    }
+
+    EXPECT_TRUE(detector.isIdle());
+    EXPECT_EQ(idleStartedSpy.count(), 1);
+    EXPECT_GT(detector.nextCheckIntervalMSecs(), 0) << "Resume poll runs while idle";
+
+    // Hook-reported activity ends the idle period, the next check re-arms the deadline
+    detector.updateLastActivityTime();
+    EXPECT_FALSE(detector.isIdle());
+    EXPECT_EQ(idleEndedSpy.count(), 1);
+
+    detector.triggerIdleCheck();
+    EXPECT_FALSE(detector.isIdle());
+    EXPECT_GT(detector.nextCheckIntervalMSecs(), 900);
+
+    detector.stop();
+}
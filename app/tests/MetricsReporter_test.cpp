@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+#include "MetricsReporter.h"
+
+/**
+ * @file MetricsReporter_test.cpp
+ * @brief Unit tests for the metrics file and telemetry records
+ *
+ * Tests cover:
+ * - Writing the local file with totals and the last interval
+ * - Telemetry records holding only what changed since the previous one
+ * - Timers following their intervals, 0 switching an output off
+ */
+
+class MetricsReporterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!QApplication::instance()) {
+            int argc = 0;
+            char* argv[] = {nullptr};
+            app_ = new QApplication(argc, argv);
+        }
+        ASSERT_TRUE(tempDir_.isValid());
+        filePath_ = tempDir_.filePath("metrics/metrics.json");
+        Metrics::setEnabled(true);
+        Metrics::reset();
+    }
+
+    void TearDown() override {
+        Metrics::reset();
+        delete app_;
+        app_ = nullptr;
+    }
+
+    QJsonObject readFile() const {
+        QFile file(filePath_);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return QJsonObject();
+        }
+        return QJsonDocument::fromJson(file.readAll()).object();
+    }
+
+    QApplication* app_ = nullptr;
+    QTemporaryDir tempDir_;
+    QString filePath_;
+};
+
+TEST_F(MetricsReporterTest, WritesTotalsAndLastInterval) {
+    MetricsReporter reporter(filePath_);
+    Metrics::add(Metrics::Counter::ScreenshotsCaptured, 2);
+    ASSERT_TRUE(reporter.writeFile());
+
+    Metrics::add(Metrics::Counter::ScreenshotsCaptured, 3);
+    ASSERT_TRUE(reporter.writeFile());
+
+    const QJsonObject object = readFile();
+    ASSERT_FALSE(object.isEmpty()) << "The file holds one JSON object";
+    EXPECT_TRUE(object["enabled"].toBool());
+    EXPECT_FALSE(object["generatedAt"].toString().isEmpty());
+    EXPECT_EQ(object["total"].toObject()["counters"].toObject()["screenshotsCaptured"].toInteger(), 5);
+    EXPECT_EQ(object["lastInterval"].toObject()["counters"].toObject()["screenshotsCaptured"].toInteger(), 3);
+}
+
+TEST_F(MetricsReporterTest, TelemetryHoldsChangesSinceLastRecord) {
+    MetricsReporter reporter(filePath_);
+    QSignalSpy spy(&reporter, &MetricsReporter::telemetryReady);
+
+    Metrics::add(Metrics::Counter::UploadRetries, 4);
+    reporter.emitTelemetry();
+    Metrics::add(Metrics::Counter::UploadRetries, 1);
+    reporter.emitTelemetry();
+
+    ASSERT_EQ(spy.count(), 2);
+    const QJsonObject first = spy.at(0).at(0).toJsonObject();
+    const QJsonObject second = spy.at(1).at(0).toJsonObject();
+    EXPECT_EQ(first["v"].toInt(), MetricsReporter::TELEMETRY_VERSION);
+    EXPECT_EQ(first["counters"].toObject()["uploadRetries"].toInteger(), 4);
+    EXPECT_EQ(second["counters"].toObject()["uploadRetries"].toInteger(), 1);
+    EXPECT_TRUE(second.contains("intervalMs"));
+}
+
+TEST_F(MetricsReporterTest, FollowsIntervals) {
+    MetricsReporter reporter(filePath_);
+    QSignalSpy spy(&reporter, &MetricsReporter::telemetryReady);
+    reporter.setWriteIntervalMSecs(0);
+    reporter.setTelemetryIntervalMSecs(20);
+    reporter.start();
+
+    EXPECT_TRUE(spy.wait(2000));
+    EXPECT_FALSE(QFile::exists(filePath_)) << "A write interval of 0 never writes the file";
+
+    reporter.setTelemetryIntervalMSecs(0);
+    reporter.setWriteIntervalMSecs(20);
+    const int records = spy.count();
+    EXPECT_TRUE(QTest::qWaitFor([&]() { return QFile::exists(filePath_); }, 2000));
+    EXPECT_EQ(spy.count(), records);
+
+    reporter.stop();
+    EXPECT_EQ(readFile()["total"].toObject()["counters"].toObject().size(), Metrics::COUNTER_COUNT);
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <QJsonObject>
+#include <thread>
+#include <vector>
+#include "Metrics.h"
+
+/**
+ * @file Metrics_test.cpp
+ * @brief Unit tests for the process metrics
+ *
+ * Tests cover:
+ * - Counters and gauges, including from several threads
+ * - Histogram buckets and percentiles
+ * - Differences between snapshots
+ * - Recording switched off at runtime, or compiled out with TIMETRACKER_METRICS=0
+ * - The JSON names and layout
+ */
+
+class MetricsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Metrics::setEnabled(true);
+        Metrics::reset();
+    }
+
+    void TearDown() override {
+        Metrics::setEnabled(true);
+        Metrics::reset();
+    }
+};
+
+TEST_F(MetricsTest, CountsAndSetsGauges) {
+    Metrics::add(Metrics::Counter::HookEvents, 1);
+    Metrics::add(Metrics::Counter::HookEvents, 2);
+    Metrics::add(Metrics::Counter::JournalBytesWritten, 4096);
+    Metrics::set(Metrics::Gauge::UploadQueueDepth, 7);
+    Metrics::set(Metrics::Gauge::UploadQueueDepth, 3);
+
+    const Metrics::Snapshot snapshot = Metrics::snapshot();
+    EXPECT_EQ(snapshot.counter(Metrics::Counter::HookEvents), 3u);
+    EXPECT_EQ(snapshot.counter(Metrics::Counter::JournalBytesWritten), 4096u);
+    EXPECT_EQ(snapshot.counter(Metrics::Counter::RingBufferDrops), 0u);
+    EXPECT_EQ(snapshot.gauge(Metrics::Gauge::UploadQueueDepth), 3);
+}
+
+TEST_F(MetricsTest, CountsFromSeveralThreads) {
+    const int threadCount = 4;
+    const int perThread = 10000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([]() {
+            for (int n = 0; n < perThread; ++n) {
+                Metrics::add(Metrics::Counter::HookEvents, 1);
+                Metrics::record(Metrics::Histogram::HookLatencyMicros, 5);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const Metrics::Snapshot snapshot = Metrics::snapshot();
+    EXPECT_EQ(snapshot.counter(Metrics::Counter::HookEvents), quint64(threadCount * perThread));
+    EXPECT_EQ(snapshot.histogram(Metrics::Histogram::HookLatencyMicros).count, quint64(threadCount * perThread));
+}
+
+TEST_F(MetricsTest, HistogramPercentilesUseBucketBounds) {
+    for (int i = 0; i < 90; ++i) {
+        Metrics::record(Metrics::Histogram::HookLatencyMicros, 10);   // [8, 16)
+    }
+    for (int i = 0; i < 10; ++i) {
+        Metrics::record(Metrics::Histogram::HookLatencyMicros, 1000); // [512, 1024)
+    }
+
+    const Metrics::HistogramSnapshot histogram = Metrics::snapshot().histogram(Metrics::Histogram::HookLatencyMicros);
+    EXPECT_EQ(histogram.count, 100u);
+    EXPECT_EQ(histogram.sum, 90u * 10 + 10u * 1000);
+    EXPECT_EQ(histogram.percentile(0.50), 15u);
+    EXPECT_EQ(histogram.percentile(0.90), 15u);
+    EXPECT_EQ(histogram.percentile(0.95), 1023u);
+    EXPECT_EQ(histogram.percentile(1.0), 1023u);
+    EXPECT_EQ(Metrics::HistogramSnapshot().percentile(0.5), 0u) << "Empty histograms report 0";
+}
+
+TEST_F(MetricsTest, ScopedTimerRecordsOneSample) {
+    {
+        Metrics::ScopedTimer timer(Metrics::Histogram::ScreenshotEncodeMicros);
+    }
+    EXPECT_EQ(Metrics::snapshot().histogram(Metrics::Histogram::ScreenshotEncodeMicros).count, 1u);
+}
+
+TEST_F(MetricsTest, SinceGivesDifferences) {
+    Metrics::add(Metrics::Counter::ScreenshotsCaptured, 5);
+    Metrics::record(Metrics::Histogram::ScreenshotGrabMicros, 100);
+    Metrics::set(Metrics::Gauge::UploadQueueDepth, 2);
+    const Metrics::Snapshot earlier = Metrics::snapshot();
+
+    Metrics::add(Metrics::Counter::ScreenshotsCaptured, 3);
+    Metrics::record(Metrics::Histogram::ScreenshotGrabMicros, 200);
+    Metrics::record(Metrics::Histogram::ScreenshotGrabMicros, 300);
+    Metrics::set(Metrics::Gauge::UploadQueueDepth, 9);
+    const Metrics::Snapshot delta = Metrics::snapshot().since(earlier);
+
+    EXPECT_EQ(delta.counter(Metrics::Counter::ScreenshotsCaptured), 3u);
+    EXPECT_EQ(delta.histogram(Metrics::Histogram::ScreenshotGrabMicros).count, 2u);
+    EXPECT_EQ(delta.histogram(Metrics::Histogram::ScreenshotGrabMicros).sum, 500u);
+    EXPECT_EQ(delta.gauge(Metrics::Gauge::UploadQueueDepth), 9) << "Gauges are current values";
+    EXPECT_GE(delta.intervalTicks, 0);
+}
+
+// The TT_METRIC_* macros check the runtime switch; the functions above record unconditionally
+#if TIMETRACKER_METRICS
+TEST_F(MetricsTest, SwitchedOffRecordsNothing) {
+    TT_METRIC_ADD(UploadRetries, 1);
+    Metrics::setEnabled(false);
+    EXPECT_FALSE(Metrics::isEnabled());
+
+    TT_METRIC_ADD(UploadRetries, 1);
+    TT_METRIC_SET(UploadQueueDepth, 4);
+    TT_METRIC_RECORD(ScreenshotUploadMSecs, 50);
+    {
+        TT_METRIC_SCOPED_TIMER(ScreenshotEncodeMicros);
+    }
+
+    const Metrics::Snapshot snapshot = Metrics::snapshot();
+    EXPECT_EQ(snapshot.counter(Metrics::Counter::UploadRetries), 1u) << "Values recorded before are kept";
+    EXPECT_EQ(snapshot.gauge(Metrics::Gauge::UploadQueueDepth), 0);
+    EXPECT_EQ(snapshot.histogram(Metrics::Histogram::ScreenshotUploadMSecs).count, 0u);
+    EXPECT_EQ(snapshot.histogram(Metrics::Histogram::ScreenshotEncodeMicros).count, 0u);
+}
+#else
+TEST_F(MetricsTest, CompiledOutMacrosRecordNothing) {
+    TT_METRIC_ADD(UploadRetries, 1);
+    TT_METRIC_SET(UploadQueueDepth, 4);
+    TT_METRIC_RECORD(ScreenshotUploadMSecs, 50);
+    {
+        TT_METRIC_SCOPED_TIMER(ScreenshotEncodeMicros);
+    }
+
+    const Metrics::Snapshot snapshot = Metrics::snapshot();
+    EXPECT_EQ(snapshot.counter(Metrics::Counter::UploadRetries), 0u);
+    EXPECT_EQ(snapshot.gauge(Metrics::Gauge::UploadQueueDepth), 0);
+    EXPECT_EQ(snapshot.histogram(Metrics::Histogram::ScreenshotUploadMSecs).count, 0u);
+    EXPECT_EQ(snapshot.histogram(Metrics::Histogram::ScreenshotEncodeMicros).count, 0u);
+}
+#endif
+
+TEST_F(MetricsTest, ConvertsToJson) {
+    Metrics::add(Metrics::Counter::HookEvents, 2);
+    Metrics::set(Metrics::Gauge::HookTimeoutMSecs, 1000);
+    Metrics::record(Metrics::Histogram::HookLatencyMicros, 3);
+
+    const QJsonObject totals = Metrics::snapshot().toJson();
+    EXPECT_EQ(totals["counters"].toObject()["hookEvents"].toInteger(), 2);
+    EXPECT_EQ(totals["counters"].toObject()["ringBufferDrops"].toInteger(), 0);
+    EXPECT_EQ(totals["gauges"].toObject()["hookTimeoutMs"].toInteger(), 1000);
+    const QJsonObject latency = totals["histograms"].toObject()["hookLatencyUs"].toObject();
+    EXPECT_EQ(latency["count"].toInteger(), 1);
+    EXPECT_EQ(latency["p99"].toInteger(), 3);
+    EXPECT_FALSE(totals["histograms"].toObject()["screenshotUploadMs"].toObject().contains("p50"))
+        << "Empty histograms carry only their count";
+    EXPECT_FALSE(totals.contains("intervalMs"));
+
+    Metrics::Snapshot delta = Metrics::snapshot().since(Metrics::Snapshot());
+    delta.intervalTicks = ActivityClock::frequency();  // One second
+    const QJsonObject interval = delta.toJson();
+    EXPECT_EQ(interval["intervalMs"].toInteger(), 1000);
+    EXPECT_DOUBLE_EQ(interval["hookEventsPerSecond"].toDouble(), 2.0);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <QFileInfo>
+#include "ProcessNameCache.h"
+
+/**
+ * @file ProcessNameCache_test.cpp
+ * @brief Unit tests for the PID-to-process-name cache
+ *
+ * Tests cover:
+ * - Resolving a running process and answering repeats from the cache
+ * - Not caching processes that cannot be opened
+ * - Capacity-bound LRU eviction
+ * - Dropping processes that have exited
+ */
+
+namespace {
+
+/**
+ * @brief Start a short-lived child process, suspended until resumed
+ */
+bool startChild(PROCESS_INFORMATION *process)
+{
+    wchar_t commandLine[] = L"cmd.exe /c exit 0";
+    STARTUPINFOW startup = {};
+    startup.cb = sizeof(startup);
+    ZeroMemory(process, sizeof(*process));
+    return CreateProcessW(nullptr, commandLine, nullptr, nullptr, FALSE,
+                          CREATE_NO_WINDOW | CREATE_SUSPENDED, nullptr, nullptr, &startup, process);
+}
+
+} // namespace
+
+TEST(ProcessNameCacheTest, ResolvesCurrentProcessOnce) {
+    ProcessNameCache cache;
+    const DWORD self = GetCurrentProcessId();
+
+    ProcessImageInfo info = cache.lookup(self);
+    ASSERT_TRUE(info.valid);
+    EXPECT_EQ(info.processId, self);
+    EXPECT_NE(info.creationTime, 0u);
+    wchar_t modulePath[MAX_PATH];
+    const DWORD length = GetModuleFileNameW(nullptr, modulePath, MAX_PATH);
+    EXPECT_EQ(info.name.toLower(), QFileInfo(QString::fromWCharArray(modulePath, length)).fileName().toLower());
+    EXPECT_EQ(cache.missCount(), 1u);
+    EXPECT_EQ(cache.hitCount(), 0u);
+
+    ProcessImageInfo again = cache.lookup(self);
+    EXPECT_EQ(again.name, info.name);
+    EXPECT_EQ(again.creationTime, info.creationTime);
+    EXPECT_EQ(cache.missCount(), 1u);
+    EXPECT_EQ(cache.hitCount(), 1u);
+    EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(ProcessNameCacheTest, DoesNotCacheFailures) {
+    ProcessNameCache cache;
+
+    // PID 0 is the idle process and cannot be opened
+    EXPECT_FALSE(cache.lookup(0).valid);
+    EXPECT_FALSE(cache.lookup(0).valid);
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ(cache.missCount(), 2u);
+}
+
+TEST(ProcessNameCacheTest, EvictsLeastRecentlyUsed) {
+    PROCESS_INFORMATION child;
+    ASSERT_TRUE(startChild(&child));
+
+    ProcessNameCache cache(1);
+    EXPECT_EQ(cache.capacity(), 1);
+
+    ASSERT_TRUE(cache.lookup(GetCurrentProcessId()).valid);
+    ASSERT_TRUE(cache.lookup(child.dwProcessId).valid);
+    EXPECT_EQ(cache.size(), 1);
+
+    // The current process was evicted and has to be queried again
+    cache.lookup(GetCurrentProcessId());
+    EXPECT_EQ(cache.missCount(), 3u);
+    EXPECT_EQ(cache.hitCount(), 0u);
+
+    TerminateProcess(child.hProcess, 0);
+    CloseHandle(child.hThread);
+    CloseHandle(child.hProcess);
+}
+
+TEST(ProcessNameCacheTest, DropsExitedProcesses) {
+    PROCESS_INFORMATION child;
+    ASSERT_TRUE(startChild(&child));
+
+    ProcessNameCache cache;
+    ProcessImageInfo info = cache.lookup(child.dwProcessId);
+    ASSERT_TRUE(info.valid);
+    EXPECT_EQ(info.name.toLower(), QString("cmd.exe"));
+    ASSERT_TRUE(cache.lookup(GetCurrentProcessId()).valid);
+    EXPECT_EQ(cache.removeExited(), 0);
+
+    ResumeThread(child.hThread);
+    ASSERT_EQ(WaitForSingleObject(child.hProcess, 10000), WAIT_OBJECT_0);
+    CloseHandle(child.hThread);
+    CloseHandle(child.hProcess);
+
+    EXPECT_EQ(cache.removeExited(), 1);
+    EXPECT_EQ(cache.size(), 1);
+
+    // A lookup of the old PID is a fresh query, never the stale name
+    const quint64 misses = cache.missCount();
+    cache.lookup(info.processId);
+    EXPECT_EQ(cache.missCount(), misses + 1);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <QNetworkRequest>
+#include <QUrl>
+#include "ActivityJournal.h"
+#include "RequestCompressor.h"
+
+/**
+ * @file RequestCompressor_test.cpp
+ * @brief Unit tests for negotiated gzip request bodies
+ *
+ * Tests cover:
+ * - The gzip container around the deflate stream
+ * - Negotiation through Accept-Encoding and 415 responses
+ * - Leaving small bodies and unsupported servers alone
+ */
+
+namespace {
+
+quint32 readLittleEndian(const QByteArray& data, int offset)
+{
+    quint32 value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = (value << 8) | static_cast<quint8>(data.at(offset + i));
+    }
+    return value;
+}
+
+quint32 adler32(const QByteArray& data)
+{
+    quint32 a = 1;
+    quint32 b = 0;
+    for (char c : data) {
+        a = (a + static_cast<quint8>(c)) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+// Re-wraps the deflate data of a gzip member so qUncompress can inflate it
+QByteArray gunzipForTest(const QByteArray& gzip, const QByteArray& original)
+{
+    QByteArray zlib;
+    const quint32 size = static_cast<quint32>(original.size());
+    const quint32 checksum = adler32(original);
+    for (int shift = 24; shift >= 0; shift -= 8) zlib.append(static_cast<char>((size >> shift) & 0xff));
+    zlib.append("\x78\x9c", 2);
+    zlib.append(gzip.mid(10, gzip.size() - 18));
+    for (int shift = 24; shift >= 0; shift -= 8) zlib.append(static_cast<char>((checksum >> shift) & 0xff));
+    return qUncompress(zlib);
+}
+
+QByteArray activityLikeJson(int entries)
+{
+    QByteArray json = "[";
+    for (int i = 0; i < entries; ++i) {
+        json += QByteArray(i ? "," : "") + "{\"timestamp\":\"2025-06-15T10:00:" + QByteArray::number(i % 60)
+                + "Z\",\"eventType\":\"KEY_DOWN\",\"details\":\"VK Code: " + QByteArray::number(65 + i % 26) + "\"}";
+    }
+    return json + "]";
+}
+
+} // namespace
+
+TEST(RequestCompressorTest, ProducesValidGzipMember) {
+    const QByteArray json = activityLikeJson(500);
+    const QByteArray gzip = RequestCompressor::gzip(json);
+
+    ASSERT_GT(gzip.size(), 18);
+    EXPECT_EQ(static_cast<quint8>(gzip.at(0)), 0x1f);
+    EXPECT_EQ(static_cast<quint8>(gzip.at(1)), 0x8b);
+    EXPECT_EQ(gzip.at(2), 8) << "Compression method must be deflate";
+    EXPECT_EQ(gzip.at(3), 0) << "No optional header fields";
+
+    EXPECT_EQ(readLittleEndian(gzip, gzip.size() - 8), ActivityJournal::crc32(json.constData(), json.size()));
+    EXPECT_EQ(readLittleEndian(gzip, gzip.size() - 4), static_cast<quint32>(json.size()));
+    EXPECT_EQ(gunzipForTest(gzip, json), json);
+
+    // Repetitive activity JSON is where the bandwidth goes
+    EXPECT_LT(gzip.size() * 10, json.size());
+}
+
+TEST(RequestCompressorTest, StartsUncompressedUntilServerAdvertisesGzip) {
+    RequestCompressor compressor;
+    QNetworkRequest request(QUrl("http://localhost/activity"));
+    QByteArray body = activityLikeJson(100);
+    const QByteArray original = body;
+
+    EXPECT_FALSE(compressor.prepare(request, body));
+    EXPECT_EQ(body, original);
+    EXPECT_FALSE(request.hasRawHeader("Content-Encoding"));
+
+    // A server without the header says nothing either way
+    compressor.observeResponse(200, QByteArray(), false);
+    EXPECT_FALSE(compressor.isEnabled());
+
+    compressor.observeResponse(200, "br;q=1.0, GZIP;q=0.5", false);
+    EXPECT_TRUE(compressor.isEnabled());
+
+    EXPECT_TRUE(compressor.prepare(request, body));
+    EXPECT_EQ(request.rawHeader("Content-Encoding"), "gzip");
+    EXPECT_EQ(gunzipForTest(body, original), original);
+}
+
+TEST(RequestCompressorTest, KeepsSmallBodiesPlain) {
+    RequestCompressor compressor;
+    compressor.setEnabled(true);
+
+    QNetworkRequest request(QUrl("http://localhost/idletime/batch"));
+    QByteArray body = "[{\"reason\":\"Meeting\"}]";
+    EXPECT_FALSE(compressor.prepare(request, body));
+    EXPECT_EQ(body, "[{\"reason\":\"Meeting\"}]");
+    EXPECT_FALSE(request.hasRawHeader("Content-Encoding"));
+}
+
+TEST(RequestCompressorTest, FallsBackWhenServerRejectsGzip) {
+    RequestCompressor compressor;
+    compressor.observeResponse(200, "gzip", false);
+    ASSERT_TRUE(compressor.isEnabled());
+
+    // A transport error or plain 415 to an uncompressed body teaches nothing
+    compressor.observeResponse(0, QByteArray(), true);
+    compressor.observeResponse(415, QByteArray(), false);
+    EXPECT_TRUE(compressor.isEnabled());
+
+    compressor.observeResponse(415, QByteArray(), true);
+    EXPECT_FALSE(compressor.isEnabled());
+
+    // A downgraded server that still answers advertises only what it decodes
+    compressor.observeResponse(200, "gzip", false);
+    compressor.observeResponse(200, "identity", false);
+    EXPECT_FALSE(compressor.isEnabled());
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QTest>
+#include "RuntimeConfig.h"
+
+/**
+ * @file RuntimeConfig_test.cpp
+ * @brief Unit tests for the runtime configuration
+ *
+ * Tests cover:
+ * - Defaults when no file exists
+ * - Reading, clamping and rejecting values
+ * - Layering base values, the local file and the server policy
+ * - Keeping the trace file and server URL out of the server policy
+ * - Reporting changes once, and re-reading the file when it is saved
+ */
+
+class RuntimeConfigTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!QApplication::instance()) {
+            int argc = 0;
+            char* argv[] = {nullptr};
+            app_ = new QApplication(argc, argv);
+        }
+        ASSERT_TRUE(tempDir_.isValid());
+        filePath_ = tempDir_.filePath("timetracker.ini");
+    }
+
+    void TearDown() override {
+        delete app_;
+        app_ = nullptr;
+    }
+
+    void writeFile(const QVariantMap& values) {
+        QSettings file(filePath_, QSettings::IniFormat);
+        file.clear();
+        for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+            file.setValue(it.key(), it.value());
+        }
+        file.sync();
+    }
+
+    QApplication* app_ = nullptr;
+    QTemporaryDir tempDir_;
+    QString filePath_;
+};
+
+TEST_F(RuntimeConfigTest, UsesDefaultsWithoutFile) {
+    RuntimeConfig config(filePath_);
+    const RuntimeSettings& settings = config.settings();
+
+    EXPECT_EQ(settings, RuntimeSettings());
+    EXPECT_EQ(settings.idleThresholdSecs, 300);
+    EXPECT_EQ(settings.uploadIntervalSecs, 300);
+    EXPECT_EQ(settings.appPollIntervalSecs, 5);
+    EXPECT_TRUE(settings.desktopDuplication);
+    EXPECT_EQ(settings.activityUpload, "both");
+}
+
+TEST_F(RuntimeConfigTest, ReadsAndValidatesValues) {
+    RuntimeSettings settings = RuntimeSettings::fromValues({
+        {"Screenshots/intervalSeconds", "120"},
+        {"Screenshots/jitterPercent", 250},
+        {"Screenshots/quality", 60},
+        {"Screenshots/captureBackend", "GDI"},
+        {"Idle/thresholdSeconds", "soon"},
+        {"Tracking/moveCoalescingMSecs", 0},
+        {"Upload/serverUrl", "ftp://example.com"},
+        {"Upload/activity", "Summaries"},
+    });
+
+    EXPECT_EQ(settings.screenshotIntervalSecs, 120);
+    EXPECT_EQ(settings.screenshotJitterPercent, 100) << "Clamped to 100%";
+    EXPECT_EQ(settings.encoder.quality, 60);
+    EXPECT_FALSE(settings.desktopDuplication);
+    EXPECT_EQ(settings.idleThresholdSecs, 300) << "Unparsable values keep the default";
+    EXPECT_EQ(settings.moveCoalescingMSecs, 0);
+    EXPECT_EQ(settings.serverUrl, RuntimeSettings().serverUrl) << "Only HTTP URLs are accepted";
+    EXPECT_EQ(settings.activityUpload, "summaries");
+}
+
+TEST_F(RuntimeConfigTest, PolicyOverridesFileOverridesBase) {
+    writeFile({{"Idle/thresholdSeconds", 600}, {"Upload/intervalSeconds", 120}});
+    RuntimeConfig config(filePath_);
+    config.setBaseValues({{"Idle/thresholdSeconds", 900}, {"Screenshots/quality", 70}});
+
+    EXPECT_EQ(config.settings().idleThresholdSecs, 600);
+    EXPECT_EQ(config.settings().encoder.quality, 70);
+    EXPECT_EQ(config.settings().uploadIntervalSecs, 120);
+
+    const QJsonObject policy = QJsonDocument::fromJson(
+        R"({"Upload": {"intervalSeconds": 60}, "Screenshots/quality": 50})").object();
+    config.setServerPolicy(policy);
+    EXPECT_EQ(config.settings().uploadIntervalSecs, 60);
+    EXPECT_EQ(config.settings().encoder.quality, 50);
+    EXPECT_EQ(config.serverPolicy().value("Upload/intervalSeconds").toInt(), 60);
+
+    config.setServerPolicy(QJsonObject());
+    EXPECT_EQ(config.settings().uploadIntervalSecs, 120) << "An empty policy removes it";
+}
+
+TEST_F(RuntimeConfigTest, TraceFileComesOnlyFromTheMachine) {
+    const QString tracePath = tempDir_.filePath("activity.tttr");
+    writeFile({{"Tracking/traceFile", tracePath}});
+    RuntimeConfig config(filePath_);
+    EXPECT_EQ(config.settings().traceFilePath, tracePath);
+
+    config.setServerPolicy(QJsonDocument::fromJson(R"({"Tracking": {"traceFile": "C:/Users/Public/trace"}})").object());
+    EXPECT_EQ(config.settings().traceFilePath, tracePath) << "The server cannot start or redirect a trace";
+}
+
+TEST_F(RuntimeConfigTest, ServerUrlComesOnlyFromTheMachine) {
+    writeFile({{"Upload/serverUrl", "https://tracker.example.com/api/trackingdata"}});
+    RuntimeConfig config(filePath_);
+    config.setServerPolicy(QJsonDocument::fromJson(
+        R"({"Upload": {"serverUrl": "https://elsewhere.example.net/api/trackingdata", "intervalSeconds": 120}})").object());
+    EXPECT_EQ(config.settings().serverUrl, "https://tracker.example.com/api/trackingdata")
+        << "The server cannot redirect uploads or the next policy fetch";
+    EXPECT_EQ(config.settings().uploadIntervalSecs, 120) << "The rest of the policy still applies";
+    EXPECT_FALSE(config.serverPolicy().contains("Upload/serverUrl"));
+
+    RuntimeConfig defaults(tempDir_.filePath("missing.ini"));
+    defaults.setServerPolicy(QJsonDocument::fromJson(R"({"Upload": {"serverUrl": "https://elsewhere.example.net"}})").object());
+    EXPECT_EQ(defaults.settings().serverUrl, RuntimeSettings().serverUrl);
+}
+
+TEST_F(RuntimeConfigTest, ReportsOnlyRealChanges) {
+    RuntimeConfig config(filePath_);
+    int changes = 0;
+    RuntimeSettings reportedPrevious;
+    QObject::connect(&config, &RuntimeConfig::settingsChanged,
+                     [&](const RuntimeSettings&, const RuntimeSettings& previous) {
+                         ++changes;
+                         reportedPrevious = previous;
+                     });
+
+    config.setServerPolicy(QJsonDocument::fromJson(R"({"Idle": {"thresholdSeconds": 60}})").object());
+    EXPECT_EQ(changes, 1);
+    EXPECT_EQ(reportedPrevious.idleThresholdSecs, 300);
+
+    config.setServerPolicy(QJsonDocument::fromJson(R"({"Idle": {"thresholdSeconds": 60}})").object());
+    config.setBaseValues({{"Idle/thresholdSeconds", 120}});
+    EXPECT_EQ(changes, 1) << "Same policy, and a base value the policy overrides";
+}
+
+TEST_F(RuntimeConfigTest, ReloadsWhenFileIsSaved) {
+    RuntimeConfig config(filePath_);
+    ASSERT_EQ(config.settings().appPollIntervalSecs, 5);
+
+    // Created after the config, so only the directory watch sees it
+    writeFile({{"Tracking/pollIntervalSeconds", 2}});
+    ASSERT_TRUE(QTest::qWaitFor([&]() { return config.settings().appPollIntervalSecs == 2; }, 5000));
+
+    writeFile({{"Tracking/pollIntervalSeconds", 3}});
+    ASSERT_TRUE(QTest::qWaitFor([&]() { return config.settings().appPollIntervalSecs == 3; }, 5000));
+
+    ASSERT_TRUE(QFile::remove(filePath_));
+    EXPECT_TRUE(QTest::qWaitFor([&]() { return config.settings().appPollIntervalSecs == 5; }, 5000))
+        << "A removed file falls back to the defaults";
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <QImage>
+#include <QPainter>
+#include "ScreenshotDeduplicator.h"
+
+/**
+ * @file ScreenshotDeduplicator_test.cpp
+ * @brief Unit tests for perceptual-hash duplicate screenshot suppression
+ *
+ * Tests cover:
+ * - Stable hashes for identical and slightly altered images
+ * - Skipping near-duplicates per screen and counting saved bytes
+ * - Threshold configuration and disabled suppression
+ * - Comparing hashes computed by the caller
+ */
+
+namespace {
+
+// A "desktop" with a few large windows, optionally shifted to the right
+QImage makeDesktop(int windowOffset = 0, QImage::Format format = QImage::Format_RGB32)
+{
+    QImage image(1920, 1080, format);
+    image.fill(QColor(30, 60, 120));
+    QPainter painter(&image);
+    painter.fillRect(100 + windowOffset, 100, 900, 700, Qt::white);
+    painter.fillRect(1100 + windowOffset, 200, 600, 500, QColor(200, 200, 200));
+    painter.fillRect(0, 1040, 1920, 40, Qt::black);
+    return image;
+}
+
+} // namespace
+
+TEST(ScreenshotDeduplicatorTest, HashIsStableAndTolerant) {
+    const quint64 hash = ScreenshotDeduplicator::differenceHash(makeDesktop());
+    EXPECT_NE(hash, 0u);
+    EXPECT_EQ(ScreenshotDeduplicator::differenceHash(makeDesktop()), hash);
+    EXPECT_LE(ScreenshotDeduplicator::hammingDistance(
+                  ScreenshotDeduplicator::differenceHash(makeDesktop(0, QImage::Format_RGB888)), hash),
+              ScreenshotDeduplicator::DEFAULT_HAMMING_THRESHOLD);
+
+    // A blinking cursor is far below the grid resolution
+    QImage withCursor = makeDesktop();
+    QPainter(&withCursor).fillRect(500, 400, 2, 16, Qt::black);
+    EXPECT_LE(ScreenshotDeduplicator::hammingDistance(
+                  ScreenshotDeduplicator::differenceHash(withCursor), hash), 1);
+
+    // Moving the windows by half the screen is a different picture
+    EXPECT_GT(ScreenshotDeduplicator::hammingDistance(
+                  ScreenshotDeduplicator::differenceHash(makeDesktop(600)), hash),
+              ScreenshotDeduplicator::DEFAULT_HAMMING_THRESHOLD);
+
+    EXPECT_EQ(ScreenshotDeduplicator::differenceHash(QImage()), 0u);
+    EXPECT_EQ(ScreenshotDeduplicator::hammingDistance(0x0Fu, 0xF0u), 8);
+}
+
+TEST(ScreenshotDeduplicatorTest, SkipsNearDuplicatesPerScreen) {
+    ScreenshotDeduplicator deduplicator;
+    int distance = 0;
+
+    EXPECT_FALSE(deduplicator.isDuplicate(0, makeDesktop(), &distance));
+    EXPECT_EQ(distance, -1) << "First capture of a screen has no reference";
+    deduplicator.recordEncodedBytes(0, 250000);
+
+    EXPECT_FALSE(deduplicator.isDuplicate(1, makeDesktop())) << "Screens are compared independently";
+
+    EXPECT_TRUE(deduplicator.isDuplicate(0, makeDesktop(), &distance));
+    EXPECT_EQ(distance, 0);
+    EXPECT_TRUE(deduplicator.isDuplicate(0, makeDesktop()));
+    EXPECT_FALSE(deduplicator.isDuplicate(0, makeDesktop(600)));
+
+    EXPECT_EQ(deduplicator.checkedCount(), 5u);
+    EXPECT_EQ(deduplicator.skippedCount(), 2u);
+    EXPECT_EQ(deduplicator.savedBytes(), 500000);
+
+    deduplicator.reset();
+    EXPECT_FALSE(deduplicator.isDuplicate(0, makeDesktop(600)));
+    deduplicator.forget(0);
+    EXPECT_FALSE(deduplicator.isDuplicate(0, makeDesktop(600)));
+}
+
+TEST(ScreenshotDeduplicatorTest, ThresholdControlsSuppression) {
+    ScreenshotDeduplicator deduplicator(64);
+    EXPECT_FALSE(deduplicator.isDuplicate(0, makeDesktop()));
+    EXPECT_TRUE(deduplicator.isDuplicate(0, makeDesktop(600))) << "Every hash is within 64 bits";
+
+    deduplicator.setHammingThreshold(-1);
+    EXPECT_FALSE(deduplicator.isDuplicate(0, makeDesktop()));
+    EXPECT_FALSE(deduplicator.isDuplicate(0, makeDesktop()));
+    EXPECT_EQ(deduplicator.skippedCount(), 1u);
+}
+
+TEST(ScreenshotDeduplicatorTest, ComparesPrecomputedHashes) {
+    const quint64 hash = ScreenshotDeduplicator::differenceHash(makeDesktop());
+    ScreenshotDeduplicator deduplicator;
+    EXPECT_FALSE(deduplicator.isDuplicateHash(0, hash));
+    EXPECT_TRUE(deduplicator.isDuplicate(0, makeDesktop())) << "Both overloads share the references";
+
+    int distance = 0;
+    EXPECT_FALSE(deduplicator.isDuplicateHash(0, ~hash, &distance));
+    EXPECT_EQ(distance, 64);
+    EXPECT_EQ(deduplicator.checkedCount(), 3u);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <QImage>
+#include <QPainter>
+#include "ScreenshotDeltaEncoder.h"
+
+/**
+ * @file ScreenshotDeltaEncoder_test.cpp
+ * @brief Unit tests for tile-based screenshot delta encoding
+ *
+ * Tests cover:
+ * - Detecting changed tiles, including clipped edge tiles
+ * - Packing changed tiles into an atlas
+ * - Keyframe scheduling: first capture, interval, large changes, size changes and reset
+ * - Comparing only the tiles a capture backend reports as changed
+ */
+
+namespace {
+
+QImage makeFrame(int width = 1000, int height = 600)
+{
+    QImage image(width, height, QImage::Format_RGB32);
+    image.fill(QColor(240, 240, 240));
+    return image;
+}
+
+} // namespace
+
+TEST(ScreenshotDeltaEncoderTest, FindsChangedTilesIncludingEdges) {
+    QImage previous = makeFrame();
+    QImage current = previous.copy();
+    current.setPixel(130, 10, qRgb(0, 0, 0));      // Tile (1, 0)
+    current.setPixel(999, 599, qRgb(0, 0, 0));     // Clipped bottom-right tile
+
+    int tileCount = 0;
+    QVector<QRect> tiles = ScreenshotDeltaEncoder::changedTiles(previous, current, 128, &tileCount);
+    EXPECT_EQ(tileCount, 8 * 5);
+    ASSERT_EQ(tiles.size(), 2);
+    EXPECT_EQ(tiles[0], QRect(128, 0, 128, 128));
+    EXPECT_EQ(tiles[1], QRect(896, 512, 104, 88));
+
+    EXPECT_TRUE(ScreenshotDeltaEncoder::changedTiles(previous, previous.copy(), 128).isEmpty());
+    EXPECT_EQ(ScreenshotDeltaEncoder::changedTiles(makeFrame(500, 600), current, 128).size(), tileCount)
+        << "Frames of different size are entirely changed";
+}
+
+TEST(ScreenshotDeltaEncoderTest, PacksTilesRowByRow) {
+    QImage frame = makeFrame();
+    QPainter(&frame).fillRect(QRect(256, 128, 128, 128), Qt::red);
+    QPainter(&frame).fillRect(QRect(896, 512, 104, 88), Qt::blue);
+
+    QVector<QRect> tiles{QRect(256, 128, 128, 128), QRect(896, 512, 104, 88), QRect(0, 0, 128, 128)};
+    QImage atlas = ScreenshotDeltaEncoder::packTiles(frame, tiles, 128, 2);
+    ASSERT_EQ(atlas.size(), QSize(256, 256));
+    EXPECT_EQ(atlas.pixel(10, 10), qRgb(255, 0, 0));
+    EXPECT_EQ(atlas.pixel(128 + 103, 87), qRgb(0, 0, 255));
+    EXPECT_EQ(atlas.pixel(128 + 110, 100), qRgb(0, 0, 0)) << "Unused slot area is padding";
+    EXPECT_EQ(atlas.pixel(5, 128 + 5), qRgb(240, 240, 240));
+}
+
+TEST(ScreenshotDeltaEncoderTest, SendsDeltasBetweenKeyframes) {
+    ScreenshotDeltaEncoder encoder(128);
+    encoder.setKeyframeInterval(3);
+    QImage output;
+
+    QImage frame = makeFrame();
+    ScreenDelta first = encoder.encode(0, frame, output);
+    EXPECT_TRUE(first.keyframe);
+    EXPECT_EQ(output.size(), frame.size());
+
+    // Clock in the corner changes
+    QImage second = frame.copy();
+    QPainter(&second).fillRect(QRect(900, 0, 40, 20), Qt::black);
+    ScreenDelta delta = encoder.encode(0, second, output);
+    EXPECT_FALSE(delta.keyframe);
+    EXPECT_EQ(delta.baseSequence, first.sequence);
+    EXPECT_GT(delta.sequence, first.sequence);
+    EXPECT_EQ(delta.frameSize, frame.size());
+    ASSERT_EQ(delta.tiles.size(), 1);
+    EXPECT_EQ(delta.tiles[0], QRect(896, 0, 104, 128));
+    EXPECT_EQ(delta.atlasColumns, 1);
+    EXPECT_EQ(output.size(), QSize(128, 128));
+
+    // Nothing changed since the delta: nothing to send
+    ScreenDelta unchanged = encoder.encode(0, second, output);
+    EXPECT_FALSE(unchanged.keyframe);
+    EXPECT_TRUE(unchanged.tiles.isEmpty());
+    EXPECT_TRUE(output.isNull());
+
+    QImage third = second.copy();
+    third.setPixel(0, 0, qRgb(1, 2, 3));
+    EXPECT_FALSE(encoder.encode(0, third, output).keyframe);
+
+    // Every third capture that is sent is a keyframe
+    QImage fourth = third.copy();
+    fourth.setPixel(0, 0, qRgb(4, 5, 6));
+    EXPECT_TRUE(encoder.encode(0, fourth, output).keyframe);
+
+    EXPECT_EQ(encoder.keyframeCount(), 2u);
+    EXPECT_EQ(encoder.deltaCount(), 2u);
+    EXPECT_EQ(encoder.totalTileCount(), 4u * 40u);
+    EXPECT_EQ(encoder.sentTileCount(), 2u * 40u + 2u);
+}
+
+TEST(ScreenshotDeltaEncoderTest, FallsBackToKeyframes) {
+    ScreenshotDeltaEncoder encoder(128);
+    QImage output;
+    QImage frame = makeFrame();
+    encoder.encode(0, frame, output);
+
+    // More than half the tiles changed
+    QImage scrolled = frame.copy();
+    QPainter(&scrolled).fillRect(QRect(0, 0, 1000, 400), Qt::darkGray);
+    EXPECT_TRUE(encoder.encode(0, scrolled, output).keyframe);
+
+    // Resolution change
+    EXPECT_TRUE(encoder.encode(0, makeFrame(800, 600), output).keyframe);
+
+    // Server lost its copy
+    QImage small = makeFrame(800, 600);
+    small.setPixel(1, 1, qRgb(0, 0, 0));
+    encoder.reset(0);
+    EXPECT_TRUE(encoder.encode(0, small, output).keyframe);
+
+    // Screens are tracked separately
+    EXPECT_TRUE(encoder.encode(1, frame, output).keyframe);
+
+    encoder.setEnabled(false);
+    EXPECT_TRUE(encoder.encode(1, frame, output).keyframe);
+}
+
+TEST(ScreenshotDeltaEncoderTest, ComparesOnlyTilesInChangedHint) {
+    QImage previous = makeFrame();
+    QImage current = previous.copy();
+    current.setPixel(130, 10, qRgb(0, 0, 0));      // Tile (1, 0), inside the hint
+    current.setPixel(700, 300, qRgb(0, 0, 0));     // Tile (5, 2), outside the hint
+
+    const QRegion hint(QRect(100, 0, 60, 40));
+    QVector<QRect> tiles = ScreenshotDeltaEncoder::changedTiles(previous, current, 128, nullptr, &hint);
+    ASSERT_EQ(tiles.size(), 1);
+    EXPECT_EQ(tiles[0], QRect(128, 0, 128, 128));
+
+    // The hint narrows the comparison; an unchanged tile inside it is still not sent
+    const QRegion wide(QRect(0, 0, 1000, 128));
+    EXPECT_EQ(ScreenshotDeltaEncoder::changedTiles(previous, current, 128, nullptr, &wide).size(), 1);
+
+    ScreenshotDeltaEncoder encoder;
+    QImage output;
+    EXPECT_FALSE(encoder.hasReference(0));
+    encoder.encode(0, previous, output);
+    EXPECT_TRUE(encoder.hasReference(0));
+    const QRegion empty;
+    ScreenDelta delta = encoder.encode(0, current, output, &empty);
+    EXPECT_FALSE(delta.keyframe);
+    EXPECT_TRUE(delta.tiles.isEmpty()) << "Nothing reported, nothing compared";
+    EXPECT_TRUE(output.isNull());
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QBuffer>
+#include <QImageReader>
+#include <QSettings>
+#include <QTemporaryDir>
+#include "ScreenshotEncoder.h"
+#include "ScreenshotPipeline.h"
+
+/**
+ * @file ScreenshotEncoder_test.cpp
+ * @brief Unit tests for the pluggable screenshot encoders
+ *
+ * Tests cover:
+ * - Every available encoder producing a decodable image of its MIME type
+ * - Falling back when an encoder is unknown
+ * - Downscaling to a bounding box
+ * - Reading encoder settings
+ * - Encoding through the pipeline with a configured encoder
+ */
+
+class ScreenshotEncoderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!QApplication::instance()) {
+            int argc = 0;
+            char* argv[] = {nullptr};
+            app_ = new QApplication(argc, argv);
+        }
+        ASSERT_TRUE(tempDir_.isValid());
+    }
+
+    void TearDown() override {
+        delete app_;
+        app_ = nullptr;
+    }
+
+    static QImage makeImage(int width, int height) {
+        QImage image(width, height, QImage::Format_RGB32);
+        image.fill(Qt::darkCyan);
+        for (int y = 0; y < height; y += 8) {
+            for (int x = 0; x < width; x += 8) {
+                image.setPixel(x, y, qRgb((x * 7) & 0xff, (y * 3) & 0xff, 128));
+            }
+        }
+        return image;
+    }
+
+    QApplication* app_ = nullptr;
+    QTemporaryDir tempDir_;
+};
+
+TEST_F(ScreenshotEncoderTest, AvailableEncodersProduceDecodableImages) {
+    const QStringList names = ScreenshotEncoder::availableEncoders();
+    ASSERT_FALSE(names.isEmpty());
+    EXPECT_TRUE(names.contains(ScreenshotEncoder::defaultEncoderName()));
+
+    const QImage image = makeImage(320, 200);
+    for (const QString& name : names) {
+        std::shared_ptr<const ScreenshotEncoder> encoder = ScreenshotEncoder::create(name);
+        ASSERT_NE(encoder, nullptr) << name.toStdString();
+        EXPECT_EQ(encoder->name(), name);
+
+        QByteArray data;
+        QString error;
+        ASSERT_TRUE(encoder->encode(image, 80, &data, &error)) << name.toStdString() << ":" << error.toStdString();
+
+        QBuffer buffer(&data);
+        QImageReader reader(&buffer);
+        EXPECT_EQ(reader.size(), image.size()) << name.toStdString();
+        EXPECT_EQ(ScreenshotEncoder::mimeTypeForFile("shot." + encoder->fileExtension()), encoder->mimeType());
+    }
+}
+
+TEST_F(ScreenshotEncoderTest, UnknownEncoderIsNotCreated) {
+    EXPECT_EQ(ScreenshotEncoder::create("bmp-turbo"), nullptr);
+    std::shared_ptr<const ScreenshotEncoder> encoder = ScreenshotEncoder::create(QString());
+    ASSERT_NE(encoder, nullptr);
+    EXPECT_EQ(encoder->name(), ScreenshotEncoder::defaultEncoderName());
+}
+
+TEST_F(ScreenshotEncoderTest, DownscalesToFitBoundingBox) {
+    const QImage image = makeImage(3840, 2160);
+
+    EXPECT_EQ(ScreenshotEncoder::scaledToFit(image, QSize(1920, 1920)).size(), QSize(1920, 1080));
+    EXPECT_EQ(ScreenshotEncoder::scaledToFit(image, QSize(0, 720)).size(), QSize(1280, 720))
+        << "A zero width is unbounded";
+    EXPECT_EQ(ScreenshotEncoder::scaledToFit(image, QSize(0, 0)).size(), image.size());
+    EXPECT_EQ(ScreenshotEncoder::scaledToFit(image, QSize(4000, 4000)).size(), image.size())
+        << "Smaller images are never upscaled";
+}
+
+TEST_F(ScreenshotEncoderTest, ReadsSettingsWithDefaults) {
+    QSettings settings(tempDir_.filePath("timetracker.ini"), QSettings::IniFormat);
+    ScreenshotEncoderSettings defaults = ScreenshotEncoderSettings::fromSettings(settings);
+    EXPECT_TRUE(defaults.encoder.isEmpty());
+    EXPECT_EQ(defaults.quality, 85);
+    EXPECT_EQ(defaults.maxSize, QSize(0, 0));
+
+    settings.setValue("Screenshots/encoder", " WebP ");
+    settings.setValue("Screenshots/quality", 140);
+    settings.setValue("Screenshots/maxWidth", 1920);
+    ScreenshotEncoderSettings configured = ScreenshotEncoderSettings::fromSettings(settings);
+    EXPECT_EQ(configured.encoder, "webp");
+    EXPECT_EQ(configured.quality, 100);
+    EXPECT_EQ(configured.maxSize, QSize(1920, 0));
+}
+
+TEST_F(ScreenshotEncoderTest, PipelineUsesConfiguredEncoder) {
+    ScreenshotPipeline pipeline;
+    ASSERT_NE(pipeline.encoder(), nullptr);
+    EXPECT_EQ(pipeline.encoder()->name(), "jpeg");
+
+    std::shared_ptr<const ScreenshotEncoder> encoder = ScreenshotEncoder::create(QString());
+    pipeline.setEncoder(encoder);
+    EXPECT_EQ(pipeline.encoder(), encoder);
+
+    ScreenshotResult result = ScreenshotPipeline::encode(makeImage(64, 64), "shot.jpg", 85, encoder.get());
+    EXPECT_TRUE(result.success) << result.errorString.toStdString();
+    EXPECT_EQ(result.mimeType, encoder->mimeType());
+    EXPECT_EQ(result.bytes, result.data.size());
+}
@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QBuffer>
+#include <QFile>
+#include <QImageReader>
+#include <QPainter>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+#include "ScreenshotPipeline.h"
+
+/**
+ * @file ScreenshotPipeline_test.cpp
+ * @brief Unit tests for off-thread screenshot preparation and encoding
+ *
+ * Tests cover:
+ * - Encoding to an in-memory JPEG on a worker thread with an asynchronous result
+ * - Encoding every screen of a multi-screen capture and reporting them together
+ * - Rejecting submissions while the encoder is saturated
+ * - Reporting encoder failures
+ * - Downscaling, duplicate suppression and tile deltas ahead of encoding
+ * - Skipping screens the capture backend reported unchanged
+ * - Sending a keyframe on request
+ */
+
+class ScreenshotPipelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!QApplication::instance()) {
+            int argc = 0;
+            char* argv[] = {nullptr};
+            app_ = new QApplication(argc, argv);
+        }
+        ASSERT_TRUE(tempDir_.isValid());
+    }
+
+    void TearDown() override {
+        delete app_;
+        app_ = nullptr;
+    }
+
+    static QImage makeImage(int width, int height) {
+        QImage image(width, height, QImage::Format_RGB32);
+        image.fill(Qt::darkCyan);
+        return image;
+    }
+
+    static QList<CapturedScreen> makeCapture(const QImage& image, const QString& filePath) {
+        CapturedScreen capture;
+        capture.image = image;
+        capture.filePath = filePath;
+        return {capture};
+    }
+
+    // A black frame with its top-left corner painted white, enough to change the hash
+    static QImage makeFrame(int changedEdge = 0) {
+        QImage image = makeImage(1024, 512);
+        image.fill(Qt::black);
+        if (changedEdge > 0) {
+            QPainter(&image).fillRect(QRect(0, 0, changedEdge, changedEdge), Qt::white);
+        }
+        return image;
+    }
+
+    // Submit one single-screen capture and return its decision once it went through the pipeline
+    PreparedScreen prepareOne(ScreenshotPipeline& pipeline, const CapturedScreen& capture) {
+        QSignalSpy preparedSpy(&pipeline, &ScreenshotPipeline::screensPrepared);
+        EXPECT_TRUE(pipeline.submitScreens({capture}, 85));
+        pipeline.waitForIdle();
+        EXPECT_EQ(preparedSpy.count(), 1);
+        if (preparedSpy.isEmpty()) {
+            return PreparedScreen();
+        }
+        return preparedSpy.at(0).at(0).value<QVector<PreparedScreen>>().value(0);
+    }
+
+    QApplication* app_ = nullptr;
+    QTemporaryDir tempDir_;
+};
+
+TEST_F(ScreenshotPipelineTest, EncodesOnWorkerThreadAndReportsAsynchronously) {
+    ScreenshotPipeline pipeline;
+    QSignalSpy savedSpy(&pipeline, &ScreenshotPipeline::screenshotsEncoded);
+    const QString path = tempDir_.filePath("screenshot_test.jpg");
+
+    ASSERT_TRUE(pipeline.submitScreens(makeCapture(makeImage(640, 480), path), 85));
+    EXPECT_EQ(pipeline.pendingCount(), 1);
+    EXPECT_EQ(savedSpy.count(), 0) << "Result must not be delivered synchronously";
+
+    ASSERT_TRUE(savedSpy.wait(5000));
+    const QVector<ScreenshotResult> results = savedSpy.at(0).at(0).value<QVector<ScreenshotResult>>();
+    ASSERT_EQ(results.size(), 1);
+    ScreenshotResult result = results.first();
+    EXPECT_TRUE(result.success) << result.errorString.toStdString();
+    EXPECT_EQ(result.filePath, path);
+    EXPECT_EQ(result.size, QSize(640, 480));
+    EXPECT_EQ(result.bytes, result.data.size());
+    EXPECT_FALSE(QFile::exists(path)) << "Encoded screenshots must not touch the disk";
+
+    QBuffer buffer(&result.data);
+    buffer.open(QIODevice::ReadOnly);
+    EXPECT_EQ(QImageReader(&buffer).format(), "jpeg");
+    EXPECT_EQ(pipeline.pendingCount(), 0);
+}
+
+TEST_F(ScreenshotPipelineTest, EncodesAllScreensOfACaptureTogether) {
+    ScreenshotPipeline pipeline;
+    QSignalSpy batchSpy(&pipeline, &ScreenshotPipeline::screenshotsEncoded);
+
+    QList<CapturedScreen> screens;
+    for (int i = 0; i < 3; ++i) {
+        CapturedScreen capture;
+        capture.image = makeImage(320 + i * 10, 200);
+        capture.filePath = tempDir_.filePath(QString("shot_screen%1.jpg").arg(i));
+        capture.screen.index = i;
+        capture.screen.name = QString("DISPLAY%1").arg(i + 1);
+        capture.screen.geometry = QRect(i * 1920, 0, 1920, 1080);
+        capture.screen.devicePixelRatio = 1.0 + i * 0.25;
+        screens.append(capture);
+    }
+
+    ASSERT_TRUE(pipeline.submitScreens(screens, 85));
+    EXPECT_EQ(pipeline.pendingCount(), 1) << "A capture counts once regardless of its screen count";
+    ASSERT_TRUE(batchSpy.wait(5000));
+    EXPECT_EQ(batchSpy.count(), 1);
+
+    QVector<ScreenshotResult> results = batchSpy.at(0).at(0).value<QVector<ScreenshotResult>>();
+    ASSERT_EQ(results.size(), 3);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(results[i].success) << results[i].errorString.toStdString();
+        EXPECT_EQ(results[i].screen.index, i);
+        EXPECT_EQ(results[i].screen.geometry, QRect(i * 1920, 0, 1920, 1080));
+        EXPECT_DOUBLE_EQ(results[i].screen.devicePixelRatio, 1.0 + i * 0.25);
+        EXPECT_EQ(results[i].size, QSize(320 + i * 10, 200));
+        EXPECT_GT(results[i].data.size(), 0);
+    }
+    EXPECT_EQ(pipeline.pendingCount(), 0);
+    EXPECT_FALSE(pipeline.submitScreens({}, 85));
+}
+
+TEST_F(ScreenshotPipelineTest, RejectsSubmissionsWhenSaturated) {
+    ScreenshotPipeline pipeline;
+    pipeline.setMaxPending(1);
+    QSignalSpy savedSpy(&pipeline, &ScreenshotPipeline::screenshotsEncoded);
+
+    EXPECT_TRUE(pipeline.submitScreens(makeCapture(makeImage(1920, 1080), tempDir_.filePath("a.jpg")), 85));
+    EXPECT_FALSE(pipeline.submitScreens(makeCapture(makeImage(1920, 1080), tempDir_.filePath("b.jpg")), 85));
+
+    pipeline.waitForIdle();
+    EXPECT_EQ(pipeline.pendingCount(), 0);
+    ASSERT_EQ(savedSpy.count(), 1);
+    EXPECT_EQ(savedSpy.at(0).at(0).value<QVector<ScreenshotResult>>().first().filePath, tempDir_.filePath("a.jpg"));
+    EXPECT_TRUE(pipeline.submitScreens(makeCapture(makeImage(64, 64), tempDir_.filePath("c.jpg")), 85));
+    pipeline.waitForIdle();
+}
+
+TEST_F(ScreenshotPipelineTest, ReportsEncoderFailure) {
+    ScreenshotResult result = ScreenshotPipeline::encode(QImage(), tempDir_.filePath("shot.jpg"), 85);
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(result.errorString.isEmpty());
+    EXPECT_TRUE(result.data.isEmpty());
+    EXPECT_EQ(result.bytes, 0);
+}
+
+TEST_F(ScreenshotPipelineTest, DownscalesBeforeEncoding) {
+    ScreenshotPipeline pipeline;
+    QSignalSpy preparedSpy(&pipeline, &ScreenshotPipeline::screensPrepared);
+    QSignalSpy encodedSpy(&pipeline, &ScreenshotPipeline::screenshotsEncoded);
+
+    ASSERT_TRUE(pipeline.submitScreens(makeCapture(makeImage(1600, 800), tempDir_.filePath("big.jpg")), 85,
+                                       QSize(800, 800)));
+    pipeline.waitForIdle();
+
+    ASSERT_EQ(preparedSpy.count(), 1);
+    const PreparedScreen prepared = preparedSpy.at(0).at(0).value<QVector<PreparedScreen>>().first();
+    EXPECT_EQ(prepared.outcome, PreparedScreen::Outcome::Encode);
+    EXPECT_EQ(prepared.size, QSize(800, 400));
+
+    ASSERT_EQ(encodedSpy.count(), 1);
+    EXPECT_EQ(encodedSpy.at(0).at(0).value<QVector<ScreenshotResult>>().first().size, QSize(800, 400));
+}
+
+TEST_F(ScreenshotPipelineTest, SkipsDuplicatesAndSendsChangedTiles) {
+    ScreenshotPipeline pipeline;
+    QSignalSpy encodedSpy(&pipeline, &ScreenshotPipeline::screenshotsEncoded);
+    CapturedScreen capture = makeCapture(makeFrame(), tempDir_.filePath("frame.jpg")).first();
+
+    PreparedScreen first = prepareOne(pipeline, capture);
+    EXPECT_EQ(first.outcome, PreparedScreen::Outcome::Encode);
+    EXPECT_TRUE(first.delta.keyframe);
+
+    PreparedScreen repeated = prepareOne(pipeline, capture);
+    EXPECT_EQ(repeated.outcome, PreparedScreen::Outcome::Duplicate);
+    EXPECT_EQ(repeated.distance, 0);
+    EXPECT_EQ(repeated.hash, first.hash);
+
+    capture.image = makeFrame(256);
+    PreparedScreen changed = prepareOne(pipeline, capture);
+    ASSERT_EQ(changed.outcome, PreparedScreen::Outcome::Encode);
+    EXPECT_FALSE(changed.delta.keyframe);
+    EXPECT_EQ(changed.delta.baseSequence, first.delta.sequence);
+    EXPECT_EQ(changed.delta.tiles.size(), 4);
+
+    // The duplicate was never encoded
+    ASSERT_EQ(encodedSpy.count(), 2);
+    const ScreenshotResult delta = encodedSpy.at(1).at(0).value<QVector<ScreenshotResult>>().first();
+    EXPECT_TRUE(delta.success) << delta.errorString.toStdString();
+    EXPECT_FALSE(delta.delta.keyframe);
+    EXPECT_EQ(delta.size, QSize(256, 256)) << "Only the tile atlas is encoded";
+}
+
+TEST_F(ScreenshotPipelineTest, SkipsScreensTheBackendReportedUnchanged) {
+    ScreenshotPipeline pipeline;
+    CapturedScreen capture = makeCapture(makeFrame(), tempDir_.filePath("frame.jpg")).first();
+
+    // The first capture after a backend change cannot vouch for earlier changes
+    EXPECT_EQ(prepareOne(pipeline, capture).outcome, PreparedScreen::Outcome::Encode);
+
+    capture.changesKnown = true;
+    EXPECT_EQ(prepareOne(pipeline, capture).outcome, PreparedScreen::Outcome::Unchanged);
+
+    capture.image = makeFrame(256);
+    capture.changedRegion = QRegion(0, 0, 256, 256);
+    PreparedScreen changed = prepareOne(pipeline, capture);
+    EXPECT_EQ(changed.outcome, PreparedScreen::Outcome::Encode);
+    EXPECT_EQ(changed.delta.tiles.size(), 4);
+}
+
+TEST_F(ScreenshotPipelineTest, SendsKeyframeOnRequest) {
+    ScreenshotPipeline pipeline;
+    CapturedScreen capture = makeCapture(makeFrame(), tempDir_.filePath("frame.jpg")).first();
+    EXPECT_EQ(prepareOne(pipeline, capture).outcome, PreparedScreen::Outcome::Encode);
+
+    // The server may have lost the last upload, so even a duplicate goes out in full
+    pipeline.requestKeyframe(0);
+    PreparedScreen resent = prepareOne(pipeline, capture);
+    EXPECT_EQ(resent.outcome, PreparedScreen::Outcome::Encode);
+    EXPECT_TRUE(resent.delta.keyframe);
+
+    EXPECT_EQ(prepareOne(pipeline, capture).outcome, PreparedScreen::Outcome::Duplicate);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QTest>
+#include <QVector>
+#include "ScreenshotScheduler.h"
+
+/**
+ * @file ScreenshotScheduler_test.cpp
+ * @brief Unit tests for adaptive screenshot scheduling
+ *
+ * Tests cover:
+ * - Periodic captures within the interval plus jitter
+ * - Pausing while idle or locked and resuming afterwards
+ * - Capturing after an application switch, ignoring title changes
+ * - Backing off during bursts of switches
+ * - Changing the interval while running
+ */
+
+class ScreenshotSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!QApplication::instance()) {
+            int argc = 0;
+            char* argv[] = {nullptr};
+            app_ = new QApplication(argc, argv);
+        }
+    }
+
+    void TearDown() override {
+        delete app_;
+        app_ = nullptr;
+    }
+
+    void record(ScreenshotScheduler& scheduler) {
+        QObject::connect(&scheduler, &ScreenshotScheduler::captureRequested,
+                         [this](ScreenshotScheduler::Trigger trigger) { triggers_.append(trigger); });
+    }
+
+    QApplication* app_ = nullptr;
+    QVector<ScreenshotScheduler::Trigger> triggers_;
+};
+
+TEST_F(ScreenshotSchedulerTest, CapturesPeriodicallyWithJitter) {
+    ScreenshotScheduler scheduler(200);
+    EXPECT_EQ(scheduler.jitterMSecs(), 20) << "10% of the interval by default";
+    scheduler.setJitterMSecs(50);
+    record(scheduler);
+
+    scheduler.start();
+    EXPECT_TRUE(scheduler.isRunning());
+    ASSERT_TRUE(QTest::qWaitFor([&]() { return triggers_.size() >= 2; }, 2000));
+    for (ScreenshotScheduler::Trigger trigger : triggers_) {
+        EXPECT_EQ(trigger, ScreenshotScheduler::Trigger::Periodic);
+    }
+    EXPECT_EQ(scheduler.intervalMSecs(), 200) << "Jitter delays captures, not the interval";
+
+    scheduler.stop();
+    const int count = triggers_.size();
+    QTest::qWait(400);
+    EXPECT_EQ(triggers_.size(), count);
+}
+
+TEST_F(ScreenshotSchedulerTest, PausesWhileIdleOrLocked) {
+    ScreenshotScheduler scheduler(100);
+    scheduler.setJitterMSecs(0);
+    record(scheduler);
+    scheduler.start();
+
+    scheduler.setIdle(true);
+    scheduler.setSessionLocked(true);
+    EXPECT_TRUE(scheduler.isPaused());
+    scheduler.notifyForegroundChanged("code.exe");
+    QTest::qWait(400);
+    EXPECT_TRUE(triggers_.isEmpty());
+
+    // Still locked
+    scheduler.setIdle(false);
+    QTest::qWait(300);
+    EXPECT_TRUE(triggers_.isEmpty());
+
+    scheduler.setSessionLocked(false);
+    EXPECT_FALSE(scheduler.isPaused());
+    ASSERT_TRUE(QTest::qWaitFor([&]() { return !triggers_.isEmpty(); }, 3000));
+    EXPECT_EQ(triggers_.first(), ScreenshotScheduler::Trigger::Resumed);
+}
+
+TEST_F(ScreenshotSchedulerTest, CapturesSoonAfterApplicationSwitch) {
+    ScreenshotScheduler scheduler(60 * 1000);
+    record(scheduler);
+    scheduler.start();
+
+    scheduler.notifyForegroundChanged("code.exe");
+    ASSERT_TRUE(QTest::qWaitFor([&]() { return !triggers_.isEmpty(); }, 3000));
+    EXPECT_EQ(triggers_.first(), ScreenshotScheduler::Trigger::ForegroundChanged);
+
+    // A title change within the same application is not a switch
+    scheduler.notifyForegroundChanged("code.exe");
+    QTest::qWait(ScreenshotScheduler::SETTLE_DELAY_MS + 250);
+    EXPECT_EQ(triggers_.size(), 1);
+}
+
+TEST_F(ScreenshotSchedulerTest, BacksOffDuringBurstsOfSwitches) {
+    ScreenshotScheduler scheduler(60 * 1000);
+    scheduler.setMinimumSpacingMSecs(100);
+    record(scheduler);
+    scheduler.start();
+
+    // Twenty switches in two seconds
+    for (int i = 0; i < 20; ++i) {
+        scheduler.notifyForegroundChanged(QString("app%1.exe").arg(i % 2));
+        QTest::qWait(100);
+    }
+    QTest::qWait(ScreenshotScheduler::SETTLE_DELAY_MS + 250);
+
+    ASSERT_FALSE(triggers_.isEmpty());
+    EXPECT_LT(triggers_.size(), 5) << "Each switch capture doubles the spacing";
+    EXPECT_GT(scheduler.currentSpacingMSecs(), scheduler.minimumSpacingMSecs());
+    EXPECT_LE(scheduler.currentSpacingMSecs(), scheduler.intervalMSecs());
+}
+
+TEST_F(ScreenshotSchedulerTest, AppliesNewIntervalWhileRunning) {
+    ScreenshotScheduler scheduler(60 * 1000);
+    scheduler.setJitterMSecs(30 * 1000);
+    scheduler.setMinimumSpacingMSecs(20 * 1000);
+    record(scheduler);
+    scheduler.start();
+
+    scheduler.setIntervalMSecs(100);
+    EXPECT_EQ(scheduler.intervalMSecs(), 100);
+    EXPECT_LE(scheduler.jitterMSecs(), 100) << "Jitter and spacing are clamped to the new interval";
+    EXPECT_LE(scheduler.minimumSpacingMSecs(), 100);
+
+    scheduler.setJitterMSecs(0);
+    ASSERT_TRUE(QTest::qWaitFor([&]() { return triggers_.size() >= 2; }, 2000));
+}
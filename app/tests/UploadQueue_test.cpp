@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+#include "UploadQueue.h"
+#include "test_utils.h"
+
+/**
+ * @file UploadQueue_test.cpp
+ * @brief Unit tests for the durable upload queue
+ *
+ * Tests cover:
+ * - Jittered exponential backoff bounds
+ * - Persisting jobs across queue instances
+ * - Batching and per-kind concurrency limits
+ * - Retrying transient failures and dropping rejected jobs
+ */
+
+namespace {
+
+QList<int> batchSizes(const TimeTrackerTest::FakeHttpEndpoint& endpoint)
+{
+    QList<int> sizes;
+    for (const QByteArray& body : endpoint.requestBodies()) {
+        sizes.append(QJsonDocument::fromJson(body).array().size());
+    }
+    return sizes;
+}
+
+QJsonObject makePayload(int value)
+{
+    QJsonObject payload;
+    payload["value"] = value;
+    return payload;
+}
+
+} // namespace
+
+class UploadQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!QApplication::instance()) {
+            int argc = 0;
+            char* argv[] = {nullptr};
+            app_ = new QApplication(argc, argv);
+        }
+        ASSERT_TRUE(tempDir_.isValid());
+        queueDir_ = tempDir_.filePath("upload_queue");
+        network_ = new QNetworkAccessManager;
+    }
+
+    void TearDown() override {
+        delete network_;
+        network_ = nullptr;
+        delete app_;
+        app_ = nullptr;
+    }
+
+    // Posts the payloads of a batch as one JSON array
+    UploadQueue::Sender jsonSender(const QUrl& url) {
+        return [this, url](const QList<UploadJob>& jobs) {
+            QJsonArray array;
+            for (const UploadJob& job : jobs) {
+                array.append(job.payload);
+            }
+            QNetworkRequest request(url);
+            request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+            return network_->post(request, QJsonDocument(array).toJson(QJsonDocument::Compact));
+        };
+    }
+
+    int jobFileCount() const {
+        return QDir(queueDir_).entryList(QStringList() << "*.job", QDir::Files).size();
+    }
+
+    QApplication* app_ = nullptr;
+    QTemporaryDir tempDir_;
+    QString queueDir_;
+    QNetworkAccessManager* network_ = nullptr;
+};
+
+TEST_F(UploadQueueTest, BackoffStaysWithinJitteredCeiling) {
+    RetryBackoff backoff(100, 1000);
+
+    EXPECT_EQ(backoff.ceilingMSecs(1), 100);
+    EXPECT_EQ(backoff.ceilingMSecs(2), 200);
+    EXPECT_EQ(backoff.ceilingMSecs(4), 800);
+    EXPECT_EQ(backoff.ceilingMSecs(5), 1000);
+    EXPECT_EQ(backoff.ceilingMSecs(1000), 1000) << "Large attempt counts must not overflow";
+
+    for (int attempts = 1; attempts <= 8; ++attempts) {
+        for (int i = 0; i < 50; ++i) {
+            const int delay = backoff.delayMSecs(attempts);
+            EXPECT_GE(delay, backoff.ceilingMSecs(attempts) / 2);
+            EXPECT_LE(delay, backoff.ceilingMSecs(attempts));
+        }
+    }
+}
+
+TEST_F(UploadQueueTest, PersistsJobsAcrossInstances) {
+    quint64 lastId = 0;
+    {
+        // No kind registered, so nothing is sent
+        UploadQueue queue(queueDir_);
+        for (int i = 0; i < 3; ++i) {
+            lastId = queue.enqueue("idletime", makePayload(i));
+            EXPECT_NE(lastId, 0u);
+        }
+        queue.enqueue("screenshot", QJsonObject(), "capture.jpg");
+        EXPECT_EQ(queue.pendingCount(), 4);
+    }
+    EXPECT_EQ(jobFileCount(), 4);
+
+    UploadQueue reloaded(queueDir_);
+    ASSERT_EQ(reloaded.pendingCount(), 4);
+    EXPECT_EQ(reloaded.pendingCount("idletime"), 3);
+
+    const QList<UploadJob> jobs = reloaded.jobs();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(jobs[i].kind, "idletime");
+        EXPECT_EQ(jobs[i].payload["value"].toInt(), i) << "Jobs must reload in enqueue order";
+    }
+    EXPECT_EQ(jobs[3].filePath, "capture.jpg");
+    EXPECT_GT(reloaded.enqueue("idletime", makePayload(3)), lastId) << "IDs must not be reused";
+}
+
+TEST_F(UploadQueueTest, BatchesJobsWithinConcurrencyLimit) {
+    TimeTrackerTest::FakeHttpEndpoint endpoint;
+    UploadQueue queue(queueDir_);
+    for (int i = 0; i < 25; ++i) {
+        queue.enqueue("idletime", makePayload(i));
+    }
+
+    int maxInFlight = 0;
+    const UploadQueue::Sender send = jsonSender(endpoint.url());
+    queue.registerKind("idletime", [&](const QList<UploadJob>& jobs) {
+        maxInFlight = qMax(maxInFlight, queue.inFlightCount("idletime") + 1);
+        return send(jobs);
+    }, 1, 10);
+
+    ASSERT_TRUE(QTest::qWaitFor([&]() { return queue.pendingCount() == 0; }, 5000));
+    EXPECT_EQ(batchSizes(endpoint), (QList<int>{10, 10, 5}));
+    EXPECT_LE(maxInFlight, 1);
+    EXPECT_EQ(jobFileCount(), 0) << "Accepted jobs must be removed from disk";
+}
+
+TEST_F(UploadQueueTest, RetriesTransientFailuresWithBackoff) {
+    // Two outages, then the server accepts
+    TimeTrackerTest::FakeHttpEndpoint endpoint([](int request, const QByteArray&) { return request < 2 ? 503 : 200; });
+    UploadQueue queue(queueDir_);
+    queue.setBackoff(RetryBackoff(20, 80));
+    QSignalSpy finishedSpy(&queue, &UploadQueue::jobFinished);
+
+    queue.registerKind("idletime", jsonSender(endpoint.url()));
+    queue.enqueue("idletime", makePayload(1));
+
+    ASSERT_TRUE(QTest::qWaitFor([&]() { return queue.pendingCount() == 0; }, 5000));
+    ASSERT_EQ(finishedSpy.count(), 3);
+    EXPECT_EQ(finishedSpy.at(0).at(0).value<UploadJob>().attempts, 1);
+    EXPECT_FALSE(finishedSpy.at(0).at(1).toBool());
+    EXPECT_TRUE(finishedSpy.at(0).at(2).toBool());
+    EXPECT_EQ(finishedSpy.at(1).at(0).value<UploadJob>().attempts, 2);
+    EXPECT_TRUE(finishedSpy.at(2).at(1).toBool());
+    EXPECT_EQ(endpoint.receivedRequests(), 3);
+}
+
+TEST_F(UploadQueueTest, FailedJobKeepsAttemptsOnDisk) {
+    TimeTrackerTest::FakeHttpEndpoint endpoint([](int, const QByteArray&) { return 500; });
+    {
+        UploadQueue queue(queueDir_);
+        queue.setBackoff(RetryBackoff(60000, 60000));
+        QSignalSpy finishedSpy(&queue, &UploadQueue::jobFinished);
+        queue.registerKind("idletime", jsonSender(endpoint.url()));
+        queue.enqueue("idletime", makePayload(1));
+        ASSERT_TRUE(finishedSpy.wait(5000));
+    }
+
+    UploadQueue reloaded(queueDir_);
+    ASSERT_EQ(reloaded.pendingCount(), 1);
+    const UploadJob job = reloaded.jobs().first();
+    EXPECT_EQ(job.attempts, 1);
+    EXPECT_GT(job.nextAttemptMSecs, QDateTime::currentMSecsSinceEpoch() + 10000)
+        << "The backoff must survive a restart";
+}
+
+TEST_F(UploadQueueTest, RejectedBatchIsRetriedOneByOne) {
+    // The batch is rejected, then only the second job is
+    TimeTrackerTest::FakeHttpEndpoint endpoint([](int request, const QByteArray&) { return request == 0 || request == 2 ? 400 : 200; });
+    UploadQueue queue(queueDir_);
+    QSignalSpy finishedSpy(&queue, &UploadQueue::jobFinished);
+
+    for (int i = 0; i < 3; ++i) {
+        queue.enqueue("idletime", makePayload(i));
+    }
+    queue.registerKind("idletime", jsonSender(endpoint.url()), 1, 10);
+
+    ASSERT_TRUE(QTest::qWaitFor([&]() { return queue.pendingCount() == 0; }, 5000));
+    EXPECT_EQ(batchSizes(endpoint), (QList<int>{3, 1, 1, 1}));
+
+    int dropped = 0;
+    int accepted = 0;
+    for (const QList<QVariant>& arguments : finishedSpy) {
+        if (arguments.at(1).toBool()) {
+            ++accepted;
+        } else if (!arguments.at(2).toBool()) {
+            ++dropped;
+            EXPECT_EQ(arguments.at(0).value<UploadJob>().payload["value"].toInt(), 1);
+        }
+    }
+    EXPECT_EQ(accepted, 2);
+    EXPECT_EQ(dropped, 1);
+}
+
+TEST_F(UploadQueueTest, DropsJobsThatCannotBeSent) {
+    UploadQueue queue(queueDir_);
+    QSignalSpy finishedSpy(&queue, &UploadQueue::jobFinished);
+
+    queue.registerKind("screenshot", [](const QList<UploadJob>&) { return nullptr; });
+    queue.enqueue("screenshot", QJsonObject(), "missing.jpg");
+
+    ASSERT_TRUE(finishedSpy.wait(5000));
+    EXPECT_FALSE(finishedSpy.at(0).at(1).toBool());
+    EXPECT_FALSE(finishedSpy.at(0).at(2).toBool());
+    EXPECT_EQ(queue.pendingCount(), 0);
+    EXPECT_EQ(jobFileCount(), 0);
+}
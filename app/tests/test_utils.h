@@ -6,6 +6,12 @@
 #include <QTimer>
 #include <QEventLoop>
 #include <QTest>
+#include <QHash>
+#include <QList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUrl>
+#include <functional>
 #include <memory>
 
 /**
@@ -17,6 +23,7 @@
  * - Mock objects for Qt dependencies
  * - Helper functions for test data management
  * - Common test fixtures
+ * - A fake HTTP endpoint for upload tests
  */
 
 namespace TimeTrackerTest {
@@ -165,6 +172,77 @@ private:
     QString path_;
 };
 
+/**
+ * @brief Minimal HTTP endpoint on localhost for upload tests
+ *
+ * Answers every request with the status from the status callback, 200 by
+ * default, and the body from the body hook, "{}" by default. Both are
+ * called with the zero-based request number and the request body.
+ * Keep-alive connections and pipelined requests are handled.
+ */
+class FakeHttpEndpoint : public QObject
+{
+public:
+    using StatusCallback = std::function<int(int request, const QByteArray& body)>;
+    using BodyHook = std::function<QByteArray(int request, const QByteArray& body)>;
+
+    explicit FakeHttpEndpoint(StatusCallback statusForRequest = StatusCallback())
+        : m_statusForRequest(std::move(statusForRequest))
+    {
+        m_server.listen(QHostAddress::LocalHost);
+        QObject::connect(&m_server, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+                QObject::connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { handle(socket); });
+                QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+    }
+
+    void setStatusCallback(StatusCallback statusForRequest) { m_statusForRequest = std::move(statusForRequest); }
+    void setBodyHook(BodyHook bodyForRequest) { m_bodyForRequest = std::move(bodyForRequest); }
+
+    QUrl url(const QString& path = "/upload") const {
+        return QUrl(QString("http://127.0.0.1:%1%2").arg(m_server.serverPort()).arg(path));
+    }
+    int receivedRequests() const { return m_requestBodies.size(); }
+    QList<QByteArray> requestBodies() const { return m_requestBodies; }
+
+private:
+    void handle(QTcpSocket *socket) {
+        QByteArray& buffer = m_buffers[socket];
+        buffer += socket->readAll();
+
+        for (;;) {
+            const int headerEnd = buffer.indexOf("\r\n\r\n");
+            if (headerEnd < 0) return;
+            int contentLength = 0;
+            for (const QByteArray& line : buffer.left(headerEnd).split('\n')) {
+                if (line.toLower().startsWith("content-length:")) {
+                    contentLength = line.mid(15).trimmed().toInt();
+                }
+            }
+            if (buffer.size() < headerEnd + 4 + contentLength) return;
+
+            const QByteArray body = buffer.mid(headerEnd + 4, contentLength);
+            buffer.remove(0, headerEnd + 4 + contentLength);
+
+            const int request = m_requestBodies.size();
+            m_requestBodies.append(body);
+            const int status = m_statusForRequest ? m_statusForRequest(request, body) : 200;
+            const QByteArray responseBody = m_bodyForRequest ? m_bodyForRequest(request, body) : QByteArray("{}");
+            socket->write("HTTP/1.1 " + QByteArray::number(status) + " Status\r\n"
+                          "Content-Type: application/json\r\nContent-Length: "
+                          + QByteArray::number(responseBody.size()) + "\r\n\r\n" + responseBody);
+        }
+    }
+
+    QTcpServer m_server;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+    StatusCallback m_statusForRequest;
+    BodyHook m_bodyForRequest;
+    QList<QByteArray> m_requestBodies;
+};
+
 } // namespace TimeTrackerTest
 
 /**
@@ -0,0 +1,70 @@
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include "ActivityJournal.h"
+
+/**
+ * @file JournalDump.cpp
+ * @brief Debugging tool that prints an activity journal in the legacy text form
+ *
+ * Usage: TimeTrackerJournalDump [journal-file]
+ * journal-file is either a single segment file or a journal base path such
+ * as "activity_journal.ttj", in which case all of its segments are printed
+ * in order. Each record is printed as "YYYY-MM-DD HH:MM:SS - EVENT_TYPE - DETAILS",
+ * matching the old activity_log.txt lines.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList args = QCoreApplication::arguments();
+    QString path = args.size() > 1 ? args.at(1) : QString(ActivityJournal::DEFAULT_FILE_NAME);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QStringList files;
+    if (QFile::exists(path)) {
+        files << path;
+    } else {
+        for (quint32 sequence : ActivityJournal::segmentSequences(path)) {
+            files << ActivityJournal::segmentFilePath(path, sequence);
+        }
+    }
+    if (files.isEmpty()) {
+        err << "Cannot open activity journal: " << path << Qt::endl;
+        return 1;
+    }
+
+    int recordCount = 0;
+    qint64 byteCount = 0;
+    int corruptBlocks = 0;
+    for (const QString& file : files) {
+        ActivityJournalReader reader(file);
+        if (!reader.open()) {
+            err << "Cannot open activity journal: " << file << Qt::endl;
+            return 1;
+        }
+
+        QVector<ActivityJournalRecord> block;
+        while (reader.readNextBlock(block)) {
+            for (const ActivityJournalRecord& record : block) {
+                out << ActivityJournal::toTextLine(record) << '\n';
+            }
+            recordCount += block.size();
+            block.clear();
+        }
+        byteCount += reader.position();
+        corruptBlocks += reader.corruptBlockCount();
+    }
+    out.flush();
+
+    err << recordCount << " records, " << byteCount << " bytes in " << files.size() << " segment(s)";
+    if (corruptBlocks > 0) {
+        err << ", " << corruptBlocks << " corrupt blocks skipped";
+    }
+    err << Qt::endl;
+
+    return corruptBlocks > 0 ? 2 : 0;
+}
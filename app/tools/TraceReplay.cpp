@@ -0,0 +1,798 @@
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <QVariantMap>
+#include <limits>
+#include <windows.h>
+#include <Psapi.h>
+#include "ActivityAggregator.h"
+#include "ActivityClock.h"
+#include "ActivityEventBus.h"
+#include "ActivityJournal.h"
+#include "ActivityLogWriter.h"
+#include "ActivityTrace.h"
+#include "ApiService.h"
+#include "Metrics.h"
+#include "RuntimeConfig.h"
+#include "ScreenshotDeduplicator.h"
+#include "ScreenshotPipeline.h"
+#include "UploadQueue.h"
+
+/**
+ * @file TraceReplay.cpp
+ * @brief Load tool that replays a recorded activity trace through the client pipeline
+ *
+ * Usage: TimeTrackerTraceReplay trace-file [--speed 1x|max] [--config name:Key=Value,...]... [--json out-file]
+ *
+ * A trace is recorded by a client with Tracking/traceFile set. Every
+ * configuration replays the whole trace, in a scratch directory of its
+ * own, through the same components the client runs: the event bus, the
+ * journal writer, the minute aggregator, the screenshot deduplicator and
+ * ApiService with its upload queue. ApiService posts to a local mock
+ * backend that accepts everything and counts the bytes of each request
+ * and response per endpoint.
+ *
+ * Configurations are "Group/key" values as in timetracker.ini, e.g.
+ * "coarse:Tracking/moveCoalescingMSecs=5000,Upload/activity=summaries".
+ * Screenshots/duplicateThreshold sets the deduplicator's Hamming
+ * threshold, -1 to upload every capture. Without --config a default set
+ * is compared.
+ *
+ * Times are virtual: a record's place in the trace is added to the
+ * replay's start ticks. At 1x the replay waits for that time; at max it
+ * does not wait, and the journal and summary uploads follow the virtual
+ * clock instead of the wall clock. Screenshots are replayed from their
+ * recorded hashes and encoded sizes, so the deduplicator decides again
+ * with the configured threshold and the uploads carry filler of the
+ * recorded size.
+ *
+ * For each configuration the tool reports the input event throughput,
+ * the largest working set sampled and the bytes on the wire, on stdout
+ * and, with --json, as a JSON file.
+ */
+
+namespace {
+
+const char USER_ID[] = "replay@timetracker.local";
+const int PROCESS_EVENTS_EVERY = 256;        ///< Records fed between event loop passes at max speed
+const int MEMORY_SAMPLE_EVERY = 4096;        ///< Records fed between explicit memory samples
+const int MEMORY_SAMPLE_INTERVAL_MS = 50;    ///< Working set sampling period
+const int SUMMARY_FLUSH_INTERVAL_MS = 60 * 1000; ///< As in the client
+const int QUIET_PERIOD_MS = 1500;            ///< Backend silence that ends a replay
+const int DRAIN_TIMEOUT_MS = 2 * 60 * 1000;  ///< Longest wait for the uploads after the trace ends
+
+struct ReplayConfig {
+    QString name;
+    QVariantMap values;
+};
+
+struct EndpointTraffic {
+    qint64 requests = 0;
+    qint64 bytesUp = 0;    ///< Request line, headers and body as received
+    qint64 bytesDown = 0;  ///< Response as sent
+};
+
+/**
+ * Tracking data API stand-in; runs on its own thread so serving it does not slow the replay
+ *
+ * Every request gets 200 with an empty JSON object, which the uploaders take
+ * as full acknowledgement, and the Accept-Encoding header the real server sends.
+ */
+class MockBackend : public QObject
+{
+public:
+    MockBackend()
+    {
+        m_thread.setObjectName("MockBackend");
+        moveToThread(&m_thread);
+        m_thread.start();
+        QMetaObject::invokeMethod(this, [this]() { listen(); }, Qt::BlockingQueuedConnection);
+    }
+
+    ~MockBackend() override
+    {
+        QMetaObject::invokeMethod(this, [this]() {
+            m_buffers.clear();
+            delete m_server;
+            m_server = nullptr;
+        }, Qt::BlockingQueuedConnection);
+        m_thread.quit();
+        m_thread.wait();
+    }
+
+    bool isListening() const { return m_port != 0; }
+    QString baseUrl() const { return QString("http://127.0.0.1:%1/api/trackingdata").arg(m_port); }
+
+    void reset()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_traffic.clear();
+        m_lastActivityTicks = 0;
+    }
+
+    QMap<QString, EndpointTraffic> traffic() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_traffic;
+    }
+
+    qint64 lastActivityTicks() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_lastActivityTicks;
+    }
+
+private:
+    void listen()
+    {
+        m_server = new QTcpServer();
+        if (!m_server->listen(QHostAddress::LocalHost)) {
+            qWarning() << "Mock backend failed to listen:" << m_server->errorString();
+            return;
+        }
+        m_port = m_server->serverPort();
+        connect(m_server, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+                connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { handle(socket); });
+                connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+                    m_buffers.remove(socket);
+                    socket->deleteLater();
+                });
+            }
+        });
+    }
+
+    void handle(QTcpSocket *socket)
+    {
+        QByteArray& buffer = m_buffers[socket];
+        buffer += socket->readAll();
+        {
+            QMutexLocker locker(&m_mutex);
+            m_lastActivityTicks = ActivityClock::ticks();
+        }
+
+        for (;;) {
+            const int headerEnd = buffer.indexOf("\r\n\r\n");
+            if (headerEnd < 0) {
+                // Connection warm-ups speak TLS to this plain HTTP port; their bytes are not requests
+                if (buffer.size() > 64 * 1024) {
+                    buffer.clear();
+                }
+                return;
+            }
+
+            const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+            qint64 contentLength = 0;
+            for (const QByteArray& line : lines) {
+                if (line.toLower().startsWith("content-length:")) {
+                    contentLength = line.mid(15).trimmed().toLongLong();
+                }
+            }
+            const qint64 requestSize = headerEnd + 4 + contentLength;
+            if (buffer.size() < requestSize) {
+                return;
+            }
+
+            // "POST /api/trackingdata/activity/chunk HTTP/1.1"
+            const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+            static const QString prefix = "/api/trackingdata";
+            QString path = requestLine.size() > 1 ? QString::fromLatin1(requestLine.at(1)).section('?', 0, 0) : "?";
+            if (path.startsWith(prefix)) {
+                path = path.mid(prefix.size());
+            }
+            buffer.remove(0, requestSize);
+
+            static const QByteArray responseBody = "{}";
+            const QByteArray response = "HTTP/1.1 200 OK\r\n"
+                                        "Content-Type: application/json\r\n"
+                                        "Accept-Encoding: gzip, br, deflate\r\n"
+                                        "Content-Length: " + QByteArray::number(responseBody.size()) + "\r\n"
+                                        "\r\n" + responseBody;
+            socket->write(response);
+
+            QMutexLocker locker(&m_mutex);
+            EndpointTraffic& traffic = m_traffic[path];
+            ++traffic.requests;
+            traffic.bytesUp += requestSize;
+            traffic.bytesDown += response.size();
+        }
+    }
+
+    QThread m_thread;
+    QTcpServer *m_server = nullptr;
+    quint16 m_port = 0;
+    QHash<QTcpSocket*, QByteArray> m_buffers;   ///< Backend thread only
+
+    mutable QMutex m_mutex;                     ///< Protects the members below
+    QMap<QString, EndpointTraffic> m_traffic;
+    qint64 m_lastActivityTicks = 0;
+};
+
+struct ReplayResult {
+    QString name;
+    bool ok = false;
+    quint64 records = 0;
+    quint64 inputEvents = 0;
+    quint64 foregroundChanges = 0;
+    quint64 screenshotsChecked = 0;
+    quint64 screenshotsSkipped = 0;
+    quint64 screenshotsUploaded = 0;
+    quint64 summaries = 0;
+    quint64 journalEvents = 0;
+    quint64 writerDrops = 0;
+    quint64 busStalls = 0;        ///< Times the replay waited for room in the bus ring buffer
+    qint64 traceMSecs = 0;        ///< Virtual time covered
+    qint64 feedMSecs = 0;         ///< Wall time to feed the trace
+    qint64 totalMSecs = 0;        ///< Wall time including the final uploads
+    qint64 baselineWorkingSet = 0;
+    qint64 peakWorkingSet = 0;
+    QMap<QString, EndpointTraffic> traffic;
+    Metrics::Snapshot metrics;
+
+    double eventsPerSecond() const
+    {
+        return feedMSecs > 0 ? inputEvents * 1000.0 / feedMSecs : 0.0;
+    }
+
+    EndpointTraffic totalTraffic() const
+    {
+        EndpointTraffic total;
+        for (const EndpointTraffic& endpoint : traffic) {
+            total.requests += endpoint.requests;
+            total.bytesUp += endpoint.bytesUp;
+            total.bytesDown += endpoint.bytesDown;
+        }
+        return total;
+    }
+
+    QJsonObject toJson() const
+    {
+        QJsonObject endpoints;
+        for (auto it = traffic.constBegin(); it != traffic.constEnd(); ++it) {
+            QJsonObject endpoint;
+            endpoint["requests"] = it->requests;
+            endpoint["bytesUp"] = it->bytesUp;
+            endpoint["bytesDown"] = it->bytesDown;
+            endpoints[it.key()] = endpoint;
+        }
+        const EndpointTraffic total = totalTraffic();
+
+        QJsonObject object;
+        object["name"] = name;
+        object["completed"] = ok;
+        object["records"] = static_cast<qint64>(records);
+        object["inputEvents"] = static_cast<qint64>(inputEvents);
+        object["foregroundChanges"] = static_cast<qint64>(foregroundChanges);
+        object["screenshotsChecked"] = static_cast<qint64>(screenshotsChecked);
+        object["screenshotsSkipped"] = static_cast<qint64>(screenshotsSkipped);
+        object["screenshotsUploaded"] = static_cast<qint64>(screenshotsUploaded);
+        object["summaries"] = static_cast<qint64>(summaries);
+        object["journalEvents"] = static_cast<qint64>(journalEvents);
+        object["writerDrops"] = static_cast<qint64>(writerDrops);
+        object["busStalls"] = static_cast<qint64>(busStalls);
+        object["traceMs"] = traceMSecs;
+        object["feedMs"] = feedMSecs;
+        object["totalMs"] = totalMSecs;
+        object["eventsPerSecond"] = eventsPerSecond();
+        object["baselineWorkingSetBytes"] = baselineWorkingSet;
+        object["peakWorkingSetBytes"] = peakWorkingSet;
+        object["requests"] = total.requests;
+        object["bytesUp"] = total.bytesUp;
+        object["bytesDown"] = total.bytesDown;
+        object["endpoints"] = endpoints;
+        object["metrics"] = metrics.toJson();
+        return object;
+    }
+};
+
+qint64 workingSetBytes()
+{
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return static_cast<qint64>(counters.WorkingSetSize);
+}
+
+qint64 microsToTicks(qint64 micros)
+{
+    const qint64 frequency = ActivityClock::frequency();
+    return micros / 1000000 * frequency + micros % 1000000 * frequency / 1000000;
+}
+
+ApiService::ActivityUploadPolicy uploadPolicy(const QString& activityUpload)
+{
+    if (activityUpload == "raw") {
+        return ApiService::ActivityUploadPolicy::RawEvents;
+    }
+    if (activityUpload == "summaries") {
+        return ApiService::ActivityUploadPolicy::Summaries;
+    }
+    return ApiService::ActivityUploadPolicy::RawEventsAndSummaries;
+}
+
+/**
+ * One configuration's run over the trace
+ */
+class Replay
+{
+public:
+    Replay(const QString& tracePath, const ReplayConfig& config, bool realTime, MockBackend& backend)
+        : m_tracePath(tracePath)
+        , m_config(config)
+        , m_realTime(realTime)
+        , m_backend(backend)
+    {
+        m_result.name = config.name;
+    }
+
+    ReplayResult run()
+    {
+        QTemporaryDir scratch;
+        if (!scratch.isValid()) {
+            qWarning() << "Cannot create a scratch directory for" << m_config.name;
+            return m_result;
+        }
+
+        // The journal, its upload cursor and the upload queue all live in the working directory
+        const QString previousDirectory = QDir::currentPath();
+        QDir::setCurrent(scratch.path());
+        m_backend.reset();
+        Metrics::reset();
+        runInScratchDirectory();
+        QDir::setCurrent(previousDirectory);
+        return m_result;
+    }
+
+private:
+    void runInScratchDirectory()
+    {
+        const RuntimeSettings settings = RuntimeSettings::fromValues(m_config.values);
+        m_result.baselineWorkingSet = workingSetBytes();
+        m_result.peakWorkingSet = m_result.baselineWorkingSet;
+
+        ActivityTraceReader reader(m_tracePath);
+        if (!reader.open()) {
+            return;
+        }
+
+        ActivityLogWriter writer(ActivityJournal::DEFAULT_FILE_NAME);
+        writer.setMoveCoalescingIntervalMSecs(settings.moveCoalescingMSecs);
+        writer.start();
+
+        ActivityAggregator aggregator;
+        aggregator.setIdleThresholdSeconds(settings.idleThresholdSecs);
+
+        // Consumers as wired in TimeTrackerMainWindow::setupActivityLogging()
+        ActivityEventBus bus;
+        bus.subscribe("journal", ActivityEventBus::INPUT_EVENTS, [&writer](const QVector<ActivityEvent>& events) {
+            for (const ActivityEvent& event : events) {
+                writer.pushEvent(event);
+            }
+        });
+        bus.subscribe("summary",
+                      ActivityEventBus::INPUT_EVENTS
+                          | ActivityEventBus::typeBit(ActivityEventType::IdleStarted)
+                          | ActivityEventBus::typeBit(ActivityEventType::IdleEnded),
+                      [&aggregator](const QVector<ActivityEvent>& events) { aggregator.addEvents(events); });
+        bus.start();
+
+        // Uploads follow the trace's clock, so the service's own timer stays out of the way
+        ApiService api;
+        api.setBaseUrl(m_backend.baseUrl());
+        api.setActivityUploadIntervalMSecs(std::numeric_limits<int>::max());
+        api.setActivityUploadPolicy(uploadPolicy(settings.activityUpload));
+        m_api = &api;
+
+        m_deduplicator.setHammingThreshold(
+            m_config.values.value("Screenshots/duplicateThreshold", ScreenshotDeduplicator::DEFAULT_HAMMING_THRESHOLD)
+                .toInt());
+
+        QTimer sampler;
+        sampler.setInterval(MEMORY_SAMPLE_INTERVAL_MS);
+        QObject::connect(&sampler, &QTimer::timeout, [this]() { sampleMemory(); });
+        sampler.start();
+
+        const qint64 uploadIntervalMicros = static_cast<qint64>(settings.uploadIntervalSecs) * 1000000;
+        const qint64 summaryIntervalMicros = static_cast<qint64>(SUMMARY_FLUSH_INTERVAL_MS) * 1000;
+        qint64 nextUploadMicros = uploadIntervalMicros;
+        qint64 nextSummaryMicros = summaryIntervalMicros;
+        qint64 lastOffsetMicros = 0;
+
+        m_startTicks = ActivityClock::ticks();
+        QElapsedTimer wallClock;
+        wallClock.start();
+
+        ActivityTraceRecord record;
+        while (reader.readNext(record)) {
+            const qint64 ticks = m_startTicks + microsToTicks(record.offsetMicros);
+            ++m_result.records;
+            if (m_realTime) {
+                waitUntil(ticks);
+            } else if (m_result.records % PROCESS_EVENTS_EVERY == 0) {
+                QCoreApplication::processEvents();
+            }
+            if (m_result.records % MEMORY_SAMPLE_EVERY == 0) {
+                sampleMemory();
+            }
+
+            // Bus batches were written after later records, so only time that moved forward schedules uploads
+            lastOffsetMicros = qMax(lastOffsetMicros, record.offsetMicros);
+            while (lastOffsetMicros >= nextSummaryMicros) {
+                uploadSummaries(aggregator, m_startTicks + microsToTicks(nextSummaryMicros));
+                nextSummaryMicros += summaryIntervalMicros;
+            }
+            while (lastOffsetMicros >= nextUploadMicros) {
+                api.uploadActivityLogs();
+                nextUploadMicros += uploadIntervalMicros;
+            }
+
+            if (record.kind != ActivityTraceRecord::Kind::ScreenshotEncoded) {
+                uploadScreenshotBatch();
+            }
+
+            switch (record.kind) {
+                case ActivityTraceRecord::Kind::Event:
+                    publish(bus, record, ticks);
+                    break;
+                case ActivityTraceRecord::Kind::Foreground: {
+                    const qint64 timestampMSecs = ActivityClock::toMSecsSinceEpoch(ticks);
+                    writer.logActiveApplication(record.processName, record.windowTitle, timestampMSecs);
+                    aggregator.setForegroundApplication(record.processName, record.windowTitle, timestampMSecs);
+                    ++m_result.foregroundChanges;
+                    break;
+                }
+                case ActivityTraceRecord::Kind::Screenshot:
+                    checkScreenshot(record);
+                    break;
+                case ActivityTraceRecord::Kind::ScreenshotEncoded:
+                    screenshotEncoded(record);
+                    break;
+            }
+        }
+
+        // Captures the recording client never encoded still go up at their last known size
+        for (auto it = m_screens.begin(); it != m_screens.end(); ++it) {
+            if (it->pendingUpload) {
+                queueLastKnownUpload(it.key());
+            }
+        }
+        uploadScreenshotBatch();
+        m_result.feedMSecs = wallClock.elapsed();
+        m_result.traceMSecs = lastOffsetMicros / 1000;
+
+        // Final flush, as on shutdown: everything recorded reaches the journal and the backend
+        bus.stop();
+        writer.stop();
+        uploadSummaries(aggregator, m_startTicks + microsToTicks(lastOffsetMicros) + ActivityClock::msecsToTicks(
+                                        ActivityAggregator::MINUTE_MS));
+        api.uploadActivityLogs();
+        m_result.ok = waitForUploads(api);
+        sampleMemory();
+        sampler.stop();
+
+        m_result.totalMSecs = wallClock.elapsed();
+        m_result.screenshotsChecked = m_deduplicator.checkedCount();
+        m_result.screenshotsSkipped = m_deduplicator.skippedCount();
+        m_result.journalEvents = writer.writtenEventCount();
+        m_result.writerDrops = writer.droppedEventCount();
+        m_result.traffic = m_backend.traffic();
+        m_result.metrics = Metrics::snapshot();
+        m_api = nullptr;
+    }
+
+    void publish(ActivityEventBus& bus, const ActivityTraceRecord& record, qint64 ticks)
+    {
+        ActivityEvent event{};
+        event.ticks = ticks;
+        event.type = record.eventType;
+        event.x = record.x;
+        event.y = record.y;
+
+        // The hooks drop on a full ring; the replay waits, so every configuration sees the whole trace
+        while (!bus.publish(event)) {
+            ++m_result.busStalls;
+            QCoreApplication::processEvents();
+            QThread::usleep(500);
+        }
+        if (record.eventType <= ActivityEventType::MouseOther) {
+            ++m_result.inputEvents;
+        }
+    }
+
+    void checkScreenshot(const ActivityTraceRecord& record)
+    {
+        ScreenState& screen = m_screens[record.screenIndex];
+        if (screen.pendingUpload) {
+            // The recording client skipped the previous capture; this configuration did not
+            queueLastKnownUpload(record.screenIndex);
+            uploadScreenshotBatch();
+        }
+        if (record.unchanged) {
+            // Reported unchanged by Desktop Duplication before any hashing, whatever the threshold
+            return;
+        }
+
+        screen.size = record.size;
+        screen.pendingUpload = !m_deduplicator.isDuplicateHash(record.screenIndex, record.hash);
+    }
+
+    void screenshotEncoded(const ActivityTraceRecord& record)
+    {
+        ScreenState& screen = m_screens[record.screenIndex];
+        if (record.encodedBytes > 0) {
+            screen.lastEncodedBytes = record.encodedBytes;
+            m_deduplicator.recordEncodedBytes(record.screenIndex, record.encodedBytes);
+        }
+        if (!screen.pendingUpload) {
+            return;
+        }
+        screen.pendingUpload = false;
+        if (record.encodedBytes > 0) {
+            // Consecutive encoded records are the screens of one capture, sent in one request
+            m_screenshotBatch.append(screenshotResult(record.screenIndex, record.encodedBytes));
+        }
+    }
+
+    void queueLastKnownUpload(int screenIndex)
+    {
+        ScreenState& screen = m_screens[screenIndex];
+        screen.pendingUpload = false;
+        if (screen.lastEncodedBytes > 0) {
+            m_screenshotBatch.append(screenshotResult(screenIndex, screen.lastEncodedBytes));
+        }
+    }
+
+    ScreenshotResult screenshotResult(int screenIndex, qint64 bytes) const
+    {
+        const ScreenState& screen = m_screens.value(screenIndex);
+        ScreenshotResult result;
+        result.filePath = QString("replay_screen%1_%2.jpg").arg(screenIndex).arg(m_result.records);
+        result.screen.index = screenIndex;
+        result.screen.name = QString("SCREEN%1").arg(screenIndex);
+        result.screen.geometry = QRect(QPoint(0, 0), screen.size);
+        result.delta.frameSize = screen.size;
+        result.success = true;
+        result.data = QByteArray(static_cast<qsizetype>(bytes), 'x');
+        result.mimeType = "image/jpeg";
+        result.size = screen.size;
+        result.bytes = bytes;
+        return result;
+    }
+
+    void uploadScreenshotBatch()
+    {
+        if (m_screenshotBatch.isEmpty()) {
+            return;
+        }
+        m_result.screenshotsUploaded += m_screenshotBatch.size();
+        m_api->uploadScreenshots(m_screenshotBatch, USER_ID, m_config.name);
+        m_screenshotBatch.clear();
+    }
+
+    void uploadSummaries(ActivityAggregator& aggregator, qint64 ticks)
+    {
+        const QVector<ActivityMinuteSummary> summaries = aggregator.takeCompleted(
+            ActivityClock::toMSecsSinceEpoch(ticks));
+        m_result.summaries += summaries.size();
+        m_api->uploadActivitySummaries(summaries, USER_ID, m_config.name);
+    }
+
+    void waitUntil(qint64 ticks)
+    {
+        for (;;) {
+            QCoreApplication::processEvents();
+            const qint64 remainingMSecs = ActivityClock::ticksToMSecs(ticks - ActivityClock::ticks());
+            if (remainingMSecs <= 0) {
+                return;
+            }
+            QThread::msleep(static_cast<unsigned long>(qMin<qint64>(remainingMSecs, 5)));
+        }
+    }
+
+    bool waitForUploads(ApiService& api)
+    {
+        const qint64 drainStartTicks = ActivityClock::ticks();
+        QElapsedTimer timeout;
+        timeout.start();
+        while (timeout.elapsed() < DRAIN_TIMEOUT_MS) {
+            QCoreApplication::processEvents();
+            const qint64 lastActivity = qMax(drainStartTicks, m_backend.lastActivityTicks());
+            if (api.uploadQueue()->pendingCount() == 0
+                && ActivityClock::ticksToMSecs(ActivityClock::ticks() - lastActivity) >= QUIET_PERIOD_MS) {
+                return true;
+            }
+            QThread::msleep(5);
+        }
+        qWarning() << "Uploads of" << m_config.name << "still pending after" << DRAIN_TIMEOUT_MS / 1000 << "s";
+        return false;
+    }
+
+    void sampleMemory()
+    {
+        m_result.peakWorkingSet = qMax(m_result.peakWorkingSet, workingSetBytes());
+    }
+
+    struct ScreenState {
+        QSize size;
+        qint64 lastEncodedBytes = 0;
+        bool pendingUpload = false;   ///< Not a duplicate here; waits for the recorded encoded size
+    };
+
+    QString m_tracePath;
+    ReplayConfig m_config;
+    bool m_realTime;
+    MockBackend& m_backend;
+    ReplayResult m_result;
+    ApiService *m_api = nullptr;
+    ScreenshotDeduplicator m_deduplicator;
+    QHash<int, ScreenState> m_screens;
+    QVector<ScreenshotResult> m_screenshotBatch;
+    qint64 m_startTicks = 0;
+};
+
+bool parseConfig(const QString& argument, ReplayConfig& config)
+{
+    const int colon = argument.indexOf(':');
+    config.name = colon >= 0 ? argument.left(colon).trimmed() : argument.trimmed();
+    if (config.name.isEmpty()) {
+        return false;
+    }
+    if (colon < 0) {
+        return true;
+    }
+    for (const QString& pair : argument.mid(colon + 1).split(',', Qt::SkipEmptyParts)) {
+        const int equals = pair.indexOf('=');
+        if (equals <= 0) {
+            return false;
+        }
+        config.values.insert(pair.left(equals).trimmed(), pair.mid(equals + 1).trimmed());
+    }
+    return true;
+}
+
+QVector<ReplayConfig> defaultConfigs()
+{
+    return {
+        {"default", {}},
+        {"no-coalescing", {{"Tracking/moveCoalescingMSecs", 0}}},
+        {"summaries-only", {{"Upload/activity", "summaries"}}},
+        {"no-dedup", {{"Screenshots/duplicateThreshold", -1}}},
+    };
+}
+
+QString kilobytes(qint64 bytes)
+{
+    return QString::number(bytes / 1024.0, 'f', 1);
+}
+
+void printResult(QTextStream& out, const ReplayResult& result)
+{
+    const EndpointTraffic total = result.totalTraffic();
+    out << result.name << (result.ok ? "" : " (uploads incomplete)") << '\n'
+        << "  " << result.inputEvents << " input events in " << result.feedMSecs << " ms: "
+        << QString::number(result.eventsPerSecond(), 'f', 0) << " events/s, "
+        << result.totalMSecs << " ms with final uploads\n"
+        << "  peak working set " << kilobytes(result.peakWorkingSet) << " KB ("
+        << kilobytes(result.peakWorkingSet - result.baselineWorkingSet) << " KB above start)\n"
+        << "  journal " << result.journalEvents << " events, " << result.writerDrops << " dropped; "
+        << result.busStalls << " bus stalls\n"
+        << "  screenshots " << result.screenshotsUploaded << " sent, " << result.screenshotsSkipped << " of "
+        << result.screenshotsChecked << " skipped as duplicates; " << result.summaries << " minute summaries\n"
+        << "  wire: " << total.requests << " requests, " << kilobytes(total.bytesUp) << " KB up, "
+        << kilobytes(total.bytesDown) << " KB down\n";
+    for (auto it = result.traffic.constBegin(); it != result.traffic.constEnd(); ++it) {
+        out << "    " << it.key() << ": " << it->requests << " requests, " << kilobytes(it->bytesUp) << " KB up, "
+            << kilobytes(it->bytesDown) << " KB down\n";
+    }
+    out.flush();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QStringList args = QCoreApplication::arguments();
+    QString tracePath;
+    QString jsonPath;
+    bool realTime = false;
+    QVector<ReplayConfig> configs;
+    for (int i = 1; i < args.size(); ++i) {
+        const QString& arg = args.at(i);
+        if (arg == "--speed" && i + 1 < args.size()) {
+            const QString speed = args.at(++i).toLower();
+            if (speed != "1x" && speed != "max") {
+                err << "Unknown speed " << speed << ", expected 1x or max" << Qt::endl;
+                return 1;
+            }
+            realTime = speed == "1x";
+        } else if (arg == "--config" && i + 1 < args.size()) {
+            ReplayConfig config;
+            if (!parseConfig(args.at(++i), config)) {
+                err << "Invalid configuration " << args.at(i) << ", expected name:Group/key=value,..." << Qt::endl;
+                return 1;
+            }
+            configs.append(config);
+        } else if (arg == "--json" && i + 1 < args.size()) {
+            jsonPath = QFileInfo(args.at(++i)).absoluteFilePath();
+        } else if (tracePath.isEmpty() && !arg.startsWith("--")) {
+            tracePath = QFileInfo(arg).absoluteFilePath();
+        } else {
+            err << "Usage: TimeTrackerTraceReplay trace-file [--speed 1x|max] "
+                   "[--config name:Group/key=value,...]... [--json out-file]" << Qt::endl;
+            return 1;
+        }
+    }
+    if (tracePath.isEmpty()) {
+        err << "Usage: TimeTrackerTraceReplay trace-file [--speed 1x|max] "
+               "[--config name:Group/key=value,...]... [--json out-file]" << Qt::endl;
+        return 1;
+    }
+    if (configs.isEmpty()) {
+        configs = defaultConfigs();
+    }
+
+    ActivityTraceReader probe(tracePath);
+    if (!probe.open()) {
+        err << "Cannot open activity trace: " << tracePath << Qt::endl;
+        return 1;
+    }
+
+    MockBackend backend;
+    if (!backend.isListening()) {
+        err << "Cannot start the mock backend" << Qt::endl;
+        return 1;
+    }
+
+    out << "Replaying " << tracePath << " at " << (realTime ? "1x" : "max") << " speed, trace recorded "
+        << QDateTime::fromMSecsSinceEpoch(probe.startMSecs()).toString(Qt::ISODate) << '\n';
+    out.flush();
+
+    QJsonArray results;
+    bool allCompleted = true;
+    for (const ReplayConfig& config : configs) {
+        const ReplayResult result = Replay(tracePath, config, realTime, backend).run();
+        printResult(out, result);
+        results.append(result.toJson());
+        allCompleted = allCompleted && result.ok;
+    }
+
+    if (!jsonPath.isEmpty()) {
+        QJsonObject report;
+        report["trace"] = tracePath;
+        report["traceStart"] = QDateTime::fromMSecsSinceEpoch(probe.startMSecs()).toUTC().toString(Qt::ISODate);
+        report["speed"] = realTime ? "1x" : "max";
+        report["configurations"] = results;
+
+        QFile file(jsonPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "Cannot write " << jsonPath << ": " << file.errorString() << Qt::endl;
+            return 1;
+        }
+        file.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+        out << "Report written to " << jsonPath << '\n';
+    }
+
+    return allCompleted ? 0 : 2;
+}
@@ -0,0 +1,233 @@
+using Microsoft.EntityFrameworkCore;
+using Microsoft.Extensions.DependencyInjection;
+using System.Net;
+using System.Net.Http.Json;
+using System.Text;
+using TimeTracker.API.Controllers;
+using TimeTracker.API.Data;
+
+namespace TimeTracker.API.Tests.Controllers
+{
+    public class ActivityChunkControllerTests : IClassFixture<InMemoryApiFactory>
+    {
+        private readonly InMemoryApiFactory _factory;
+        private readonly HttpClient _client;
+
+        public ActivityChunkControllerTests(InMemoryApiFactory factory)
+        {
+            // On the in-memory database activity batches take the ingestor's AddRange path
+            _factory = factory;
+            _client = _factory.CreateClient();
+        }
+
+        [Fact]
+        public async Task UploadActivityChunk_ShouldResolveStringIds()
+        {
+            // Arrange - timestamps as the client writes them
+            var chunk = new
+            {
+                UserId = "chunk-strings@test.com",
+                SessionId = "session1",
+                Strings = new Dictionary<string, string> { ["1"] = "chrome.exe", ["2"] = "Inbox - Mail" },
+                Entries = new object[]
+                {
+                    new { Timestamp = "2026-03-02T09:00:00.000Z", EventType = "APP_CHANGE", Process = 1, Title = 2 },
+                    new { Timestamp = "2026-03-02T09:00:01.000Z", EventType = "KEY_PRESS", Details = "count=12" }
+                }
+            };
+
+            // Act
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/activity/chunk", chunk);
+
+            // Assert
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+            var body = await response.Content.ReadFromJsonAsync<ActivityChunkResponseDto>();
+            Assert.NotNull(body);
+            Assert.Equal(2, body.Count);
+            Assert.Null(body.Acknowledged);
+
+            using var scope = _factory.Services.CreateScope();
+            var context = scope.ServiceProvider.GetRequiredService<TimeTrackerDbContext>();
+            var saved = await context.ActivityLogs
+                .Where(x => x.UserId == "chunk-strings@test.com")
+                .OrderBy(x => x.Timestamp)
+                .ToListAsync();
+
+            Assert.Equal(2, saved.Count);
+            Assert.Equal("PROCESS: chrome.exe - TITLE: Inbox - Mail", saved[0].Details);
+            Assert.Equal("count=12", saved[1].Details);
+            Assert.All(saved, log => Assert.Equal("session1", log.SessionId));
+        }
+
+        [Fact]
+        public async Task UploadActivityChunk_ShouldAcceptClientWireFormat()
+        {
+            // Arrange - the body exactly as ActivityUploader::chunkBody and toJson emit it
+            const string body =
+                "{\"endOffset\":8208,\"segment\":1,\"sessionId\":\"1\",\"startOffset\":16," +
+                "\"strings\":{\"3\":\"code.exe\",\"4\":\"main.cpp - timetracker\"},\"userId\":\"chunk-wire@test.com\"," +
+                "\"entries\":[{\"details\":\"VK Code: 65\",\"eventType\":\"KEY_DOWN\",\"timestamp\":\"2025-06-15T15:06:40.123Z\"}," +
+                "{\"eventType\":\"ACTIVE_APP\",\"process\":3,\"timestamp\":\"2025-06-15T15:06:41.000Z\",\"title\":4}]}";
+
+            // Act
+            var response = await _client.PostAsync("/api/trackingdata/activity/chunk",
+                new StringContent(body, Encoding.UTF8, "application/json"));
+
+            // Assert
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+
+            using var scope = _factory.Services.CreateScope();
+            var context = scope.ServiceProvider.GetRequiredService<TimeTrackerDbContext>();
+            var saved = await context.ActivityLogs
+                .Where(x => x.UserId == "chunk-wire@test.com")
+                .OrderBy(x => x.Timestamp)
+                .ToListAsync();
+
+            Assert.Equal(2, saved.Count);
+            Assert.Equal(new DateTime(2025, 6, 15, 15, 6, 40, 123, DateTimeKind.Utc), saved[0].Timestamp);
+            Assert.Equal(DateTimeKind.Utc, saved[0].Timestamp.Kind);
+            Assert.Equal("PROCESS: code.exe - TITLE: main.cpp - timetracker", saved[1].Details);
+        }
+
+        [Fact]
+        public async Task UploadActivityChunk_ShouldEchoJournalRange()
+        {
+            // Arrange
+            var chunk = new
+            {
+                UserId = "chunk-range@test.com",
+                SessionId = "session2",
+                Segment = 4u,
+                StartOffset = 16L,
+                EndOffset = 8208L,
+                Entries = new object[]
+                {
+                    new { Timestamp = "2026-03-02T09:05:00.250Z", EventType = "MOUSE_CLICK", Details = "left" }
+                }
+            };
+
+            // Act
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/activity/chunk", chunk);
+
+            // Assert
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+            var body = await response.Content.ReadFromJsonAsync<ActivityChunkResponseDto>();
+            Assert.NotNull(body);
+            Assert.NotNull(body.Acknowledged);
+            Assert.Equal(4u, body.Acknowledged.Segment);
+            Assert.Equal(16L, body.Acknowledged.StartOffset);
+            Assert.Equal(8208L, body.Acknowledged.EndOffset);
+        }
+
+        [Theory]
+        [InlineData("2026-03-02 09:20:00")]
+        [InlineData("2026-03-02T09:20:00.000")]
+        public async Task UploadActivityChunk_ShouldReturnBadRequest_WhenTimestampHasNoZone(string timestamp)
+        {
+            // Arrange - local time without a zone cannot be placed on the UTC timeline
+            var chunk = new
+            {
+                UserId = "chunk-zoneless@test.com",
+                SessionId = "session5",
+                Entries = new object[]
+                {
+                    new { Timestamp = "2026-03-02T09:19:59.000Z", EventType = "KEY_DOWN", Details = "VK Code: 65" },
+                    new { Timestamp = timestamp, EventType = "KEY_DOWN", Details = "VK Code: 66" }
+                }
+            };
+
+            // Act
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/activity/chunk", chunk);
+
+            // Assert
+            Assert.Equal(HttpStatusCode.BadRequest, response.StatusCode);
+
+            using var scope = _factory.Services.CreateScope();
+            var context = scope.ServiceProvider.GetRequiredService<TimeTrackerDbContext>();
+            Assert.False(await context.ActivityLogs.AnyAsync(x => x.UserId == "chunk-zoneless@test.com"));
+        }
+
+        [Fact]
+        public async Task UploadActivityChunk_ShouldStoreOffsetTimestampsAsUtc()
+        {
+            // Arrange
+            var chunk = new
+            {
+                UserId = "chunk-offset@test.com",
+                SessionId = "session6",
+                Entries = new object[]
+                {
+                    new { Timestamp = "2026-03-02T11:30:00.000+02:00", EventType = "KEY_DOWN", Details = "VK Code: 65" }
+                }
+            };
+
+            // Act
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/activity/chunk", chunk);
+
+            // Assert
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+
+            using var scope = _factory.Services.CreateScope();
+            var context = scope.ServiceProvider.GetRequiredService<TimeTrackerDbContext>();
+            var saved = await context.ActivityLogs.SingleAsync(x => x.UserId == "chunk-offset@test.com");
+            Assert.Equal(new DateTime(2026, 3, 2, 9, 30, 0, DateTimeKind.Utc), saved.Timestamp);
+            Assert.Equal(DateTimeKind.Utc, saved.Timestamp.Kind);
+        }
+
+        [Fact]
+        public async Task UploadActivityChunk_ShouldReturnBadRequest_WhenStringIdIsUnknown()
+        {
+            // Arrange - the title id is missing from the string table
+            var chunk = new
+            {
+                UserId = "chunk-unknown@test.com",
+                SessionId = "session3",
+                Strings = new Dictionary<string, string> { ["1"] = "code.exe" },
+                EndOffset = 512L,
+                Entries = new object[]
+                {
+                    new { Timestamp = "2026-03-02T09:10:00.000Z", EventType = "KEY_PRESS", Details = "count=3" },
+                    new { Timestamp = "2026-03-02T09:10:01.000Z", EventType = "APP_CHANGE", Process = 1, Title = 9 }
+                }
+            };
+
+            // Act
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/activity/chunk", chunk);
+
+            // Assert - nothing of the chunk is stored, so the client resends all of it
+            Assert.Equal(HttpStatusCode.BadRequest, response.StatusCode);
+
+            using var scope = _factory.Services.CreateScope();
+            var context = scope.ServiceProvider.GetRequiredService<TimeTrackerDbContext>();
+            Assert.False(await context.ActivityLogs.AnyAsync(x => x.UserId == "chunk-unknown@test.com"));
+        }
+
+        [Fact]
+        public async Task UploadActivityChunk_ShouldTruncateOverlongValues()
+        {
+            // Arrange
+            var chunk = new
+            {
+                UserId = "chunk-long@test.com",
+                SessionId = "session4",
+                Strings = new Dictionary<string, string> { ["1"] = "winword.exe", ["2"] = new string('x', 2000) },
+                Entries = new object[]
+                {
+                    new { Timestamp = "2026-03-02T09:15:00.000Z", EventType = "APP_CHANGE", Process = 1, Title = 2 }
+                }
+            };
+
+            // Act
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/activity/chunk", chunk);
+
+            // Assert
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+
+            using var scope = _factory.Services.CreateScope();
+            var context = scope.ServiceProvider.GetRequiredService<TimeTrackerDbContext>();
+            var saved = await context.ActivityLogs.SingleAsync(x => x.UserId == "chunk-long@test.com");
+            Assert.Equal(1000, saved.Details.Length);
+            Assert.StartsWith("PROCESS: winword.exe - TITLE: xxx", saved.Details);
+        }
+    }
+}
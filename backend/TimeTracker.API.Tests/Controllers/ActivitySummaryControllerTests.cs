@@ -0,0 +1,112 @@
+using System.Net;
+using System.Net.Http.Json;
+using TimeTracker.API.Controllers;
+
+namespace TimeTracker.API.Tests.Controllers
+{
+    public class ActivitySummaryControllerTests : IClassFixture<InMemoryApiFactory>
+    {
+        private readonly HttpClient _client;
+
+        public ActivitySummaryControllerTests(InMemoryApiFactory factory)
+        {
+            _client = factory.CreateClient();
+        }
+
+        private static readonly DateTime Minute = new(2026, 3, 2, 9, 15, 0, DateTimeKind.Utc);
+
+        private static object Summary(string userId, DateTime minuteStart, int keyCount, int activeSeconds = 40, int idleSeconds = 20) =>
+            new
+            {
+                MinuteStart = minuteStart,
+                KeyCount = keyCount,
+                ClickCount = 2,
+                MouseDistance = 1500L,
+                ActiveSeconds = activeSeconds,
+                IdleSeconds = idleSeconds,
+                ProcessName = "code.exe",
+                WindowTitle = "main.cpp",
+                UserId = userId,
+                SessionId = "session1"
+            };
+
+        private async Task<List<ActivitySummaryDto>> GetSummaries(string userId)
+        {
+            var from = Uri.EscapeDataString(Minute.AddHours(-1).ToString("o"));
+            var to = Uri.EscapeDataString(Minute.AddHours(1).ToString("o"));
+            var response = await _client.GetAsync($"/api/trackingdata/activity/summary?userId={Uri.EscapeDataString(userId)}&from={from}&to={to}");
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+            return await response.Content.ReadFromJsonAsync<List<ActivitySummaryDto>>() ?? new List<ActivitySummaryDto>();
+        }
+
+        [Fact]
+        public async Task UploadActivitySummaries_ShouldReplaceRepeatedMinute()
+        {
+            // Arrange
+            const string userId = "summary-repeat@test.com";
+            var first = await _client.PostAsJsonAsync("/api/trackingdata/activity/summary",
+                new[] { Summary(userId, Minute, 5), Summary(userId, Minute.AddMinutes(1), 7) });
+            Assert.Equal(HttpStatusCode.OK, first.StatusCode);
+
+            // Act - a retried upload sends the first minute again with newer totals
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/activity/summary",
+                new[] { Summary(userId, Minute, 9) });
+
+            // Assert
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+            var summaries = await GetSummaries(userId);
+            Assert.Equal(2, summaries.Count);
+            Assert.Equal(Minute, summaries[0].MinuteStart.ToUniversalTime());
+            Assert.Equal(9, summaries[0].KeyCount);
+            Assert.Equal(7, summaries[1].KeyCount);
+        }
+
+        [Fact]
+        public async Task UploadActivitySummaries_ShouldKeepLastDuplicateInBatch()
+        {
+            // Arrange - both entries fall into the same minute
+            const string userId = "summary-duplicate@test.com";
+            var batch = new[] { Summary(userId, Minute, 1), Summary(userId, Minute.AddSeconds(30), 2) };
+
+            // Act
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/activity/summary", batch);
+
+            // Assert
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+            var summaries = await GetSummaries(userId);
+            var summary = Assert.Single(summaries);
+            Assert.Equal(Minute, summary.MinuteStart.ToUniversalTime());
+            Assert.Equal(2, summary.KeyCount);
+        }
+
+        [Fact]
+        public async Task UploadActivitySummaries_ShouldRejectMoreThanAMinuteOfTime()
+        {
+            // Arrange - the second minute claims 70 seconds
+            const string userId = "summary-invalid@test.com";
+            var batch = new[]
+            {
+                Summary(userId, Minute, 3),
+                Summary(userId, Minute.AddMinutes(1), 3, activeSeconds: 40, idleSeconds: 30)
+            };
+
+            // Act
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/activity/summary", batch);
+
+            // Assert - the valid minute is not stored either
+            Assert.Equal(HttpStatusCode.BadRequest, response.StatusCode);
+            Assert.Empty(await GetSummaries(userId));
+        }
+
+        [Fact]
+        public async Task GetActivitySummaries_ShouldReturnBadRequest_WhenRangeIsEmpty()
+        {
+            // Act
+            var at = Uri.EscapeDataString(Minute.ToString("o"));
+            var response = await _client.GetAsync($"/api/trackingdata/activity/summary?userId=someone&from={at}&to={at}");
+
+            // Assert
+            Assert.Equal(HttpStatusCode.BadRequest, response.StatusCode);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+using System.Net;
+using System.Text.Json;
+
+namespace TimeTracker.API.Tests.Controllers
+{
+    public class ClientPolicyControllerTests : IClassFixture<InMemoryApiFactory>
+    {
+        private readonly InMemoryApiFactory _factory;
+
+        public ClientPolicyControllerTests(InMemoryApiFactory factory)
+        {
+            _factory = factory;
+        }
+
+        private HttpClient CreateClient(Dictionary<string, string> settings)
+        {
+            return _factory.WithWebHostBuilder(builder =>
+            {
+                foreach (var (key, value) in settings)
+                {
+                    builder.UseSetting(key, value);
+                }
+            }).CreateClient();
+        }
+
+        private static readonly Dictionary<string, string> Policy = new()
+        {
+            ["ClientPolicy:Screenshots:intervalSeconds"] = "300",
+            ["ClientPolicy:Screenshots:quality"] = "70",
+            ["ClientPolicy:Idle:thresholdSeconds"] = "600",
+            ["ClientPolicy:Users:alice@test.com:Screenshots:intervalSeconds"] = "60",
+            ["ClientPolicy:Users:alice@test.com:Upload:intervalSeconds"] = "120"
+        };
+
+        private static async Task<JsonElement> ReadPolicy(HttpResponseMessage response)
+        {
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+            using var document = JsonDocument.Parse(await response.Content.ReadAsStringAsync());
+            return document.RootElement.Clone();
+        }
+
+        [Fact]
+        public async Task GetClientPolicy_ShouldMergeUserOverrides()
+        {
+            // Arrange
+            var client = CreateClient(Policy);
+
+            // Act
+            var policy = await ReadPolicy(await client.GetAsync("/api/trackingdata/client/policy?userId=alice@test.com"));
+
+            // Assert - the user's group is merged key by key into the shared one
+            var screenshots = policy.GetProperty("Screenshots");
+            Assert.Equal("60", screenshots.GetProperty("intervalSeconds").GetString());
+            Assert.Equal("70", screenshots.GetProperty("quality").GetString());
+            Assert.Equal("600", policy.GetProperty("Idle").GetProperty("thresholdSeconds").GetString());
+            Assert.Equal("120", policy.GetProperty("Upload").GetProperty("intervalSeconds").GetString());
+            Assert.False(policy.TryGetProperty("Users", out _));
+        }
+
+        [Fact]
+        public async Task GetClientPolicy_ShouldReturnSharedPolicy_ForOtherUsers()
+        {
+            // Arrange
+            var client = CreateClient(Policy);
+
+            // Act
+            var anonymous = await ReadPolicy(await client.GetAsync("/api/trackingdata/client/policy"));
+            var bob = await ReadPolicy(await client.GetAsync("/api/trackingdata/client/policy?userId=bob@test.com"));
+
+            // Assert
+            foreach (var policy in new[] { anonymous, bob })
+            {
+                Assert.Equal("300", policy.GetProperty("Screenshots").GetProperty("intervalSeconds").GetString());
+                Assert.False(policy.TryGetProperty("Upload", out _));
+                Assert.False(policy.TryGetProperty("Users", out _));
+            }
+        }
+
+        [Fact]
+        public async Task GetClientPolicy_ShouldReturnNoContent_WhenNoPolicyIsConfigured()
+        {
+            // Arrange
+            var client = CreateClient(new Dictionary<string, string>());
+
+            // Act
+            var response = await client.GetAsync("/api/trackingdata/client/policy?userId=alice@test.com");
+
+            // Assert
+            Assert.Equal(HttpStatusCode.NoContent, response.StatusCode);
+        }
+    }
+}
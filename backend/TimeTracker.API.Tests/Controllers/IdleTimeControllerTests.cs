@@ -174,5 +174,66 @@ namespace TimeTracker.API.Tests.Controllers
             Assert.NotNull(savedSession);
             Assert.True(Math.Abs(savedSession.DurationSeconds - expectedDuration) <= 1); // Allow 1 second tolerance
         }
+
+        [Fact]
+        public async Task PostIdleTimeBatch_ShouldSaveAllSessions()
+        {
+            // Arrange
+            var start = DateTime.UtcNow.AddHours(-2);
+            var batch = new[]
+            {
+                new { StartTime = start, EndTime = start.AddMinutes(10), Reason = "Meeting", UserId = "batch-ok@test.com", SessionId = "batch1" },
+                new { StartTime = start.AddMinutes(30), EndTime = start.AddMinutes(45), Reason = "Break", UserId = "batch-ok@test.com", SessionId = "batch1" }
+            };
+
+            // Act
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/idletime/batch", batch);
+
+            // Assert
+            Assert.Equal(System.Net.HttpStatusCode.OK, response.StatusCode);
+
+            using var scope = _factory.Services.CreateScope();
+            var context = scope.ServiceProvider.GetRequiredService<TimeTrackerDbContext>();
+            var saved = await context.IdleSessions
+                .Where(x => x.UserId == "batch-ok@test.com")
+                .OrderBy(x => x.StartTime)
+                .ToListAsync();
+
+            Assert.Equal(2, saved.Count);
+            Assert.Equal(600, saved[0].DurationSeconds);
+            Assert.Equal("Break", saved[1].Reason);
+        }
+
+        [Fact]
+        public async Task PostIdleTimeBatch_ShouldSaveNothing_WhenAnySessionIsInvalid()
+        {
+            // Arrange - the second session ends before it starts
+            var start = DateTime.UtcNow.AddHours(-2);
+            var batch = new[]
+            {
+                new { StartTime = start, EndTime = start.AddMinutes(10), Reason = "Meeting", UserId = "batch-invalid@test.com", SessionId = "batch2" },
+                new { StartTime = start.AddMinutes(30), EndTime = start.AddMinutes(20), Reason = "Break", UserId = "batch-invalid@test.com", SessionId = "batch2" }
+            };
+
+            // Act
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/idletime/batch", batch);
+
+            // Assert - the client keeps the whole batch queued
+            Assert.Equal(System.Net.HttpStatusCode.BadRequest, response.StatusCode);
+
+            using var scope = _factory.Services.CreateScope();
+            var context = scope.ServiceProvider.GetRequiredService<TimeTrackerDbContext>();
+            Assert.False(await context.IdleSessions.AnyAsync(x => x.UserId == "batch-invalid@test.com"));
+        }
+
+        [Fact]
+        public async Task PostIdleTimeBatch_ShouldReturnBadRequest_WhenBatchIsEmpty()
+        {
+            // Act
+            var response = await _client.PostAsJsonAsync("/api/trackingdata/idletime/batch", Array.Empty<object>());
+
+            // Assert
+            Assert.Equal(System.Net.HttpStatusCode.BadRequest, response.StatusCode);
+        }
     }
 }
@@ -0,0 +1,159 @@
+using Microsoft.AspNetCore.Http;
+using Microsoft.AspNetCore.Mvc.Testing;
+using Microsoft.Extensions.DependencyInjection;
+using Moq;
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+using System.Net;
+using System.Net.Http.Headers;
+using System.Text.Json;
+using TimeTracker.API.Services;
+
+namespace TimeTracker.API.Tests.Controllers
+{
+    public class ScreenshotBatchControllerTests : IClassFixture<InMemoryApiFactory>
+    {
+        private readonly WebApplicationFactory<Program> _factory;
+        private readonly HttpClient _client;
+        private readonly List<(string ContentType, byte[] Content)> _uploads = new();
+
+        public ScreenshotBatchControllerTests(InMemoryApiFactory factory)
+        {
+            var s3 = new Mock<IS3Service>();
+            s3.Setup(s => s.UploadScreenshotAsync(It.IsAny<IFormFile>(), It.IsAny<string>()))
+                .Callback<IFormFile, string>((file, _) =>
+                {
+                    using var content = new MemoryStream();
+                    file.CopyTo(content);
+                    _uploads.Add((file.ContentType, content.ToArray()));
+                })
+                .ReturnsAsync(("https://bucket/original.jpg", "https://bucket/thumbnail.jpg"));
+
+            _factory = factory.WithWebHostBuilder(builder =>
+            {
+                builder.ConfigureServices(services =>
+                {
+                    // Capture uploads instead of sending them to S3
+                    services.AddSingleton(s3.Object);
+                });
+            });
+
+            _client = _factory.CreateClient();
+        }
+
+        private static byte[] Png(int width, int height, Rgba32 color)
+        {
+            using var image = new Image<Rgba32>(width, height, color);
+            using var output = new MemoryStream();
+            image.SaveAsPng(output);
+            return output.ToArray();
+        }
+
+        private Task<HttpResponseMessage> PostBatch(string sessionId, object metadata, params (string FileName, byte[] Content)[] files)
+        {
+            var form = new MultipartFormDataContent();
+            foreach (var (fileName, content) in files)
+            {
+                var part = new ByteArrayContent(content);
+                part.Headers.ContentType = new MediaTypeHeaderValue("image/png");
+                form.Add(part, "files", fileName);
+            }
+            form.Add(new StringContent("batch@test.com"), "userId");
+            form.Add(new StringContent(sessionId), "sessionId");
+            form.Add(new StringContent(JsonSerializer.Serialize(metadata)), "metadata");
+            return _client.PostAsync("/api/trackingdata/screenshots/batch", form);
+        }
+
+        private static object Keyframe(string fileName, int screenIndex, long sequence) =>
+            new { fileName, screenIndex, kind = "keyframe", sequence };
+
+        private static object Delta(string fileName, int screenIndex, long baseSequence, long sequence, params int[][] tiles) =>
+            new
+            {
+                fileName,
+                screenIndex,
+                kind = "delta",
+                sequence,
+                baseSequence,
+                frameWidth = 64,
+                frameHeight = 48,
+                tileSize = 16,
+                atlasColumns = 1,
+                tiles
+            };
+
+        private static List<int> KeyframeRequired(JsonDocument body) =>
+            body.RootElement.GetProperty("keyframeRequired").EnumerateArray().Select(e => e.GetInt32()).ToList();
+
+        [Fact]
+        public async Task UploadScreenshotBatch_ShouldStoreReassembledDeltaAsJpeg()
+        {
+            // Arrange
+            var keyframe = await PostBatch("delta-session", new[] { Keyframe("screen0.png", 0, 1) },
+                ("screen0.png", Png(64, 48, new Rgba32(0, 0, 0))));
+            Assert.Equal(HttpStatusCode.OK, keyframe.StatusCode);
+
+            // Act
+            var response = await PostBatch("delta-session", new[] { Delta("screen0.png", 0, 1, 2, new[] { 16, 16, 16, 16 }) },
+                ("screen0.png", Png(16, 16, new Rgba32(255, 0, 0))));
+
+            // Assert
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+            using var body = JsonDocument.Parse(await response.Content.ReadAsStringAsync());
+            Assert.Empty(KeyframeRequired(body));
+            Assert.Single(body.RootElement.GetProperty("screenshots").EnumerateArray());
+
+            Assert.Equal(2, _uploads.Count);
+            Assert.Equal("image/png", _uploads[0].ContentType);
+            Assert.Equal("image/jpeg", _uploads[1].ContentType);
+            using var frame = Image.Load<Rgba32>(_uploads[1].Content);
+            Assert.Equal(64, frame.Width);
+            Assert.Equal(48, frame.Height);
+
+            // JPEG is lossy; check colours well inside and outside the tile
+            var inside = frame[24, 24];
+            var outside = frame[4, 4];
+            Assert.True(inside.R > 200 && inside.G < 60 && inside.B < 60);
+            Assert.True(outside.R < 40 && outside.G < 40 && outside.B < 40);
+        }
+
+        [Fact]
+        public async Task UploadScreenshotBatch_ShouldRequestKeyframe_WhenDeltaHasNoBase()
+        {
+            // Act - screen 1 sends a keyframe; screen 0's delta refers to a frame the server never saw
+            var response = await PostBatch("missing-base-session",
+                new[] { Delta("screen0.png", 0, 7, 8, new[] { 0, 0, 16, 16 }), Keyframe("screen1.png", 1, 1) },
+                ("screen0.png", Png(16, 16, new Rgba32(255, 0, 0))),
+                ("screen1.png", Png(64, 48, new Rgba32(0, 0, 0))));
+
+            // Assert
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+            using var body = JsonDocument.Parse(await response.Content.ReadAsStringAsync());
+            Assert.Equal(new List<int> { 0 }, KeyframeRequired(body));
+
+            var screenshots = body.RootElement.GetProperty("screenshots").EnumerateArray().ToList();
+            Assert.Single(screenshots);
+            Assert.Equal(1, screenshots[0].GetProperty("screenIndex").GetInt32());
+            Assert.Single(_uploads);
+        }
+
+        [Fact]
+        public async Task UploadScreenshotBatch_ShouldRequestKeyframe_WhenDeltaIsStale()
+        {
+            // Arrange
+            await PostBatch("stale-session", new[] { Keyframe("screen0.png", 0, 3) },
+                ("screen0.png", Png(64, 48, new Rgba32(0, 0, 0))));
+
+            // Act - the client believes the server still holds frame 2
+            var response = await PostBatch("stale-session", new[] { Delta("screen0.png", 0, 2, 4, new[] { 0, 0, 16, 16 }) },
+                ("screen0.png", Png(16, 16, new Rgba32(255, 0, 0))));
+
+            // Assert
+            Assert.Equal(HttpStatusCode.OK, response.StatusCode);
+            using var body = JsonDocument.Parse(await response.Content.ReadAsStringAsync());
+            Assert.Equal(new List<int> { 0 }, KeyframeRequired(body));
+            Assert.Empty(body.RootElement.GetProperty("screenshots").EnumerateArray());
+            Assert.Single(_uploads);
+        }
+    }
+}
@@ -0,0 +1,36 @@
+using Microsoft.AspNetCore.Hosting;
+using Microsoft.AspNetCore.Mvc.Testing;
+using Microsoft.EntityFrameworkCore;
+using Microsoft.Extensions.DependencyInjection;
+using TimeTracker.API.Data;
+
+namespace TimeTracker.API.Tests
+{
+    /// <summary>
+    /// Hosts the API on an in-memory database instead of the configured one.
+    /// Each instance gets its own database, so test classes sharing it as a
+    /// class fixture do not see each other's data.
+    /// </summary>
+    public class InMemoryApiFactory : WebApplicationFactory<Program>
+    {
+        private readonly string _databaseName = $"TestDatabase-{Guid.NewGuid()}";
+
+        protected override void ConfigureWebHost(IWebHostBuilder builder)
+        {
+            builder.ConfigureServices(services =>
+            {
+                // Remove the existing DbContext registration
+                var descriptor = services.SingleOrDefault(
+                    d => d.ServiceType == typeof(DbContextOptions<TimeTrackerDbContext>));
+                if (descriptor != null)
+                    services.Remove(descriptor);
+
+                // Add in-memory database for testing
+                services.AddDbContext<TimeTrackerDbContext>(options =>
+                {
+                    options.UseInMemoryDatabase(_databaseName);
+                });
+            });
+        }
+    }
+}
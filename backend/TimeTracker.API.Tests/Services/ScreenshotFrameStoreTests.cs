@@ -0,0 +1,194 @@
+using Microsoft.Extensions.Configuration;
+using Microsoft.Extensions.Logging.Abstractions;
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+using TimeTracker.API.Services;
+
+namespace TimeTracker.API.Tests.Services
+{
+    public class ScreenshotFrameStoreTests
+    {
+        private const string Stream = "user@test.com/session1/0";
+        private const int TileSize = 16;
+
+        private static ScreenshotFrameStore CreateStore(Dictionary<string, string?>? settings = null)
+        {
+            var configuration = new ConfigurationBuilder()
+                .AddInMemoryCollection(settings ?? new Dictionary<string, string?>())
+                .Build();
+            return new ScreenshotFrameStore(configuration, NullLogger<ScreenshotFrameStore>.Instance);
+        }
+
+        private static readonly Rgba32 Black = new(0, 0, 0);
+        private static readonly Rgba32 Red = new(255, 0, 0);
+        private static readonly Rgba32 Blue = new(0, 0, 255);
+
+        private static Image<Rgba32> Solid(int width, int height, Rgba32 color) => new(width, height, color);
+
+        [Fact]
+        public void ApplyDelta_ShouldPasteTilesOntoStoredFrame()
+        {
+            // Arrange
+            var store = CreateStore();
+            store.StoreKeyframe(Stream, 1, Solid(64, 48, Black));
+            using var atlas = Solid(TileSize * 2, TileSize, Red);
+            atlas[TileSize, 0] = Blue;
+
+            // Act - slot 0 goes to (16, 0), slot 1 (starting blue) to (32, 32)
+            using var frame = store.ApplyDelta(Stream, 1, 2, 64, 48, TileSize, 2,
+                new[] { new ScreenshotTile(16, 0, 16, 16), new ScreenshotTile(32, 32, 8, 8) }, atlas);
+
+            // Assert
+            Assert.NotNull(frame);
+            Assert.Equal(Black, frame[0, 0]);
+            Assert.Equal(Red, frame[16, 0]);
+            Assert.Equal(Blue, frame[32, 32]);
+            Assert.Equal(Red, frame[39, 39]);
+            Assert.Equal(Black, frame[40, 40]);
+        }
+
+        [Fact]
+        public void ApplyDelta_ShouldChainOnTheReassembledFrame()
+        {
+            // Arrange
+            var store = CreateStore();
+            store.StoreKeyframe(Stream, 1, Solid(64, 48, Black));
+            using var atlas = Solid(TileSize, TileSize, Red);
+            using var first = store.ApplyDelta(Stream, 1, 2, 64, 48, TileSize, 1, new[] { new ScreenshotTile(0, 0, 16, 16) }, atlas);
+
+            // Act
+            using var second = store.ApplyDelta(Stream, 2, 3, 64, 48, TileSize, 1, new[] { new ScreenshotTile(48, 32, 16, 16) }, atlas);
+
+            // Assert - the second delta builds on the first
+            Assert.NotNull(second);
+            Assert.Equal(Red, second[0, 0]);
+            Assert.Equal(Red, second[63, 47]);
+        }
+
+        [Fact]
+        public void ApplyDelta_ShouldReturnNull_WhenBaseSequenceDoesNotMatch()
+        {
+            // Arrange
+            var store = CreateStore();
+            store.StoreKeyframe(Stream, 5, Solid(64, 48, Black));
+            using var atlas = Solid(TileSize, TileSize, Red);
+            var tiles = new[] { new ScreenshotTile(0, 0, 16, 16) };
+
+            // Act & Assert
+            Assert.Null(store.ApplyDelta(Stream, 4, 6, 64, 48, TileSize, 1, tiles, atlas));
+            Assert.Null(store.ApplyDelta("user@test.com/session1/1", 5, 6, 64, 48, TileSize, 1, tiles, atlas));
+            Assert.Null(store.ApplyDelta(Stream, 5, 6, 32, 48, TileSize, 1, tiles, atlas));
+
+            // The stored frame is still the base for a matching delta
+            using var frame = store.ApplyDelta(Stream, 5, 6, 64, 48, TileSize, 1, tiles, atlas);
+            Assert.NotNull(frame);
+        }
+
+        [Theory]
+        [InlineData(0, 0, 0, 16)]      // empty
+        [InlineData(0, 0, 17, 16)]     // wider than a slot
+        [InlineData(56, 0, 16, 16)]    // past the right edge of the frame
+        [InlineData(0, -1, 16, 16)]    // above the frame
+        public void ApplyDelta_ShouldReturnNull_WhenTileIsInvalid(int x, int y, int width, int height)
+        {
+            // Arrange
+            var store = CreateStore();
+            store.StoreKeyframe(Stream, 1, Solid(64, 48, Black));
+            using var atlas = Solid(TileSize * 2, TileSize, Red);
+
+            // Act - a valid tile ahead of the invalid one must not be pasted either
+            var result = store.ApplyDelta(Stream, 1, 2, 64, 48, TileSize, 2,
+                new[] { new ScreenshotTile(0, 0, 16, 16), new ScreenshotTile(x, y, width, height) }, atlas);
+
+            // Assert
+            Assert.Null(result);
+            using var frame = store.ApplyDelta(Stream, 1, 2, 64, 48, TileSize, 1, Array.Empty<ScreenshotTile>(), atlas);
+            Assert.NotNull(frame);
+            Assert.Equal(Black, frame[0, 0]);
+        }
+
+        [Fact]
+        public void ApplyDelta_ShouldReturnNull_WhenTileSlotIsOutsideAtlas()
+        {
+            // Arrange
+            var store = CreateStore();
+            store.StoreKeyframe(Stream, 1, Solid(64, 48, Black));
+            using var atlas = Solid(TileSize * 2, TileSize, Red);
+
+            // Act - with two columns, slot 2 starts a second row the atlas does not have
+            var tiles = new[]
+            {
+                new ScreenshotTile(0, 0, 16, 16),
+                new ScreenshotTile(16, 0, 16, 16),
+                new ScreenshotTile(32, 0, 16, 16)
+            };
+            var result = store.ApplyDelta(Stream, 1, 2, 64, 48, TileSize, 2, tiles, atlas);
+
+            // Assert
+            Assert.Null(result);
+            Assert.Null(store.ApplyDelta(Stream, 1, 2, 64, 48, TileSize, 0, tiles.Take(1).ToList(), atlas));
+        }
+
+        [Fact]
+        public void StoreKeyframe_ShouldEvictLeastRecentlyUsedFrames_WhenOverByteLimit()
+        {
+            // Arrange - room for two 64x48 frames
+            var store = CreateStore(new Dictionary<string, string?>
+            {
+                ["Screenshots:FrameStore:MaxBytes"] = (2 * 64 * 48 * 4).ToString()
+            });
+            using var atlas = Solid(TileSize, TileSize, Red);
+            var tiles = new[] { new ScreenshotTile(0, 0, 16, 16) };
+
+            // Act
+            store.StoreKeyframe("a", 1, Solid(64, 48, Black));
+            store.StoreKeyframe("b", 1, Solid(64, 48, Black));
+            store.ApplyDelta("a", 1, 2, 64, 48, TileSize, 1, tiles, atlas)?.Dispose();
+            store.StoreKeyframe("c", 1, Solid(64, 48, Black));
+
+            // Assert - "b" was used least recently
+            Assert.Equal(2, store.StreamCount);
+            Assert.Equal(2 * 64 * 48 * 4, store.TotalBytes);
+            Assert.Equal(1, store.EvictedForSpace);
+            Assert.Null(store.ApplyDelta("b", 1, 2, 64, 48, TileSize, 1, tiles, atlas));
+            using var frame = store.ApplyDelta("a", 2, 3, 64, 48, TileSize, 1, tiles, atlas);
+            Assert.NotNull(frame);
+        }
+
+        [Fact]
+        public void StoreKeyframe_ShouldReleaseReplacedFrame()
+        {
+            // Arrange
+            var store = CreateStore();
+
+            // Act
+            store.StoreKeyframe(Stream, 1, Solid(64, 48, Black));
+            store.StoreKeyframe(Stream, 2, Solid(32, 32, Black));
+
+            // Assert
+            Assert.Equal(1, store.StreamCount);
+            Assert.Equal(32 * 32 * 4, store.TotalBytes);
+            Assert.Equal(0, store.EvictedForSpace);
+        }
+
+        [Fact]
+        public void StoreKeyframe_ShouldExpireIdleStreams()
+        {
+            // Arrange - with no idle timeout every stream not just used expires at the next keyframe
+            var store = CreateStore(new Dictionary<string, string?>
+            {
+                ["Screenshots:FrameStore:IdleMinutes"] = "0"
+            });
+            store.StoreKeyframe("a", 1, Solid(64, 48, Black));
+            Thread.Sleep(10);
+
+            // Act
+            store.StoreKeyframe("b", 1, Solid(64, 48, Black));
+
+            // Assert
+            Assert.Equal(1, store.StreamCount);
+            Assert.Equal(1, store.Expired);
+            Assert.Equal(64 * 48 * 4, store.TotalBytes);
+        }
+    }
+}
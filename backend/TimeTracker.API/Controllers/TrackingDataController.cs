@@ -1,6 +1,9 @@
 using Microsoft.AspNetCore.Mvc;
 using Microsoft.EntityFrameworkCore;
 using System.ComponentModel.DataAnnotations;
+using System.Text.Json;
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
 using TimeTracker.API.Data;
 using TimeTracker.API.Models;
 using TimeTracker.API.Services;
@@ -13,18 +16,100 @@ namespace TimeTracker.API.Controllers
     {
         private readonly TimeTrackerDbContext _context;
         private readonly IS3Service _s3Service;
+        private readonly IScreenshotFrameStore _frameStore;
+        private readonly IActivityLogIngestor _activityIngestor;
+        private readonly IConfiguration _configuration;
         private readonly ILogger<TrackingDataController> _logger;
 
         public TrackingDataController(
             TimeTrackerDbContext context, 
             IS3Service s3Service,
+            IScreenshotFrameStore frameStore,
+            IActivityLogIngestor activityIngestor,
+            IConfiguration configuration,
             ILogger<TrackingDataController> logger)
         {
             _context = context;
             _s3Service = s3Service;
+            _frameStore = frameStore;
+            _activityIngestor = activityIngestor;
+            _configuration = configuration;
             _logger = logger;
         }
 
+        // Runtime settings pushed to clients, e.g. "ClientPolicy": { "Screenshots": { "intervalSeconds": 300 } }.
+        // A "Users:<userId>" subsection overrides them for that user.
+        [HttpGet("client/policy")]
+        public IActionResult GetClientPolicy([FromQuery] string? userId)
+        {
+            var section = _configuration.GetSection("ClientPolicy");
+            var policy = ToPolicy(section, skipKey: "Users");
+            if (!string.IsNullOrEmpty(userId))
+            {
+                Merge(policy, ToPolicy(section.GetSection("Users").GetSection(userId), skipKey: null));
+            }
+
+            if (policy.Count == 0)
+            {
+                return NoContent();
+            }
+            return Ok(policy);
+        }
+
+        private static Dictionary<string, object> ToPolicy(IConfigurationSection section, string? skipKey)
+        {
+            var policy = new Dictionary<string, object>(StringComparer.OrdinalIgnoreCase);
+            foreach (var child in section.GetChildren())
+            {
+                if (child.Key == skipKey)
+                {
+                    continue;
+                }
+                if (child.Value != null)
+                {
+                    policy[child.Key] = child.Value;
+                }
+                else
+                {
+                    policy[child.Key] = ToPolicy(child, skipKey: null);
+                }
+            }
+            return policy;
+        }
+
+        private static void Merge(Dictionary<string, object> target, Dictionary<string, object> overrides)
+        {
+            foreach (var (key, value) in overrides)
+            {
+                if (value is Dictionary<string, object> group && target.TryGetValue(key, out var existing)
+                    && existing is Dictionary<string, object> existingGroup)
+                {
+                    Merge(existingGroup, group);
+                }
+                else
+                {
+                    target[key] = value;
+                }
+            }
+        }
+
+        // Client metrics deltas ("v", "counters", "gauges", "histograms", "intervalMs"), logged for the
+        // log pipeline to index rather than stored.
+        [HttpPost("telemetry")]
+        public IActionResult UploadTelemetry([FromBody] JsonElement record)
+        {
+            if (record.ValueKind != JsonValueKind.Object)
+            {
+                return BadRequest("Expected a telemetry object");
+            }
+
+            var userId = record.TryGetProperty("userId", out var user) && user.ValueKind == JsonValueKind.String
+                ? user.GetString()
+                : null;
+            _logger.LogInformation("Client telemetry for user {UserId}: {Telemetry}", userId, record.GetRawText());
+            return Accepted();
+        }
+
         [HttpPost("activity")]
         public async Task<IActionResult> UploadActivity([FromBody] List<ActivityLogDto> activityLogs)
         {
@@ -34,6 +119,10 @@ namespace TimeTracker.API.Controllers
                 {
                     return BadRequest("No activity logs provided");
                 }
+                if (activityLogs.Any(dto => dto.Timestamp.Kind == DateTimeKind.Unspecified))
+                {
+                    return BadRequest(ZonelessTimestampError);
+                }
 
                 var entities = activityLogs.Select(dto => new ActivityLog
                 {
@@ -44,8 +133,7 @@ namespace TimeTracker.API.Controllers
                     SessionId = dto.SessionId
                 }).ToList();
 
-                await _context.ActivityLogs.AddRangeAsync(entities);
-                await _context.SaveChangesAsync();
+                await _activityIngestor.InsertAsync(entities, HttpContext.RequestAborted);
 
                 _logger.LogInformation("Successfully saved {Count} activity logs for user {UserId}", 
                     entities.Count, entities.First().UserId);
@@ -59,6 +147,191 @@ namespace TimeTracker.API.Controllers
             }
         }
 
+        [HttpPost("activity/chunk")]
+        public async Task<IActionResult> UploadActivityChunk([FromBody] ActivityChunkDto chunk)
+        {
+            try
+            {
+                if (chunk.Entries == null || !chunk.Entries.Any())
+                {
+                    return BadRequest("No activity logs provided");
+                }
+                if (chunk.Entries.Any(entry => entry.Timestamp.Kind == DateTimeKind.Unspecified))
+                {
+                    return BadRequest(ZonelessTimestampError);
+                }
+
+                // Application changes refer to the chunk's string table by id
+                var entities = new List<ActivityLog>(chunk.Entries.Count);
+                foreach (var entry in chunk.Entries)
+                {
+                    var details = entry.Details ?? string.Empty;
+                    if (entry.Process.HasValue || entry.Title.HasValue)
+                    {
+                        if (!chunk.Strings.TryGetValue(entry.Process?.ToString() ?? string.Empty, out var process) ||
+                            !chunk.Strings.TryGetValue(entry.Title?.ToString() ?? string.Empty, out var title))
+                        {
+                            return BadRequest("Activity entry refers to an unknown string id");
+                        }
+                        details = $"PROCESS: {process} - TITLE: {title}";
+                    }
+
+                    entities.Add(new ActivityLog
+                    {
+                        Timestamp = entry.Timestamp,
+                        EventType = entry.EventType,
+                        Details = details,
+                        UserId = chunk.UserId,
+                        SessionId = chunk.SessionId
+                    });
+                }
+
+                await _activityIngestor.InsertAsync(entities, HttpContext.RequestAborted);
+
+                _logger.LogInformation("Successfully saved {Count} activity logs ({StringCount} strings) for user {UserId}",
+                    entities.Count, chunk.Strings.Count, chunk.UserId);
+
+                // Echo the journal range so the client only advances its cursor over what was stored
+                return Ok(new ActivityChunkResponseDto
+                {
+                    Message = "Activity logs saved successfully",
+                    Count = entities.Count,
+                    Acknowledged = chunk.EndOffset.HasValue
+                        ? new ActivityChunkRangeDto
+                        {
+                            Segment = chunk.Segment ?? 0,
+                            StartOffset = chunk.StartOffset ?? 0,
+                            EndOffset = chunk.EndOffset.Value
+                        }
+                        : null
+                });
+            }
+            catch (Exception ex)
+            {
+                _logger.LogError(ex, "Failed to save activity chunk");
+                return StatusCode(500, "Internal server error");
+            }
+        }
+
+        // Minutes are re-sent after a failed upload, so a repeat replaces the stored row
+        [HttpPost("activity/summary")]
+        public async Task<IActionResult> UploadActivitySummaries([FromBody] List<ActivitySummaryDto> summaries)
+        {
+            try
+            {
+                if (summaries == null || summaries.Count == 0)
+                {
+                    return BadRequest("No activity summaries provided");
+                }
+
+                for (var i = 0; i < summaries.Count; i++)
+                {
+                    var summary = summaries[i];
+                    if (summary == null || string.IsNullOrEmpty(summary.UserId) ||
+                        summary.ActiveSeconds < 0 || summary.IdleSeconds < 0 ||
+                        summary.ActiveSeconds + summary.IdleSeconds > 60)
+                    {
+                        return BadRequest($"Invalid activity summary at index {i}");
+                    }
+                }
+
+                // Last one wins when a batch holds the same minute twice
+                var incoming = summaries
+                    .GroupBy(dto => (dto.UserId, MinuteStart: ToMinuteStart(dto.MinuteStart)))
+                    .ToDictionary(group => group.Key, group => group.Last());
+
+                var userIds = incoming.Keys.Select(key => key.UserId).Distinct().ToList();
+                var first = incoming.Keys.Min(key => key.MinuteStart);
+                var last = incoming.Keys.Max(key => key.MinuteStart);
+                var existing = await _context.ActivitySummaries
+                    .Where(s => userIds.Contains(s.UserId) && s.MinuteStart >= first && s.MinuteStart <= last)
+                    .ToDictionaryAsync(s => (s.UserId, s.MinuteStart), HttpContext.RequestAborted);
+
+                var added = new List<ActivitySummary>();
+                foreach (var (key, dto) in incoming)
+                {
+                    if (!existing.TryGetValue(key, out var entity))
+                    {
+                        entity = new ActivitySummary { UserId = key.UserId, MinuteStart = key.MinuteStart };
+                        added.Add(entity);
+                    }
+
+                    entity.SessionId = Truncate(dto.SessionId, 50);
+                    entity.KeyCount = dto.KeyCount;
+                    entity.ClickCount = dto.ClickCount;
+                    entity.MouseDistance = dto.MouseDistance;
+                    entity.ActiveSeconds = dto.ActiveSeconds;
+                    entity.IdleSeconds = dto.IdleSeconds;
+                    entity.ProcessName = Truncate(dto.ProcessName, 100);
+                    entity.WindowTitle = Truncate(dto.WindowTitle, 500);
+                }
+
+                await _context.ActivitySummaries.AddRangeAsync(added);
+                await _context.SaveChangesAsync(HttpContext.RequestAborted);
+
+                _logger.LogInformation("Saved {Count} activity summaries ({Added} new) for {UserCount} user(s)",
+                    incoming.Count, added.Count, userIds.Count);
+
+                return Ok(new { message = "Activity summaries saved successfully", count = incoming.Count });
+            }
+            catch (Exception ex)
+            {
+                _logger.LogError(ex, "Failed to save activity summaries");
+                return StatusCode(500, "Internal server error");
+            }
+        }
+
+        [HttpGet("activity/summary")]
+        public async Task<IActionResult> GetActivitySummaries([FromQuery] string userId, [FromQuery] DateTime from,
+            [FromQuery] DateTime to)
+        {
+            if (string.IsNullOrEmpty(userId) || from >= to)
+            {
+                return BadRequest("A user id and a non-empty time range are required");
+            }
+
+            var fromUtc = ToMinuteStart(from);
+            var toUtc = to.ToUniversalTime();
+            var summaries = await _context.ActivitySummaries
+                .AsNoTracking()
+                .Where(s => s.UserId == userId && s.MinuteStart >= fromUtc && s.MinuteStart < toUtc)
+                .OrderBy(s => s.MinuteStart)
+                .Select(s => new ActivitySummaryDto
+                {
+                    MinuteStart = s.MinuteStart,
+                    KeyCount = s.KeyCount,
+                    ClickCount = s.ClickCount,
+                    MouseDistance = s.MouseDistance,
+                    ActiveSeconds = s.ActiveSeconds,
+                    IdleSeconds = s.IdleSeconds,
+                    ProcessName = s.ProcessName,
+                    WindowTitle = s.WindowTitle,
+                    UserId = s.UserId,
+                    SessionId = s.SessionId
+                })
+                .ToListAsync(HttpContext.RequestAborted);
+
+            return Ok(summaries);
+        }
+
+        // Without a zone the server cannot tell which UTC instant the client meant
+        private const string ZonelessTimestampError = "Activity timestamps need a UTC 'Z' or an offset";
+
+        private static DateTime ToMinuteStart(DateTime timestamp)
+        {
+            var utc = timestamp.ToUniversalTime();
+            return new DateTime(utc.Ticks - utc.Ticks % TimeSpan.TicksPerMinute, DateTimeKind.Utc);
+        }
+
+        private static string Truncate(string? value, int maxLength)
+        {
+            if (string.IsNullOrEmpty(value))
+            {
+                return string.Empty;
+            }
+            return value.Length <= maxLength ? value : value.Substring(0, maxLength);
+        }
+
         [HttpPost("screenshots")]
         public async Task<IActionResult> UploadScreenshot([FromForm] IFormFile file, [FromForm] string userId, [FromForm] string sessionId)
         {
@@ -75,10 +348,10 @@ namespace TimeTracker.API.Controllers
                 }
 
                 // Validate file type
-                var allowedTypes = new[] { "image/jpeg", "image/jpg", "image/png" };
+                var allowedTypes = new[] { "image/jpeg", "image/jpg", "image/png", "image/webp" };
                 if (!allowedTypes.Contains(file.ContentType.ToLower()))
                 {
-                    return BadRequest("Only JPEG and PNG files are allowed");
+                    return BadRequest("Only JPEG, PNG and WebP files are allowed");
                 }
 
                 // Upload to S3
@@ -115,6 +388,159 @@ namespace TimeTracker.API.Controllers
             }
         }
 
+        [HttpPost("screenshots/batch")]
+        public async Task<IActionResult> UploadScreenshotBatch([FromForm] List<IFormFile> files, [FromForm] string userId,
+            [FromForm] string sessionId, [FromForm] string? metadata)
+        {
+            try
+            {
+                if (files == null || files.Count == 0 || files.Any(f => f.Length == 0))
+                {
+                    return BadRequest("No files provided");
+                }
+
+                if (string.IsNullOrEmpty(userId))
+                {
+                    return BadRequest("UserId is required");
+                }
+
+                // Validate file types
+                var allowedTypes = new[] { "image/jpeg", "image/jpg", "image/png", "image/webp" };
+                if (files.Any(f => !allowedTypes.Contains(f.ContentType.ToLower())))
+                {
+                    return BadRequest("Only JPEG, PNG and WebP files are allowed");
+                }
+
+                // Screen geometry per file, matched by file name and falling back to position
+                var screens = new List<ScreenMetadataDto>();
+                if (!string.IsNullOrEmpty(metadata))
+                {
+                    try
+                    {
+                        screens = JsonSerializer.Deserialize<List<ScreenMetadataDto>>(metadata,
+                            new JsonSerializerOptions { PropertyNameCaseInsensitive = true }) ?? screens;
+                    }
+                    catch (JsonException)
+                    {
+                        return BadRequest("Invalid screen metadata");
+                    }
+                }
+
+                var captureId = Guid.NewGuid().ToString("N");
+                var timestamp = DateTime.UtcNow;
+                var entities = new List<Screenshot>();
+                var keyframeRequired = new List<int>();
+
+                for (var i = 0; i < files.Count; i++)
+                {
+                    var file = files[i];
+                    var screen = screens.FirstOrDefault(s => s.FileName == file.FileName)
+                        ?? (i < screens.Count ? screens[i] : new ScreenMetadataDto { ScreenIndex = i });
+                    var streamKey = $"{userId}/{sessionId}/{screen.ScreenIndex}";
+
+                    // Deltas are pasted onto the previous frame and stored as a full screenshot
+                    var upload = file;
+                    if (screen.Kind == "delta")
+                    {
+                        upload = await ReassembleDeltaAsync(file, screen, streamKey);
+                        if (upload == null)
+                        {
+                            keyframeRequired.Add(screen.ScreenIndex);
+                            continue;
+                        }
+                    }
+                    else if (screen.Sequence > 0)
+                    {
+                        using var stream = file.OpenReadStream();
+                        _frameStore.StoreKeyframe(streamKey, screen.Sequence, await Image.LoadAsync<Rgba32>(stream));
+                    }
+
+                    // Upload to S3
+                    var (originalUrl, thumbnailUrl) = await _s3Service.UploadScreenshotAsync(upload, userId);
+
+                    entities.Add(new Screenshot
+                    {
+                        Timestamp = timestamp,
+                        OriginalImageUrl = originalUrl,
+                        ThumbnailUrl = thumbnailUrl,
+                        UserId = userId,
+                        SessionId = sessionId,
+                        FileSize = upload.Length,
+                        CaptureId = captureId,
+                        ScreenIndex = screen.ScreenIndex,
+                        ScreenName = screen.ScreenName,
+                        ScreenX = screen.X,
+                        ScreenY = screen.Y,
+                        ScreenWidth = screen.Width,
+                        ScreenHeight = screen.Height,
+                        DevicePixelRatio = screen.DevicePixelRatio,
+                        Dpi = screen.Dpi
+                    });
+                }
+
+                await _context.Screenshots.AddRangeAsync(entities);
+                await _context.SaveChangesAsync();
+
+                _logger.LogInformation("Successfully processed {Count} screenshots for user {UserId}", entities.Count, userId);
+
+                if (keyframeRequired.Any())
+                {
+                    _logger.LogInformation("Requested keyframes for screens {Screens} of user {UserId}",
+                        string.Join(",", keyframeRequired), userId);
+                }
+
+                return Ok(new
+                {
+                    message = "Screenshots uploaded successfully",
+                    captureId = captureId,
+                    keyframeRequired = keyframeRequired,
+                    screenshots = entities.Select(e => new
+                    {
+                        id = e.Id,
+                        screenIndex = e.ScreenIndex,
+                        originalUrl = e.OriginalImageUrl,
+                        thumbnailUrl = e.ThumbnailUrl
+                    })
+                });
+            }
+            catch (Exception ex)
+            {
+                _logger.LogError(ex, "Failed to upload screenshots for user {UserId}", userId);
+                return StatusCode(500, "Internal server error");
+            }
+        }
+
+        private async Task<IFormFile?> ReassembleDeltaAsync(IFormFile atlasFile, ScreenMetadataDto screen, string streamKey)
+        {
+            using var atlasStream = atlasFile.OpenReadStream();
+            using var atlas = await Image.LoadAsync<Rgba32>(atlasStream);
+
+            var tiles = screen.Tiles
+                .Where(t => t.Length == 4)
+                .Select(t => new ScreenshotTile(t[0], t[1], t[2], t[3]))
+                .ToList();
+            if (tiles.Count != screen.Tiles.Count)
+            {
+                return null;
+            }
+
+            using var frame = _frameStore.ApplyDelta(streamKey, screen.BaseSequence, screen.Sequence,
+                screen.FrameWidth, screen.FrameHeight, screen.TileSize, screen.AtlasColumns, tiles, atlas);
+            if (frame == null)
+            {
+                return null;
+            }
+
+            var output = new MemoryStream();
+            await frame.SaveAsJpegAsync(output);
+            output.Position = 0;
+            return new FormFile(output, 0, output.Length, "files", atlasFile.FileName)
+            {
+                Headers = new HeaderDictionary(),
+                ContentType = "image/jpeg"
+            };
+        }
+
         [HttpPost("idletime")]
         public async Task<IActionResult> UploadIdleTime([FromBody] IdleSessionDto idleSession)
         {
@@ -132,33 +558,19 @@ namespace TimeTracker.API.Controllers
                     return BadRequest(new ErrorResponseDto { Error = "Invalid idle session data" });
                 }
 
-                // Calculate duration
-                var durationSeconds = (int)(idleSession.EndTime - idleSession.StartTime).TotalSeconds;
-
-                var entity = new IdleSession
-                {
-                    StartTime = idleSession.StartTime,
-                    EndTime = idleSession.EndTime,
-                    Reason = idleSession.Reason ?? "Idle",
-                    Note = idleSession.Note ?? string.Empty,
-                    UserId = idleSession.UserId,
-                    SessionId = idleSession.SessionId ?? string.Empty,
-                    DurationSeconds = durationSeconds,
-                    IsRemoteSession = idleSession.IsRemoteSession,
-                    ActiveApplication = idleSession.ActiveApplication ?? string.Empty
-                };
+                var entity = ToIdleSession(idleSession);
 
                 await _context.IdleSessions.AddAsync(entity);
                 await _context.SaveChangesAsync();
 
                 _logger.LogInformation("Successfully saved idle session for user {UserId}, duration {Duration}s",
-                    entity.UserId, durationSeconds);
+                    entity.UserId, entity.DurationSeconds);
 
                 return Ok(new IdleSessionResponseDto
                 {
                     Message = "Idle session saved successfully",
                     Id = entity.Id,
-                    Duration = durationSeconds
+                    Duration = entity.DurationSeconds
                 });
             }
             catch (Exception ex)
@@ -167,6 +579,59 @@ namespace TimeTracker.API.Controllers
                 return StatusCode(500, new ErrorResponseDto { Error = "Internal server error" });
             }
         }
+
+        // Sessions queued by a client while offline arrive together; all are saved or none
+        [HttpPost("idletime/batch")]
+        public async Task<IActionResult> UploadIdleTimeBatch([FromBody] List<IdleSessionDto> idleSessions)
+        {
+            try
+            {
+                if (idleSessions == null || idleSessions.Count == 0)
+                {
+                    return BadRequest(new ErrorResponseDto { Error = "No idle session data provided" });
+                }
+
+                for (var i = 0; i < idleSessions.Count; i++)
+                {
+                    var idleSession = idleSessions[i];
+                    if (idleSession == null || string.IsNullOrEmpty(idleSession.UserId) ||
+                        idleSession.StartTime >= idleSession.EndTime)
+                    {
+                        return BadRequest(new ErrorResponseDto { Error = $"Invalid idle session data at index {i}" });
+                    }
+                }
+
+                var entities = idleSessions.Select(ToIdleSession).ToList();
+
+                await _context.IdleSessions.AddRangeAsync(entities);
+                await _context.SaveChangesAsync();
+
+                _logger.LogInformation("Successfully saved {Count} idle sessions", entities.Count);
+
+                return Ok(new { message = "Idle sessions saved successfully", count = entities.Count });
+            }
+            catch (Exception ex)
+            {
+                _logger.LogError(ex, "Failed to save idle session batch");
+                return StatusCode(500, new ErrorResponseDto { Error = "Internal server error" });
+            }
+        }
+
+        private static IdleSession ToIdleSession(IdleSessionDto idleSession)
+        {
+            return new IdleSession
+            {
+                StartTime = idleSession.StartTime,
+                EndTime = idleSession.EndTime,
+                Reason = idleSession.Reason ?? "Idle",
+                Note = idleSession.Note ?? string.Empty,
+                UserId = idleSession.UserId,
+                SessionId = idleSession.SessionId ?? string.Empty,
+                DurationSeconds = (int)(idleSession.EndTime - idleSession.StartTime).TotalSeconds,
+                IsRemoteSession = idleSession.IsRemoteSession,
+                ActiveApplication = idleSession.ActiveApplication ?? string.Empty
+            };
+        }
     }
 
     // DTOs
@@ -179,6 +644,79 @@ namespace TimeTracker.API.Controllers
         public string SessionId { get; set; } = string.Empty;
     }
 
+    public class ActivityChunkDto
+    {
+        public string UserId { get; set; } = string.Empty;
+        public string SessionId { get; set; } = string.Empty;
+        public Dictionary<string, string> Strings { get; set; } = new();
+        public List<ActivityChunkEntryDto> Entries { get; set; } = new();
+
+        // Journal range the chunk was read from; older clients omit it
+        public uint? Segment { get; set; }
+        public long? StartOffset { get; set; }
+        public long? EndOffset { get; set; }
+    }
+
+    public class ActivityChunkRangeDto
+    {
+        public uint Segment { get; set; }
+        public long StartOffset { get; set; }
+        public long EndOffset { get; set; }
+    }
+
+    public class ActivityChunkResponseDto
+    {
+        public string Message { get; set; } = string.Empty;
+        public int Count { get; set; }
+        public ActivityChunkRangeDto? Acknowledged { get; set; }
+    }
+
+    public class ActivityChunkEntryDto
+    {
+        public DateTime Timestamp { get; set; }
+        public string EventType { get; set; } = string.Empty;
+        public string? Details { get; set; }
+        public int? Process { get; set; }
+        public int? Title { get; set; }
+    }
+
+    public class ActivitySummaryDto
+    {
+        public DateTime MinuteStart { get; set; }
+        public int KeyCount { get; set; }
+        public int ClickCount { get; set; }
+        public long MouseDistance { get; set; }
+        public int ActiveSeconds { get; set; }
+        public int IdleSeconds { get; set; }
+        public string? ProcessName { get; set; }
+        public string? WindowTitle { get; set; }
+        public string UserId { get; set; } = string.Empty;
+        public string? SessionId { get; set; }
+    }
+
+    public class ScreenMetadataDto
+    {
+        public string FileName { get; set; } = string.Empty;
+        public int ScreenIndex { get; set; }
+        public string? ScreenName { get; set; }
+        public int X { get; set; }
+        public int Y { get; set; }
+        public int Width { get; set; }
+        public int Height { get; set; }
+        public double DevicePixelRatio { get; set; } = 1.0;
+        public double Dpi { get; set; } = 96.0;
+
+        // Tile deltas (see IScreenshotFrameStore)
+        public string Kind { get; set; } = "keyframe";
+        public long Sequence { get; set; }
+        public long BaseSequence { get; set; }
+        public int FrameWidth { get; set; }
+        public int FrameHeight { get; set; }
+        public int TileSize { get; set; }
+        public int AtlasColumns { get; set; }
+        public List<int[]> Tiles { get; set; } = new();
+    }
+
     public class IdleSessionDto
     {
         [Required]
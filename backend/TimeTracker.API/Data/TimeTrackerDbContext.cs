@@ -12,6 +12,7 @@ namespace TimeTracker.API.Data
         public DbSet<ActivityLog> ActivityLogs { get; set; }
         public DbSet<Screenshot> Screenshots { get; set; }
         public DbSet<IdleSession> IdleSessions { get; set; }
+        public DbSet<ActivitySummary> ActivitySummaries { get; set; }
 
         protected override void OnModelCreating(ModelBuilder modelBuilder)
         {
@@ -27,6 +28,21 @@ namespace TimeTracker.API.Data
                 entity.HasIndex(e => new { e.UserId, e.Timestamp });
             });
 
+            modelBuilder.Entity<ActivitySummary>(entity =>
+            {
+                entity.HasKey(e => e.Id);
+                entity.Property(e => e.UserId).IsRequired().HasMaxLength(100);
+                entity.Property(e => e.SessionId).HasMaxLength(50);
+                entity.Property(e => e.MinuteStart).IsRequired();
+                entity.Property(e => e.ProcessName).HasMaxLength(100);
+                entity.Property(e => e.WindowTitle).HasMaxLength(500);
+
+                // One row per user and minute; a retried upload replaces it
+                entity.HasIndex(e => new { e.UserId, e.MinuteStart })
+                      .IsUnique()
+                      .HasDatabaseName("IX_ActivitySummaries_UserId_MinuteStart");
+            });
+
             modelBuilder.Entity<Screenshot>(entity =>
             {
                 entity.HasKey(e => e.Id);
@@ -35,8 +51,11 @@ namespace TimeTracker.API.Data
                 entity.Property(e => e.ThumbnailUrl).IsRequired().HasMaxLength(500);
                 entity.Property(e => e.UserId).IsRequired().HasMaxLength(100);
                 entity.Property(e => e.SessionId).HasMaxLength(50);
+                entity.Property(e => e.CaptureId).HasMaxLength(50);
+                entity.Property(e => e.ScreenName).HasMaxLength(100);
 
                 entity.HasIndex(e => new { e.UserId, e.Timestamp });
+                entity.HasIndex(e => e.CaptureId);
             });
 
             modelBuilder.Entity<IdleSession>(entity =>
@@ -0,0 +1,124 @@
+﻿using Microsoft.EntityFrameworkCore.Migrations;
+
+#nullable disable
+
+namespace TimeTracker.API.Migrations
+{
+    /// <inheritdoc />
+    public partial class AddScreenshotScreenMetadata : Migration
+    {
+        /// <inheritdoc />
+        protected override void Up(MigrationBuilder migrationBuilder)
+        {
+            migrationBuilder.AddColumn<string>(
+                name: "CaptureId",
+                table: "Screenshots",
+                type: "character varying(50)", maxLength: 50,
+                nullable: true);
+
+            migrationBuilder.AddColumn<double>(
+                name: "DevicePixelRatio",
+                table: "Screenshots",
+                type: "double precision",
+                nullable: false,
+                defaultValue: 1.0);
+
+            migrationBuilder.AddColumn<double>(
+                name: "Dpi",
+                table: "Screenshots",
+                type: "double precision",
+                nullable: false,
+                defaultValue: 96.0);
+
+            migrationBuilder.AddColumn<int>(
+                name: "ScreenHeight",
+                table: "Screenshots",
+                type: "integer",
+                nullable: false,
+                defaultValue: 0);
+
+            migrationBuilder.AddColumn<int>(
+                name: "ScreenIndex",
+                table: "Screenshots",
+                type: "integer",
+                nullable: false,
+                defaultValue: 0);
+
+            migrationBuilder.AddColumn<string>(
+                name: "ScreenName",
+                table: "Screenshots",
+                type: "character varying(100)", maxLength: 100,
+                nullable: true);
+
+            migrationBuilder.AddColumn<int>(
+                name: "ScreenWidth",
+                table: "Screenshots",
+                type: "integer",
+                nullable: false,
+                defaultValue: 0);
+
+            migrationBuilder.AddColumn<int>(
+                name: "ScreenX",
+                table: "Screenshots",
+                type: "integer",
+                nullable: false,
+                defaultValue: 0);
+
+            migrationBuilder.AddColumn<int>(
+                name: "ScreenY",
+                table: "Screenshots",
+                type: "integer",
+                nullable: false,
+                defaultValue: 0);
+
+            migrationBuilder.CreateIndex(
+                name: "IX_Screenshots_CaptureId",
+                table: "Screenshots",
+                column: "CaptureId");
+        }
+
+        /// <inheritdoc />
+        protected override void Down(MigrationBuilder migrationBuilder)
+        {
+            migrationBuilder.DropIndex(
+                name: "IX_Screenshots_CaptureId",
+                table: "Screenshots");
+
+            migrationBuilder.DropColumn(
+                name: "CaptureId",
+                table: "Screenshots");
+
+            migrationBuilder.DropColumn(
+                name: "DevicePixelRatio",
+                table: "Screenshots");
+
+            migrationBuilder.DropColumn(
+                name: "Dpi",
+                table: "Screenshots");
+
+            migrationBuilder.DropColumn(
+                name: "ScreenHeight",
+                table: "Screenshots");
+
+            migrationBuilder.DropColumn(
+                name: "ScreenIndex",
+                table: "Screenshots");
+
+            migrationBuilder.DropColumn(
+                name: "ScreenName",
+                table: "Screenshots");
+
+            migrationBuilder.DropColumn(
+                name: "ScreenWidth",
+                table: "Screenshots");
+
+            migrationBuilder.DropColumn(
+                name: "ScreenX",
+                table: "Screenshots");
+
+            migrationBuilder.DropColumn(
+                name: "ScreenY",
+                table: "Screenshots");
+        }
+    }
+}
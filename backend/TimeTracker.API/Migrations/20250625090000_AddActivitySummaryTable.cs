@@ -0,0 +1,52 @@
+﻿using System;
+using Microsoft.EntityFrameworkCore.Migrations;
+using Npgsql.EntityFrameworkCore.PostgreSQL.Metadata;
+
+#nullable disable
+
+namespace TimeTracker.API.Migrations
+{
+    /// <inheritdoc />
+    public partial class AddActivitySummaryTable : Migration
+    {
+        /// <inheritdoc />
+        protected override void Up(MigrationBuilder migrationBuilder)
+        {
+            migrationBuilder.CreateTable(
+                name: "ActivitySummaries",
+                columns: table => new
+                {
+                    Id = table.Column<long>(type: "bigint", nullable: false)
+                        .Annotation("Npgsql:ValueGenerationStrategy", NpgsqlValueGenerationStrategy.IdentityByDefaultColumn),
+                    UserId = table.Column<string>(type: "character varying(100)", maxLength: 100, nullable: false),
+                    SessionId = table.Column<string>(type: "character varying(50)", maxLength: 50, nullable: false),
+                    MinuteStart = table.Column<DateTime>(type: "timestamp with time zone", nullable: false),
+                    KeyCount = table.Column<int>(type: "integer", nullable: false),
+                    ClickCount = table.Column<int>(type: "integer", nullable: false),
+                    MouseDistance = table.Column<long>(type: "bigint", nullable: false),
+                    ActiveSeconds = table.Column<int>(type: "integer", nullable: false),
+                    IdleSeconds = table.Column<int>(type: "integer", nullable: false),
+                    ProcessName = table.Column<string>(type: "character varying(100)", maxLength: 100, nullable: false),
+                    WindowTitle = table.Column<string>(type: "character varying(500)", maxLength: 500, nullable: false),
+                    CreatedAt = table.Column<DateTime>(type: "timestamp with time zone", nullable: false)
+                },
+                constraints: table =>
+                {
+                    table.PrimaryKey("PK_ActivitySummaries", x => x.Id);
+                });
+
+            migrationBuilder.CreateIndex(
+                name: "IX_ActivitySummaries_UserId_MinuteStart",
+                table: "ActivitySummaries",
+                columns: new[] { "UserId", "MinuteStart" },
+                unique: true);
+        }
+
+        /// <inheritdoc />
+        protected override void Down(MigrationBuilder migrationBuilder)
+        {
+            migrationBuilder.DropTable(
+                name: "ActivitySummaries");
+        }
+    }
+}
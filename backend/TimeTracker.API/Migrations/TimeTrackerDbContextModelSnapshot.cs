@@ -60,6 +60,64 @@ namespace TimeTracker.API.Migrations
                     b.ToTable("ActivityLogs");
                 });
 
+            modelBuilder.Entity("TimeTracker.API.Models.ActivitySummary", b =>
+                {
+                    b.Property<long>("Id")
+                        .ValueGeneratedOnAdd()
+                        .HasColumnType("bigint");
+
+                    NpgsqlPropertyBuilderExtensions.UseIdentityByDefaultColumn(b.Property<long>("Id"));
+
+                    b.Property<int>("ActiveSeconds")
+                        .HasColumnType("integer");
+
+                    b.Property<int>("ClickCount")
+                        .HasColumnType("integer");
+
+                    b.Property<DateTime>("CreatedAt")
+                        .HasColumnType("timestamp with time zone");
+
+                    b.Property<int>("IdleSeconds")
+                        .HasColumnType("integer");
+
+                    b.Property<int>("KeyCount")
+                        .HasColumnType("integer");
+
+                    b.Property<DateTime>("MinuteStart")
+                        .HasColumnType("timestamp with time zone");
+
+                    b.Property<long>("MouseDistance")
+                        .HasColumnType("bigint");
+
+                    b.Property<string>("ProcessName")
+                        .IsRequired()
+                        .HasMaxLength(100)
+                        .HasColumnType("character varying(100)");
+
+                    b.Property<string>("SessionId")
+                        .IsRequired()
+                        .HasMaxLength(50)
+                        .HasColumnType("character varying(50)");
+
+                    b.Property<string>("UserId")
+                        .IsRequired()
+                        .HasMaxLength(100)
+                        .HasColumnType("character varying(100)");
+
+                    b.Property<string>("WindowTitle")
+                        .IsRequired()
+                        .HasMaxLength(500)
+                        .HasColumnType("character varying(500)");
+
+                    b.HasKey("Id");
+
+                    b.HasIndex("UserId", "MinuteStart")
+                        .IsUnique()
+                        .HasDatabaseName("IX_ActivitySummaries_UserId_MinuteStart");
+
+                    b.ToTable("ActivitySummaries");
+                });
+
             modelBuilder.Entity("TimeTracker.API.Models.IdleSession", b =>
                 {
                     b.Property<int>("Id")
@@ -127,6 +185,16 @@ namespace TimeTracker.API.Migrations
 
                     NpgsqlPropertyBuilderExtensions.UseIdentityByDefaultColumn(b.Property<int>("Id"));
 
+                    b.Property<string>("CaptureId")
+                        .HasMaxLength(50)
+                        .HasColumnType("character varying(50)");
+
+                    b.Property<double>("DevicePixelRatio")
+                        .HasColumnType("double precision");
+
+                    b.Property<double>("Dpi")
+                        .HasColumnType("double precision");
+
                     b.Property<long>("FileSize")
                         .HasColumnType("bigint");
 
@@ -135,6 +203,25 @@ namespace TimeTracker.API.Migrations
                         .HasMaxLength(500)
                         .HasColumnType("character varying(500)");
 
+                    b.Property<int>("ScreenHeight")
+                        .HasColumnType("integer");
+
+                    b.Property<int>("ScreenIndex")
+                        .HasColumnType("integer");
+
+                    b.Property<string>("ScreenName")
+                        .HasMaxLength(100)
+                        .HasColumnType("character varying(100)");
+
+                    b.Property<int>("ScreenWidth")
+                        .HasColumnType("integer");
+
+                    b.Property<int>("ScreenX")
+                        .HasColumnType("integer");
+
+                    b.Property<int>("ScreenY")
+                        .HasColumnType("integer");
+
                     b.Property<string>("SessionId")
                         .IsRequired()
                         .HasMaxLength(50)
@@ -155,6 +242,8 @@ namespace TimeTracker.API.Migrations
 
                     b.HasKey("Id");
 
+                    b.HasIndex("CaptureId");
+
                     b.HasIndex("UserId", "Timestamp");
 
                     b.ToTable("Screenshots");
@@ -0,0 +1,40 @@
+using System.ComponentModel.DataAnnotations;
+
+namespace TimeTracker.API.Models
+{
+    /// <summary>
+    /// Activity of one user during one wall-clock minute, aggregated by the client
+    /// </summary>
+    public class ActivitySummary
+    {
+        public long Id { get; set; }
+
+        [Required]
+        [StringLength(100)]
+        public string UserId { get; set; } = string.Empty;
+
+        [StringLength(50)]
+        public string SessionId { get; set; } = string.Empty;
+
+        [Required]
+        public DateTime MinuteStart { get; set; }
+
+        public int KeyCount { get; set; }
+
+        public int ClickCount { get; set; }
+
+        public long MouseDistance { get; set; }
+
+        public int ActiveSeconds { get; set; }
+
+        public int IdleSeconds { get; set; }
+
+        [StringLength(100)]
+        public string ProcessName { get; set; } = string.Empty;
+
+        [StringLength(500)]
+        public string WindowTitle { get; set; } = string.Empty;
+
+        public DateTime CreatedAt { get; set; } = DateTime.UtcNow;
+    }
+}
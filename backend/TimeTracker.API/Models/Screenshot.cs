@@ -25,5 +25,26 @@ namespace TimeTracker.API.Models
         public string SessionId { get; set; } = string.Empty;
         
         public long FileSize { get; set; }
+
+        // Multi-screen captures: screenshots taken together share a CaptureId
+        [StringLength(50)]
+        public string? CaptureId { get; set; }
+
+        public int ScreenIndex { get; set; }
+
+        [StringLength(100)]
+        public string? ScreenName { get; set; }
+
+        public int ScreenX { get; set; }
+
+        public int ScreenY { get; set; }
+
+        public int ScreenWidth { get; set; }
+
+        public int ScreenHeight { get; set; }
+
+        public double DevicePixelRatio { get; set; } = 1.0;
+
+        public double Dpi { get; set; } = 96.0;
     }
 }
@@ -1,10 +1,18 @@
 using Amazon.S3;
+using Microsoft.AspNetCore.Server.Kestrel.Core;
 using Microsoft.EntityFrameworkCore;
 using TimeTracker.API.Data;
 using TimeTracker.API.Services;
 
 var builder = WebApplication.CreateBuilder(args);
 
+// Clients upload every few minutes over one multiplexed HTTP/2 connection; keep it open in between
+builder.WebHost.ConfigureKestrel(options =>
+{
+    options.Limits.KeepAliveTimeout = TimeSpan.FromMinutes(10);
+    options.ConfigureEndpointDefaults(listen => listen.Protocols = HttpProtocols.Http1AndHttp2);
+});
+
 // Add services to the container
 builder.Services.AddControllers();
 builder.Services.AddEndpointsApiExplorer();
@@ -32,6 +40,15 @@ builder.Services.AddSingleton<IAmazonS3>(provider =>
 
 builder.Services.AddScoped<IS3Service, S3Service>();
 
+// Activity batches bypass change tracking (binary COPY on PostgreSQL)
+builder.Services.AddScoped<IActivityLogIngestor, ActivityLogIngestor>();
+
+// Clients gzip JSON bodies once a response advertises support (see below)
+builder.Services.AddRequestDecompression();
+
+// Last frame of every screen, the base for tile deltas
+builder.Services.AddSingleton<IScreenshotFrameStore, ScreenshotFrameStore>();
+
 // CORS configuration for client communication
 builder.Services.AddCors(options =>
 {
@@ -54,6 +71,15 @@ if (app.Environment.IsDevelopment())
 
 app.UseHttpsRedirection();
 app.UseCors("AllowClient");
+
+// Advertise the request content codings we decode (RFC 7694); older servers never send this,
+// so clients keep posting plain bodies to them
+app.Use(async (context, next) =>
+{
+    context.Response.Headers.Append("Accept-Encoding", "gzip, br, deflate");
+    await next();
+});
+app.UseRequestDecompression();
 app.UseAuthorization();
 app.MapControllers();
 
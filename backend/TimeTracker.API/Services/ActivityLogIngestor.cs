@@ -0,0 +1,125 @@
+using Microsoft.EntityFrameworkCore;
+using Npgsql;
+using NpgsqlTypes;
+using TimeTracker.API.Data;
+using TimeTracker.API.Models;
+
+namespace TimeTracker.API.Services
+{
+    public interface IActivityLogIngestor
+    {
+        /// <summary>
+        /// Insert a batch of activity logs as a single unit. Returns the number of rows written.
+        /// Timestamps must be UTC or local server time; zone-less ones are rejected with an
+        /// <see cref="ArgumentException"/> before anything is written.
+        /// </summary>
+        Task<int> InsertAsync(IReadOnlyList<ActivityLog> logs, CancellationToken cancellationToken = default);
+    }
+
+    /// <summary>
+    /// Writes activity logs with PostgreSQL binary COPY, one round trip per batch and
+    /// no EF Core change tracking. Other providers (the in-memory database used by the
+    /// tests) fall back to AddRange with change detection off. Either way a batch is
+    /// stored completely or not at all.
+    /// </summary>
+    public class ActivityLogIngestor : IActivityLogIngestor
+    {
+        private const string CopyCommand =
+            "COPY \"ActivityLogs\" (\"Timestamp\", \"EventType\", \"Details\", \"UserId\", \"SessionId\") " +
+            "FROM STDIN (FORMAT BINARY)";
+
+        // Column limits from TimeTrackerDbContext; COPY would reject the whole batch for one long value
+        private const int EventTypeMaxLength = 50;
+        private const int DetailsMaxLength = 1000;
+        private const int UserIdMaxLength = 100;
+        private const int SessionIdMaxLength = 50;
+
+        private readonly TimeTrackerDbContext _context;
+
+        public ActivityLogIngestor(TimeTrackerDbContext context)
+        {
+            _context = context;
+        }
+
+        public async Task<int> InsertAsync(IReadOnlyList<ActivityLog> logs, CancellationToken cancellationToken = default)
+        {
+            if (logs.Count == 0)
+            {
+                return 0;
+            }
+
+            if (logs.Any(log => log.Timestamp.Kind == DateTimeKind.Unspecified))
+            {
+                throw new ArgumentException("Activity log timestamps must carry a time zone", nameof(logs));
+            }
+
+            foreach (var log in logs)
+            {
+                Normalize(log);
+            }
+
+            if (_context.Database.IsNpgsql())
+            {
+                return await CopyAsync(logs, cancellationToken);
+            }
+
+            var autoDetectChanges = _context.ChangeTracker.AutoDetectChangesEnabled;
+            _context.ChangeTracker.AutoDetectChangesEnabled = false;
+            try
+            {
+                await _context.ActivityLogs.AddRangeAsync(logs, cancellationToken);
+                await _context.SaveChangesAsync(cancellationToken);
+                return logs.Count;
+            }
+            finally
+            {
+                _context.ChangeTracker.Clear();
+                _context.ChangeTracker.AutoDetectChangesEnabled = autoDetectChanges;
+            }
+        }
+
+        private async Task<int> CopyAsync(IReadOnlyList<ActivityLog> logs, CancellationToken cancellationToken)
+        {
+            var connection = (NpgsqlConnection)_context.Database.GetDbConnection();
+            await _context.Database.OpenConnectionAsync(cancellationToken);
+            try
+            {
+                // Rows are only committed by Complete; disposing the importer earlier discards them
+                await using var importer = await connection.BeginBinaryImportAsync(CopyCommand, cancellationToken);
+                foreach (var log in logs)
+                {
+                    await importer.StartRowAsync(cancellationToken);
+                    await importer.WriteAsync(log.Timestamp, NpgsqlDbType.TimestampTz, cancellationToken);
+                    await importer.WriteAsync(log.EventType, NpgsqlDbType.Varchar, cancellationToken);
+                    await importer.WriteAsync(log.Details, NpgsqlDbType.Varchar, cancellationToken);
+                    await importer.WriteAsync(log.UserId, NpgsqlDbType.Varchar, cancellationToken);
+                    await importer.WriteAsync(log.SessionId, NpgsqlDbType.Varchar, cancellationToken);
+                }
+                return (int)await importer.CompleteAsync(cancellationToken);
+            }
+            finally
+            {
+                await _context.Database.CloseConnectionAsync();
+            }
+        }
+
+        private static void Normalize(ActivityLog log)
+        {
+            // timestamptz only accepts UTC
+            log.Timestamp = log.Timestamp.ToUniversalTime();
+            log.EventType = Truncate(log.EventType, EventTypeMaxLength);
+            log.Details = Truncate(log.Details, DetailsMaxLength);
+            log.UserId = Truncate(log.UserId, UserIdMaxLength);
+            log.SessionId = Truncate(log.SessionId, SessionIdMaxLength);
+        }
+
+        private static string Truncate(string? value, int maxLength)
+        {
+            if (string.IsNullOrEmpty(value))
+            {
+                return string.Empty;
+            }
+            return value.Length <= maxLength ? value : value[..maxLength];
+        }
+    }
+}
@@ -28,7 +28,15 @@ namespace TimeTracker.API.Services
             try
             {
                 var timestamp = DateTime.UtcNow.ToString("yyyyMMdd_HHmmss_fff");
-                var originalKey = $"screenshots/{userId}/{timestamp}_original.jpg";
+                // The original keeps the client's encoding; thumbnails are always JPEG
+                var contentType = file.ContentType.ToLower() switch
+                {
+                    "image/png" => "image/png",
+                    "image/webp" => "image/webp",
+                    _ => "image/jpeg"
+                };
+                var extension = contentType == "image/jpeg" ? "jpg" : contentType.Substring("image/".Length);
+                var originalKey = $"screenshots/{userId}/{timestamp}_original.{extension}";
                 var thumbnailKey = $"screenshots/{userId}/{timestamp}_thumbnail.jpg";
 
                 // Upload original image
@@ -38,7 +46,7 @@ namespace TimeTracker.API.Services
                     BucketName = _bucketName,
                     Key = originalKey,
                     InputStream = originalStream,
-                    ContentType = "image/jpeg",
+                    ContentType = contentType,
                     ServerSideEncryptionMethod = ServerSideEncryptionMethod.AES256
                 };
 
@@ -0,0 +1,240 @@
+using System.Collections.Concurrent;
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+using SixLabors.ImageSharp.Processing;
+
+namespace TimeTracker.API.Services
+{
+    /// <summary>
+    /// A changed region of a screen, packed into a tile atlas slot
+    /// </summary>
+    public record ScreenshotTile(int X, int Y, int Width, int Height);
+
+    public interface IScreenshotFrameStore
+    {
+        /// <summary>
+        /// Remember a full frame as the base for later deltas
+        /// </summary>
+        void StoreKeyframe(string streamKey, long sequence, Image<Rgba32> frame);
+
+        /// <summary>
+        /// Paste the tiles of an atlas onto the stored frame. Returns the reassembled
+        /// frame, or null if the stored frame is not the delta's base.
+        /// </summary>
+        Image<Rgba32>? ApplyDelta(string streamKey, long baseSequence, long sequence, int frameWidth,
+            int frameHeight, int tileSize, int atlasColumns, IReadOnlyList<ScreenshotTile> tiles, Image<Rgba32> atlas);
+    }
+
+    /// <summary>
+    /// Keeps the last reassembled frame of every screen stream in memory.
+    /// Frames are lost on restart; the client then receives keyframeRequired
+    /// and sends a keyframe with its next capture.
+    ///
+    /// The store is bounded by the total size of its frames
+    /// (Screenshots:FrameStore:MaxBytes, default 2 GiB) rather than by the
+    /// number of streams, since one 4K frame alone is about 33 MB. Frames not
+    /// used for Screenshots:FrameStore:IdleMinutes (default 30) are dropped,
+    /// and past the byte limit the least recently used frames go first.
+    /// </summary>
+    public class ScreenshotFrameStore : IScreenshotFrameStore
+    {
+        private const long DefaultMaxBytes = 2L * 1024 * 1024 * 1024;
+        private const int DefaultIdleMinutes = 30;
+        private static readonly TimeSpan SweepInterval = TimeSpan.FromMinutes(1);
+
+        private class FrameState
+        {
+            public required Image<Rgba32> Frame { get; set; }
+            public long Bytes { get; set; }
+            public long Sequence { get; set; }
+            public DateTime LastUsed { get; set; }
+            public bool Disposed { get; set; }
+        }
+
+        private readonly ConcurrentDictionary<string, FrameState> _frames = new();
+        private readonly ILogger<ScreenshotFrameStore> _logger;
+        private readonly long _maxBytes;
+        private readonly TimeSpan _idleTimeout;
+        private readonly TimeSpan _sweepInterval;
+        private readonly object _trimLock = new();
+        private DateTime _nextSweep = DateTime.MinValue;
+        private long _totalBytes;
+        private long _evictedForSpace;
+        private long _expired;
+
+        public ScreenshotFrameStore(IConfiguration configuration, ILogger<ScreenshotFrameStore> logger)
+        {
+            _logger = logger;
+            _maxBytes = configuration.GetValue<long?>("Screenshots:FrameStore:MaxBytes") ?? DefaultMaxBytes;
+            _idleTimeout = TimeSpan.FromMinutes(configuration.GetValue<double?>("Screenshots:FrameStore:IdleMinutes") ?? DefaultIdleMinutes);
+            _sweepInterval = _idleTimeout < SweepInterval ? _idleTimeout : SweepInterval;
+        }
+
+        /// <summary>
+        /// Number of streams with a stored frame
+        /// </summary>
+        public int StreamCount => _frames.Count;
+
+        /// <summary>
+        /// Approximate memory held by the stored frames
+        /// </summary>
+        public long TotalBytes => Interlocked.Read(ref _totalBytes);
+
+        /// <summary>
+        /// Frames dropped to stay under the byte limit since startup
+        /// </summary>
+        public long EvictedForSpace => Interlocked.Read(ref _evictedForSpace);
+
+        /// <summary>
+        /// Frames dropped after going unused for the idle timeout since startup
+        /// </summary>
+        public long Expired => Interlocked.Read(ref _expired);
+
+        public void StoreKeyframe(string streamKey, long sequence, Image<Rgba32> frame)
+        {
+            var now = DateTime.UtcNow;
+            var state = new FrameState { Frame = frame, Bytes = (long)frame.Width * frame.Height * 4, Sequence = sequence, LastUsed = now };
+            FrameState? previous = null;
+            _frames.AddOrUpdate(streamKey, state, (_, existing) =>
+            {
+                previous = existing;
+                return state;
+            });
+            Interlocked.Add(ref _totalBytes, state.Bytes);
+            if (previous != null)
+            {
+                Release(previous);
+            }
+            Trim(now);
+        }
+
+        public Image<Rgba32>? ApplyDelta(string streamKey, long baseSequence, long sequence, int frameWidth,
+            int frameHeight, int tileSize, int atlasColumns, IReadOnlyList<ScreenshotTile> tiles, Image<Rgba32> atlas)
+        {
+            if (!_frames.TryGetValue(streamKey, out var state))
+            {
+                return null;
+            }
+
+            Image<Rgba32> result;
+            lock (state)
+            {
+                if (state.Disposed)
+                {
+                    return null;
+                }
+
+                if (state.Sequence != baseSequence || state.Frame.Width != frameWidth || state.Frame.Height != frameHeight
+                    || tileSize <= 0 || atlasColumns <= 0)
+                {
+                    _logger.LogWarning("Screenshot delta for {Stream} does not match the stored frame (have {Have}, need {Need})",
+                        streamKey, state.Sequence, baseSequence);
+                    return null;
+                }
+
+                var sources = new List<Rectangle>(tiles.Count);
+                for (var i = 0; i < tiles.Count; i++)
+                {
+                    var tile = tiles[i];
+                    var source = new Rectangle((i % atlasColumns) * tileSize, (i / atlasColumns) * tileSize, tile.Width, tile.Height);
+                    if (tile.Width <= 0 || tile.Height <= 0 || tile.Width > tileSize || tile.Height > tileSize
+                        || !atlas.Bounds.Contains(source) || !state.Frame.Bounds.Contains(new Rectangle(tile.X, tile.Y, tile.Width, tile.Height)))
+                    {
+                        _logger.LogWarning("Screenshot delta for {Stream} has an invalid tile {Tile}", streamKey, tile);
+                        return null;
+                    }
+                    sources.Add(source);
+                }
+
+                // Only paste once every tile is known to be valid, so a bad delta cannot corrupt the frame
+                for (var i = 0; i < tiles.Count; i++)
+                {
+                    using var patch = atlas.Clone(ctx => ctx.Crop(sources[i]));
+                    state.Frame.Mutate(ctx => ctx.DrawImage(patch, new Point(tiles[i].X, tiles[i].Y), 1f));
+                }
+
+                state.Sequence = sequence;
+                state.LastUsed = DateTime.UtcNow;
+                result = state.Frame.Clone();
+            }
+
+            // Outside the frame lock: trimming locks the frames it drops
+            Trim(DateTime.UtcNow);
+            return result;
+        }
+
+        private void Trim(DateTime now)
+        {
+            lock (_trimLock)
+            {
+                var expired = 0;
+                if (now >= _nextSweep)
+                {
+                    _nextSweep = now + _sweepInterval;
+                    foreach (var entry in _frames.Where(e => now - e.Value.LastUsed > _idleTimeout).ToList())
+                    {
+                        if (Remove(entry.Key, entry.Value))
+                        {
+                            expired++;
+                        }
+                    }
+                }
+
+                var evicted = 0;
+                if (TotalBytes > _maxBytes)
+                {
+                    foreach (var entry in _frames.OrderBy(e => e.Value.LastUsed).ToList())
+                    {
+                        if (TotalBytes <= _maxBytes)
+                        {
+                            break;
+                        }
+                        if (Remove(entry.Key, entry.Value))
+                        {
+                            evicted++;
+                        }
+                    }
+                }
+
+                if (expired > 0)
+                {
+                    Interlocked.Add(ref _expired, expired);
+                    _logger.LogInformation("Screenshot frame store dropped {Count} idle streams ({Streams} streams, {Bytes} bytes left)",
+                        expired, StreamCount, TotalBytes);
+                }
+                if (evicted > 0)
+                {
+                    // Evicted streams fall back to keyframes, so a steady stream of these means the limit is too low
+                    Interlocked.Add(ref _evictedForSpace, evicted);
+                    _logger.LogWarning("Screenshot frame store evicted {Count} streams to stay under {MaxBytes} bytes "
+                        + "({Streams} streams, {Total} evicted since startup)", evicted, _maxBytes, StreamCount, EvictedForSpace);
+                }
+            }
+        }
+
+        private bool Remove(string streamKey, FrameState state)
+        {
+            // Only remove the entry that was looked at; a newer keyframe may have replaced it since
+            if (!_frames.TryRemove(new KeyValuePair<string, FrameState>(streamKey, state)))
+            {
+                return false;
+            }
+            Release(state);
+            return true;
+        }
+
+        private void Release(FrameState state)
+        {
+            lock (state)
+            {
+                if (state.Disposed)
+                {
+                    return;
+                }
+                state.Frame.Dispose();
+                state.Disposed = true;
+            }
+            Interlocked.Add(ref _totalBytes, -state.Bytes);
+        }
+    }
+}